@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <cstdlib>
+#include <cstring>
+#include <signal.h>
+#include <QCoreApplication>
+
+#include "maincore.h"
+
+static void usage(const char *program)
+{
+	fprintf(stderr, "usage: %s [-d deviceId] [-s serial] [-n sequence] [-g presetGroup] [-p presetDescription]\n", program);
+	fprintf(stderr, "  runs the working preset of the settings file unless a preset is given\n");
+}
+
+static void handleSignal(int sig)
+{
+	(void) sig;
+	MainCore::requestQuit();
+}
+
+static int runQtApplication(int argc, char* argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	// same settings file as the GUI
+	QCoreApplication::setOrganizationName("f4exb");
+	QCoreApplication::setApplicationName("SDRangel");
+
+	MainCore::Options options;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if ((strcmp(argv[i], "-d") == 0) && (i + 1 < argc)) {
+			options.m_deviceId = argv[++i];
+		} else if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+			options.m_deviceSerial = argv[++i];
+		} else if ((strcmp(argv[i], "-n") == 0) && (i + 1 < argc)) {
+			options.m_deviceSequence = std::atoi(argv[++i]);
+		} else if ((strcmp(argv[i], "-g") == 0) && (i + 1 < argc)) {
+			options.m_presetGroup = argv[++i];
+		} else if ((strcmp(argv[i], "-p") == 0) && (i + 1 < argc)) {
+			options.m_presetDescription = argv[++i];
+		}
+		else
+		{
+			usage(argv[0]);
+			return 1;
+		}
+	}
+
+	signal(SIGINT, handleSignal);
+	signal(SIGTERM, handleSignal);
+
+	MainCore m(options);
+
+	if (!m.start()) {
+		return 1;
+	}
+
+	return a.exec();
+}
+
+int main(int argc, char* argv[])
+{
+	int res = runQtApplication(argc, argv);
+	qWarning("SDRangel server quit.");
+	return res;
+}
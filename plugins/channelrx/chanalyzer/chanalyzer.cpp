@@ -20,6 +20,7 @@
 #include <QTime>
 #include <QDebug>
 #include <stdio.h>
+#include <algorithm>
 #include "audio/audiooutput.h"
 
 
@@ -63,25 +64,29 @@ void ChannelAnalyzer::configure(MessageQueue* messageQueue,
 void ChannelAnalyzer::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
 {
 	fftfilt::cmplx *sideband;
-	int n_out;
+	int n_out, nbIn;
 	int decim = 1<<m_spanLog2;
 	unsigned char decim_mask = decim - 1; // counter LSB bit mask for decimation by 2^(m_scaleLog2 - 1)
 
 	m_settingsMutex.lock();
 
-	for(SampleVector::const_iterator it = begin; it < end; ++it)
+	for (SampleVector::const_iterator it = begin; it < end; it += nbIn)
 	{
-		//Complex c(it->real() / 32768.0f, it->imag() / 32768.0f);
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		// process in blocks of at most ssbFftLen samples to keep the work buffers small
+		nbIn = std::min((int) (end - it), (int) ssbFftLen);
+		m_nco.mixIQ(it, it + nbIn, m_mixBuffer);
 
 		if (m_ssb)
 		{
-			n_out = SSBFilter->runSSB(c, &sideband, m_usb);
+			m_sidebandBuffer.resize(SSBFilter->outputSize(nbIn));
+			sideband = m_sidebandBuffer.data();
+			n_out = SSBFilter->runSSB(m_mixBuffer.data(), nbIn, sideband, m_usb);
 		}
 		else
 		{
-			n_out = DSBFilter->runDSB(c, &sideband);
+			m_sidebandBuffer.resize(DSBFilter->outputSize(nbIn));
+			sideband = m_sidebandBuffer.data();
+			n_out = DSBFilter->runDSB(m_mixBuffer.data(), nbIn, sideband);
 		}
 
 		for (int i = 0; i < n_out; i++)
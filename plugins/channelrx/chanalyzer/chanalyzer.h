@@ -94,8 +94,10 @@ private:
 	Real m_magsq;
 
 	NCOF m_nco;
+	std::vector<Complex> m_mixBuffer; //!< input block mixed down by the NCO
 	fftfilt* SSBFilter;
 	fftfilt* DSBFilter;
+	std::vector<fftfilt::cmplx> m_sidebandBuffer; //!< filter output of the mixed block
 
 	BasebandSampleSink* m_sampleSink;
 	SampleVector m_sampleBuffer;
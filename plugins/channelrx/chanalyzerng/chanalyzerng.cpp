@@ -20,6 +20,7 @@
 #include <QTime>
 #include <QDebug>
 #include <stdio.h>
+#include <algorithm>
 #include "audio/audiooutput.h"
 
 
@@ -60,27 +61,24 @@ void ChannelAnalyzerNG::configure(MessageQueue* messageQueue,
 
 void ChannelAnalyzerNG::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
 {
-	fftfilt::cmplx *sideband;
-	Complex ci;
+	int nbIn;
 
 	m_settingsMutex.lock();
 
-	for(SampleVector::const_iterator it = begin; it < end; ++it)
+	for (SampleVector::const_iterator it = begin; it < end; it += nbIn)
 	{
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		// process in blocks of at most ssbFftLen samples to keep the work buffers small
+		nbIn = std::min((int) (end - it), (int) ssbFftLen);
+		m_nco.mixIQ(it, it + nbIn, m_mixBuffer);
 
 		if (m_useInterpolator)
 		{
-            if (m_interpolator.decimate(&m_interpolatorDistanceRemain, c, &ci))
-            {
-                processOneSample(ci, sideband);
-                m_interpolatorDistanceRemain += m_interpolatorDistance;
-            }
+            int nbDecim = m_interpolator.decimate(&m_interpolatorDistanceRemain, m_interpolatorDistance, m_mixBuffer.data(), nbIn, m_mixBuffer.data());
+            processBlock(m_mixBuffer.data(), nbDecim);
 		}
 		else
 		{
-	        processOneSample(c, sideband);
+	        processBlock(m_mixBuffer.data(), nbIn);
 		}
 	}
 
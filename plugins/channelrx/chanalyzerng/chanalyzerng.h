@@ -124,12 +124,14 @@ private:
 	bool m_useInterpolator;
 
 	NCOF m_nco;
+	std::vector<Complex> m_mixBuffer; //!< input block mixed down by the NCO
     Interpolator m_interpolator;
     Real m_interpolatorDistance;
     Real m_interpolatorDistanceRemain;
 
 	fftfilt* SSBFilter;
 	fftfilt* DSBFilter;
+	std::vector<fftfilt::cmplx> m_sidebandBuffer; //!< filter output of the mixed or decimated block
 
 	BasebandSampleSink* m_sampleSink;
 	SampleVector m_sampleBuffer;
@@ -137,18 +139,23 @@ private:
 
 	void apply(bool force = false);
 
-	void processOneSample(Complex& c, fftfilt::cmplx *sideband)
+	void processBlock(const Complex *in, int nbIn)
 	{
+	    fftfilt::cmplx *sideband;
 	    int n_out;
 	    int decim = 1<<m_running.m_spanLog2;
 
         if (m_running.m_ssb)
         {
-            n_out = SSBFilter->runSSB(c, &sideband, m_usb);
+            m_sidebandBuffer.resize(SSBFilter->outputSize(nbIn));
+            sideband = m_sidebandBuffer.data();
+            n_out = SSBFilter->runSSB(in, nbIn, sideband, m_usb);
         }
         else
         {
-            n_out = DSBFilter->runDSB(c, &sideband);
+            m_sidebandBuffer.resize(DSBFilter->outputSize(nbIn));
+            sideband = m_sidebandBuffer.data();
+            n_out = DSBFilter->runDSB(in, nbIn, sideband);
         }
 
         for (int i = 0; i < n_out; i++)
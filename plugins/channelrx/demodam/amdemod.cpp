@@ -75,11 +75,12 @@ void AMDemod::feed(const SampleVector::const_iterator& begin, const SampleVector
 
 	m_settingsMutex.lock();
 
-	for (SampleVector::const_iterator it = begin; it != end; ++it)
+	m_nco.mixIQ(begin, end, m_mixBuffer);
+	std::vector<Complex>::const_iterator mixed = m_mixBuffer.begin();
+
+	for (SampleVector::const_iterator it = begin; it != end; ++it, ++mixed)
 	{
-		//Complex c(it->real() / 32768.0, it->imag() / 32768.0);
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		Complex c = *mixed;
 
 		if (m_interpolatorDistance < 1.0f) // interpolate
 		{
@@ -124,6 +124,7 @@ private:
 	Config m_running;
 
 	NCO m_nco;
+	std::vector<Complex> m_mixBuffer; //!< input block mixed down by the NCO
 	Interpolator m_interpolator;
 	Real m_interpolatorDistance;
 	Real m_interpolatorDistanceRemain;
@@ -21,6 +21,7 @@
 #include <QDebug>
 #include <stdio.h>
 #include <complex.h>
+#include <algorithm>
 #include "audio/audiooutput.h"
 #include "dsp/dspengine.h"
 #include "dsp/pidcontroller.h"
@@ -105,21 +106,28 @@ void BFMDemod::configure(MessageQueue* messageQueue,
 
 void BFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool firstOfBurst)
 {
-	Complex ci, cs, cr;
+	Complex ci, cs;
 	fftfilt::cmplx *rf;
-	int rf_out;
+	int rf_out, nbIn;
 	Real msq, demod;
 
 	m_sampleBuffer.clear();
 
 	m_settingsMutex.lock();
 
-	for (SampleVector::const_iterator it = begin; it != end; ++it)
+	for (SampleVector::const_iterator it = begin; it != end; it += nbIn)
 	{
-		Complex c(it->real() / 32768.0f, it->imag() / 32768.0f);
-		c *= m_nco.nextIQ();
+		// process in blocks of at most filtFftLen samples to keep the work buffers small
+		nbIn = std::min((int) (end - it), (int) filtFftLen);
+		m_nco.mixIQ(it, it + nbIn, m_rfFilterIn, 1.0f / 32768.0f);
 
-		rf_out = m_rfFilter->runFilt(c, &rf); // filter RF before demod
+		m_rfFilterOut.resize(m_rfFilter->outputSize(nbIn));
+		rf = m_rfFilterOut.data();
+		rf_out = m_rfFilter->runFilt(m_rfFilterIn.data(), nbIn, rf); // filter RF before demod
+
+		m_demodBuffer.resize(rf_out);
+		m_stereoBuffer.clear();
+		m_rdsBuffer.clear();
 
 		for (int i =0 ; i  <rf_out; i++)
 		{
@@ -160,29 +168,9 @@ void BFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 			if (m_running.m_rdsActive)
 			{
 				//Complex r(demod * 2.0 * std::cos(3.0 * m_pilotPLLSamples[3]), 0.0);
-				Complex r(demod * 2.0 * std::cos(3.0 * m_pilotPLLSamples[3]), 0.0);
-
-				if (m_interpolatorRDS.decimate(&m_interpolatorRDSDistanceRemain, r, &cr))
-				{
-					bool bit;
-
-					if (m_rdsDemod.process(cr.real(), bit))
-					{
-						if (m_rdsDecoder.frameSync(bit))
-						{
-							if (m_rdsParser)
-							{
-								m_rdsParser->parseGroup(m_rdsDecoder.getGroup());
-							}
-						}
-					}
-
-					m_interpolatorRDSDistanceRemain += m_interpolatorRDSDistance;
-				}
+				m_rdsBuffer.push_back(Complex(demod * 2.0 * std::cos(3.0 * m_pilotPLLSamples[3]), 0.0));
 			}
 
-			Real sampleStereo;
-
 			// Process stereo if stereo mode is selected
 
 			if (m_running.m_audioStereo)
@@ -197,70 +185,90 @@ void BFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 				if (m_running.m_lsbStereo)
 				{
 					// 1.17 * 0.7 = 0.819
-					Complex s(demod * m_pilotPLLSamples[1], demod * m_pilotPLLSamples[2]);
-
-					if (m_interpolatorStereo.decimate(&m_interpolatorStereoDistanceRemain, s, &cs))
-					{
-						sampleStereo = cs.real() + cs.imag();
-						m_interpolatorStereoDistanceRemain += m_interpolatorStereoDistance;
-					}
+					m_stereoBuffer.push_back(Complex(demod * m_pilotPLLSamples[1], demod * m_pilotPLLSamples[2]));
 				}
 				else
 				{
-					Complex s(demod * 1.17 * m_pilotPLLSamples[1], 0);
+					m_stereoBuffer.push_back(Complex(demod * 1.17 * m_pilotPLLSamples[1], 0));
+				}
+			}
+
+			m_demodBuffer[i] = Complex(demod, 0);
+		}
+
+		int nbRDS = m_interpolatorRDS.decimate(&m_interpolatorRDSDistanceRemain, m_interpolatorRDSDistance, m_rdsBuffer.data(), m_rdsBuffer.size(), m_rdsBuffer.data());
 
-					if (m_interpolatorStereo.decimate(&m_interpolatorStereoDistanceRemain, s, &cs))
+		for (int i = 0; i < nbRDS; i++)
+		{
+			bool bit;
+
+			if (m_rdsDemod.process(m_rdsBuffer[i].real(), bit))
+			{
+				if (m_rdsDecoder.frameSync(bit))
+				{
+					if (m_rdsParser)
 					{
-						sampleStereo = cs.real();
-						m_interpolatorStereoDistanceRemain += m_interpolatorStereoDistance;
+						m_rdsParser->parseGroup(m_rdsDecoder.getGroup());
 					}
 				}
 			}
+		}
 
-			Complex e(demod, 0);
+		// Stereo and mono outputs are paired by index. In stereo mode both interpolators
+		// get the same rf_out samples at the same distance and start from the same remainder
+		// so they produce the same number of outputs. In mono mode the stereo buffer is empty.
+		if (m_running.m_audioStereo)
+		{
+			m_interpolatorStereoDistanceRemain = m_interpolatorDistanceRemain;
+		}
+
+		int nbStereo = m_interpolatorStereo.decimate(&m_interpolatorStereoDistanceRemain, m_interpolatorStereoDistance, m_stereoBuffer.data(), m_stereoBuffer.size(), m_stereoBuffer.data());
+		int nbOut = m_interpolator.decimate(&m_interpolatorDistanceRemain, m_interpolatorDistance, m_demodBuffer.data(), rf_out, m_demodBuffer.data());
+		Q_ASSERT(!m_running.m_audioStereo || nbStereo == nbOut);
 
-			if (m_interpolator.decimate(&m_interpolatorDistanceRemain, e, &ci))
+		for (int i = 0; i < nbOut; i++)
+		{
+			ci = m_demodBuffer[i];
+			cs = i < nbStereo ? m_stereoBuffer[i] : Complex(0, 0);
+			Real sampleStereo = m_running.m_lsbStereo ? cs.real() + cs.imag() : cs.real();
+
+			if (m_running.m_audioStereo)
 			{
-				if (m_running.m_audioStereo)
+				Real deemph_l, deemph_r; // Pre-emphasis is applied on each channel before multiplexing
+				m_deemphasisFilterX.process(ci.real() + sampleStereo, deemph_l);
+				m_deemphasisFilterY.process(ci.real() - sampleStereo, deemph_r);
+				if (m_running.m_lsbStereo)
 				{
-					Real deemph_l, deemph_r; // Pre-emphasis is applied on each channel before multiplexing
-					m_deemphasisFilterX.process(ci.real() + sampleStereo, deemph_l);
-					m_deemphasisFilterY.process(ci.real() - sampleStereo, deemph_r);
-					if (m_running.m_lsbStereo)
-					{
-						m_audioBuffer[m_audioBufferFill].l = (qint16)(deemph_l * (1<<12) * m_running.m_volume);
-						m_audioBuffer[m_audioBufferFill].r = (qint16)(deemph_r * (1<<12) * m_running.m_volume);
-					}
-					else
-					{
-						m_audioBuffer[m_audioBufferFill].l = (qint16)(deemph_l * (1<<12) * m_running.m_volume);
-						m_audioBuffer[m_audioBufferFill].r = (qint16)(deemph_r * (1<<12) * m_running.m_volume);
-					}
+					m_audioBuffer[m_audioBufferFill].l = (qint16)(deemph_l * (1<<12) * m_running.m_volume);
+					m_audioBuffer[m_audioBufferFill].r = (qint16)(deemph_r * (1<<12) * m_running.m_volume);
 				}
 				else
 				{
-					Real deemph;
-					m_deemphasisFilterX.process(ci.real(), deemph);
-					quint16 sample = (qint16)(deemph * (1<<12) * m_running.m_volume);
-					m_audioBuffer[m_audioBufferFill].l = sample;
-					m_audioBuffer[m_audioBufferFill].r = sample;
+					m_audioBuffer[m_audioBufferFill].l = (qint16)(deemph_l * (1<<12) * m_running.m_volume);
+					m_audioBuffer[m_audioBufferFill].r = (qint16)(deemph_r * (1<<12) * m_running.m_volume);
 				}
+			}
+			else
+			{
+				Real deemph;
+				m_deemphasisFilterX.process(ci.real(), deemph);
+				quint16 sample = (qint16)(deemph * (1<<12) * m_running.m_volume);
+				m_audioBuffer[m_audioBufferFill].l = sample;
+				m_audioBuffer[m_audioBufferFill].r = sample;
+			}
 
-				++m_audioBufferFill;
-
-				if(m_audioBufferFill >= m_audioBuffer.size())
-				{
-					uint res = m_audioFifo.write((const quint8*)&m_audioBuffer[0], m_audioBufferFill, 1);
+			++m_audioBufferFill;
 
-					if(res != m_audioBufferFill)
-					{
-						qDebug("BFMDemod::feed: %u/%u audio samples written", res, m_audioBufferFill);
-					}
+			if(m_audioBufferFill >= m_audioBuffer.size())
+			{
+				uint res = m_audioFifo.write((const quint8*)&m_audioBuffer[0], m_audioBufferFill, 1);
 
-					m_audioBufferFill = 0;
+				if(res != m_audioBufferFill)
+				{
+					qDebug("BFMDemod::feed: %u/%u audio samples written", res, m_audioBufferFill);
 				}
 
-				m_interpolatorDistanceRemain += m_interpolatorDistance;
+				m_audioBufferFill = 0;
 			}
 		}
 	}
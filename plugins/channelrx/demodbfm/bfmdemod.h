@@ -200,6 +200,11 @@ private:
 
 	Lowpass<Real> m_lowpass;
 	fftfilt* m_rfFilter;
+	std::vector<fftfilt::cmplx> m_rfFilterIn;  //!< NCO mixed input block
+	std::vector<fftfilt::cmplx> m_rfFilterOut; //!< filtered output block
+	std::vector<Complex> m_demodBuffer;  //!< demodulated block then decimated in place
+	std::vector<Complex> m_stereoBuffer; //!< stereo difference block then decimated in place
+	std::vector<Complex> m_rdsBuffer;    //!< RDS subcarrier block then decimated in place
 	static const int filtFftLen = 1024;
 
 	Real m_squelchLevel;
@@ -21,6 +21,7 @@
 #include <QDebug>
 #include <stdio.h>
 #include <complex.h>
+#include <algorithm>
 #include <dsp/downchannelizer.h>
 #include "audio/audiooutput.h"
 #include "dsp/pidcontroller.h"
@@ -126,19 +127,23 @@ void DSDDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 {
 	Complex ci;
 	int samplesPerSymbol = m_dsdDecoder.getSamplesPerSymbol();
+	int nbIn;
 
 	m_settingsMutex.lock();
 	m_scopeSampleBuffer.clear();
 
 	m_dsdDecoder.enableMbelib(!DSPEngine::instance()->hasDVSerialSupport()); // disable mbelib if DV serial support is present and activated else enable it
 
-	for (SampleVector::const_iterator it = begin; it != end; ++it)
+	for (SampleVector::const_iterator it = begin; it != end; it += nbIn)
 	{
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		nbIn = std::min((int) (end - it), (int) mixBlockSize);
+		m_nco.mixIQ(it, it + nbIn, m_mixBuffer);
+		m_decimBuffer.resize(nbIn);
+		int nbOut = m_interpolator.decimate(&m_interpolatorDistanceRemain, m_interpolatorDistance, m_mixBuffer.data(), nbIn, m_decimBuffer.data());
 
-        if (m_interpolator.decimate(&m_interpolatorDistanceRemain, c, &ci))
+        for (int i = 0; i < nbOut; i++)
         {
+            ci = m_decimBuffer[i];
             qint16 sample, delayedSample;
 
             Real magsq = ((ci.real()*ci.real() +  ci.imag()*ci.imag()))  / (1<<30);
@@ -261,8 +266,6 @@ void DSDDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 //
 //                m_dsdDecoder.resetMbeDV1();
 //            }
-
-            m_interpolatorDistanceRemain += m_interpolatorDistance;
         }
 	}
 
@@ -245,10 +245,12 @@ void LoRaDemod::feed(const SampleVector::const_iterator& begin, const SampleVect
 
 	m_settingsMutex.lock();
 
-	for(SampleVector::const_iterator it = begin; it < end; ++it)
+	m_nco.mixIQ(begin, end, m_mixBuffer, 1.0f / 32768.0f);
+	std::vector<Complex>::const_iterator mixed = m_mixBuffer.begin();
+
+	for(SampleVector::const_iterator it = begin; it < end; ++it, ++mixed)
 	{
-		Complex c(it->real() / 32768.0f, it->imag() / 32768.0f);
-		c *= m_nco.nextIQ();
+		Complex c = *mixed;
 
 		if(m_interpolator.decimate(&m_sampleDistanceRemain, c, &ci))
 		{
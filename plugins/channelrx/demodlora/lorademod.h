@@ -93,6 +93,7 @@ private:
 	short* finetune;
 
 	NCO m_nco;
+	std::vector<Complex> m_mixBuffer; //!< input block mixed down by the NCO
 	Interpolator m_interpolator;
 	Real m_sampleDistanceRemain;
 
@@ -21,6 +21,7 @@
 #include <QDebug>
 #include <stdio.h>
 #include <complex.h>
+#include <algorithm>
 #include <dsp/downchannelizer.h>
 #include "audio/audiooutput.h"
 #include "dsp/pidcontroller.h"
@@ -141,18 +142,21 @@ Real angleDist(Real a, Real b)
 void NFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool firstOfBurst)
 {
 	Complex ci;
+	int nbIn;
 
 	m_settingsMutex.lock();
 
-	for (SampleVector::const_iterator it = begin; it != end; ++it)
+	for (SampleVector::const_iterator it = begin; it != end; it += nbIn)
 	{
-		//Complex c(it->real() / 32768.0f, it->imag() / 32768.0f);
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		nbIn = std::min((int) (end - it), (int) mixBlockSize);
+		m_nco.mixIQ(it, it + nbIn, m_mixBuffer);
+		m_decimBuffer.resize(nbIn);
+		int nbOut = m_interpolator.decimate(&m_interpolatorDistanceRemain, m_interpolatorDistance, m_mixBuffer.data(), nbIn, m_decimBuffer.data());
 
 		{
-			if (m_interpolator.decimate(&m_interpolatorDistanceRemain, c, &ci))
+			for (int i = 0; i < nbOut; i++)
 			{
+				ci = m_decimBuffer[i];
 
 				qint16 sample;
 
@@ -315,8 +319,6 @@ void NFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 
 					m_audioBufferFill = 0;
 				}
-
-				m_interpolatorDistanceRemain += m_interpolatorDistance;
 			}
 		}
 	}
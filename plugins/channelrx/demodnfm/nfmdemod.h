@@ -199,7 +199,11 @@ private:
 	Config m_config;
 	Config m_running;
 
+	static const int mixBlockSize = 1024; //!< input samples mixed and decimated per pass
+
 	NCO m_nco;
+	std::vector<Complex> m_mixBuffer; //!< input block mixed down by the NCO
+	std::vector<Complex> m_decimBuffer; //!< input block decimated by the interpolator
 	Interpolator m_interpolator;
 	Real m_interpolatorDistance;
 	Real m_interpolatorDistanceRemain;
@@ -22,6 +22,7 @@
 #include <QTime>
 #include <QDebug>
 #include <stdio.h>
+#include <algorithm>
 #include "audio/audiooutput.h"
 #include "dsp/dspengine.h"
 
@@ -91,38 +92,33 @@ void SSBDemod::configure(MessageQueue* messageQueue,
 
 void SSBDemod::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
 {
-	Complex ci;
 	fftfilt::cmplx *sideband;
 	Real avg;
-	int n_out;
+	int n_out, nbIn;
 
 	m_settingsMutex.lock();
 
 	int decim = 1<<(m_spanLog2 - 1);
 	unsigned char decim_mask = decim - 1; // counter LSB bit mask for decimation by 2^(m_scaleLog2 - 1)
 
-	for(SampleVector::const_iterator it = begin; it < end; ++it)
+	for (SampleVector::const_iterator it = begin; it < end; it += nbIn)
 	{
-		//Complex c(it->real() / 32768.0, it->imag() / 32768.0);
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		// process in blocks of at most ssbFftLen samples to keep the work buffers small
+		nbIn = std::min((int) (end - it), (int) ssbFftLen);
+		m_nco.mixIQ(it, it + nbIn, m_mixBuffer);
+		int nbDecim = m_interpolator.decimate(&m_sampleDistanceRemain, (Real)m_sampleRate / m_audioSampleRate, m_mixBuffer.data(), nbIn, m_mixBuffer.data());
 
-		if(m_interpolator.decimate(&m_sampleDistanceRemain, c, &ci))
+		if (m_dsb)
 		{
-			if (m_dsb)
-			{
-				n_out = DSBFilter->runDSB(ci, &sideband);
-			}
-			else
-			{
-				n_out = SSBFilter->runSSB(ci, &sideband, m_usb);
-			}
-
-			m_sampleDistanceRemain += (Real)m_sampleRate / m_audioSampleRate;
+			m_sidebandBuffer.resize(DSBFilter->outputSize(nbDecim));
+			sideband = m_sidebandBuffer.data();
+			n_out = DSBFilter->runDSB(m_mixBuffer.data(), nbDecim, sideband);
 		}
 		else
 		{
-			n_out = 0;
+			m_sidebandBuffer.resize(SSBFilter->outputSize(nbDecim));
+			sideband = m_sidebandBuffer.data();
+			n_out = SSBFilter->runSSB(m_mixBuffer.data(), nbDecim, sideband, m_usb);
 		}
 
 		for (int i = 0; i < n_out; i++)
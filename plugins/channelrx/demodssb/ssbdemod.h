@@ -144,10 +144,12 @@ private:
     int  m_magsqCount;
 
 	NCOF m_nco;
+	std::vector<Complex> m_mixBuffer; //!< input block mixed down by the NCO
 	Interpolator m_interpolator;
 	Real m_sampleDistanceRemain;
 	fftfilt* SSBFilter;
 	fftfilt* DSBFilter;
+	std::vector<fftfilt::cmplx> m_sidebandBuffer; //!< filter output of the decimated block
 
 	BasebandSampleSink* m_sampleSink;
 	SampleVector m_sampleBuffer;
@@ -21,6 +21,7 @@
 #include <QDebug>
 #include <stdio.h>
 #include <complex.h>
+#include <algorithm>
 #include <dsp/downchannelizer.h>
 #include "audio/audiooutput.h"
 #include "dsp/dspengine.h"
@@ -88,20 +89,24 @@ void WFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
 {
 	Complex ci;
 	fftfilt::cmplx *rf;
-	int rf_out;
+	int rf_out, nbIn;
 	Real demod;
 	double msq;
 	float fmDev;
 
 	m_settingsMutex.lock();
 
-	for (SampleVector::const_iterator it = begin; it != end; ++it)
+	for (SampleVector::const_iterator it = begin; it != end; it += nbIn)
 	{
-		//Complex c(it->real() / 32768.0f, it->imag() / 32768.0f);
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		// process in blocks of at most rfFilterFftLength samples to keep the work buffers small
+		nbIn = std::min((int) (end - it), (int) rfFilterFftLength);
+		m_nco.mixIQ(it, it + nbIn, m_rfFilterIn);
 
-		rf_out = m_rfFilter->runFilt(c, &rf); // filter RF before demod
+		m_rfFilterOut.resize(m_rfFilter->outputSize(nbIn));
+		rf = m_rfFilterOut.data();
+		rf_out = m_rfFilter->runFilt(m_rfFilterIn.data(), nbIn, rf); // filter RF before demod
+
+		m_demodBuffer.resize(rf_out);
 
 		for (int i = 0 ; i < rf_out; i++)
 		{
@@ -137,29 +142,31 @@ void WFMDemod::feed(const SampleVector::const_iterator& begin, const SampleVecto
                 demod = 0;
             }
 
-            Complex e(demod, 0);
+            m_demodBuffer[i] = Complex(demod, 0);
+		}
 
-			if(m_interpolator.decimate(&m_interpolatorDistanceRemain, e, &ci))
-			{
-				quint16 sample = (qint16)(ci.real() * 3276.8f * m_running.m_volume);
-				m_sampleBuffer.push_back(Sample(sample, sample));
-				m_audioBuffer[m_audioBufferFill].l = sample;
-				m_audioBuffer[m_audioBufferFill].r = sample;
-				++m_audioBufferFill;
+		int nbOut = m_interpolator.decimate(&m_interpolatorDistanceRemain, m_interpolatorDistance, m_demodBuffer.data(), rf_out, m_demodBuffer.data());
 
-				if(m_audioBufferFill >= m_audioBuffer.size())
-				{
-					uint res = m_audioFifo.write((const quint8*)&m_audioBuffer[0], m_audioBufferFill, 1);
+		for (int i = 0; i < nbOut; i++)
+		{
+			ci = m_demodBuffer[i];
+
+			quint16 sample = (qint16)(ci.real() * 3276.8f * m_running.m_volume);
+			m_sampleBuffer.push_back(Sample(sample, sample));
+			m_audioBuffer[m_audioBufferFill].l = sample;
+			m_audioBuffer[m_audioBufferFill].r = sample;
+			++m_audioBufferFill;
 
-					if(res != m_audioBufferFill)
-					{
-						qDebug("WFMDemod::feed: %u/%u audio samples written", res, m_audioBufferFill);
-					}
+			if(m_audioBufferFill >= m_audioBuffer.size())
+			{
+				uint res = m_audioFifo.write((const quint8*)&m_audioBuffer[0], m_audioBufferFill, 1);
 
-					m_audioBufferFill = 0;
+				if(res != m_audioBufferFill)
+				{
+					qDebug("WFMDemod::feed: %u/%u audio samples written", res, m_audioBufferFill);
 				}
 
-				m_interpolatorDistanceRemain += m_interpolatorDistance;
+				m_audioBufferFill = 0;
 			}
 		}
 	}
@@ -138,6 +138,9 @@ private:
 	Real m_interpolatorDistance;
 	Real m_interpolatorDistanceRemain;
 	fftfilt* m_rfFilter;
+	std::vector<fftfilt::cmplx> m_rfFilterIn;  //!< NCO mixed input block
+	std::vector<fftfilt::cmplx> m_rfFilterOut; //!< filtered output block
+	std::vector<Complex> m_demodBuffer; //!< demodulated block then decimated in place
 
 	Real m_squelchLevel;
 	int m_squelchState;
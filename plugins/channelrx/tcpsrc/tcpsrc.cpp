@@ -88,10 +88,11 @@ void TCPSrc::feed(const SampleVector::const_iterator& begin, const SampleVector:
 	//int rescale = 32768 * (1 << m_boost);
 	int rescale = (1 << m_boost);
 
-	for(SampleVector::const_iterator it = begin; it < end; ++it) {
-		//Complex c(it->real() / 32768.0f, it->imag() / 32768.0f);
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+	m_nco.mixIQ(begin, end, m_mixBuffer);
+	std::vector<Complex>::const_iterator mixed = m_mixBuffer.begin();
+
+	for(SampleVector::const_iterator it = begin; it < end; ++it, ++mixed) {
+		Complex c = *mixed;
 
 		if(m_interpolator.decimate(&m_sampleDistanceRemain, c, &ci))
 		{
@@ -40,8 +40,12 @@ UDPSrc::UDPSrc(MessageQueue* uiMessageQueue, UDPSrcGUI* udpSrcGUI, BasebandSampl
 {
 	setObjectName("UDPSrc");
 
-	m_udpBuffer = new UDPSink<Sample>(this, udpBLockSampleSize, m_udpPort);
-	m_udpBufferMono = new UDPSink<FixReal>(this, udpBLockSampleSize, m_udpPort);
+	m_udpAddressStr = "127.0.0.1";
+	m_udpSender = new UDPSender(udpBLockSampleSize * sizeof(Sample));
+	m_udpSender->setDestinations(m_udpAddressStr, m_udpPort);
+	m_udpSender->startWork();
+	m_udpBuffer = new UDPSink<Sample>(m_udpSender, udpBLockSampleSize);
+	m_udpBufferMono = new UDPSink<FixReal>(m_udpSender, udpBLockSampleSize);
 	m_audioSocket = new QUdpSocket(this);
 	m_udpAudioBuf = new char[m_udpAudioPayloadSize];
 
@@ -90,6 +94,8 @@ UDPSrc::~UDPSrc()
 	delete m_audioSocket;
 	delete m_udpBuffer;
 	delete m_udpBufferMono;
+	m_udpSender->stopWork();
+	delete m_udpSender;
 	delete[] m_udpAudioBuf;
 	if (UDPFilter) delete UDPFilter;
 	if (m_audioActive) DSPEngine::instance()->removeAudioSink(&m_audioFifo);
@@ -144,10 +150,12 @@ void UDPSrc::feed(const SampleVector::const_iterator& begin, const SampleVector:
 	m_settingsMutex.lock();
 	int rescale = (1 << m_boost);
 
-	for(SampleVector::const_iterator it = begin; it < end; ++it)
+	m_nco.mixIQ(begin, end, m_mixBuffer);
+	std::vector<Complex>::const_iterator mixed = m_mixBuffer.begin();
+
+	for(SampleVector::const_iterator it = begin; it < end; ++it, ++mixed)
 	{
-		Complex c(it->real(), it->imag());
-		c *= m_nco.nextIQ();
+		Complex c = *mixed;
 
 		if(m_interpolator.decimate(&m_sampleDistanceRemain, c, &ci))
 		{
@@ -330,18 +338,14 @@ bool UDPSrc::handleMessage(const Message& cmd)
 		m_outputSampleRate = cfg.getOutputSampleRate();
 		m_rfBandwidth = cfg.getRFBandwidth();
 
-		if (cfg.getUDPAddress() != m_udpAddressStr)
+		if ((cfg.getUDPAddress() != m_udpAddressStr) || (cfg.getUDPPort() != m_udpPort))
 		{
 			m_udpAddressStr = cfg.getUDPAddress();
-			m_udpBuffer->setAddress(m_udpAddressStr);
-			m_udpBufferMono->setAddress(m_udpAddressStr);
-		}
-
-		if (cfg.getUDPPort() != m_udpPort)
-		{
 			m_udpPort = cfg.getUDPPort();
-			m_udpBuffer->setPort(m_udpPort);
-			m_udpBufferMono->setPort(m_udpPort);
+
+			if (m_udpSender->setDestinations(m_udpAddressStr, m_udpPort) == 0) {
+				qWarning("UDPSrc::handleMessage: no valid destination in %s", qPrintable(m_udpAddressStr));
+			}
 		}
 
 		if (cfg.getAudioPort() != m_audioPort)
@@ -25,6 +25,7 @@
 #include "dsp/fftfilt.h"
 #include "dsp/interpolator.h"
 #include "dsp/phasediscri.h"
+#include "util/udpsender.h"
 #include "util/udpsink.h"
 #include "util/message.h"
 #include "audio/audiofifo.h"
@@ -74,6 +75,8 @@ public:
 			int volume);
 	void setSpectrum(MessageQueue* messageQueue, bool enabled);
 	Real getMagSq() const { return m_magsq; }
+	quint32 getUDPSentCount() const { return m_udpSender->getSentCount(); }       //!< datagrams sent summed over destinations
+	quint32 getUDPDroppedCount() const { return m_udpSender->getDroppedCount(); } //!< datagrams lost on a full send queue or a send error
 
 	virtual void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly);
 	virtual void start();
@@ -227,11 +230,13 @@ protected:
 	Complex m_last, m_this;
 
 	NCO m_nco;
+	std::vector<Complex> m_mixBuffer; //!< input block mixed down by the NCO
 	Interpolator m_interpolator;
 	Real m_sampleDistanceRemain;
 	fftfilt* UDPFilter;
 
 	SampleVector m_sampleBuffer;
+	UDPSender *m_udpSender;             //!< sends the datagrams of both buffers to all destinations
 	UDPSink<Sample> *m_udpBuffer;
 	UDPSink<FixReal> *m_udpBufferMono;
 
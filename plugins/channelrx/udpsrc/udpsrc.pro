@@ -24,10 +24,12 @@ CONFIG(Debug):build_subdir = debug
 
 SOURCES += udpsrc.cpp\
     udpsrcgui.cpp\
+    udpsrcheadless.cpp\
     udpsrcplugin.cpp
 
 HEADERS += udpsrc.h\
     udpsrcgui.h\
+    udpsrcheadless.h\
     udpsrcplugin.h
 
 FORMS += udpsrcgui.ui
@@ -218,6 +218,18 @@ void UDPSrcGUI::tick()
 	Real powDb = CalcDb::dbPower(m_udpSrc->getMagSq());
 	m_channelPowerDbAvg.feed(powDb);
 	ui->channelPower->setText(QString::number(m_channelPowerDbAvg.average(), 'f', 1));
+
+	if (++m_tickCount == 20) // once per second with the 50 ms master timer
+	{
+		quint32 udpSentCount = m_udpSrc->getUDPSentCount();
+		quint32 udpDroppedCount = m_udpSrc->getUDPDroppedCount();
+		ui->udpStats->setText(QString("%1/%2 p/s")
+			.arg(udpSentCount - m_udpSentCount)
+			.arg(udpDroppedCount - m_udpDroppedCount));
+		m_udpSentCount = udpSentCount;
+		m_udpDroppedCount = udpDroppedCount;
+		m_tickCount = 0;
+	}
 }
 
 UDPSrcGUI::UDPSrcGUI(PluginAPI* pluginAPI, DeviceSourceAPI *deviceAPI, QWidget* parent) :
@@ -228,6 +240,9 @@ UDPSrcGUI::UDPSrcGUI(PluginAPI* pluginAPI, DeviceSourceAPI *deviceAPI, QWidget*
 	m_udpSrc(0),
 	m_channelMarker(this),
 	m_channelPowerDbAvg(40,0),
+	m_tickCount(0),
+	m_udpSentCount(0),
+	m_udpDroppedCount(0),
 	m_basicSettingsShown(false),
 	m_doApplySettings(true),
 	m_boost(1),
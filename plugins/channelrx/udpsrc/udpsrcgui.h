@@ -84,6 +84,9 @@ private:
 	UDPSrc* m_udpSrc;
 	ChannelMarker m_channelMarker;
 	MovingAverage<double> m_channelPowerDbAvg;
+	int m_tickCount;
+	quint32 m_udpSentCount;    //!< sender counters at the last rate update
+	quint32 m_udpDroppedCount;
 
 	// settings
 	UDPSrc::SampleFormat m_sampleFormat;
@@ -0,0 +1,208 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "../../channelrx/udpsrc/udpsrcheadless.h"
+
+#include <device/devicesourceapi.h>
+#include "dsp/downchannelizer.h"
+#include "dsp/threadedbasebandsamplesink.h"
+#include "util/simpleserializer.h"
+
+UDPSrcHeadless* UDPSrcHeadless::create(DeviceSourceAPI *deviceAPI)
+{
+	UDPSrcHeadless* headless = new UDPSrcHeadless(deviceAPI);
+	return headless;
+}
+
+void UDPSrcHeadless::destroy()
+{
+	delete this;
+}
+
+void UDPSrcHeadless::setName(const QString& name)
+{
+	m_name = name;
+}
+
+QString UDPSrcHeadless::getName() const
+{
+	return m_name;
+}
+
+qint64 UDPSrcHeadless::getCenterFrequency() const
+{
+	return m_centerFrequency;
+}
+
+void UDPSrcHeadless::setCenterFrequency(qint64 centerFrequency)
+{
+	m_centerFrequency = centerFrequency;
+	applySettings();
+}
+
+void UDPSrcHeadless::resetToDefaults()
+{
+	m_sampleFormat = UDPSrc::FormatS16LE;
+	m_outputSampleRate = 48000;
+	m_rfBandwidth = 32000;
+	m_fmDeviation = 2500;
+	m_udpAddress = "127.0.0.1";
+	m_udpPort = 9999;
+	m_audioPort = 9999;
+	m_boost = 1;
+	m_volume = 20;
+	m_audioActive = false;
+	m_audioStereo = false;
+	m_spectrumSettings.clear();
+
+	applySettingsImmediate();
+	applySettings();
+}
+
+QByteArray UDPSrcHeadless::serialize() const
+{
+	SimpleSerializer s(1);
+	s.writeBlob(1, QByteArray()); // no rollup state
+	s.writeS32(2, m_centerFrequency);
+	s.writeS32(3, m_sampleFormat);
+	s.writeReal(4, m_outputSampleRate);
+	s.writeReal(5, m_rfBandwidth);
+	s.writeS32(6, m_udpPort);
+	s.writeBlob(7, m_spectrumSettings);
+	s.writeS32(8, (qint32)m_boost);
+	s.writeS32(9, m_centerFrequency);
+	s.writeString(10, m_udpAddress);
+	s.writeBool(11, m_audioActive);
+	s.writeS32(12, (qint32)m_volume);
+	s.writeS32(13, m_audioPort);
+	s.writeBool(14, m_audioStereo);
+	s.writeS32(15, m_fmDeviation);
+	return s.final();
+}
+
+bool UDPSrcHeadless::deserialize(const QByteArray& data)
+{
+	SimpleDeserializer d(data);
+
+	if (!d.isValid())
+	{
+		resetToDefaults();
+		return false;
+	}
+
+	if (d.getVersion() == 1)
+	{
+		qint32 s32tmp;
+
+		d.readS32(3, &s32tmp, UDPSrc::FormatS16LE);
+
+		if ((s32tmp < (qint32) UDPSrc::FormatS16LE) || (s32tmp >= (qint32) UDPSrc::FormatNone)) {
+			m_sampleFormat = UDPSrc::FormatS16LE;
+		} else {
+			m_sampleFormat = (UDPSrc::SampleFormat) s32tmp;
+		}
+
+		d.readReal(4, &m_outputSampleRate, 48000);
+		d.readReal(5, &m_rfBandwidth, 32000);
+		d.readS32(6, &m_udpPort, 9999);
+		d.readBlob(7, &m_spectrumSettings);
+		d.readS32(8, &m_boost, 1);
+		d.readS32(9, &m_centerFrequency, 0);
+		d.readString(10, &m_udpAddress, "127.0.0.1");
+		d.readBool(11, &m_audioActive, false);
+		d.readS32(12, &m_volume, 20);
+		d.readS32(13, &m_audioPort, 9998);
+		d.readBool(14, &m_audioStereo, false);
+		d.readS32(15, &m_fmDeviation, 2500);
+
+		applySettingsImmediate();
+		applySettings();
+		return true;
+	}
+	else
+	{
+		resetToDefaults();
+		return false;
+	}
+}
+
+UDPSrcHeadless::UDPSrcHeadless(DeviceSourceAPI *deviceAPI) :
+	m_deviceAPI(deviceAPI),
+	m_udpSrc(0),
+	m_centerFrequency(0)
+{
+	m_udpSrc = new UDPSrc(0, 0, 0); // no GUI message queue, GUI nor spectrum
+	m_channelizer = new DownChannelizer(m_udpSrc);
+	m_threadedChannelizer = new ThreadedBasebandSampleSink(m_channelizer, 0);
+	m_deviceAPI->addThreadedSink(m_threadedChannelizer);
+
+	resetToDefaults();
+}
+
+UDPSrcHeadless::~UDPSrcHeadless()
+{
+	m_deviceAPI->removeThreadedSink(m_threadedChannelizer);
+	delete m_threadedChannelizer;
+	delete m_channelizer;
+	delete m_udpSrc;
+}
+
+void UDPSrcHeadless::applySettingsImmediate()
+{
+	m_udpSrc->configureImmediate(m_udpSrc->getInputMessageQueue(),
+		m_audioActive,
+		m_audioStereo,
+		m_boost,
+		m_volume);
+}
+
+void UDPSrcHeadless::applySettings()
+{
+	// same sanity checks as the GUI
+	if (m_outputSampleRate < 1000) {
+		m_outputSampleRate = 48000;
+	}
+
+	if (m_rfBandwidth > m_outputSampleRate) {
+		m_rfBandwidth = m_outputSampleRate;
+	}
+
+	if ((m_udpPort < 1024) || (m_udpPort > 65535)) {
+		m_udpPort = 9999;
+	}
+
+	if ((m_audioPort < 1) || (m_audioPort > 65535) || (m_audioPort == m_udpPort)) {
+		m_audioPort = m_udpPort - 1;
+	}
+
+	if (m_fmDeviation < 1) {
+		m_fmDeviation = 2500;
+	}
+
+	m_channelizer->configure(m_channelizer->getInputMessageQueue(),
+		m_outputSampleRate,
+		m_centerFrequency);
+
+	m_udpSrc->configure(m_udpSrc->getInputMessageQueue(),
+		m_sampleFormat,
+		m_outputSampleRate,
+		m_rfBandwidth,
+		m_fmDeviation,
+		m_udpAddress,
+		m_udpPort,
+		m_audioPort);
+}
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_UDPSRCHEADLESS_H
+#define INCLUDE_UDPSRCHEADLESS_H
+
+#include "plugin/pluginheadless.h"
+
+#include "../../channelrx/udpsrc/udpsrc.h"
+
+class DeviceSourceAPI;
+class ThreadedBasebandSampleSink;
+class DownChannelizer;
+
+/**
+ * UDP channel source without GUI. Reads and writes the UDPSrcGUI serialized settings.
+ */
+class UDPSrcHeadless : public PluginHeadless {
+public:
+	static UDPSrcHeadless* create(DeviceSourceAPI *deviceAPI);
+	void destroy();
+
+	void setName(const QString& name);
+	QString getName() const;
+	virtual qint64 getCenterFrequency() const;
+	virtual void setCenterFrequency(qint64 centerFrequency);
+
+	void resetToDefaults();
+	QByteArray serialize() const;
+	bool deserialize(const QByteArray& data);
+
+private:
+	DeviceSourceAPI* m_deviceAPI;
+	ThreadedBasebandSampleSink* m_threadedChannelizer;
+	DownChannelizer* m_channelizer;
+	UDPSrc* m_udpSrc;
+	QString m_name;
+
+	// settings
+	int m_centerFrequency;
+	UDPSrc::SampleFormat m_sampleFormat;
+	Real m_outputSampleRate;
+	Real m_rfBandwidth;
+	int m_fmDeviation;
+	QString m_udpAddress;
+	int m_udpPort;
+	int m_audioPort;
+	bool m_audioActive;
+	bool m_audioStereo;
+	int m_boost;
+	int m_volume;
+	QByteArray m_spectrumSettings; //!< GUI spectrum settings kept as is for serialization
+
+	explicit UDPSrcHeadless(DeviceSourceAPI *deviceAPI);
+	virtual ~UDPSrcHeadless();
+
+	void applySettingsImmediate();
+	void applySettings();
+};
+
+#endif // INCLUDE_UDPSRCHEADLESS_H
@@ -21,6 +21,7 @@
 #include "plugin/pluginapi.h"
 
 #include "../../channelrx/udpsrc/udpsrcgui.h"
+#include "../../channelrx/udpsrc/udpsrcheadless.h"
 
 const PluginDescriptor UDPSrcPlugin::m_pluginDescriptor = {
 	QString("UDP Channel Source"),
@@ -63,6 +64,16 @@ PluginGUI* UDPSrcPlugin::createRxChannel(const QString& channelName, DeviceSourc
 	}
 }
 
+PluginHeadless* UDPSrcPlugin::createRxChannelHeadless(const QString& channelName, DeviceSourceAPI *deviceAPI)
+{
+	if(channelName == UDPSrcGUI::m_channelID)
+	{
+		return UDPSrcHeadless::create(deviceAPI);
+	} else {
+		return 0;
+	}
+}
+
 void UDPSrcPlugin::createInstanceUDPSrc(DeviceSourceAPI *deviceAPI)
 {
 	UDPSrcGUI* gui = UDPSrcGUI::create(m_pluginAPI, deviceAPI);
@@ -35,6 +35,7 @@ public:
 	void initPlugin(PluginAPI* pluginAPI);
 
 	PluginGUI* createRxChannel(const QString& channelName, DeviceSourceAPI *deviceAPI);
+	PluginHeadless* createRxChannelHeadless(const QString& channelName, DeviceSourceAPI *deviceAPI);
 
 private:
 	static const PluginDescriptor m_pluginDescriptor;
@@ -20,6 +20,7 @@
 #include <QDebug>
 #include <QMutexLocker>
 #include <stdio.h>
+#include <algorithm>
 #include <complex.h>
 #include <dsp/upchannelizer.h>
 #include "dsp/dspengine.h"
@@ -102,10 +103,32 @@ void AMMod::pull(Sample& sample)
 		return;
 	}
 
-	Complex ci;
+	m_settingsMutex.lock();
+	pullOne(sample);
+	m_settingsMutex.unlock();
+}
+
+void AMMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+	if (m_running.m_channelMute)
+	{
+		std::fill(begin, begin + nbSamples, Sample(0, 0));
+		return;
+	}
 
 	m_settingsMutex.lock();
 
+	for (unsigned int i = 0; i < nbSamples; i++, ++begin) {
+		pullOne(*begin);
+	}
+
+	m_settingsMutex.unlock();
+}
+
+void AMMod::pullOne(Sample& sample)
+{
+	Complex ci;
+
     if (m_interpolatorDistance > 1.0f) // decimate
     {
     	modulateSample();
@@ -127,8 +150,6 @@ void AMMod::pull(Sample& sample)
 
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
 
-    m_settingsMutex.unlock();
-
     Real magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
 	magsq /= (1<<30);
 	m_movingAverage.feed(magsq);
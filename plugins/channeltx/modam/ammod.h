@@ -185,6 +185,7 @@ public:
             bool playLoop);
 
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual void pullAudio(int nbSamples);
     virtual void start();
     virtual void stop();
@@ -318,6 +319,7 @@ private:
     static const int m_levelNbSamples;
 
     void apply();
+    void pullOne(Sample& sample); //!< pull one sample with the settings mutex already locked
     void pullAF(Real& sample);
     void calculateLevel(Real& sample);
     void modulateSample();
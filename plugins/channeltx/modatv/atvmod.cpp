@@ -16,6 +16,7 @@
 
 #include <QDebug>
 #include <time.h>
+#include <algorithm>
 
 #include "opencv2/imgproc/imgproc.hpp"
 
@@ -150,9 +151,31 @@ void ATVMod::pull(Sample& sample)
 		return;
 	}
 
-    Complex ci;
+	m_settingsMutex.lock();
+	pullOne(sample);
+	m_settingsMutex.unlock();
+}
+
+void ATVMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+	if (m_running.m_channelMute)
+	{
+		std::fill(begin, begin + nbSamples, Sample(0, 0));
+		return;
+	}
 
-    m_settingsMutex.lock();
+	m_settingsMutex.lock();
+
+	for (unsigned int i = 0; i < nbSamples; i++, ++begin) {
+		pullOne(*begin);
+	}
+
+	m_settingsMutex.unlock();
+}
+
+void ATVMod::pullOne(Sample& sample)
+{
+    Complex ci;
 
     if ((m_tvSampleRate == m_running.m_outputSampleRate) && (!m_running.m_forceDecimator)) // no interpolation nor decimation
     {
@@ -187,8 +210,6 @@ void ATVMod::pullFinalize(Complex& ci, Sample& sample)
 {
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
 
-    m_settingsMutex.unlock();
-
     Real magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
     magsq /= (1<<30);
     m_movingAverage.feed(magsq);
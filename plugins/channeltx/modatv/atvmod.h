@@ -397,6 +397,7 @@ public:
             bool forceDecimator);
 
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual void pullAudio(int nbSamples); // this is used for video signal actually
     virtual void start();
     virtual void stop();
@@ -702,6 +703,7 @@ private:
     static const int m_cameraFPSTestNbFrames; //!< number of frames for camera FPS test
 
     void apply(bool force = false);
+    void pullOne(Sample& sample); //!< pull one sample with the settings mutex already locked
     void pullFinalize(Complex& ci, Sample& sample);
     void pullVideo(Real& sample);
     void calculateLevel(Real& sample);
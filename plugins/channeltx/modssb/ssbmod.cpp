@@ -147,10 +147,26 @@ void SSBMod::configure(MessageQueue* messageQueue,
 
 void SSBMod::pull(Sample& sample)
 {
-	Complex ci;
+	m_settingsMutex.lock();
+	pullOne(sample);
+	m_settingsMutex.unlock();
+}
 
+void SSBMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
 	m_settingsMutex.lock();
 
+	for (unsigned int i = 0; i < nbSamples; i++, ++begin) {
+		pullOne(*begin);
+	}
+
+	m_settingsMutex.unlock();
+}
+
+void SSBMod::pullOne(Sample& sample)
+{
+	Complex ci;
+
     if (m_interpolatorDistance > 1.0f) // decimate
     {
     	modulateSample();
@@ -173,8 +189,6 @@ void SSBMod::pull(Sample& sample)
     ci *= m_carrierNco.nextIQ(); // shift to carrier frequency
     ci *= 29204.0f; //scaling at -1 dB to account for possible filter overshoot
 
-    m_settingsMutex.unlock();
-
     Real magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
 	magsq /= (1<<30);
 	m_movingAverage.feed(magsq);
@@ -371,13 +385,16 @@ void SSBMod::pullAF(Complex& sample)
 
     if ((m_afInput == SSBModInputFile) || (m_afInput == SSBModInputAudio)) // real audio
     {
+    	// the filter is run once per block of its output size so the delay is the same as feeding it sample by sample
+    	m_filterInput.push_back(ci);
+
     	if (m_running.m_dsb)
     	{
-    		n_out = m_DSBFilter->runDSB(ci, &filtered);
-
-    		if (n_out > 0)
+    		if (m_filterInput.size() == (unsigned int) m_ssbFftLen)
     		{
-    			memcpy((void *) m_DSBFilterBuffer, (const void *) filtered, n_out*sizeof(Complex));
+    			filtered = m_DSBFilterBuffer;
+    			n_out = m_DSBFilter->runDSB(m_filterInput.data(), m_filterInput.size(), filtered);
+    			m_filterInput.clear();
     			m_DSBFilterBufferIndex = 0;
     		}
 
@@ -386,11 +403,11 @@ void SSBMod::pullAF(Complex& sample)
     	}
     	else
     	{
-    		n_out = m_SSBFilter->runSSB(ci, &filtered, m_running.m_usb);
-
-    		if (n_out > 0)
+    		if (m_filterInput.size() == (unsigned int) (m_ssbFftLen>>1))
     		{
-    			memcpy((void *) m_SSBFilterBuffer, (const void *) filtered, n_out*sizeof(Complex));
+    			filtered = m_SSBFilterBuffer;
+    			n_out = m_SSBFilter->runSSB(m_filterInput.data(), m_filterInput.size(), filtered, m_running.m_usb);
+    			m_filterInput.clear();
     			m_SSBFilterBufferIndex = 0;
     		}
 
@@ -693,6 +710,8 @@ void SSBMod::apply()
 
 	if (m_config.m_dsb != m_running.m_dsb)
 	{
+		m_settingsMutex.lock();
+
 		if (m_config.m_dsb)
 		{
 			memset(m_DSBFilterBuffer, 0, sizeof(Complex)*(m_ssbFftLen));
@@ -703,6 +722,9 @@ void SSBMod::apply()
 			memset(m_SSBFilterBuffer, 0, sizeof(Complex)*(m_ssbFftLen>>1));
 			m_SSBFilterBufferIndex = 0;
 		}
+
+		m_filterInput.clear(); // the block sizes of the two filters differ
+		m_settingsMutex.unlock();
 	}
 
 	m_running.m_outputSampleRate = m_config.m_outputSampleRate;
@@ -190,6 +190,7 @@ public:
             bool playLoop);
 
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual void pullAudio(int nbSamples);
     virtual void start();
     virtual void stop();
@@ -350,6 +351,7 @@ private:
 	Complex* m_DSBFilterBuffer;
 	int m_SSBFilterBufferIndex;
 	int m_DSBFilterBufferIndex;
+	std::vector<Complex> m_filterInput; //!< real audio samples waiting for a full filter block
 	static const int m_ssbFftLen;
 
 	BasebandSampleSink* m_sampleSink;
@@ -389,6 +391,7 @@ private:
     static const int m_levelNbSamples;
 
     void apply();
+    void pullOne(Sample& sample); //!< pull one sample with the settings mutex already locked
     void pullAF(Complex& sample);
     void calculateLevel(Complex& sample);
     void modulateSample();
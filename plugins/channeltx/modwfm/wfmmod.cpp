@@ -116,13 +116,35 @@ void WFMMod::pull(Sample& sample)
 		return;
 	}
 
+	m_settingsMutex.lock();
+	pullOne(sample);
+	m_settingsMutex.unlock();
+}
+
+void WFMMod::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+	if (m_running.m_channelMute)
+	{
+		std::fill(begin, begin + nbSamples, Sample(0, 0));
+		return;
+	}
+
+	m_settingsMutex.lock();
+
+	for (unsigned int i = 0; i < nbSamples; i++, ++begin) {
+		pullOne(*begin);
+	}
+
+	m_settingsMutex.unlock();
+}
+
+void WFMMod::pullOne(Sample& sample)
+{
 	Complex ci, ri;
 	Real t;
     fftfilt::cmplx *rf;
     int rf_out;
 
-	m_settingsMutex.lock();
-
 	if ((m_afInput == WFMModInputFile) || (m_afInput == WFMModInputAudio))
 	{
 	    if (m_interpolator.interpolate(&m_interpolatorDistanceRemain, m_modSample, &ri))
@@ -156,8 +178,6 @@ void WFMMod::pull(Sample& sample)
     ci = m_rfFilterBuffer[m_rfFilterBufferIndex] * m_carrierNco.nextIQ(); // shift to carrier frequency
     m_rfFilterBufferIndex++;
 
-    m_settingsMutex.unlock();
-
     Real magsq = ci.real() * ci.real() + ci.imag() * ci.imag();
 	magsq /= (1<<30);
 	m_movingAverage.feed(magsq);
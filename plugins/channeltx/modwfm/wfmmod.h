@@ -187,6 +187,7 @@ public:
             bool playLoop);
 
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual void pullAudio(int nbSamples);
     virtual void start();
     virtual void stop();
@@ -349,6 +350,7 @@ private:
     static const int m_levelNbSamples;
 
     void apply();
+    void pullOne(Sample& sample); //!< pull one sample with the settings mutex already locked
     void pullAF(Complex& sample);
     void calculateLevel(const Real& sample);
     void openFileStream();
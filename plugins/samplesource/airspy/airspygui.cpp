@@ -368,6 +368,8 @@ void AirspyGui::on_record_toggled(bool checked)
     if (checked)
     {
         ui->record->setStyleSheet("QToolButton { background-color : red; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device"));
+        m_fileSink->setCompression(m_deviceAPI->getRecordCompression());
         m_fileSink->startRecording();
     }
     else
@@ -412,6 +414,12 @@ void AirspyGui::updateStatus()
 
         m_lastEngineState = state;
     }
+
+    if (ui->record->isChecked() && (m_fileSink->getDroppedCount() > 0)) // the disk does not keep up
+    {
+        ui->record->setStyleSheet("QToolButton { background-color : magenta; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device (%1 samples dropped)").arg(m_fileSink->getDroppedCount()));
+    }
 }
 
 uint32_t AirspyGui::getDevSampleRate(unsigned int rate_index)
@@ -360,6 +360,8 @@ void BladerfInputGui::on_record_toggled(bool checked)
     if (checked)
     {
         ui->record->setStyleSheet("QToolButton { background-color : red; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device"));
+        m_fileSink->setCompression(m_deviceAPI->getRecordCompression());
         m_fileSink->startRecording();
     }
     else
@@ -404,6 +406,12 @@ void BladerfInputGui::updateStatus()
 
         m_lastEngineState = state;
     }
+
+    if (ui->record->isChecked() && (m_fileSink->getDroppedCount() > 0)) // the disk does not keep up
+    {
+        ui->record->setStyleSheet("QToolButton { background-color : magenta; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device (%1 samples dropped)").arg(m_fileSink->getDroppedCount()));
+    }
 }
 
 unsigned int BladerfInputGui::getXb200Index(bool xb_200, bladerf_xb200_path xb200Path, bladerf_xb200_filter xb200Filter)
@@ -63,11 +63,10 @@ FileSourceGui::FileSourceGui(DeviceSourceAPI *deviceAPI, QWidget* parent) :
 	displaySettings();
 
 	ui->navTimeSlider->setEnabled(false);
-	ui->playLoop->setChecked(true); // FIXME: always play in a loop
-	ui->playLoop->setEnabled(false);
 
-	m_sampleSource = new FileSourceInput(m_deviceAPI->getMainWindow()->getMasterTimer());
+	m_sampleSource = new FileSourceInput(m_deviceAPI, m_deviceAPI->getMainWindow()->getMasterTimer());
 	connect(m_sampleSource->getOutputMessageQueueToGUI(), SIGNAL(messageEnqueued()), this, SLOT(handleSourceMessages()));
+	ui->playLoop->setChecked(true);
 	m_deviceAPI->setSource(m_sampleSource);
 
     connect(m_deviceAPI->getDeviceOutputMessageQueue(), SIGNAL(messageEnqueued()), this, SLOT(handleDSPMessages()), Qt::QueuedConnection);
@@ -211,7 +210,21 @@ void FileSourceGui::sendSettings()
 
 void FileSourceGui::on_playLoop_toggled(bool checked)
 {
-	// TODO: do something about it!
+	sendPlayback();
+}
+
+void FileSourceGui::on_playbackSpeed_currentIndexChanged(int index)
+{
+	sendPlayback();
+}
+
+void FileSourceGui::sendPlayback()
+{
+	int speedIndex = ui->playbackSpeed->currentIndex();
+	int speed = speedIndex < 4 ? 1<<speedIndex : 0; // 0 is as fast as possible
+
+	FileSourceInput::MsgConfigureFileSourcePlayback* message = FileSourceInput::MsgConfigureFileSourcePlayback::create(speed, ui->playLoop->isChecked());
+	m_sampleSource->getInputMessageQueue()->push(message);
 }
 
 void FileSourceGui::on_startStop_toggled(bool checked)
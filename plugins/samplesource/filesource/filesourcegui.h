@@ -72,6 +72,7 @@ private:
 	void sendSettings();
     void updateSampleRateAndFrequency();
 	void configureFileName();
+	void sendPlayback();
 	void updateWithAcquisition();
 	void updateWithStreamData();
 	void updateWithStreamTime();
@@ -81,6 +82,7 @@ private slots:
 	void handleSourceMessages();
 	void on_startStop_toggled(bool checked);
 	void on_playLoop_toggled(bool checked);
+	void on_playbackSpeed_currentIndexChanged(int index);
 	void on_play_toggled(bool checked);
 	void on_navTimeSlider_valueChanged(int value);
 	void on_showFileDialog_clicked(bool checked);
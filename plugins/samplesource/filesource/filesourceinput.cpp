@@ -21,11 +21,10 @@
 #include "util/simpleserializer.h"
 #include "dsp/dspcommands.h"
 #include "dsp/dspengine.h"
+#include "device/devicesourceapi.h"
 #include "filesourcegui.h"
 #include "filesourceinput.h"
 
-#include <dsp/filerecord.h>
-
 #include "filesourcethread.h"
 
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSource, Message)
@@ -33,6 +32,8 @@ MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceName, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceWork, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceSeek, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceStreamTiming, Message)
+MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourceSeekSample, Message)
+MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgConfigureFileSourcePlayback, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportFileSourceAcquisition, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportFileSourceStreamData, Message)
 MESSAGE_CLASS_DEFINITION(FileSourceInput::MsgReportFileSourceStreamTiming, Message)
@@ -73,8 +74,12 @@ bool FileSourceInput::Settings::deserialize(const QByteArray& data)
 	}
 }
 
-FileSourceInput::FileSourceInput(const QTimer& masterTimer) :
+FileSourceInput::FileSourceInput(DeviceSourceAPI *deviceAPI, const QTimer& masterTimer) :
+	m_deviceAPI(deviceAPI),
 	m_settings(),
+	m_startSample(0),
+	m_playbackSpeed(1),
+	m_playbackLoop(true),
 	m_fileSourceThread(NULL),
 	m_deviceDescription(),
 	m_fileName("..."),
@@ -93,30 +98,46 @@ FileSourceInput::~FileSourceInput()
 
 void FileSourceInput::openFileStream()
 {
-	//stopInput();
+	QMutexLocker mutexLocker(&m_mutex);
 
-	if (m_ifstream.is_open()) {
-		m_ifstream.close();
+	if (m_fileSourceThread != 0) // the thread reads the mapping that is about to go
+	{
+		m_fileSourceThread->stopWork();
+		delete m_fileSourceThread;
+		m_fileSourceThread = 0;
 	}
 
-	m_ifstream.open(m_fileName.toStdString().c_str(), std::ios::binary | std::ios::ate);
-	quint64 fileSize = m_ifstream.tellg();
-	m_ifstream.seekg(0,std::ios_base::beg);
-	FileRecord::Header header;
-	FileRecord::readHeader(m_ifstream, header);
+	m_startSample = 0;
+	m_sampleRate = 0;
+	m_centerFrequency = 0;
+	m_startingTimeStamp = 0;
+	m_recordLength = 0;
 
-	m_sampleRate = header.sampleRate;
-	m_centerFrequency = header.centerFrequency;
-	m_startingTimeStamp = header.startTimeStamp;
+	if (m_reader.open(m_fileName))
+	{
+		double recordLength = 0.0;
 
-	if (fileSize > sizeof(FileRecord::Header)) {
-		m_recordLength = (fileSize - sizeof(FileRecord::Header)) / (4 * m_sampleRate);
-	} else {
-		m_recordLength = 0;
+		for (int i = 0; i < m_reader.getNbChunks(); i++)
+		{
+			const FileRecordReader::Chunk& chunk = m_reader.getChunk(i);
+
+			if (chunk.sampleRate > 0) {
+				recordLength += (double) chunk.nbSamples / chunk.sampleRate;
+			}
+		}
+
+		m_recordLength = recordLength;
+		m_startingTimeStamp = m_reader.getStartTimeStamp() / 1000;
+		setStartSample(0);
+	}
+	else
+	{
+		qCritical("FileSourceInput::openFileStream: cannot map %s: %s", qPrintable(m_fileName), qPrintable(m_reader.errorString()));
 	}
 
 	qDebug() << "FileSourceInput::openFileStream: " << m_fileName.toStdString().c_str()
-			<< " fileSize: " << fileSize << "bytes"
+			<< " samples: " << m_reader.getNbSamples()
+			<< " chunks: " << m_reader.getNbChunks()
 			<< " length: " << m_recordLength << " seconds";
 
 	MsgReportFileSourceStreamData *report = MsgReportFileSourceStreamData::create(m_sampleRate,
@@ -126,18 +147,29 @@ void FileSourceInput::openFileStream()
 	getOutputMessageQueueToGUI()->push(report);
 }
 
-void FileSourceInput::seekFileStream(int seekPercentage)
+void FileSourceInput::seekFileStream(quint64 sampleIndex)
 {
 	QMutexLocker mutexLocker(&m_mutex);
 
-	if ((m_ifstream.is_open()) && !m_fileSourceThread->isRunning())
+	if (m_fileSourceThread != 0) {
+		m_fileSourceThread->seekSample(sampleIndex);
+	} else {
+		setStartSample(sampleIndex);
+	}
+}
+
+void FileSourceInput::setStartSample(quint64 sampleIndex)
+{
+	if (m_reader.getNbChunks() == 0)
 	{
-		int seekPoint = ((m_recordLength * seekPercentage) / 100) * m_sampleRate;
-		m_fileSourceThread->setSamplesCount(seekPoint);
-		seekPoint *= 4; // + sizeof(FileSink::Header)
-		m_ifstream.clear();
-		m_ifstream.seekg(seekPoint + sizeof(FileRecord::Header), std::ios::beg);
+		m_startSample = 0;
+		return;
 	}
+
+	const FileRecordReader::Chunk& chunk = m_reader.getChunk(m_reader.findChunk(sampleIndex));
+	m_startSample = sampleIndex;
+	m_sampleRate = chunk.sampleRate;           // read by the DSP engine when acquisition starts
+	m_centerFrequency = chunk.centerFrequency;
 }
 
 bool FileSourceInput::start()
@@ -145,25 +177,27 @@ bool FileSourceInput::start()
 	QMutexLocker mutexLocker(&m_mutex);
 	qDebug() << "FileSourceInput::start";
 
-	if (m_ifstream.tellg() != 0) {
-		m_ifstream.clear();
-		m_ifstream.seekg(sizeof(FileRecord::Header), std::ios::beg);
+	if (!m_reader.isOpen())
+	{
+		qCritical("FileSourceInput::start: no record file");
+		return false;
 	}
 
-	if(!m_sampleFifo.setSize(m_sampleRate * 4)) {
+	if(!m_sampleFifo.setSize(m_reader.getMaxSampleRate() * 4)) {
 		qCritical("Could not allocate SampleFifo");
 		return false;
 	}
 
-	//openFileStream();
-
-	if((m_fileSourceThread = new FileSourceThread(&m_ifstream, &m_sampleFifo)) == NULL) {
+	if((m_fileSourceThread = new FileSourceThread(m_reader, &m_sampleFifo, m_deviceAPI->getDeviceInputMessageQueue())) == NULL) {
 		qFatal("out of memory");
 		stop();
 		return false;
 	}
 
-	m_fileSourceThread->setSamplerate(m_sampleRate);
+	m_fileSourceThread->setPlaybackSpeed(m_playbackSpeed);
+	m_fileSourceThread->setLoop(m_playbackLoop);
+	m_fileSourceThread->seekSample(m_startSample);
+	setStartSample(0); // next start from the beginning unless seeking while stopped
 	m_fileSourceThread->connectTimer(m_masterTimer);
 	m_fileSourceThread->startWork();
 	m_deviceDescription = "FileSource";
@@ -252,7 +286,29 @@ bool FileSourceInput::handleMessage(const Message& message)
 	{
 		MsgConfigureFileSourceSeek& conf = (MsgConfigureFileSourceSeek&) message;
 		int seekPercentage = conf.getPercentage();
-		seekFileStream(seekPercentage);
+		seekFileStream((m_reader.getNbSamples() * seekPercentage) / 100);
+
+		return true;
+	}
+	else if (MsgConfigureFileSourceSeekSample::match(message))
+	{
+		MsgConfigureFileSourceSeekSample& conf = (MsgConfigureFileSourceSeekSample&) message;
+		seekFileStream(conf.getSampleIndex());
+
+		return true;
+	}
+	else if (MsgConfigureFileSourcePlayback::match(message))
+	{
+		MsgConfigureFileSourcePlayback& conf = (MsgConfigureFileSourcePlayback&) message;
+		QMutexLocker mutexLocker(&m_mutex);
+		m_playbackSpeed = conf.getSpeed();
+		m_playbackLoop = conf.getLoop();
+
+		if (m_fileSourceThread != 0)
+		{
+			m_fileSourceThread->setPlaybackSpeed(m_playbackSpeed);
+			m_fileSourceThread->setLoop(m_playbackLoop);
+		}
 
 		return true;
 	}
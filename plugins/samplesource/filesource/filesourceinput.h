@@ -21,9 +21,10 @@
 #include <QString>
 #include <QTimer>
 #include <ctime>
-#include <iostream>
-#include <fstream>
 
+#include "dsp/filerecordreader.h"
+
+class DeviceSourceAPI;
 class FileSourceThread;
 
 class FileSourceInput : public DeviceSampleSource {
@@ -134,6 +135,49 @@ public:
 		{ }
 	};
 
+	class MsgConfigureFileSourceSeekSample : public Message {
+		MESSAGE_CLASS_DECLARATION
+
+	public:
+		quint64 getSampleIndex() const { return m_sampleIndex; }
+
+		static MsgConfigureFileSourceSeekSample* create(quint64 sampleIndex)
+		{
+			return new MsgConfigureFileSourceSeekSample(sampleIndex);
+		}
+
+	protected:
+		quint64 m_sampleIndex; //!< index of the next I/Q sample to play from the beginning of the record
+
+		MsgConfigureFileSourceSeekSample(quint64 sampleIndex) :
+			Message(),
+			m_sampleIndex(sampleIndex)
+		{ }
+	};
+
+	class MsgConfigureFileSourcePlayback : public Message {
+		MESSAGE_CLASS_DECLARATION
+
+	public:
+		int getSpeed() const { return m_speed; }
+		bool getLoop() const { return m_loop; }
+
+		static MsgConfigureFileSourcePlayback* create(int speed, bool loop)
+		{
+			return new MsgConfigureFileSourcePlayback(speed, loop);
+		}
+
+	protected:
+		int m_speed;  //!< multiple of the record sample rate. 0 to play as fast as the DSP engine can process
+		bool m_loop;  //!< restart at the beginning at end of record
+
+		MsgConfigureFileSourcePlayback(int speed, bool loop) :
+			Message(),
+			m_speed(speed),
+			m_loop(loop)
+		{ }
+	};
+
 	class MsgReportFileSourceAcquisition : public Message {
 		MESSAGE_CLASS_DECLARATION
 
@@ -209,7 +253,7 @@ public:
 		{ }
 	};
 
-	FileSourceInput(const QTimer& masterTimer);
+	FileSourceInput(DeviceSourceAPI *deviceAPI, const QTimer& masterTimer);
 	virtual ~FileSourceInput();
 
 	virtual bool start();
@@ -223,20 +267,25 @@ public:
 	virtual bool handleMessage(const Message& message);
 
 private:
+	DeviceSourceAPI *m_deviceAPI;
 	QMutex m_mutex;
 	Settings m_settings;
-	std::ifstream m_ifstream;
+	FileRecordReader m_reader;
+	quint64 m_startSample;    //!< sample to start from when playback is not running
+	int m_playbackSpeed;
+	bool m_playbackLoop;
 	FileSourceThread* m_fileSourceThread;
 	QString m_deviceDescription;
 	QString m_fileName;
-	int m_sampleRate;
-	quint64 m_centerFrequency;
+	int m_sampleRate;         //!< sample rate at the start sample
+	quint64 m_centerFrequency; //!< center frequency at the start sample
 	quint32 m_recordLength; //!< record length in seconds computed from file size
 	std::time_t m_startingTimeStamp;
 	const QTimer& m_masterTimer;
 
 	void openFileStream();
-	void seekFileStream(int seekPercentage);
+	void seekFileStream(quint64 sampleIndex);
+	void setStartSample(quint64 sampleIndex);
 };
 
 #endif // INCLUDE_FILESOURCEINPUT_H
@@ -19,24 +19,29 @@
 #include <assert.h>
 #include <QDebug>
 
-#include "dsp/filerecord.h"
 #include "filesourcethread.h"
 #include "dsp/samplesinkfifo.h"
+#include "dsp/filerecordreader.h"
+#include "dsp/dspcommands.h"
+#include "util/messagequeue.h"
 
-FileSourceThread::FileSourceThread(std::ifstream *samplesStream, SampleSinkFifo* sampleFifo, QObject* parent) :
+FileSourceThread::FileSourceThread(FileRecordReader& reader, SampleSinkFifo* sampleFifo, MessageQueue *notificationQueue, QObject* parent) :
 	QThread(parent),
 	m_running(false),
-	m_ifstream(samplesStream),
-	m_buf(0),
-	m_bufsize(0),
-	m_chunksize(0),
+	m_reader(reader),
 	m_sampleFifo(sampleFifo),
+	m_notificationQueue(notificationQueue),
 	m_samplesCount(0),
-    m_samplerate(0),
-    m_throttlems(FILESOURCE_THROTTLE_MS),
-    m_throttleToggle(false)
+	m_loop(true),
+	m_endOfRecord(false),
+	m_chunkIndex(0),
+	m_samplerate(0),
+	m_centerFrequency(0),
+	m_speed(1),
+	m_sampleTimeRemainder(0)
 {
-    assert(m_ifstream != 0);
+	assert(m_reader.getNbChunks() > 0);
+	selectChunk(false);
 }
 
 FileSourceThread::~FileSourceThread()
@@ -44,30 +49,18 @@ FileSourceThread::~FileSourceThread()
 	if (m_running) {
 		stopWork();
 	}
-
-	if (m_buf != 0) {
-		free(m_buf);
-	}
 }
 
 void FileSourceThread::startWork()
 {
 	qDebug() << "FileSourceThread::startWork: ";
 
-    if (m_ifstream->is_open())
-    {
-        qDebug() << "FileSourceThread::startWork: file stream open, starting...";
-        m_startWaitMutex.lock();
-        m_elapsedTimer.start();
-        start();
-        while(!m_running)
-            m_startWaiter.wait(&m_startWaitMutex, 100);
-        m_startWaitMutex.unlock();
-    }
-    else
-    {
-        qDebug() << "FileSourceThread::startWork: file stream closed, not starting.";
-    }
+	m_startWaitMutex.lock();
+	m_elapsedTimer.start();
+	start();
+	while(!m_running)
+		m_startWaiter.wait(&m_startWaitMutex, 100);
+	m_startWaitMutex.unlock();
 }
 
 void FileSourceThread::stopWork()
@@ -77,62 +70,53 @@ void FileSourceThread::stopWork()
 	wait();
 }
 
-void FileSourceThread::setSamplerate(int samplerate)
+void FileSourceThread::setPlaybackSpeed(int speed)
 {
-	qDebug() << "FileSourceThread::setSamplerate:"
-			<< " new:" << samplerate
-			<< " old:" << m_samplerate;
-
-	if (samplerate != m_samplerate)
-	{
-		if (m_running) {
-			stopWork();
-		}
+	qDebug() << "FileSourceThread::setPlaybackSpeed: " << speed;
+	m_speed = speed < 0 ? 1 : speed;
+}
 
-		m_samplerate = samplerate;
-        // TODO: implement FF and slow motion here. 4 corresponds to live. 2 is half speed, 8 is doulbe speed
-        m_chunksize = (m_samplerate * 4 * m_throttlems) / 1000;
+void FileSourceThread::setLoop(bool loop)
+{
+	QMutexLocker locker(&m_feedMutex);
+	m_loop = loop;
 
-        setBuffer(m_chunksize);
+	if (m_loop && m_endOfRecord)
+	{
+		m_samplesCount = 0;
+		m_endOfRecord = false;
 	}
-
-	//m_samplerate = samplerate;
 }
 
-void FileSourceThread::setBuffer(std::size_t chunksize)
+void FileSourceThread::seekSample(quint64 sampleIndex)
 {
-    if (chunksize > m_bufsize)
-    {
-        m_bufsize = chunksize;
-
-        if (m_buf == 0)
-        {
-            qDebug() << "FileSourceThread::setBuffer: Allocate buffer";
-            m_buf = (quint8*) malloc(m_bufsize);
-        }
-        else
-        {
-            qDebug() << "FileSourceThread::setBuffer: Re-allocate buffer";
-            quint8 *buf = m_buf;
-            m_buf = (quint8*) realloc((void*) m_buf, m_bufsize);
-            if (!m_buf) free(buf);
-        }
-
-        qDebug() << "FileSourceThread::setBuffer: size: " << m_bufsize
-                << " #samples: " << (m_bufsize/4);
-    }
+	QMutexLocker locker(&m_feedMutex);
+	m_samplesCount = sampleIndex < m_reader.getNbSamples() ? sampleIndex : m_reader.getNbSamples();
+	m_endOfRecord = false;
+	selectChunk(m_running);
 }
 
 void FileSourceThread::run()
 {
-	int res;
-
 	m_running = true;
 	m_startWaiter.wakeAll();
 
-	while(m_running) // actual work is in the tick() function
+	while(m_running)
 	{
-		sleep(1);
+		if ((m_speed == 0) && !m_endOfRecord && (m_samplerate > 0))
+		{
+			uint space = m_sampleFifo->size() - m_sampleFifo->fill();
+
+			if (space >= m_sampleFifo->size() / 8) {
+				feed(space);
+			} else {
+				usleep(1000); // wait for the DSP engine to drain the FIFO
+			}
+		}
+		else // throttled playback is done in the tick() function
+		{
+			msleep(FILESOURCE_THROTTLE_MS);
+		}
 	}
 
 	m_running = false;
@@ -148,33 +132,94 @@ void FileSourceThread::tick()
 {
 	if (m_running)
 	{
-        qint64 throttlems = m_elapsedTimer.restart();
-
-        if (throttlems != m_throttlems)
-        {
-            m_throttlems = throttlems;
-            m_chunksize = 4 * ((m_samplerate * (m_throttlems+(m_throttleToggle ? 1 : 0))) / 1000);
-            m_throttleToggle = !m_throttleToggle;
-            setBuffer(m_chunksize);
-        }
-
-		// read samples directly feeding the SampleFifo (no callback)
-		m_ifstream->read(reinterpret_cast<char*>(m_buf), m_chunksize);
-
-        if (m_ifstream->eof())
-        {
-            m_sampleFifo->write(m_buf, m_ifstream->gcount());
-            // TODO: handle loop playback situation
-    		m_ifstream->clear();
-            m_ifstream->seekg(sizeof(FileRecord::Header), std::ios::beg);
-    		m_samplesCount = 0;
-            //stopWork();
-            //m_ifstream->close();
-        }
-        else
-        {
-            m_sampleFifo->write(m_buf, m_chunksize);
-    		m_samplesCount += m_chunksize / 4;
-        }
+		qint64 throttlems = m_elapsedTimer.restart();
+
+		if (m_speed == 0) {
+			return;
+		}
+
+		// carry the sub-sample remainder over so that the average rate is exact
+		quint64 sampleTime = (quint64) m_speed * m_samplerate * throttlems + m_sampleTimeRemainder;
+		quint64 nbSamples = sampleTime / 1000;
+		m_sampleTimeRemainder = sampleTime % 1000;
+
+		uint space = m_sampleFifo->size() - m_sampleFifo->fill();
+
+		// above real time the DSP engine may lag: hold back rather than drop samples
+		feed(nbSamples < space ? nbSamples : space);
+	}
+}
+
+void FileSourceThread::feed(quint64 nbSamples)
+{
+	QMutexLocker locker(&m_feedMutex);
+	quint64 recordSamples = m_reader.getNbSamples();
+
+	while ((nbSamples > 0) && !m_endOfRecord && (recordSamples > 0))
+	{
+		if (m_samplesCount == recordSamples)
+		{
+			if (m_loop)
+			{
+				m_samplesCount = 0;
+			}
+			else
+			{
+				m_endOfRecord = true;
+				break;
+			}
+		}
+
+		const FileRecordReader::Chunk *chunk = &m_reader.getChunk(m_chunkIndex);
+
+		if ((m_samplesCount < chunk->firstSample) || (m_samplesCount >= chunk->firstSample + chunk->nbSamples))
+		{
+			selectChunk(true);
+			chunk = &m_reader.getChunk(m_chunkIndex);
+		}
+
+		quint64 offset = m_samplesCount - chunk->firstSample;
+		quint64 remaining = chunk->nbSamples - offset;
+		quint64 count = nbSamples < remaining ? nbSamples : remaining;
+		const quint8 *samples = m_reader.getSamples(m_chunkIndex);
+
+		if (samples == 0) // corrupt chunk: skip it
+		{
+			m_samplesCount += remaining;
+			continue;
+		}
+
+		// native samples go from the mapped file straight into the FIFO
+		uint written = m_sampleFifo->write(samples + 4*offset, 4*count);
+		m_samplesCount += written;
+		nbSamples -= count;
+
+		if (written < count) {
+			break;
+		}
+	}
+}
+
+void FileSourceThread::selectChunk(bool notify)
+{
+	m_chunkIndex = m_reader.findChunk(m_samplesCount);
+	const FileRecordReader::Chunk& chunk = m_reader.getChunk(m_chunkIndex);
+
+	if ((chunk.sampleRate == m_samplerate) && (chunk.centerFrequency == m_centerFrequency)) {
+		return;
+	}
+
+	qDebug() << "FileSourceThread::selectChunk: chunk " << m_chunkIndex
+			<< " sample rate: " << chunk.sampleRate
+			<< " center frequency: " << chunk.centerFrequency;
+
+	m_samplerate = chunk.sampleRate;
+	m_centerFrequency = chunk.centerFrequency;
+
+	// the engine is told when the chunk enters the FIFO so the change lags by the FIFO fill
+	if (notify && m_notificationQueue)
+	{
+		DSPSignalNotification *notif = new DSPSignalNotification(m_samplerate, m_centerFrequency);
+		m_notificationQueue->push(notif);
 	}
 }
@@ -13,7 +13,6 @@
 // You should have received a copy of the GNU General Public License             //
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
-
 #ifndef INCLUDE_FILESOURCETHREAD_H
 #define INCLUDE_FILESOURCETHREAD_H
 
@@ -22,53 +21,63 @@
 #include <QWaitCondition>
 #include <QTimer>
 #include <QElapsedTimer>
-#include <iostream>
-#include <fstream>
 #include <cstdlib>
 
-#include "dsp/inthalfbandfilter.h"
-
 #define FILESOURCE_THROTTLE_MS 50
 
 class SampleSinkFifo;
+class MessageQueue;
+class FileRecordReader;
 
+/**
+ * Feeds the sample FIFO straight from the memory mapped record file.
+ * At playback speeds of 1 and above the samples are written on the master timer tick
+ * at speed times the record sample rate. At speed 0 the thread writes as fast as the
+ * DSP engine drains the FIFO which is meant for batch processing of records.
+ * When playback enters a chunk recorded at another sample rate or center frequency
+ * a DSPSignalNotification is sent to the DSP engine.
+ */
 class FileSourceThread : public QThread {
 	Q_OBJECT
 
 public:
-	FileSourceThread(std::ifstream *samplesStream, SampleSinkFifo* sampleFifo, QObject* parent = NULL);
+	FileSourceThread(FileRecordReader& reader, SampleSinkFifo* sampleFifo, MessageQueue *notificationQueue, QObject* parent = NULL);
 	~FileSourceThread();
 
 	void startWork();
 	void stopWork();
-	void setSamplerate(int samplerate);
-    void setBuffer(std::size_t chunksize);
+	void setPlaybackSpeed(int speed);      //!< Multiple of the record sample rate. 0 for no throttling
+	void setLoop(bool loop);               //!< Restart from the beginning at end of record else stop feeding
+	void seekSample(quint64 sampleIndex);  //!< Next sample to be played. Can be called while running
 	bool isRunning() const { return m_running; }
+	bool isEndOfRecord() const { return m_endOfRecord; }
 	std::size_t getSamplesCount() const { return m_samplesCount; }
-	void setSamplesCount(int samplesCount) { m_samplesCount = samplesCount; }
 
 	void connectTimer(const QTimer& timer);
 
 private:
 	QMutex m_startWaitMutex;
 	QWaitCondition m_startWaiter;
-	bool m_running;
+	volatile bool m_running;
 
-	std::ifstream* m_ifstream;
-	quint8  *m_buf;
-	std::size_t m_bufsize;
-	std::size_t m_chunksize;
+	FileRecordReader& m_reader;  //!< decodes packed and compressed chunks in this thread
 	SampleSinkFifo* m_sampleFifo;
-	std::size_t m_samplesCount;
+	MessageQueue *m_notificationQueue; //!< DSP engine input queue for sample rate and center frequency changes
+	QMutex m_feedMutex;       //!< serializes FIFO writes and position changes between tick and run
+	quint64 m_samplesCount;   //!< index of the next sample to be played
+	bool m_loop;
+	bool m_endOfRecord;
+	int m_chunkIndex;         //!< chunk of the next sample to be played
 
 	int m_samplerate;
-    int m_throttlems;
-    QElapsedTimer m_elapsedTimer;
-    bool m_throttleToggle;
+	quint64 m_centerFrequency;
+	int m_speed;
+	quint64 m_sampleTimeRemainder; //!< samples times milliseconds not played yet
+	QElapsedTimer m_elapsedTimer;
 
 	void run();
-	//void decimate1(SampleVector::iterator* it, const qint16* buf, qint32 len);
-	//void callback(const qint16* buf, qint32 len);
+	void feed(quint64 nbSamples);
+	void selectChunk(bool notify);
 private slots:
 	void tick();
 };
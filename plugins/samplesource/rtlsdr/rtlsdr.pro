@@ -27,12 +27,14 @@ CONFIG(Release):build_subdir = release
 CONFIG(Debug):build_subdir = debug
 
 SOURCES += rtlsdrgui.cpp\
+  rtlsdrheadless.cpp\
   rtlsdrinput.cpp\
   rtlsdrplugin.cpp\
   rtlsdrsettings.cpp\
   rtlsdrthread.cpp
 
 HEADERS += rtlsdrgui.h\
+  rtlsdrheadless.h\
   rtlsdrinput.h\
   rtlsdrplugin.h\
   rtlsdrsettings.h\
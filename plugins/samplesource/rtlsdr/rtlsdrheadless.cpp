@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 Edouard Griffiths, F4EXB                                   //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QDebug>
+
+#include "rtlsdrheadless.h"
+
+#include <device/devicesourceapi.h>
+#include "util/messagequeue.h"
+
+RTLSDRHeadless::RTLSDRHeadless(DeviceSourceAPI *deviceAPI, QObject* parent) :
+	QObject(parent),
+	m_deviceAPI(deviceAPI),
+	m_settings(),
+	m_sampleSource(0)
+{
+	m_sampleSource = new RTLSDRInput(m_deviceAPI);
+	m_deviceAPI->setSource(m_sampleSource);
+
+	connect(m_sampleSource->getOutputMessageQueueToGUI(), SIGNAL(messageEnqueued()), this, SLOT(handleSourceMessages()));
+
+	sendSettings();
+}
+
+RTLSDRHeadless::~RTLSDRHeadless()
+{
+	delete m_sampleSource;
+}
+
+void RTLSDRHeadless::destroy()
+{
+	delete this;
+}
+
+void RTLSDRHeadless::setName(const QString& name)
+{
+	setObjectName(name);
+}
+
+QString RTLSDRHeadless::getName() const
+{
+	return objectName();
+}
+
+void RTLSDRHeadless::resetToDefaults()
+{
+	m_settings.resetToDefaults();
+	sendSettings();
+}
+
+qint64 RTLSDRHeadless::getCenterFrequency() const
+{
+	return m_settings.m_centerFrequency;
+}
+
+void RTLSDRHeadless::setCenterFrequency(qint64 centerFrequency)
+{
+	m_settings.m_centerFrequency = centerFrequency;
+	sendSettings();
+}
+
+QByteArray RTLSDRHeadless::serialize() const
+{
+	return m_settings.serialize();
+}
+
+bool RTLSDRHeadless::deserialize(const QByteArray& data)
+{
+	if(m_settings.deserialize(data))
+	{
+		sendSettings();
+		return true;
+	}
+	else
+	{
+		resetToDefaults();
+		return false;
+	}
+}
+
+void RTLSDRHeadless::sendSettings()
+{
+	RTLSDRInput::MsgConfigureRTLSDR* message = RTLSDRInput::MsgConfigureRTLSDR::create(m_settings);
+	m_sampleSource->getInputMessageQueue()->push(message);
+}
+
+void RTLSDRHeadless::handleSourceMessages()
+{
+	Message* message;
+
+	// reports meant for the GUI (gain list) are of no use here
+	while ((message = m_sampleSource->getOutputMessageQueueToGUI()->pop()) != 0)
+	{
+		qDebug("RTLSDRHeadless::handleSourceMessages: %s", message->getIdentifier());
+		delete message;
+	}
+}
@@ -0,0 +1,57 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 Edouard Griffiths, F4EXB                                   //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_RTLSDRHEADLESS_H
+#define INCLUDE_RTLSDRHEADLESS_H
+
+#include <QObject>
+#include "plugin/pluginheadless.h"
+#include "rtlsdrinput.h"
+
+class DeviceSourceAPI;
+
+/**
+ * RTL-SDR device without GUI. Settings are applied to the RTLSDRInput as soon as they change.
+ */
+class RTLSDRHeadless : public QObject, public PluginHeadless {
+	Q_OBJECT
+
+public:
+	explicit RTLSDRHeadless(DeviceSourceAPI *deviceAPI, QObject* parent = NULL);
+	virtual ~RTLSDRHeadless();
+	void destroy();
+
+	void setName(const QString& name);
+	QString getName() const;
+
+	void resetToDefaults();
+	virtual qint64 getCenterFrequency() const;
+	virtual void setCenterFrequency(qint64 centerFrequency);
+	QByteArray serialize() const;
+	bool deserialize(const QByteArray& data);
+
+private:
+	DeviceSourceAPI* m_deviceAPI;
+	RTLSDRSettings m_settings;
+	DeviceSampleSource* m_sampleSource;
+
+	void sendSettings();
+
+private slots:
+	void handleSourceMessages();
+};
+
+#endif // INCLUDE_RTLSDRHEADLESS_H
@@ -8,6 +8,7 @@
 #include <device/devicesourceapi.h>
 
 #include "rtlsdrgui.h"
+#include "rtlsdrheadless.h"
 
 const PluginDescriptor RTLSDRPlugin::m_pluginDescriptor = {
 	QString("RTL-SDR Input"),
@@ -72,3 +73,12 @@ PluginGUI* RTLSDRPlugin::createSampleSourcePluginGUI(const QString& sourceId, QW
 		return NULL;
 	}
 }
+
+PluginHeadless* RTLSDRPlugin::createSampleSourcePluginHeadless(const QString& sourceId, DeviceSourceAPI *deviceAPI)
+{
+	if(sourceId == m_deviceTypeID) {
+		return new RTLSDRHeadless(deviceAPI);
+	} else {
+		return NULL;
+	}
+}
@@ -21,6 +21,7 @@ public:
 
 	virtual SamplingDevices enumSampleSources();
 	virtual PluginGUI* createSampleSourcePluginGUI(const QString& sourceId, QWidget **widget, DeviceSourceAPI *deviceAPI);
+	virtual PluginHeadless* createSampleSourcePluginHeadless(const QString& sourceId, DeviceSourceAPI *deviceAPI);
 
 	static const QString m_hardwareID;
     static const QString m_deviceTypeID;
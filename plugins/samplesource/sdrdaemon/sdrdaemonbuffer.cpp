@@ -60,16 +60,10 @@ SDRdaemonBuffer::SDRdaemonBuffer(uint32_t throttlems) :
 	m_readSize(0),
 	m_readBuffer(0),
     m_autoFollowRate(false),
-    m_autoCorrBuffer(false),
-    m_skewTest(false),
-    m_skewCorrection(false),
     m_resetIndexes(false),
-    m_readCount(0),
-    m_writeCount(0),
-    m_nbCycles(0),
-    m_nbReads(0),
-    m_balCorrection(0),
-    m_balCorrLimit(0)
+    m_targetLatencyMs(SDRDAEMON_TARGETLATENCYMS),
+    m_targetLatencyBytes(0),
+    m_streamSampleIndex(0)
 {
 	m_currentMeta.init();
 }
@@ -105,7 +99,6 @@ void SDRdaemonBuffer::updateBufferSize(uint32_t sampleRate)
 	if (rawSize != m_rawSize)
 	{
 		m_rawSize = rawSize;
-        m_balCorrLimit = sampleRate / 50; // +/- 20 ms correction max per read
         m_bufferLenSec = m_rawSize / (sampleRate * m_iqSampleSize);
 
 		if (m_rawBuffer) {
@@ -187,20 +180,22 @@ bool SDRdaemonBuffer::readMeta(char *array, uint32_t length)
 
             if (sampleRate != m_sampleRateStream) // change of nominal stream sample rate
 			{
-				updateBufferSize(sampleRate);
 				m_sampleRateStream = sampleRate;
 				m_sampleRate = sampleRate;
+				updateBufferSize(sampleRate);
+				m_jitterControl.setSampleRate(sampleRate);
+				m_streamSampleIndex = 0;
 			}
 
-            // auto skew rate compensation
+            // auto skew rate compensation: follow the stream rate in local time
             if (m_autoFollowRate)
             {
-				if (m_skewCorrection)
-				{
-					int64_t deltaRate = (m_writeCount - m_readCount) / (m_nbCycles * m_rawBufferLengthSeconds * m_iqSampleSize);
-					m_sampleRate = ((m_sampleRate + deltaRate) / m_iqSampleSize) * m_iqSampleSize; // ensure it is a multiple of the I/Q sample size
-					resetIndexes();
-				}
+                int followedRate = (int) (sampleRate * (1.0 + m_jitterControl.getDriftPPM() * 1e-6));
+                int deltaRate = followedRate - (int) m_sampleRate;
+
+                if ((deltaRate > m_iqSampleSize) || (deltaRate < -m_iqSampleSize)) {
+                    m_sampleRate = (followedRate / m_iqSampleSize) * m_iqSampleSize; // ensure it is a multiple of the I/Q sample size
+                }
             }
             else
             {
@@ -233,8 +228,14 @@ bool SDRdaemonBuffer::readMeta(char *array, uint32_t length)
 			if (frameSize != m_frameSize) {
 				m_frameSize = frameSize;
 				updateBufferSize(m_sampleRate);
+				resetIndexes(); // target latency depends on frame size
 			}
 
+			// the previous frame is written: measure latency and follow the stream clock with the frame timestamp
+			latencyControl();
+			m_jitterControl.frameReceived(m_streamSampleIndex, metaData->m_tv_sec, metaData->m_tv_usec);
+			m_streamSampleIndex += frameSize / m_iqSampleSize;
+
 			m_sync = true;
 		}
 		else
@@ -267,46 +268,6 @@ void SDRdaemonBuffer::writeData(char *array, uint32_t length)
 
 uint8_t *SDRdaemonBuffer::readData(int32_t length)
 {
-    // auto compensation calculations
-    if (m_skewTest && ((m_readIndex + length) > (m_rawSize / 2)))
-    {
-        // auto follow sample rate calculation
-        int dIndex = (m_readIndex - m_writeIndex > 0 ? m_readIndex - m_writeIndex : m_writeIndex - m_readIndex); // absolute delta
-        m_skewCorrection = (dIndex < m_rawSize / 10); // close by 10%
-        m_nbCycles++;
-        // auto R/W balance calculation
-        if ((m_nbReads > 5*m_rawBufferLengthSeconds) && m_autoCorrBuffer)
-        {
-            int32_t dBytes;
-            int32_t dI = (m_rawSize / 2) - m_readIndex; // delta of read index to the middle of buffer (positive)
-
-            if (m_readIndex > m_writeIndex) { // write leads
-                dBytes = m_writeIndex + dI; // positive from start of buffer + delta read index
-            } else { // read leads
-                dBytes = m_writeIndex - (int32_t) m_rawSize + dI; // negative from end of buffer minus delta read index
-            }
-
-            m_balCorrection = (m_balCorrection / 4) + ((int32_t) dBytes / (int32_t) (m_nbReads * m_iqSampleSize)); // correction is in number of samples. Alpha = 0.25
-
-            if (m_balCorrection < -m_balCorrLimit) {
-                m_balCorrection = -m_balCorrLimit;
-            } else if (m_balCorrection > m_balCorrLimit) {
-                m_balCorrection = m_balCorrLimit;
-            }
-        }
-        else
-        {
-            m_balCorrection = 0;
-        }
-
-        m_nbReads = 0;
-        // un-arm
-        m_skewTest = false;
-    }
-
-    m_readCount += length;
-    m_nbReads++;
-
 	if (m_readIndex + length < m_rawSize)
 	{
 		uint32_t readIndex = m_readIndex;
@@ -317,7 +278,6 @@ uint8_t *SDRdaemonBuffer::readData(int32_t length)
 	{
 		uint32_t readIndex = m_readIndex;
 		m_readIndex = 0;
-        m_skewTest = true; // re-arm
 		return &m_rawBuffer[readIndex];
 	}
 	else
@@ -332,7 +292,6 @@ uint8_t *SDRdaemonBuffer::readData(int32_t length)
 		length -= m_rawSize - m_readIndex;
 		std::memcpy((void *) &m_readBuffer[m_rawSize - m_readIndex], (const void *) m_rawBuffer, length);
 		m_readIndex = length;
-        m_skewTest = true; // re-arm
         return m_readBuffer;
 	}
 }
@@ -414,21 +373,85 @@ void SDRdaemonBuffer::writeToRawBufferUncompressed(const char *array, uint32_t l
 		std::memcpy((void *) m_rawBuffer, (const void *) &array[m_rawSize - m_writeIndex], length);
 		m_writeIndex = length;
 	}
-
-    m_writeCount += length;
 }
 
 void SDRdaemonBuffer::resetIndexes()
 {
+    updateTargetLatency();
     m_writeIndex = 0;
-    m_readIndex = m_rawSize / 2;
-    m_readCount = 0;
-    m_writeCount = 0;
-    m_nbCycles = 0;
-    m_skewTest = false;
-    m_skewCorrection = false;
-    m_nbReads = 0;
-    m_balCorrection = 0;
+    m_readIndex = m_rawSize - m_targetLatencyBytes; // start reading at target latency
+}
+
+void SDRdaemonBuffer::setTargetLatency(int targetLatencyMs)
+{
+    m_targetLatencyMs = targetLatencyMs;
+    m_resetIndexes = true;
+}
+
+int SDRdaemonBuffer::getTargetLatencyMs() const
+{
+    if (m_sampleRateStream > 0) {
+        return (int) (((int64_t) (m_targetLatencyBytes / m_iqSampleSize) * 1000) / m_sampleRateStream);
+    } else {
+        return m_targetLatencyMs;
+    }
+}
+
+float SDRdaemonBuffer::getLatencyMs() const
+{
+    return m_sampleRateStream > 0 ? (m_jitterControl.getLatency() * 1000.0f) / m_sampleRateStream : 0.0f;
+}
+
+double SDRdaemonBuffer::getResamplingRatio() const
+{
+    // the ratio applies to the stream nominal rate while the output is at the possibly auto followed sample rate
+    if (m_sampleRate > 0) {
+        return (m_jitterControl.getRatio() * m_sampleRateStream) / m_sampleRate;
+    } else {
+        return 1.0;
+    }
+}
+
+void SDRdaemonBuffer::updateTargetLatency()
+{
+    int64_t targetLatencyBytes = (((int64_t) m_sampleRateStream * m_targetLatencyMs) / 1000) * m_iqSampleSize;
+    // the frame being received is not readable yet and reads are done by ticks
+    int64_t readNbBytes = (((int64_t) m_sampleRateStream * m_throttlemsNominal) / 1000) * m_iqSampleSize;
+    int64_t minLatencyBytes = 2 * m_frameSize + 2 * readNbBytes;
+    int64_t maxLatencyBytes = m_rawSize / 2;
+
+    if (targetLatencyBytes < minLatencyBytes) {
+        targetLatencyBytes = minLatencyBytes;
+    }
+
+    if (targetLatencyBytes > maxLatencyBytes) {
+        targetLatencyBytes = maxLatencyBytes;
+    }
+
+    m_targetLatencyBytes = (targetLatencyBytes / m_iqSampleSize) * m_iqSampleSize;
+    m_jitterControl.setTargetLatency(m_targetLatencyBytes / m_iqSampleSize);
+}
+
+void SDRdaemonBuffer::latencyControl()
+{
+    if (m_rawSize == 0) {
+        return;
+    }
+
+    int32_t latencyBytes = getLatencyBytes();
+    int32_t readNbBytes = (((int64_t) m_sampleRateStream * m_throttlemsNominal) / 1000) * m_iqSampleSize;
+
+    if ((latencyBytes < readNbBytes) || (latencyBytes > (int32_t) (m_rawSize - m_frameSize))) // reads about to overtake writes or writes overtook reads
+    {
+        qDebug() << "SDRdaemonBuffer::latencyControl: restart reading at target latency:"
+                << " latencyBytes: " << latencyBytes
+                << " m_targetLatencyBytes: " << m_targetLatencyBytes;
+        resetIndexes();
+    }
+    else
+    {
+        m_jitterControl.latencyMeasured(latencyBytes / m_iqSampleSize);
+    }
 }
 
 void SDRdaemonBuffer::updateBlockCounts(uint32_t nbBytesReceived)
@@ -21,6 +21,9 @@
 #include <cstdlib>
 
 #include "util/CRC64.h"
+#include "dsp/jitterbuffercontrol.h"
+
+#define SDRDAEMON_TARGETLATENCYMS 250 // default target latency
 
 class SDRdaemonBuffer
 {
@@ -80,11 +83,18 @@ public:
 	uint32_t getLz4SuccessfulDecodes() const { return m_nbLastLz4SuccessfulDecodes; }
 	float getBufferLengthInSecs() const { return m_bufferLenSec; }
 	void setAutoFollowRate(bool autoFollowRate) { m_autoFollowRate = autoFollowRate; }
-    void setAutoCorrBuffer(bool autoCorrBuffer) { m_autoCorrBuffer = autoCorrBuffer; }
     void setResetIndexes() { m_resetIndexes = true; }
-    int32_t getRWBalanceCorrection() const { return m_balCorrection; }
+    int getBufferNbSamples() const { return m_rawSize / m_iqSampleSize; }
+
+    // latency control
+    /** Sets the target latency. It is bounded by the frame duration and the buffer length. Restarts reading at next meta data reception */
+    void setTargetLatency(int targetLatencyMs);
+    int getTargetLatencyMs() const;                                          //!< effective target latency
+    double getResamplingRatio() const;                                       //!< input samples to read per output sample
+    float getClockDriftPPM() const { return m_jitterControl.getDriftPPM(); }
+    float getLatencyMs() const;                                              //!< smoothed latency
 
-    /** Get buffer gauge value in % of buffer size ([-50:50])
+    /** Get buffer gauge value in % of buffer size ([-50:50]) of the deviation from the target latency
      *  [-50:0] : write leads or read lags
      *  [0:50]  : read leads or write lags
      */
@@ -92,19 +102,12 @@ public:
     {
         if (m_rawSize)
         {
-            int32_t val = ((m_writeIndex - m_readIndex) * 100) / (int32_t) m_rawSize;
-
-            if (val < -50) {
-                return val + 100; // read leads (positive)
-            } else if (val < 50) {
-                return val;       // read leads (positive) or write leads (negative)
-            } else {
-                return val - 100; // write leads (negative)
-            }
+            int32_t val = (((int32_t) m_targetLatencyBytes - getLatencyBytes()) * 100) / (int32_t) m_rawSize;
+            return val < -50 ? -50 : val > 50 ? 50 : val;
         }
         else
         {
-            return -50; // default position
+            return 0; // default position
         }
     }
 
@@ -122,6 +125,14 @@ private:
 	void writeToRawBufferLZ4();
 	void writeToRawBufferUncompressed(const char *array, uint32_t length);
     void resetIndexes();
+    void updateTargetLatency();
+    void latencyControl();
+
+    inline int32_t getLatencyBytes() const //!< bytes written and not read yet
+    {
+        int32_t latencyBytes = m_writeIndex - m_readIndex;
+        return latencyBytes < 0 ? latencyBytes + (int32_t) m_rawSize : latencyBytes;
+    }
 
     static void printMeta(const QString& header, MetaData *metaData);
 
@@ -160,18 +171,12 @@ private:
 	uint8_t  *m_readBuffer;  //!< Read buffer to hold samples when looping back to beginning of raw buffer
 
     bool     m_autoFollowRate; //!< Auto follow stream sample rate else stick with meta data sample rate
-    bool     m_autoCorrBuffer; //!< Auto correct buffer read / write balance (attempt to ...)
-    bool     m_skewTest;
-    bool     m_skewCorrection; //!< Do a skew rate correction at next meta data reception
     bool     m_resetIndexes;   //!< Do a reset indexes at next meta data reception
 
-    int64_t  m_readCount;    //!< Number of bytes read for auto skew compensation
-    int64_t  m_writeCount;   //!< Number of bytes written for auto skew compensation
-    uint32_t m_nbCycles;     //!< Number of buffer cycles since start of auto skew compensation byte counting
-
-    uint32_t m_nbReads;      //!< Number of buffer reads since start of auto R/W balance correction period
-    int32_t  m_balCorrection; //!< R/W balance correction in number of samples
-    int32_t  m_balCorrLimit; //!< Correction absolute value limit in number of samples
+    int      m_targetLatencyMs;    //!< Requested latency
+    uint32_t m_targetLatencyBytes; //!< Effective target latency
+    JitterBufferControl m_jitterControl;
+    int64_t  m_streamSampleIndex;  //!< Index in the stream of the first sample of the current frame
 };
 
 
@@ -38,6 +38,7 @@
 #include "util/simpleserializer.h"
 
 #include "sdrdaemongui.h"
+#include "sdrdaemonbuffer.h"
 
 #include <device/devicesourceapi.h>
 #include <dsp/filerecord.h>
@@ -60,6 +61,9 @@ SDRdaemonGui::SDRdaemonGui(DeviceSourceAPI *deviceAPI, QWidget* parent) :
 	m_nbLz4SuccessfulDecodes(0),
 	m_bufferLengthInSecs(0.0),
     m_bufferGauge(-50),
+    m_latencyMs(0.0f),
+    m_effectiveTargetLatencyMs(0),
+    m_clockDriftPPM(0.0f),
 	m_samplesCount(0),
 	m_tickCount(0),
 	m_address("127.0.0.1"),
@@ -70,7 +74,8 @@ SDRdaemonGui::SDRdaemonGui(DeviceSourceAPI *deviceAPI, QWidget* parent) :
 	m_initSendConfiguration(false),
 	m_dcBlock(false),
 	m_iqCorrection(false),
-	m_autoFollowRate(false)
+	m_autoFollowRate(false),
+	m_targetLatencyMs(SDRDAEMON_TARGETLATENCYMS)
 {
 	m_sender = nn_socket(AF_SP, NN_PAIR);
 	assert(m_sender != -1);
@@ -136,6 +141,7 @@ void SDRdaemonGui::resetToDefaults()
 	m_dcBlock = false;
 	m_iqCorrection = false;
 	m_autoFollowRate = false;
+	m_targetLatencyMs = SDRDAEMON_TARGETLATENCYMS;
 	displaySettings();
 }
 
@@ -181,6 +187,7 @@ QByteArray SDRdaemonGui::serialize() const
 	}
 
 	s.writeString(12, ui->specificParms->text());
+	s.writeS32(13, m_targetLatencyMs);
 
 	return s.final();
 }
@@ -200,6 +207,7 @@ bool SDRdaemonGui::deserialize(const QByteArray& data)
     uint32_t confDecim;
     uint32_t confFcPos;
     QString confSpecificParms;
+    int targetLatencyMs;
 
 	if (!d.isValid())
 	{
@@ -237,6 +245,7 @@ bool SDRdaemonGui::deserialize(const QByteArray& data)
 		d.readU32(10, &confFcPos, 2);
 		d.readU32(11, &confSampleRate, 1000);
 		d.readString(12, &confSpecificParms, "");
+		d.readS32(13, &targetLatencyMs, SDRDAEMON_TARGETLATENCYMS);
 
 		if ((address != m_address) || (dataPort != m_dataPort))
 		{
@@ -259,6 +268,12 @@ bool SDRdaemonGui::deserialize(const QByteArray& data)
             configureAutoFollowPolicy();
 		}
 
+		if (targetLatencyMs != m_targetLatencyMs)
+		{
+			m_targetLatencyMs = targetLatencyMs;
+			configureLatency();
+		}
+
 		displaySettings();
 		displayConfigurationParameters(confFrequency, confDecim, confFcPos, confSampleRate, confSpecificParms);
 		m_initSendConfiguration = true;
@@ -322,6 +337,9 @@ bool SDRdaemonGui::handleMessage(const Message& message)
 		m_nbLz4SuccessfulDecodes = ((SDRdaemonInput::MsgReportSDRdaemonStreamTiming&)message).getLz4SuccessfulDecodes();
 		m_bufferLengthInSecs = ((SDRdaemonInput::MsgReportSDRdaemonStreamTiming&)message).getBufferLengthInSecs();
         m_bufferGauge = ((SDRdaemonInput::MsgReportSDRdaemonStreamTiming&)message).getBufferGauge();
+        m_latencyMs = ((SDRdaemonInput::MsgReportSDRdaemonStreamTiming&)message).getLatencyMs();
+        m_effectiveTargetLatencyMs = ((SDRdaemonInput::MsgReportSDRdaemonStreamTiming&)message).getTargetLatencyMs();
+        m_clockDriftPPM = ((SDRdaemonInput::MsgReportSDRdaemonStreamTiming&)message).getClockDriftPPM();
 
 		updateWithStreamTime();
 		return true;
@@ -385,6 +403,8 @@ void SDRdaemonGui::displaySettings()
 	ui->iqImbalance->setChecked(m_iqCorrection);
 	ui->autoFollowRate->setChecked(m_autoFollowRate);
     ui->autoCorrBuffer->setChecked(m_autoCorrBuffer);
+    ui->targetLatency->setValue(m_targetLatencyMs / 10);
+    ui->targetLatencyText->setText(tr("%1").arg(m_targetLatencyMs));
 }
 
 void SDRdaemonGui::displayConfigurationParameters(uint32_t freq,
@@ -557,6 +577,17 @@ void SDRdaemonGui::on_resetIndexes_clicked(bool checked)
     m_sampleSource->getInputMessageQueue()->push(message);
 }
 
+void SDRdaemonGui::on_targetLatency_valueChanged(int value)
+{
+    ui->targetLatencyText->setText(tr("%1").arg(value * 10));
+
+    if (m_targetLatencyMs != value * 10)
+    {
+        m_targetLatencyMs = value * 10;
+        configureLatency();
+    }
+}
+
 void SDRdaemonGui::on_freq_textEdited(const QString& arg1)
 {
 	ui->sendButton->setEnabled(true);
@@ -604,6 +635,8 @@ void SDRdaemonGui::on_record_toggled(bool checked)
     if (checked)
     {
         ui->record->setStyleSheet("QToolButton { background-color : red; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device"));
+        m_fileSink->setCompression(m_deviceAPI->getRecordCompression());
         m_fileSink->startRecording();
     }
     else
@@ -634,6 +667,12 @@ void SDRdaemonGui::configureAutoFollowPolicy()
 	m_sampleSource->getInputMessageQueue()->push(message);
 }
 
+void SDRdaemonGui::configureLatency()
+{
+    SDRdaemonInput::MsgConfigureSDRdaemonLatency* message = SDRdaemonInput::MsgConfigureSDRdaemonLatency::create(m_targetLatencyMs);
+    m_sampleSource->getInputMessageQueue()->push(message);
+}
+
 void SDRdaemonGui::updateWithAcquisition()
 {
 }
@@ -691,11 +730,17 @@ void SDRdaemonGui::updateWithStreamTime()
 	s = QString::number(m_bufferLengthInSecs, 'f', 1);
 	ui->bufferLenSecsText->setText(tr("%1").arg(s));
 
-	s = QString::number((m_bufferGauge < 0 ? -50 - m_bufferGauge : 50 - m_bufferGauge), 'f', 0);
+	s = QString::number(m_bufferGauge, 'f', 0);
 	ui->bufferRWBalanceText->setText(tr("%1").arg(s));
 
-    ui->bufferGaugeNegative->setValue((m_bufferGauge < 0 ? 50 + m_bufferGauge : 0));
-    ui->bufferGaugePositive->setValue((m_bufferGauge < 0 ? 0 : 50 - m_bufferGauge));
+    ui->bufferGaugeNegative->setValue((m_bufferGauge < 0 ? -m_bufferGauge : 0));
+    ui->bufferGaugePositive->setValue((m_bufferGauge < 0 ? 0 : m_bufferGauge));
+
+    s = QString::number(m_latencyMs, 'f', 0);
+    ui->latencyText->setText(tr("%1/%2").arg(s).arg(m_effectiveTargetLatencyMs));
+
+    s = QString::number(m_clockDriftPPM, 'f', 1);
+    ui->clockDriftText->setText(tr("%1").arg(s));
 }
 
 void SDRdaemonGui::updateStatus()
@@ -725,6 +770,12 @@ void SDRdaemonGui::updateStatus()
 
         m_lastEngineState = state;
     }
+
+    if (ui->record->isChecked() && (m_fileSink->getDroppedCount() > 0)) // the disk does not keep up
+    {
+        ui->record->setStyleSheet("QToolButton { background-color : magenta; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device (%1 samples dropped)").arg(m_fileSink->getDroppedCount()));
+    }
 }
 
 void SDRdaemonGui::tick()
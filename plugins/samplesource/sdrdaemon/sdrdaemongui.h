@@ -74,6 +74,9 @@ private:
 	float m_bufferLengthInSecs;
 
     int32_t m_bufferGauge;
+    float m_latencyMs;
+    int m_effectiveTargetLatencyMs;
+    float m_clockDriftPPM;
 	int m_samplesCount;
 	std::size_t m_tickCount;
 
@@ -90,6 +93,7 @@ private:
 	bool m_iqCorrection;
 	bool m_autoFollowRate;
     bool m_autoCorrBuffer;
+    int m_targetLatencyMs;
 
 	void displaySettings();
 
@@ -103,6 +107,7 @@ private:
 	void configureUDPLink();
 	void configureAutoCorrections();
     void configureAutoFollowPolicy();
+    void configureLatency();
 	void updateWithAcquisition();
 	void updateWithStreamData();
 	void updateWithStreamTime();
@@ -118,6 +123,7 @@ private slots:
 	void on_autoFollowRate_toggled(bool checked);
     void on_autoCorrBuffer_toggled(bool checked);
     void on_resetIndexes_clicked(bool checked);
+    void on_targetLatency_valueChanged(int value);
 	void on_address_textEdited(const QString& arg1);
 	void on_dataPort_textEdited(const QString& arg1);
 	void on_controlPort_textEdited(const QString& arg1);
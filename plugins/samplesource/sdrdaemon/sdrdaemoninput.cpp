@@ -33,6 +33,7 @@ MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgConfigureSDRdaemonUDPLink, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgConfigureSDRdaemonAutoCorr, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgConfigureSDRdaemonWork, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgConfigureSDRdaemonAutoFollowPolicy, Message)
+MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgConfigureSDRdaemonLatency, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgConfigureSDRdaemonResetIndexes, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgConfigureSDRdaemonStreamTiming, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonInput::MsgReportSDRdaemonAcquisition, Message)
@@ -137,6 +138,12 @@ bool SDRdaemonInput::handleMessage(const Message& message)
         }
 		return true;
 	}
+    else if (MsgConfigureSDRdaemonLatency::match(message))
+    {
+        MsgConfigureSDRdaemonLatency& conf = (MsgConfigureSDRdaemonLatency&) message;
+        m_SDRdaemonUDPHandler->setTargetLatency(conf.getTargetLatencyMs());
+        return true;
+    }
     else if (MsgConfigureSDRdaemonResetIndexes::match(message))
     {
         m_SDRdaemonUDPHandler->resetIndexes();
@@ -117,6 +117,26 @@ public:
 		{ }
 	};
 
+    class MsgConfigureSDRdaemonLatency : public Message {
+        MESSAGE_CLASS_DECLARATION
+
+    public:
+        int getTargetLatencyMs() const { return m_targetLatencyMs; }
+
+        static MsgConfigureSDRdaemonLatency* create(int targetLatencyMs)
+        {
+            return new MsgConfigureSDRdaemonLatency(targetLatencyMs);
+        }
+
+    private:
+        int m_targetLatencyMs;
+
+        MsgConfigureSDRdaemonLatency(int targetLatencyMs) :
+            Message(),
+            m_targetLatencyMs(targetLatencyMs)
+        { }
+    };
+
     class MsgConfigureSDRdaemonResetIndexes : public Message {
         MESSAGE_CLASS_DECLARATION
     public:
@@ -214,6 +234,9 @@ public:
 		uint32_t getLz4DataCRCOK() const  { return m_nbLz4CRCOK; }
 		uint32_t getLz4SuccessfulDecodes() const { return m_nbLz4SuccessfulDecodes; }
         int32_t getBufferGauge() const { return m_bufferGauge; }
+        float getLatencyMs() const { return m_latencyMs; }
+        int getTargetLatencyMs() const { return m_targetLatencyMs; }
+        float getClockDriftPPM() const { return m_clockDriftPPM; }
 
 		static MsgReportSDRdaemonStreamTiming* create(uint32_t tv_sec,
 				uint32_t tv_usec,
@@ -224,7 +247,10 @@ public:
 				float compressionRatio,
 				uint32_t nbLz4CRCOK,
                 uint32_t nbLz4SuccessfulDecodes,
-                int32_t bufferGauge)
+                int32_t bufferGauge,
+                float latencyMs,
+                int targetLatencyMs,
+                float clockDriftPPM)
 		{
 			return new MsgReportSDRdaemonStreamTiming(tv_sec,
 					tv_usec,
@@ -235,7 +261,10 @@ public:
 					compressionRatio,
 					nbLz4CRCOK,
                     nbLz4SuccessfulDecodes,
-                    bufferGauge);
+                    bufferGauge,
+                    latencyMs,
+                    targetLatencyMs,
+                    clockDriftPPM);
 		}
 
 	protected:
@@ -249,6 +278,9 @@ public:
 		uint32_t m_nbLz4CRCOK;
 		uint32_t m_nbLz4SuccessfulDecodes;
         int32_t m_bufferGauge;
+        float m_latencyMs;       //!< main buffer smoothed latency
+        int m_targetLatencyMs;   //!< main buffer effective target latency
+        float m_clockDriftPPM;   //!< estimated stream clock drift
 
 		MsgReportSDRdaemonStreamTiming(uint32_t tv_sec,
 				uint32_t tv_usec,
@@ -259,7 +291,10 @@ public:
 				float compressionRatio,
 				uint32_t nbLz4CRCOK,
                 uint32_t nbLz4SuccessfulDecodes,
-                int32_t bufferGauge) :
+                int32_t bufferGauge,
+                float latencyMs,
+                int targetLatencyMs,
+                float clockDriftPPM) :
 			Message(),
 			m_tv_sec(tv_sec),
 			m_tv_usec(tv_usec),
@@ -270,7 +305,10 @@ public:
 			m_compressionRatio(compressionRatio),
 			m_nbLz4CRCOK(nbLz4CRCOK),
             m_nbLz4SuccessfulDecodes(nbLz4SuccessfulDecodes),
-            m_bufferGauge(bufferGauge)
+            m_bufferGauge(bufferGauge),
+            m_latencyMs(latencyMs),
+            m_targetLatencyMs(targetLatencyMs),
+            m_clockDriftPPM(clockDriftPPM)
 		{ }
 	};
 
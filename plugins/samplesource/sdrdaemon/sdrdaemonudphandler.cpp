@@ -29,7 +29,7 @@
 
 SDRdaemonUDPHandler::SDRdaemonUDPHandler(SampleSinkFifo *sampleFifo, MessageQueue *outputMessageQueueToGUI, DeviceSourceAPI *devieAPI) :
     m_deviceAPI(devieAPI),
-	m_sdrDaemonBuffer(m_rateDivider),
+	m_sdrDaemonBuffer(SDRDAEMON_THROTTLE_MS),
 	m_dataSocket(0),
 	m_dataAddress(QHostAddress::LocalHost),
 	m_remoteAddress(QHostAddress::LocalHost),
@@ -47,9 +47,6 @@ SDRdaemonUDPHandler::SDRdaemonUDPHandler(SampleSinkFifo *sampleFifo, MessageQueu
 	m_samplesCount(0),
 	m_timer(0),
     m_throttlems(SDRDAEMON_THROTTLE_MS),
-    m_readLengthSamples(0),
-    m_readLength(0),
-    m_throttleToggle(false),
     m_rateDivider(1000/SDRDAEMON_THROTTLE_MS),
 	m_autoCorrBuffer(false)
 {
@@ -94,7 +91,7 @@ void SDRdaemonUDPHandler::start()
 	// Need to notify the DSP engine to actually start
 	DSPSignalNotification *notif = new DSPSignalNotification(m_samplerate, m_centerFrequency * 1000); // Frequency in Hz for the DSP engine
 	m_deviceAPI->getDeviceInputMessageQueue()->push(notif);
-    m_elapsedTimer.start();
+    m_pacer.start();
 }
 
 void SDRdaemonUDPHandler::stop()
@@ -214,29 +211,28 @@ void SDRdaemonUDPHandler::connectTimer(const QTimer* timer)
     connect(timer, SIGNAL(timeout()), this, SLOT(tick()));
 #endif
     m_rateDivider = 1000 / m_throttlems;
+    m_pacer.setTickMs(m_throttlems);
 }
 
 void SDRdaemonUDPHandler::tick()
 {
-    // auto throttling
-    int throttlems = m_elapsedTimer.restart();
+    // output at the sample rate in local time and read the stream at the rate of its own clock
+    int nbOutputSamples = m_pacer.getNbOutputSamples(m_sdrDaemonBuffer.getSampleRate());
+    m_pacer.setRatio(m_autoCorrBuffer ? m_sdrDaemonBuffer.getResamplingRatio() : 1.0);
+    int nbInputSamples = m_pacer.getNbInputSamples(nbOutputSamples);
 
-    if (throttlems != m_throttlems)
-    {
-        m_throttlems = throttlems;
-        m_readLengthSamples = (m_sdrDaemonBuffer.getSampleRate() * (m_throttlems+(m_throttleToggle ? 1 : 0))) / 1000;
-        m_throttleToggle = !m_throttleToggle;
-    }
-
-    if (m_autoCorrBuffer) {
-    	m_readLengthSamples += m_sdrDaemonBuffer.getRWBalanceCorrection();
+    if (nbInputSamples > m_sdrDaemonBuffer.getBufferNbSamples()) { // the resampler holds the last sample if input falls short
+        nbInputSamples = m_sdrDaemonBuffer.getBufferNbSamples();
     }
 
-    m_readLength = m_readLengthSamples * SDRdaemonBuffer::m_iqSampleSize;
-
 	// read samples directly feeding the SampleFifo (no callback)
-    m_sampleFifo->write(reinterpret_cast<quint8*>(m_sdrDaemonBuffer.readData(m_readLength)), m_readLength);
-    m_samplesCount += m_readLengthSamples;
+    if (nbOutputSamples > 0)
+    {
+        const qint16 *input = (const qint16 *) m_sdrDaemonBuffer.readData(nbInputSamples * SDRdaemonBuffer::m_iqSampleSize);
+        const qint16 *output = m_pacer.resample(input, nbInputSamples, nbOutputSamples);
+        m_sampleFifo->write(reinterpret_cast<const quint8*>(output), nbOutputSamples * SDRdaemonBuffer::m_iqSampleSize);
+        m_samplesCount += nbOutputSamples;
+    }
 
 	if (m_tickCount < m_rateDivider)
 	{
@@ -255,7 +251,10 @@ void SDRdaemonUDPHandler::tick()
 			m_sdrDaemonBuffer.getCompressionRatio(),
 			m_sdrDaemonBuffer.getLz4DataCRCOK(),
             m_sdrDaemonBuffer.getLz4SuccessfulDecodes(),
-            m_sdrDaemonBuffer.getBufferGauge());
+            m_sdrDaemonBuffer.getBufferGauge(),
+            m_sdrDaemonBuffer.getLatencyMs(),
+            m_sdrDaemonBuffer.getTargetLatencyMs(),
+            m_sdrDaemonBuffer.getClockDriftPPM());
 		m_outputMessageQueueToGUI->push(report);
 	}
 }
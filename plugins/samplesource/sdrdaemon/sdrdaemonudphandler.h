@@ -21,8 +21,8 @@
 #include <QUdpSocket>
 #include <QHostAddress>
 #include <QMutex>
-#include <QElapsedTimer>
 
+#include "dsp/streampacer.h"
 #include "sdrdaemonbuffer.h"
 
 #define SDRDAEMON_THROTTLE_MS 50
@@ -44,8 +44,9 @@ public:
 	void configureUDPLink(const QString& address, quint16 port);
 	void getRemoteAddress(QString& s) const { s = m_remoteAddress.toString(); }
 	void setAutoFollowRate(bool autoFollowRate) { m_sdrDaemonBuffer.setAutoFollowRate(autoFollowRate); }
-    void setAutoCorrBuffer(bool autoCorrBuffer) { m_autoCorrBuffer = autoCorrBuffer; m_sdrDaemonBuffer.setAutoCorrBuffer(autoCorrBuffer); }
+    void setAutoCorrBuffer(bool autoCorrBuffer) { m_autoCorrBuffer = autoCorrBuffer; }
     void resetIndexes() { m_sdrDaemonBuffer.setResetIndexes(); }
+    void setTargetLatency(int targetLatencyMs) { m_sdrDaemonBuffer.setTargetLatency(targetLatencyMs); }
 public slots:
 	void dataReadyRead();
 
@@ -69,11 +70,8 @@ private:
 	std::size_t m_samplesCount;
     QTimer *m_timer;
 
-	QElapsedTimer m_elapsedTimer;
 	int m_throttlems;
-    uint32_t m_readLengthSamples;
-    uint32_t m_readLength;
-    bool m_throttleToggle;
+    StreamPacer m_pacer;              //!< output at the nominal sample rate resampled to the stream clock
     int m_rateDivider;
     bool m_autoCorrBuffer;
 
@@ -40,13 +40,15 @@ SOURCES += sdrdaemonfecbuffer.cpp\
 sdrdaemonfecgui.cpp\
 sdrdaemonfecinput.cpp\
 sdrdaemonfecplugin.cpp\
-sdrdaemonfecudphandler.cpp
+sdrdaemonfecudphandler.cpp\
+sdrdaemonfecudpreceiver.cpp
 
 HEADERS += sdrdaemonfecbuffer.h\
 sdrdaemonfecgui.h\
 sdrdaemonfecinput.h\
 sdrdaemonfecplugin.h\
-sdrdaemonfecudphandler.h
+sdrdaemonfecudphandler.h\
+sdrdaemonfecudpreceiver.h
 
 FORMS += sdrdaemonfecgui.ui
 
@@ -15,6 +15,7 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include <QDebug>
+#include <QThread>
 #include <cassert>
 #include <cstring>
 #include <cmath>
@@ -29,33 +30,43 @@ const int SDRdaemonFECBuffer::m_sampleSize = 2;
 const int SDRdaemonFECBuffer::m_iqSampleSize = 2 * m_sampleSize;
 
 SDRdaemonFECBuffer::SDRdaemonFECBuffer(uint32_t throttlems) :
-        m_frameHead(0),
-        m_decoderIndexHead(nbDecoderSlots/2),
+        m_udpPayloadSize(0),
+        m_blockBytes(0),
+        m_nbOriginalBlocks(0),
+        m_nbDecoderSlots(0),
+        m_frameBytes(0),
+        m_nbSizeDrops(0),
+        m_framesNbBytes(0),
+        m_frameHead(-1),
+        m_decoderIndexHead(0),
         m_curNbBlocks(0),
         m_minNbBlocks(256),
         m_minOriginalBlocks(128),
         m_curNbRecovery(0),
         m_maxNbRecovery(0),
         m_framesDecoded(true),
+        m_nbDecodesPending(0),
+        m_maxDecodeQueueDepth(0),
+        m_maxDecodeLatencyUs(0),
+        m_nbDecoderThreads(1),
         m_throttlemsNominal(throttlems),
         m_readIndex(0),
         m_readBuffer(0),
         m_readSize(0),
         m_bufferLenSec(0.0f),
-		m_nbReads(0),
-		m_nbWrites(0),
-		m_balCorrection(0),
-	    m_balCorrLimit(0),
-	    m_curOriginalBlocks(0)
+	    m_curOriginalBlocks(0),
+	    m_latencyBytes(0),
+	    m_targetLatencyMs(SDRDAEMONFEC_TARGETLATENCYMS),
+	    m_targetLatencyBytes(0),
+	    m_frameCountValid(false),
+	    m_lastFrameIndex(0),
+	    m_frameCount(0)
 {
 	m_currentMeta.init();
-	m_framesNbBytes = nbDecoderSlots * sizeof(BufferFrame);
-	m_wrDeltaEstimate = m_framesNbBytes / 2;
+	m_wrDeltaEstimate = 0;
 	m_tvOut_sec = 0;
 	m_tvOut_usec = 0;
 	m_readNbBytes = 1;
-    m_paramsCM256.BlockBytes = sizeof(ProtectedBlock); // never changes
-    m_paramsCM256.OriginalCount = m_nbOriginalBlocks;  // never changes
 
     if (!m_cm256.isInitialized()) {
         m_cm256_OK = false;
@@ -63,18 +74,183 @@ SDRdaemonFECBuffer::SDRdaemonFECBuffer(uint32_t throttlems) :
     } else {
         m_cm256_OK = true;
     }
+
+    // leave some room to the network receive and DSP threads
+    int nbDecoderThreads = QThread::idealThreadCount() / 2;
+    nbDecoderThreads = nbDecoderThreads < 1 ? 1 : nbDecoderThreads > SDRDAEMONFEC_MAXDECODERTHREADS ? SDRDAEMONFEC_MAXDECODERTHREADS : nbDecoderThreads;
+    m_decoderPool.setMaxThreadCount(nbDecoderThreads);
+    m_nbDecoderThreads = nbDecoderThreads;
+    m_decoderPool.setExpiryTimeout(-1); // keep threads around between frames
+    qDebug("SDRdaemonFECBuffer::SDRdaemonFECBuffer: %d FEC decoder threads", nbDecoderThreads);
+
+    setGeometry(m_defaultUDPPayloadSize, m_defaultNbOriginalBlocks);
 }
 
 SDRdaemonFECBuffer::~SDRdaemonFECBuffer()
 {
+    waitFrames(-1);
+    m_decoderPool.waitForDone();
+    deleteDecoders();
+
 	if (m_readBuffer) {
 		delete[] m_readBuffer;
 	}
 }
 
+bool SDRdaemonFECBuffer::setGeometry(int udpPayloadSize, int nbOriginalBlocks)
+{
+    int blockBytes = udpPayloadSize - sizeof(Header);
+
+    if ((udpPayloadSize > m_maxUDPPayloadSize)
+        || (blockBytes < (int) sizeof(MetaDataFEC))
+        || (blockBytes % m_iqSampleSize != 0)
+        || (nbOriginalBlocks < 2)
+        || (nbOriginalBlocks > 255))
+    {
+        qDebug() << "SDRdaemonFECBuffer::setGeometry: invalid geometry:"
+                << " udpPayloadSize: " << udpPayloadSize
+                << " nbOriginalBlocks: " << nbOriginalBlocks;
+        return false;
+    }
+
+    waitFrames(-1); // decoders must be idle before the slots are moved
+
+    m_udpPayloadSize = udpPayloadSize;
+    m_blockBytes = blockBytes;
+    m_nbOriginalBlocks = nbOriginalBlocks;
+    m_frameBytes = (nbOriginalBlocks - 1) * blockBytes;
+
+    // keep the buffer close to its size with the default geometry and hold at least 4 frames
+    int defaultFramesNbBytes = SDRDAEMONFEC_NBDECODERSLOTS * (SDRDAEMONFEC_NBORIGINALBLOCKS - 1) * (SDRDAEMONFEC_UDPSIZE - sizeof(Header));
+    m_nbDecoderSlots = SDRDAEMONFEC_NBDECODERSLOTS;
+
+    while ((m_nbDecoderSlots > 4) && (m_nbDecoderSlots * m_frameBytes > defaultFramesNbBytes)) {
+        m_nbDecoderSlots /= 2;
+    }
+
+    while ((m_nbDecoderSlots < 64) && (2 * m_nbDecoderSlots * m_frameBytes <= defaultFramesNbBytes)) {
+        m_nbDecoderSlots *= 2;
+    }
+
+    m_frames.assign(m_nbDecoderSlots * m_frameBytes, 0);
+    m_framesNbBytes = m_nbDecoderSlots * m_frameBytes;
+    m_slotBlocks.assign(m_nbDecoderSlots * (nbOriginalBlocks + 1) * blockBytes, 0); // block zero and recovery blocks
+    m_slotDescriptors.resize(m_nbDecoderSlots * nbOriginalBlocks);
+    m_decoderSlots.resize(m_nbDecoderSlots);
+
+    for (int i = 0; i < m_nbDecoderSlots; i++)
+    {
+        m_decoderSlots[i].m_blockZero = &m_slotBlocks[i * (nbOriginalBlocks + 1) * blockBytes];
+        m_decoderSlots[i].m_recoveryBlocks = m_decoderSlots[i].m_blockZero + blockBytes;
+        m_decoderSlots[i].m_cm256DescriptorBlocks = &m_slotDescriptors[i * nbOriginalBlocks];
+        m_decoderSlots[i].m_pending = false;
+        m_decoderSlots[i].m_decodeJob = false;
+        m_decoderSlots[i].m_decodeDone = false;
+        m_decoderSlots[i].m_decodeLatencyUs = 0;
+        m_decoderSlots[i].m_frameIndex = 0;
+    }
+
+    deleteDecoders();
+
+    for (int i = 0; i < m_nbDecoderSlots; i++) {
+        m_decoders.push_back(new Decoder(this, i));
+    }
+
+    m_paramsCM256.BlockBytes = blockBytes;
+    m_paramsCM256.OriginalCount = nbOriginalBlocks;
+    m_minOriginalBlocks = nbOriginalBlocks;
+
+    if (m_currentMeta.m_sampleRate > 0) {
+        m_bufferLenSec = (float) m_framesNbBytes / (float) (m_currentMeta.m_sampleRate * m_iqSampleSize);
+    }
+
+    m_frameHead = -1; // start over with the next block
+    m_readIndex = 0;
+    updateTargetLatency();
+    m_wrDeltaEstimate = m_targetLatencyBytes;
+    m_latencyBytes = m_targetLatencyBytes;
+    m_frameCountValid = false; // frame size changed
+    m_jitterControl.reset();
+
+    qDebug() << "SDRdaemonFECBuffer::setGeometry:"
+            << " udpPayloadSize: " << m_udpPayloadSize
+            << " nbOriginalBlocks: " << m_nbOriginalBlocks
+            << " nbDecoderSlots: " << m_nbDecoderSlots
+            << " framesNbBytes: " << m_framesNbBytes;
+
+    return true;
+}
+
+bool SDRdaemonFECBuffer::checkGeometry(const MetaDataFEC *metaData)
+{
+    if (!checkMetaCRC(metaData)) {
+        return false;
+    }
+
+    if ((metaData->m_sampleBytes & m_blockSizeIndicator) && (metaData->m_blockSize != m_udpPayloadSize))
+    {
+        qDebug() << "SDRdaemonFECBuffer::checkGeometry: announced block size " << metaData->m_blockSize
+                << " differs from received block size " << m_udpPayloadSize;
+    }
+
+    if ((metaData->m_nbOriginalBlocks == m_nbOriginalBlocks)
+        || (metaData->m_nbOriginalBlocks + metaData->m_nbFECBlocks > 256)) { // CM256 limit
+        return false;
+    }
+
+    return setGeometry(m_udpPayloadSize, metaData->m_nbOriginalBlocks);
+}
+
+bool SDRdaemonFECBuffer::checkBlockSize(const char *array, uint32_t length)
+{
+    const Header *header = (const Header *) array;
+    const MetaDataFEC *metaData = (const MetaDataFEC *) &array[sizeof(Header)];
+
+    if ((length < sizeof(Header) + sizeof(MetaDataFEC))
+        || ((int) length > m_maxUDPPayloadSize)
+        || (header->blockIndex != 0)
+        || !checkMetaCRC(metaData))
+    {
+        return false;
+    }
+
+    if ((metaData->m_sampleBytes & m_blockSizeIndicator) && (metaData->m_blockSize != length)) // not covered by the CRC
+    {
+        qDebug() << "SDRdaemonFECBuffer::checkBlockSize: announced block size " << metaData->m_blockSize
+                << " differs from received block size " << length;
+        return false;
+    }
+
+    int nbOriginalBlocks = m_nbOriginalBlocks;
+
+    if (metaData->m_nbOriginalBlocks + metaData->m_nbFECBlocks <= 256) { // CM256 limit
+        nbOriginalBlocks = metaData->m_nbOriginalBlocks;
+    }
+
+    return setGeometry(length, nbOriginalBlocks);
+}
+
+bool SDRdaemonFECBuffer::checkMetaCRC(const MetaDataFEC *metaData)
+{
+    boost::crc_32_type crc32;
+    crc32.process_bytes(metaData, 20);
+    return crc32.checksum() == metaData->m_crc32;
+}
+
+void SDRdaemonFECBuffer::deleteDecoders()
+{
+    for (std::vector<Decoder*>::iterator it = m_decoders.begin(); it != m_decoders.end(); ++it) {
+        delete *it;
+    }
+
+    m_decoders.clear();
+}
+
 void SDRdaemonFECBuffer::initDecodeAllSlots()
 {
-    for (int i = 0; i < nbDecoderSlots; i++)
+    waitFrames(-1);
+
+    for (int i = 0; i < m_nbDecoderSlots; i++)
     {
         m_decoderSlots[i].m_blockCount = 0;
         m_decoderSlots[i].m_originalCount = 0;
@@ -82,7 +258,7 @@ void SDRdaemonFECBuffer::initDecodeAllSlots()
         m_decoderSlots[i].m_decoded = false;
         m_decoderSlots[i].m_metaRetrieved = false;
         resetOriginalBlocks(i);
-        memset((void *) m_decoderSlots[i].m_recoveryBlocks, 0, m_nbOriginalBlocks * sizeof(ProtectedBlock));
+        memset((void *) m_decoderSlots[i].m_recoveryBlocks, 0, m_nbOriginalBlocks * m_blockBytes);
     }
 }
 
@@ -119,59 +295,111 @@ void SDRdaemonFECBuffer::initDecodeSlot(int slotIndex)
     m_decoderSlots[slotIndex].m_metaRetrieved = false;
 
     resetOriginalBlocks(slotIndex);
-    memset((void *) m_decoderSlots[slotIndex].m_recoveryBlocks, 0, m_nbOriginalBlocks * sizeof(ProtectedBlock));
+    memset((void *) m_decoderSlots[slotIndex].m_recoveryBlocks, 0, m_nbOriginalBlocks * m_blockBytes);
 }
 
 void SDRdaemonFECBuffer::initReadIndex()
 {
-    m_readIndex = ((m_decoderIndexHead + (nbDecoderSlots/2)) % nbDecoderSlots) * sizeof(BufferFrame);
-    m_wrDeltaEstimate = m_framesNbBytes / 2;
-    m_nbReads = 0;
-    m_nbWrites = 0;
+    m_readIndex = m_decoderIndexHead * m_frameBytes - m_targetLatencyBytes; // target latency behind the frame being received
+
+    if (m_readIndex < 0) {
+        m_readIndex += m_framesNbBytes;
+    }
+
+    m_wrDeltaEstimate = m_targetLatencyBytes;
+    m_latencyBytes = m_targetLatencyBytes;
+}
+
+void SDRdaemonFECBuffer::setTargetLatency(int targetLatencyMs)
+{
+    m_targetLatencyMs = targetLatencyMs;
+    updateTargetLatency();
+
+    if (m_frameHead != -1) {
+        initReadIndex();
+    }
 }
 
-void SDRdaemonFECBuffer::rwCorrectionEstimate(int slotIndex)
+int SDRdaemonFECBuffer::getTargetLatencyMs() const
 {
-	if (m_nbReads >= 40) // check every ~1s as tick is ~50ms
-	{
-		int targetPivotSlot = (slotIndex + (nbDecoderSlots/2))  % nbDecoderSlots; // slot at half buffer opposite of current write slot
-		int targetPivotIndex = targetPivotSlot * sizeof(BufferFrame);             // buffer index corresponding to start of above slot
-		int normalizedReadIndex = (m_readIndex < targetPivotIndex ? m_readIndex + nbDecoderSlots * sizeof(BufferFrame) :  m_readIndex)
-				- (targetPivotSlot * sizeof(BufferFrame)); // normalize read index so it is positive and zero at start of pivot slot
-		int dBytes;
-        int rwDelta = (m_nbReads * m_readNbBytes) - (m_nbWrites * sizeof(BufferFrame));
-
-		if (normalizedReadIndex < (nbDecoderSlots/ 2) * sizeof(BufferFrame)) // read leads
-		{
-			dBytes = - normalizedReadIndex - rwDelta;
-		}
-		else // read lags
-		{
-			dBytes = (nbDecoderSlots * sizeof(BufferFrame)) - normalizedReadIndex - rwDelta;
-		}
-
-        m_balCorrection = (m_balCorrection / 4) + (dBytes / (int) (m_iqSampleSize * m_nbReads)); // correction is in number of samples. Alpha = 0.25
-
-        if (m_balCorrection < -m_balCorrLimit) {
-            m_balCorrection = -m_balCorrLimit;
-        } else if (m_balCorrection > m_balCorrLimit) {
-            m_balCorrection = m_balCorrLimit;
-        }
+    int sampleRate = m_currentMeta.m_sampleRate;
 
-        float rwRatio = (float) (m_nbWrites * sizeof(BufferFrame)) / (float)  (m_nbReads * m_readNbBytes);
+    if (sampleRate > 0) {
+        return (int) (((int64_t) (m_targetLatencyBytes / m_iqSampleSize) * 1000) / sampleRate);
+    } else {
+        return m_targetLatencyMs;
+    }
+}
 
-	    m_nbReads = 0;
-	    m_nbWrites = 0;
-	}
+float SDRdaemonFECBuffer::getLatencyMs() const
+{
+    int sampleRate = m_currentMeta.m_sampleRate;
+    return sampleRate > 0 ? (m_jitterControl.getLatency() * 1000.0f) / sampleRate : 0.0f;
+}
+
+void SDRdaemonFECBuffer::updateTargetLatency()
+{
+    int sampleRate = m_currentMeta.m_sampleRate;
+    int targetLatencyBytes = (int) (((int64_t) sampleRate * m_targetLatencyMs) / 1000) * m_iqSampleSize;
+    // the frame being received and the frames before it that the decoder threads may be recovering are not readable
+    // and reads are done by ticks
+    int minLatencyBytes = (m_nbDecoderThreads + 2) * m_frameBytes + 2 * m_readNbBytes;
+    int maxLatencyBytes = m_framesNbBytes / 2;
+
+    if (targetLatencyBytes < minLatencyBytes) {
+        targetLatencyBytes = minLatencyBytes;
+    }
+
+    if (targetLatencyBytes > maxLatencyBytes) {
+        targetLatencyBytes = maxLatencyBytes;
+    }
+
+    m_targetLatencyBytes = (targetLatencyBytes / m_iqSampleSize) * m_iqSampleSize;
+    m_jitterControl.setTargetLatency(m_targetLatencyBytes / m_iqSampleSize);
+}
+
+void SDRdaemonFECBuffer::latencyControl(int slotIndex)
+{
+    int latencyBytes = slotIndex * m_frameBytes - m_readIndex; // the frames before the slot are written
+
+    if (latencyBytes < 0) {
+        latencyBytes += m_framesNbBytes;
+    }
+
+    m_latencyBytes = latencyBytes;
+
+    // frames from the oldest one pending finalization may still be decoding in the FEC decoder threads so they are not readable
+    if ((getReadableBytes(slotIndex) < m_readNbBytes) || (latencyBytes > m_framesNbBytes - m_frameBytes)) // reads about to overtake writes or writes overtook reads
+    {
+        qDebug() << "SDRdaemonFECBuffer::latencyControl: restart reading at target latency:"
+                << " latencyBytes: " << latencyBytes
+                << " m_targetLatencyBytes: " << m_targetLatencyBytes;
+        initReadIndex();
+    }
+    else
+    {
+        m_jitterControl.latencyMeasured(latencyBytes / m_iqSampleSize);
+    }
+}
+
+int SDRdaemonFECBuffer::getReadableBytes(int slotIndex) const
+{
+    int guardSlotIndex = m_pendingSlots.isEmpty() ? slotIndex : m_pendingSlots.head();
+    int readableBytes = guardSlotIndex * m_frameBytes - m_readIndex;
+
+    if (readableBytes < 0) {
+        readableBytes += m_framesNbBytes;
+    }
+
+    return readableBytes;
 }
 
 void SDRdaemonFECBuffer::checkSlotData(int slotIndex)
 {
-    int pseudoWriteIndex = slotIndex * sizeof(BufferFrame);
+    int pseudoWriteIndex = slotIndex * m_frameBytes;
     m_wrDeltaEstimate = pseudoWriteIndex - m_readIndex;
-    m_nbWrites++;
 
-    int rwDelayBytes = (m_wrDeltaEstimate > 0 ? m_wrDeltaEstimate : sizeof(BufferFrame) * nbDecoderSlots + m_wrDeltaEstimate);
+    int rwDelayBytes = (m_wrDeltaEstimate > 0 ? m_wrDeltaEstimate : m_frameBytes * m_nbDecoderSlots + m_wrDeltaEstimate);
     int sampleRate = m_currentMeta.m_sampleRate;
 
     if (sampleRate > 0)
@@ -192,9 +420,27 @@ void SDRdaemonFECBuffer::checkSlotData(int slotIndex)
 
 void SDRdaemonFECBuffer::writeData(char *array, uint32_t length)
 {
-    SuperBlock *superBlock = (SuperBlock *) array;
-    int frameIndex = superBlock->header.frameIndex;
-    int decoderIndex = frameIndex % nbDecoderSlots;
+    if (((int) length != m_udpPayloadSize) && !checkBlockSize(array, length)) // only a valid block zero changes the datagram size of the stream
+    {
+        if (m_nbSizeDrops++ % 1000 == 0)
+        {
+            qDebug() << "SDRdaemonFECBuffer::writeData: dropped datagram of size " << length
+                    << " in a stream of size " << m_udpPayloadSize
+                    << " total: " << m_nbSizeDrops;
+        }
+
+        return;
+    }
+
+    Header *header = (Header *) array;
+    const uint8_t *block = (const uint8_t *) &array[sizeof(Header)];
+
+    if (header->blockIndex == 0) { // follow a change of the number of original blocks before storing anything
+        checkGeometry((const MetaDataFEC *) block);
+    }
+
+    int frameIndex = header->frameIndex;
+    int decoderIndex = frameIndex % m_nbDecoderSlots;
 
     // frame break
 
@@ -204,21 +450,28 @@ void SDRdaemonFECBuffer::writeData(char *array, uint32_t length)
         m_frameHead = frameIndex;
         initReadIndex(); // reset read index
         initDecodeAllSlots(); // initialize all slots
+        m_decoderSlots[decoderIndex].m_frameIndex = frameIndex;
     }
     else if (m_frameHead != frameIndex) // frame break => new frame starts
     {
         m_decoderIndexHead = decoderIndex; // new decoder slot head
         m_frameHead = frameIndex;          // new frame head
+
+        if (m_decoderSlots[decoderIndex].m_pending) { // slot reused before its frame was finalized
+            waitFrames(decoderIndex);
+        }
+
         checkSlotData(decoderIndex);       // check slot before re-init
-        rwCorrectionEstimate(decoderIndex);
+        latencyControl(decoderIndex);
         initDecodeSlot(decoderIndex);      // collect stats and re-initialize current slot
+        m_decoderSlots[decoderIndex].m_frameIndex = frameIndex;
     }
 
     // Block processing
 
     if (m_decoderSlots[decoderIndex].m_blockCount < m_nbOriginalBlocks) // not enough blocks to decode -> store data
     {
-        int blockIndex = superBlock->header.blockIndex;
+        int blockIndex = header->blockIndex;
         int blockCount = m_decoderSlots[decoderIndex].m_blockCount;
         int recoveryCount = m_decoderSlots[decoderIndex].m_recoveryCount;
         m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[blockCount].Index = blockIndex;
@@ -230,97 +483,229 @@ void SDRdaemonFECBuffer::writeData(char *array, uint32_t length)
 
         if (blockIndex < m_nbOriginalBlocks) // original data
         {
-            m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[blockCount].Block = (void *) storeOriginalBlock(decoderIndex, blockIndex, superBlock->protectedBlock);
+            m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[blockCount].Block = (void *) storeOriginalBlock(decoderIndex, blockIndex, block);
             m_decoderSlots[decoderIndex].m_originalCount++;
         }
         else // recovery data
         {
-            m_decoderSlots[decoderIndex].m_recoveryBlocks[recoveryCount] = superBlock->protectedBlock;
-            m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[blockCount].Block = (void *) &m_decoderSlots[decoderIndex].m_recoveryBlocks[recoveryCount];
+            uint8_t *recoveryBlock = &m_decoderSlots[decoderIndex].m_recoveryBlocks[recoveryCount * m_blockBytes];
+            memcpy((void *) recoveryBlock, (const void *) block, m_blockBytes);
+            m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[blockCount].Block = (void *) recoveryBlock;
             m_decoderSlots[decoderIndex].m_recoveryCount++;
         }
     }
 
     m_decoderSlots[decoderIndex].m_blockCount++;
 
-    if (m_decoderSlots[decoderIndex].m_blockCount == m_nbOriginalBlocks) // ready to decode
+    if (m_decoderSlots[decoderIndex].m_blockCount == m_nbOriginalBlocks) { // ready to decode
+        completeFrame(decoderIndex);
+    }
+
+    finalizeFrames();
+}
+
+void SDRdaemonFECBuffer::completeFrame(int slotIndex)
+{
+    DecoderSlot& slot = m_decoderSlots[slotIndex];
+    slot.m_decoded = true;
+    slot.m_pending = true;
+    slot.m_decodeJob = m_cm256_OK && (slot.m_recoveryCount > 0); // recovery data used => need to decode FEC
+    m_pendingSlots.enqueue(slotIndex);
+
+    if (slot.m_decodeJob)
     {
-        m_decoderSlots[decoderIndex].m_decoded = true;
+        Decoder *decoder = m_decoders[slotIndex];
+        decoder->m_paramsCM256.BlockBytes = m_blockBytes;  // changes only with the geometry
+        decoder->m_paramsCM256.OriginalCount = m_nbOriginalBlocks;
+
+        if (slot.m_metaRetrieved) {
+            decoder->m_paramsCM256.RecoveryCount = m_currentMeta.m_nbFECBlocks;
+        } else {
+            decoder->m_paramsCM256.RecoveryCount = slot.m_recoveryCount;
+        }
 
-        if (m_cm256_OK && (m_decoderSlots[decoderIndex].m_recoveryCount > 0)) // recovery data used => need to decode FEC
-        {
-            m_paramsCM256.BlockBytes = sizeof(ProtectedBlock); // never changes
-            m_paramsCM256.OriginalCount = m_nbOriginalBlocks;  // never changes
+        m_decodeMutex.lock();
+        slot.m_decodeDone = false;
+        m_decodeMutex.unlock();
 
-            if (m_decoderSlots[decoderIndex].m_metaRetrieved) {
-                m_paramsCM256.RecoveryCount = m_currentMeta.m_nbFECBlocks;
-            } else {
-                m_paramsCM256.RecoveryCount = m_decoderSlots[decoderIndex].m_recoveryCount;
-            }
+        m_nbDecodesPending++;
 
-            if (m_cm256.cm256_decode(m_paramsCM256, m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks)) // CM256 decode
-            {
-                qDebug() << "SDRdaemonFECBuffer::writeData: decode CM256 error:"
-                        << " m_originalCount: " << m_decoderSlots[decoderIndex].m_originalCount
-                        << " m_recoveryCount: " << m_decoderSlots[decoderIndex].m_recoveryCount;
-            }
-            else
+        if (m_nbDecodesPending > m_maxDecodeQueueDepth) {
+            m_maxDecodeQueueDepth = m_nbDecodesPending;
+        }
+
+        slot.m_decodeTimer.start();
+        m_decoderPool.start(decoder);
+    }
+    else
+    {
+        QMutexLocker mutexLocker(&m_decodeMutex);
+        slot.m_decodeDone = true;
+    }
+}
+
+void SDRdaemonFECBuffer::Decoder::run()
+{
+    m_buffer->decodeSlot(m_slotIndex, m_paramsCM256);
+}
+
+void SDRdaemonFECBuffer::decodeSlot(int slotIndex, const CM256::cm256_encoder_params& paramsCM256)
+{
+    // the receive thread does not touch the blocks of a pending slot
+    DecoderSlot& slot = m_decoderSlots[slotIndex];
+
+    if (m_cm256.cm256_decode(paramsCM256, slot.m_cm256DescriptorBlocks)) // CM256 decode
+    {
+        qDebug() << "SDRdaemonFECBuffer::decodeSlot: decode CM256 error:"
+                << " m_originalCount: " << slot.m_originalCount
+                << " m_recoveryCount: " << slot.m_recoveryCount;
+    }
+    else
+    {
+        qDebug() << "SDRdaemonFECBuffer::decodeSlot: decode CM256 success:"
+                << " m_originalCount: " << slot.m_originalCount
+                << " m_recoveryCount: " << slot.m_recoveryCount;
+
+        for (int ir = 0; ir < slot.m_recoveryCount; ir++) // restore missing blocks
+        {
+            int recoveryIndex = paramsCM256.OriginalCount - slot.m_recoveryCount + ir;
+            int blockIndex = slot.m_cm256DescriptorBlocks[recoveryIndex].Index;
+            uint8_t *recoveredBlock = (uint8_t *) slot.m_cm256DescriptorBlocks[recoveryIndex].Block;
+
+            if (blockIndex == 0) // first block with meta
             {
-                qDebug() << "SDRdaemonFECBuffer::writeData: decode CM256 success:"
-                        << " m_originalCount: " << m_decoderSlots[decoderIndex].m_originalCount
-                        << " m_recoveryCount: " << m_decoderSlots[decoderIndex].m_recoveryCount;
+                MetaDataFEC *metaData = (MetaDataFEC *) recoveredBlock;
 
-                for (int ir = 0; ir < m_decoderSlots[decoderIndex].m_recoveryCount; ir++) // restore missing blocks
+                if (checkMetaCRC(metaData))
+                {
+                    slot.m_metaRetrieved = true;
+                    printMeta("SDRdaemonFECBuffer::decodeSlot: recovered meta", metaData);
+                }
+                else
                 {
-                    int recoveryIndex = m_nbOriginalBlocks - m_decoderSlots[decoderIndex].m_recoveryCount + ir;
-                    int blockIndex = m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[recoveryIndex].Index;
-                    ProtectedBlock *recoveredBlock = (ProtectedBlock *) m_decoderSlots[decoderIndex].m_cm256DescriptorBlocks[recoveryIndex].Block;
-
-                    if (blockIndex == 0) // first block with meta
-                    {
-                        MetaDataFEC *metaData = (MetaDataFEC *) recoveredBlock;
-
-                        boost::crc_32_type crc32;
-                        crc32.process_bytes(metaData, 20);
-
-                        if (crc32.checksum() == metaData->m_crc32)
-                        {
-                            m_decoderSlots[decoderIndex].m_metaRetrieved = true;
-                            printMeta("SDRdaemonFECBuffer::writeData: recovered meta", metaData);
-                        }
-                        else
-                        {
-                            qDebug() << "SDRdaemonFECBuffer::writeData: recovered meta: invalid CRC32";
-                        }
-                    }
-
-                    storeOriginalBlock(decoderIndex, blockIndex, *recoveredBlock);
-
-                    qDebug() << "SDRdaemonFECBuffer::writeData: recovered block #" << blockIndex;
-                } // restore missing blocks
-            } // CM256 decode
-        } // revovery
-
-        if (m_decoderSlots[decoderIndex].m_metaRetrieved) // block zero with its meta data has been received
+                    qDebug() << "SDRdaemonFECBuffer::decodeSlot: recovered meta: invalid CRC32";
+                }
+            }
+
+            storeOriginalBlock(slotIndex, blockIndex, recoveredBlock);
+
+            qDebug() << "SDRdaemonFECBuffer::decodeSlot: recovered block #" << blockIndex;
+        } // restore missing blocks
+    } // CM256 decode
+
+    QMutexLocker mutexLocker(&m_decodeMutex);
+    slot.m_decodeLatencyUs = slot.m_decodeTimer.nsecsElapsed() / 1000;
+    slot.m_decodeDone = true;
+    m_decodeDone.wakeAll();
+}
+
+void SDRdaemonFECBuffer::finalizeFrames()
+{
+    while (!m_pendingSlots.isEmpty())
+    {
+        int slotIndex = m_pendingSlots.head();
+
+        m_decodeMutex.lock();
+        bool decodeDone = m_decoderSlots[slotIndex].m_decodeDone;
+        m_decodeMutex.unlock();
+
+        if (!decodeDone) { // keep frame order
+            break;
+        }
+
+        m_pendingSlots.dequeue();
+        finalizeSlot(slotIndex);
+    }
+}
+
+void SDRdaemonFECBuffer::waitFrames(int slotIndex)
+{
+    while (!m_pendingSlots.isEmpty())
+    {
+        int headSlotIndex = m_pendingSlots.dequeue();
+
+        m_decodeMutex.lock();
+
+        while (!m_decoderSlots[headSlotIndex].m_decodeDone) {
+            m_decodeDone.wait(&m_decodeMutex);
+        }
+
+        m_decodeMutex.unlock();
+        finalizeSlot(headSlotIndex);
+
+        if (headSlotIndex == slotIndex) {
+            break;
+        }
+    }
+}
+
+void SDRdaemonFECBuffer::finalizeSlot(int slotIndex)
+{
+    DecoderSlot& slot = m_decoderSlots[slotIndex];
+    slot.m_pending = false;
+
+    if (slot.m_decodeJob)
+    {
+        slot.m_decodeJob = false;
+        m_nbDecodesPending--;
+        m_avgDecodeLatencyUs(slot.m_decodeLatencyUs);
+
+        if (slot.m_decodeLatencyUs > m_maxDecodeLatencyUs) {
+            m_maxDecodeLatencyUs = slot.m_decodeLatencyUs;
+        }
+    }
+
+    if (slot.m_metaRetrieved) // block zero with its meta data has been received
+    {
+        MetaDataFEC *metaData = getMetaData(slotIndex);
+
+        if (!(*metaData == m_currentMeta))
         {
-            MetaDataFEC *metaData = getMetaData(decoderIndex);
+            int sampleRate =  metaData->m_sampleRate;
+            bool sampleRateChange = (sampleRate != (int) m_currentMeta.m_sampleRate);
+            m_currentMeta = *metaData;
 
-            if (!(*metaData == m_currentMeta))
+            if (sampleRate > 0)
             {
-                int sampleRate =  metaData->m_sampleRate;
+                m_bufferLenSec = (float) m_framesNbBytes / (float) (sampleRate * m_iqSampleSize);
+                m_readNbBytes = (int) (((int64_t) sampleRate * m_iqSampleSize * m_throttlemsNominal) / 1000);
+                m_jitterControl.setSampleRate(sampleRate);
+                updateTargetLatency();
 
-                if (sampleRate > 0) {
-                    m_bufferLenSec = (float) m_framesNbBytes / (float) (sampleRate * m_iqSampleSize);
-                    m_balCorrLimit = sampleRate / 1000; // +/- 1 ms correction max per read
-                    m_readNbBytes = (sampleRate * m_iqSampleSize) / 20;
+                if (sampleRateChange) {
+                    initReadIndex();
                 }
+            }
+
+            printMeta("SDRdaemonFECBuffer::finalizeSlot: new meta", metaData); // print for change other than timestamp
+        }
+
+        m_currentMeta = *metaData; // renew current meta
+
+        // follow the stream clock with the frames timestamps
+        if (m_frameCountValid)
+        {
+            uint16_t frameDelta = slot.m_frameIndex - m_lastFrameIndex;
 
-                printMeta("SDRdaemonFECBuffer::writeData: new meta", metaData); // print for change other than timestamp
+            if (frameDelta > 2 * m_nbDecoderSlots) // stream discontinuity
+            {
+                m_jitterControl.reset();
+                m_frameCount = 0;
+            }
+            else
+            {
+                m_frameCount += frameDelta;
             }
+        }
+        else
+        {
+            m_frameCount = 0;
+            m_frameCountValid = true;
+        }
 
-            m_currentMeta = *metaData; // renew current meta
-        } // check block 0
-    } // decode
+        m_lastFrameIndex = slot.m_frameIndex;
+        m_jitterControl.frameReceived(m_frameCount * (m_frameBytes / m_iqSampleSize), metaData->m_tv_sec, metaData->m_tv_usec);
+    } // check block 0
 }
 
 void SDRdaemonFECBuffer::writeData0(char *array, uint32_t length)
@@ -398,14 +783,12 @@ void SDRdaemonFECBuffer::writeData0(char *array, uint32_t length)
 
 uint8_t *SDRdaemonFECBuffer::readData(int32_t length)
 {
-    uint8_t *buffer = (uint8_t *) m_frames;
+    uint8_t *buffer = &m_frames[0];
     uint32_t readIndex = m_readIndex;
 
-    m_nbReads++;
-
     // SEGFAULT FIX: arbitratily truncate so that it does not exceed buffer length
-    if (length > framesSize) {
-        length = framesSize;
+    if (length > m_framesNbBytes) {
+        length = m_framesNbBytes;
     }
 
     if (m_readIndex + length < m_framesNbBytes) // ends before buffer bound
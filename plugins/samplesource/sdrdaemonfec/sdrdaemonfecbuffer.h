@@ -19,15 +19,47 @@
 
 #include <QString>
 #include <QDebug>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QQueue>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QElapsedTimer>
 #include <cstdlib>
+#include <vector>
 #include "cm256.h"
 #include "util/movingaverage.h"
+#include "dsp/jitterbuffercontrol.h"
 
 
-#define SDRDAEMONFEC_UDPSIZE 512               // UDP payload size
-#define SDRDAEMONFEC_NBORIGINALBLOCKS 128      // number of sample blocks per frame excluding FEC blocks
+#define SDRDAEMONFEC_UDPSIZE 512               // default UDP payload size
+#define SDRDAEMONFEC_MAXUDPSIZE 9000           // largest UDP payload accepted (jumbo frames)
+#define SDRDAEMONFEC_NBORIGINALBLOCKS 128      // default number of sample blocks per frame excluding FEC blocks
 #define SDRDAEMONFEC_NBDECODERSLOTS 16         // power of two sub multiple of uint16_t size. A too large one is superfluous.
-
+#define SDRDAEMONFEC_MAXDECODERTHREADS 4       // upper limit of the FEC decoding thread pool
+#define SDRDAEMONFEC_TARGETLATENCYMS 250       // default target latency
+
+/**
+ * The geometry of the stream (UDP payload size and number of original blocks per frame) is not fixed.
+ * Both are taken from a block zero with a valid meta data CRC: the payload size is the size of this
+ * datagram and the number of original blocks is given by its meta data. Senders may announce the
+ * payload size in the meta data with the block size indicator. As this field is not covered by the
+ * CRC it must match the datagram size. Other datagrams whose size differs from the current payload
+ * size are counted and dropped. Decoder slots and the samples buffer are resized when the geometry
+ * changes.
+ *
+ * Frames that need FEC recovery are decoded by a small thread pool so that the CM256 decoding does
+ * not hold the network receive path. Completed frames are finalized (meta data and stats) in frame
+ * order as their decoding completes. A slot is not reused before its decoding is finalized.
+ *
+ * The read index is kept at a target latency behind the start of the frame being received. The
+ * reader consumes the samples through a drift resampler at the ratio given by getResamplingRatio()
+ * which follows the sender clock estimated from the frames timestamps and corrects the latency.
+ * The read index is only moved back to the target latency when the reads are about to overtake
+ * the writes or the writes the reads. Several complete frames may be under FEC decoding at once
+ * and the decoder threads write the recovered blocks into the samples buffer so reads must stay
+ * before the oldest frame pending finalization and must not go past getReadableNbSamples().
+ */
 class SDRdaemonFECBuffer
 {
 public:
@@ -36,13 +68,14 @@ public:
     {
         uint32_t m_centerFrequency;   //!<  4 center frequency in kHz
         uint32_t m_sampleRate;        //!<  8 sample rate in Hz
-        uint8_t  m_sampleBytes;       //!<  9 MSB(4): indicators, LSB(4) number of bytes per sample
+        uint8_t  m_sampleBytes;       //!<  9 MSB(4): indicators (m_blockSizeIndicator), LSB(4) number of bytes per sample
         uint8_t  m_sampleBits;        //!< 10 number of effective bits per sample
         uint8_t  m_nbOriginalBlocks;  //!< 11 number of blocks with original (protected) data
         uint8_t  m_nbFECBlocks;       //!< 12 number of blocks carrying FEC
         uint32_t m_tv_sec;            //!< 16 seconds of timestamp at start time of super-frame processing
         uint32_t m_tv_usec;           //!< 20 microseconds of timestamp at start time of super-frame processing
         uint32_t m_crc32;             //!< 24 CRC32 of the above
+        uint16_t m_blockSize;         //!< 26 UDP payload size. Valid only with the block size indicator
 
         bool operator==(const MetaDataFEC& rhs)
         {
@@ -67,20 +100,6 @@ public:
         uint8_t  blockIndex;
         uint8_t  filler;
     };
-
-    static const int samplesPerBlock = (SDRDAEMONFEC_UDPSIZE - sizeof(Header)) / sizeof(Sample);
-    static const int framesSize = SDRDAEMONFEC_NBDECODERSLOTS * (SDRDAEMONFEC_NBORIGINALBLOCKS - 1) * (SDRDAEMONFEC_UDPSIZE - sizeof(Header));
-
-    struct ProtectedBlock
-    {
-        Sample samples[samplesPerBlock];
-    };
-
-    struct SuperBlock
-    {
-        Header         header;
-        ProtectedBlock protectedBlock;
-    };
 #pragma pack(pop)
 
 	SDRdaemonFECBuffer(uint32_t throttlems);
@@ -94,6 +113,25 @@ public:
 	// meta data
 	const MetaDataFEC& getCurrentMeta() const { return m_currentMeta; }
 
+	// stream geometry
+	/** Resizes the decoder slots and samples buffer for this geometry and restarts decoding. Returns false if it is not valid */
+	bool setGeometry(int udpPayloadSize, int nbOriginalBlocks);
+	int getUDPPayloadSize() const { return m_udpPayloadSize; }
+	int getNbOriginalBlocks() const { return m_nbOriginalBlocks; }
+	int getNbDecoderSlots() const { return m_nbDecoderSlots; }
+	int getBufferNbSamples() const { return m_framesNbBytes / m_iqSampleSize; }
+	/** Samples that can be read before the frame being received or the oldest frame that may still be FEC decoding */
+	int getReadableNbSamples() const { return getReadableBytes(m_decoderIndexHead) / m_iqSampleSize; }
+	uint32_t getNbSizeDrops() const { return m_nbSizeDrops; } //!< datagrams dropped as their size does not match the stream since start
+
+	// latency control
+	/** Sets the target latency. It is bounded by the frame duration and the buffer length. Restarts reading */
+	void setTargetLatency(int targetLatencyMs);
+	int getTargetLatencyMs() const;                                               //!< effective target latency
+	double getResamplingRatio() const { return m_jitterControl.getRatio(); }      //!< input samples to read per output sample
+	float getClockDriftPPM() const { return m_jitterControl.getDriftPPM(); }
+	float getLatencyMs() const;                                                   //!< smoothed latency
+
 	// samples timestamp
 	uint32_t getTVOutSec() const { return m_tvOut_sec; }
 	uint32_t getTVOutUsec() const { return m_tvOut_usec; }
@@ -117,7 +155,7 @@ public:
     int getMinOriginalBlocks()
     {
         int minOriginalBlocks = m_minOriginalBlocks;
-        m_minOriginalBlocks = 128;
+        m_minOriginalBlocks = m_nbOriginalBlocks;
         return minOriginalBlocks;
     }
 
@@ -128,6 +166,23 @@ public:
         return maxNbRecovery;
     }
 
+    float getAvgDecodeLatencyUs() const { return m_avgDecodeLatencyUs; } //!< from frame completion to end of FEC decoding
+    int getDecodeQueueDepth() const { return m_nbDecodesPending; }       //!< frames handed to the decoders and not yet finalized
+
+    int getMaxDecodeLatencyUs()
+    {
+        int maxDecodeLatencyUs = m_maxDecodeLatencyUs;
+        m_maxDecodeLatencyUs = 0;
+        return maxDecodeLatencyUs;
+    }
+
+    int getMaxDecodeQueueDepth()
+    {
+        int maxDecodeQueueDepth = m_maxDecodeQueueDepth;
+        m_maxDecodeQueueDepth = m_nbDecodesPending;
+        return maxDecodeQueueDepth;
+    }
+
     bool allFramesDecoded()
     {
         bool framesDecoded = m_framesDecoded;
@@ -136,9 +191,8 @@ public:
     }
 
     float getBufferLengthInSecs() const { return m_bufferLenSec; }
-    int32_t getRWBalanceCorrection() const { return m_balCorrection; }
 
-    /** Get buffer gauge value in % of buffer size ([-50:50])
+    /** Get buffer gauge value in % of buffer size ([-50:50]) of the deviation from the target latency
      *  [-50:0] : write leads or read lags
      *  [0:50]  : read leads or write lags
      */
@@ -146,10 +200,8 @@ public:
     {
         if (m_framesNbBytes)
         {
-            int32_t val = (m_wrDeltaEstimate * 100) / (int32_t) m_framesNbBytes;
-            int32_t ret = val < 0 ? -val - 50 : 50 -val;
-            int32_t rp  = (m_readIndex * 100) / (int32_t) m_framesNbBytes;
-            return ret;
+            int32_t val = ((m_targetLatencyBytes - m_latencyBytes) * 100) / (int32_t) m_framesNbBytes;
+            return val < -50 ? -50 : val > 50 ? 50 : val;
         }
         else
         {
@@ -157,38 +209,55 @@ public:
         }
     }
 
-    static const int m_udpPayloadSize = SDRDAEMONFEC_UDPSIZE;
-    static const int m_nbOriginalBlocks = SDRDAEMONFEC_NBORIGINALBLOCKS;
+    static const int m_defaultUDPPayloadSize = SDRDAEMONFEC_UDPSIZE;
+    static const int m_maxUDPPayloadSize = SDRDAEMONFEC_MAXUDPSIZE;
+    static const int m_defaultNbOriginalBlocks = SDRDAEMONFEC_NBORIGINALBLOCKS;
+    static const uint8_t m_blockSizeIndicator = 0x20; //!< in m_sampleBytes of the meta data: m_blockSize is set
 	static const int m_sampleSize;
 	static const int m_iqSampleSize;
 
 private:
-    static const int nbDecoderSlots = SDRDAEMONFEC_NBDECODERSLOTS;
-
-#pragma pack(push, 1)
-    struct BufferFrame
-    {
-        ProtectedBlock  m_blocks[m_nbOriginalBlocks - 1];
-    };
-#pragma pack(pop)
-
     struct DecoderSlot
     {
-        ProtectedBlock       m_blockZero;                                 //!< First block of a frame. Has meta data.
-        ProtectedBlock       m_originalBlocks[m_nbOriginalBlocks];        //!< Original blocks retrieved directly or by later FEC
-        ProtectedBlock       m_recoveryBlocks[m_nbOriginalBlocks];        //!< Recovery blocks (FEC blocks) with max size
-        CM256::cm256_block   m_cm256DescriptorBlocks[m_nbOriginalBlocks]; //!< CM256 decoder descriptors (block addresses and block indexes)
+        uint8_t             *m_blockZero;              //!< First block of a frame. Has meta data.
+        uint8_t             *m_recoveryBlocks;         //!< Recovery blocks (FEC blocks) with max number of original blocks
+        CM256::cm256_block  *m_cm256DescriptorBlocks;  //!< CM256 decoder descriptors (block addresses and block indexes)
         int                  m_blockCount;         //!< number of blocks received for this frame
         int                  m_originalCount;      //!< number of original blocks received
         int                  m_recoveryCount;      //!< number of recovery blocks received
         bool                 m_decoded;            //!< true if decoded
         bool                 m_metaRetrieved;      //!< true if meta data (block zero) was retrieved
+        bool                 m_pending;            //!< complete frame waiting to be finalized in frame order
+        bool                 m_decodeJob;          //!< the frame was handed to the FEC decoders
+        bool                 m_decodeDone;         //!< FEC decoding finished (protected by m_decodeMutex)
+        QElapsedTimer        m_decodeTimer;        //!< started when the frame is handed to the decoders
+        int                  m_decodeLatencyUs;    //!< time from hand over to end of FEC decoding
+        uint16_t             m_frameIndex;         //!< index of the frame held in the slot
     };
 
+    class Decoder : public QRunnable
+    {
+    public:
+        Decoder(SDRdaemonFECBuffer *buffer, int slotIndex) : m_buffer(buffer), m_slotIndex(slotIndex) { setAutoDelete(false); }
+        virtual void run();
+        CM256::cm256_encoder_params m_paramsCM256; //!< parameters of the frame being decoded
+    private:
+        SDRdaemonFECBuffer *m_buffer;
+        int m_slotIndex;
+    };
+
+    int                  m_udpPayloadSize;       //!< current size of the datagrams
+    int                  m_blockBytes;           //!< bytes of data in a block i.e. payload less header
+    int                  m_nbOriginalBlocks;     //!< current number of original blocks per frame
+    int                  m_nbDecoderSlots;       //!< number of frames held in the buffer
+    int                  m_frameBytes;           //!< bytes of samples in a frame (all original blocks but block zero)
+    uint32_t             m_nbSizeDrops;          //!< datagrams dropped as their size does not match the stream
     MetaDataFEC          m_currentMeta;          //!< Stored current meta data
     CM256::cm256_encoder_params m_paramsCM256;          //!< CM256 decoder parameters block
-    DecoderSlot          m_decoderSlots[nbDecoderSlots]; //!< CM256 decoding control/buffer slots
-    BufferFrame          m_frames[nbDecoderSlots];       //!< Samples buffer
+    std::vector<DecoderSlot> m_decoderSlots;             //!< CM256 decoding control/buffer slots
+    std::vector<uint8_t> m_slotBlocks;                   //!< storage of block zero and recovery blocks of all slots
+    std::vector<CM256::cm256_block> m_slotDescriptors;   //!< storage of CM256 descriptors of all slots
+    std::vector<uint8_t> m_frames;                       //!< Samples buffer
     int                  m_framesNbBytes;                //!< Number of bytes in samples buffer
     int                  m_decoderIndexHead;     //!< index of the current head frame slot in decoding slots
     int                  m_frameHead;            //!< index of the current head frame sent
@@ -202,11 +271,23 @@ private:
     MovingAverage<int, int, 10> m_avgOrigBlocks; //!< (stats) average number of original blocks received
     MovingAverage<int, int, 10> m_avgNbRecovery; //!< (stats) average number of recovery blocks used
     bool                 m_framesDecoded;        //!< [stats] true if all frames were decoded since last poll
+    int                  m_nbDecodesPending;     //!< (stats) frames handed to the decoders and not yet finalized
+    int                  m_maxDecodeQueueDepth;  //!< (stats) maximum number of pending decodes since last poll
+    int                  m_maxDecodeLatencyUs;   //!< (stats) maximum decode latency since last poll
+    int                  m_nbDecoderThreads;     //!< number of frames that may be FEC decoding at once
+    MovingAverage<int, int, 10> m_avgDecodeLatencyUs; //!< (stats) average decode latency
     int                  m_readIndex;            //!< current byte read index in frames buffer
     int                  m_wrDeltaEstimate;      //!< Sampled estimate of write to read indexes difference
+    int                  m_latencyBytes;         //!< Write to read distance at the last frame break
+    int                  m_targetLatencyMs;      //!< Requested latency
+    int                  m_targetLatencyBytes;   //!< Effective target write to read distance
+    JitterBufferControl  m_jitterControl;        //!< Stream clock estimation and latency control
+    bool                 m_frameCountValid;      //!< m_frameCount can be followed from m_lastFrameIndex
+    uint16_t             m_lastFrameIndex;       //!< Index of the last finalized frame with meta data
+    int64_t              m_frameCount;           //!< Frames of the stream since the start of the clock estimation
     uint32_t             m_tvOut_sec;            //!< Estimated returned samples timestamp (seconds)
     uint32_t             m_tvOut_usec;           //!< Estimated returned samples timestamp (microseconds)
-    int                  m_readNbBytes;          //!< Nominal number of bytes per read (50ms)
+    int                  m_readNbBytes;          //!< Nominal number of bytes per read
 
 	uint32_t m_throttlemsNominal;  //!< Initial throttle in ms
     uint8_t* m_readBuffer;         //!< Read buffer to hold samples when looping back to beginning of raw buffer
@@ -214,58 +295,58 @@ private:
 
     float    m_bufferLenSec;
 
-    int      m_nbReads;       //!< Number of buffer reads since start of auto R/W balance correction period
-    int      m_nbWrites;      //!< Number of buffer writes since start of auto R/W balance correction period
-    int      m_balCorrection; //!< R/W balance correction in number of samples
-    int      m_balCorrLimit;  //!< Correction absolute value limit in number of samples
     CM256    m_cm256;         //!< CM256 library
     bool     m_cm256_OK;      //!< CM256 library initialized OK
+    std::vector<Decoder*> m_decoders;  //!< one decoding job per decoder slot
+    QQueue<int>    m_pendingSlots;     //!< complete frames slot indexes in frame order
+    QMutex         m_decodeMutex;      //!< protects the decode done flags
+    QWaitCondition m_decodeDone;       //!< signaled when a decoding finishes
+    QThreadPool    m_decoderPool;      //!< FEC decoding threads
 
-    inline ProtectedBlock* storeOriginalBlock(int slotIndex, int blockIndex, const ProtectedBlock& protectedBlock)
+    inline uint8_t* getOriginalBlock(int slotIndex, int blockIndex)
     {
         if (blockIndex == 0) {
-            // m_decoderSlots[slotIndex].m_originalBlocks[0] = protectedBlock;
-            // return &m_decoderSlots[slotIndex].m_originalBlocks[0];
-            m_decoderSlots[slotIndex].m_blockZero = protectedBlock;
-            return &m_decoderSlots[slotIndex].m_blockZero;
+            return m_decoderSlots[slotIndex].m_blockZero;
         } else {
-            // m_decoderSlots[slotIndex].m_originalBlocks[blockIndex] = protectedBlock;
-            // return &m_decoderSlots[slotIndex].m_originalBlocks[blockIndex];
-            m_frames[slotIndex].m_blocks[blockIndex - 1] = protectedBlock;
-            return &m_frames[slotIndex].m_blocks[blockIndex - 1];
+            return &m_frames[slotIndex * m_frameBytes + (blockIndex - 1) * m_blockBytes];
         }
     }
 
-    inline ProtectedBlock& getOriginalBlock(int slotIndex, int blockIndex)
+    inline uint8_t* storeOriginalBlock(int slotIndex, int blockIndex, const uint8_t *block)
     {
-        if (blockIndex == 0) {
-            // return m_decoderSlots[slotIndex].m_originalBlocks[0];
-            return m_decoderSlots[slotIndex].m_blockZero;
-        } else {
-            // return m_decoderSlots[slotIndex].m_originalBlocks[blockIndex];
-            return m_frames[slotIndex].m_blocks[blockIndex - 1];
-        }
+        uint8_t *originalBlock = getOriginalBlock(slotIndex, blockIndex);
+        memcpy((void *) originalBlock, (const void *) block, m_blockBytes);
+        return originalBlock;
     }
 
     inline MetaDataFEC *getMetaData(int slotIndex)
     {
-        // return (MetaDataFEC *) &m_decoderSlots[slotIndex].m_originalBlocks[0];
-        return (MetaDataFEC *) &m_decoderSlots[slotIndex].m_blockZero;
+        return (MetaDataFEC *) m_decoderSlots[slotIndex].m_blockZero;
     }
 
     inline void resetOriginalBlocks(int slotIndex)
     {
-        // memset((void *) m_decoderSlots[slotIndex].m_originalBlocks, 0, m_nbOriginalBlocks * sizeof(ProtectedBlock));
-        memset((void *) &m_decoderSlots[slotIndex].m_blockZero, 0, sizeof(ProtectedBlock));
-        memset((void *) m_frames[slotIndex].m_blocks, 0, (m_nbOriginalBlocks - 1) * sizeof(ProtectedBlock));
+        memset((void *) m_decoderSlots[slotIndex].m_blockZero, 0, m_blockBytes);
+        memset((void *) &m_frames[slotIndex * m_frameBytes], 0, m_frameBytes);
     }
 
     void initDecodeAllSlots();
     void initReadIndex();
-    void rwCorrectionEstimate(int slotIndex);
+    void updateTargetLatency();
+    void latencyControl(int slotIndex);
+    int getReadableBytes(int slotIndex) const; //!< bytes from the read index to the oldest pending frame or this slot if none
     void checkSlotData(int slotIndex);
     void initDecodeSlot(int slotIndex);
-
+    bool checkGeometry(const MetaDataFEC *metaData); //!< follows a new number of original blocks. Returns true if decoding restarted
+    bool checkBlockSize(const char *array, uint32_t length); //!< follows a new payload size announced by a valid block zero. Returns true if decoding restarted
+    void completeFrame(int slotIndex);  //!< hands the complete frame to the decoders if it needs recovery and queues it for finalization
+    void decodeSlot(int slotIndex, const CM256::cm256_encoder_params& paramsCM256); //!< runs in the decoder threads
+    void finalizeFrames();              //!< finalizes the frames at the head of the queue that are decoded
+    void waitFrames(int slotIndex);     //!< finalizes the frames up to this slot waiting for their decoding. -1 for all
+    void finalizeSlot(int slotIndex);
+    void deleteDecoders();
+
+    static bool checkMetaCRC(const MetaDataFEC *metaData);
     static void printMeta(const QString& header, MetaDataFEC *metaData);
 };
 
@@ -38,6 +38,7 @@
 #include "util/simpleserializer.h"
 
 #include "sdrdaemonfecgui.h"
+#include "sdrdaemonfecbuffer.h"
 
 #include <device/devicesourceapi.h>
 #include <dsp/filerecord.h>
@@ -64,8 +65,17 @@ SDRdaemonFECGui::SDRdaemonFECGui(DeviceSourceAPI *deviceAPI, QWidget* parent) :
 	m_initSendConfiguration(false),
 	m_dcBlock(false),
 	m_iqCorrection(false),
+	m_targetLatencyMs(SDRDAEMONFEC_TARGETLATENCYMS),
 	m_nbOriginalBlocks(128),
-	m_nbFECBlocks(0)
+	m_nbFECBlocks(0),
+	m_nbKernelDrops(0),
+	m_nbSizeDrops(0),
+	m_avgDecodeLatencyUs(0.0f),
+	m_maxDecodeLatencyUs(0),
+	m_maxDecodeQueueDepth(0),
+	m_latencyMs(0.0f),
+	m_effectiveTargetLatencyMs(0),
+	m_clockDriftPPM(0.0f)
 {
 	m_sender = nn_socket(AF_SP, NN_PAIR);
 	assert(m_sender != -1);
@@ -134,6 +144,7 @@ void SDRdaemonFECGui::resetToDefaults()
 	m_controlPort = 9091;
 	m_dcBlock = false;
 	m_iqCorrection = false;
+	m_targetLatencyMs = SDRDAEMONFEC_TARGETLATENCYMS;
 	displaySettings();
 }
 
@@ -177,6 +188,7 @@ QByteArray SDRdaemonFECGui::serialize() const
 	}
 
 	s.writeString(10, ui->specificParms->text());
+	s.writeS32(11, m_targetLatencyMs);
 
 	return s.final();
 }
@@ -194,6 +206,7 @@ bool SDRdaemonFECGui::deserialize(const QByteArray& data)
     uint32_t confDecim;
     uint32_t confFcPos;
     QString confSpecificParms;
+    int targetLatencyMs;
 
 	if (!d.isValid())
 	{
@@ -229,6 +242,7 @@ bool SDRdaemonFECGui::deserialize(const QByteArray& data)
 		d.readU32(8, &confFcPos, 2);
 		d.readU32(9, &confSampleRate, 1000);
 		d.readString(10, &confSpecificParms, "");
+		d.readS32(11, &targetLatencyMs, SDRDAEMONFEC_TARGETLATENCYMS);
 
 		if ((address != m_address) || (dataPort != m_dataPort))
 		{
@@ -244,6 +258,12 @@ bool SDRdaemonFECGui::deserialize(const QByteArray& data)
 			configureAutoCorrections();
 		}
 
+		if (targetLatencyMs != m_targetLatencyMs)
+		{
+			m_targetLatencyMs = targetLatencyMs;
+			configureLatency();
+		}
+
 		displaySettings();
 		displayConfigurationParameters(confFrequency, confDecim, confFcPos, confSampleRate, confSpecificParms);
 		m_initSendConfiguration = true;
@@ -304,6 +324,14 @@ bool SDRdaemonFECGui::handleMessage(const Message& message)
         m_avgNbRecovery = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getAvgNbRecovery();
         m_nbOriginalBlocks = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getNbOriginalBlocksPerFrame();
         m_nbFECBlocks = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getNbFECBlocksPerFrame();
+        m_nbKernelDrops = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getNbKernelDrops();
+        m_nbSizeDrops = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getNbSizeDrops();
+        m_avgDecodeLatencyUs = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getAvgDecodeLatencyUs();
+        m_maxDecodeLatencyUs = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getMaxDecodeLatencyUs();
+        m_maxDecodeQueueDepth = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getMaxDecodeQueueDepth();
+        m_latencyMs = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getLatencyMs();
+        m_effectiveTargetLatencyMs = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getTargetLatencyMs();
+        m_clockDriftPPM = ((SDRdaemonFECInput::MsgReportSDRdaemonFECStreamTiming&)message).getClockDriftPPM();
 
 		updateWithStreamTime();
 		return true;
@@ -365,6 +393,8 @@ void SDRdaemonFECGui::displaySettings()
 	ui->controlPort->setText(QString::number(m_controlPort));
 	ui->dcOffset->setChecked(m_dcBlock);
 	ui->iqImbalance->setChecked(m_iqCorrection);
+	ui->targetLatency->setValue(m_targetLatencyMs / 10);
+	ui->targetLatencyText->setText(tr("%1").arg(m_targetLatencyMs));
 }
 
 void SDRdaemonFECGui::displayConfigurationParameters(uint32_t freq,
@@ -516,6 +546,17 @@ void SDRdaemonFECGui::on_iqImbalance_toggled(bool checked)
 	}
 }
 
+void SDRdaemonFECGui::on_targetLatency_valueChanged(int value)
+{
+	ui->targetLatencyText->setText(tr("%1").arg(value * 10));
+
+	if (m_targetLatencyMs != value * 10)
+	{
+		m_targetLatencyMs = value * 10;
+		configureLatency();
+	}
+}
+
 void SDRdaemonFECGui::on_freq_textEdited(const QString& arg1)
 {
 	ui->sendButton->setEnabled(true);
@@ -563,6 +604,8 @@ void SDRdaemonFECGui::on_record_toggled(bool checked)
     if (checked)
     {
         ui->record->setStyleSheet("QToolButton { background-color : red; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device"));
+        m_fileSink->setCompression(m_deviceAPI->getRecordCompression());
         m_fileSink->startRecording();
     }
     else
@@ -587,6 +630,12 @@ void SDRdaemonFECGui::configureAutoCorrections()
 	m_sampleSource->getInputMessageQueue()->push(message);
 }
 
+void SDRdaemonFECGui::configureLatency()
+{
+	SDRdaemonFECInput::MsgConfigureSDRdaemonLatency* message = SDRdaemonFECInput::MsgConfigureSDRdaemonLatency::create(m_targetLatencyMs);
+	m_sampleSource->getInputMessageQueue()->push(message);
+}
+
 void SDRdaemonFECGui::updateWithAcquisition()
 {
 }
@@ -651,6 +700,20 @@ void SDRdaemonFECGui::updateWithStreamTime()
     s = QString::number(m_nbOriginalBlocks + m_nbFECBlocks, 'f', 0);
     QString s1 = QString::number(m_nbFECBlocks, 'f', 0);
     ui->nominalNbBlocksText->setText(tr("%1/%2").arg(s).arg(s1));
+
+    ui->kernelDropsText->setText(tr("%1/%2").arg(m_nbKernelDrops).arg(m_nbSizeDrops));
+
+    s = QString::number(m_avgDecodeLatencyUs / 1000.0f, 'f', 1);
+    s1 = QString::number(m_maxDecodeLatencyUs / 1000.0f, 'f', 1);
+    ui->decodeLatencyText->setText(tr("%1/%2").arg(s).arg(s1));
+
+    ui->decodeQueueText->setText(tr("%1").arg(m_maxDecodeQueueDepth));
+
+    s = QString::number(m_latencyMs, 'f', 0);
+    ui->latencyText->setText(tr("%1/%2").arg(s).arg(m_effectiveTargetLatencyMs));
+
+    s = QString::number(m_clockDriftPPM, 'f', 1);
+    ui->clockDriftText->setText(tr("%1").arg(s));
 }
 
 void SDRdaemonFECGui::updateStatus()
@@ -680,6 +743,12 @@ void SDRdaemonFECGui::updateStatus()
 
         m_lastEngineState = state;
     }
+
+    if (ui->record->isChecked() && (m_fileSink->getDroppedCount() > 0)) // the disk does not keep up
+    {
+        ui->record->setStyleSheet("QToolButton { background-color : magenta; }");
+        ui->record->setToolTip(tr("Toggle record I/Q samples from device (%1 samples dropped)").arg(m_fileSink->getDroppedCount()));
+    }
 }
 
 void SDRdaemonFECGui::tick()
@@ -76,6 +76,14 @@ private:
     float m_avgNbRecovery;
     int m_nbOriginalBlocks;
     int m_nbFECBlocks;
+    uint32_t m_nbKernelDrops;
+    uint32_t m_nbSizeDrops;
+    float m_avgDecodeLatencyUs;
+    int m_maxDecodeLatencyUs;
+    int m_maxDecodeQueueDepth;
+    float m_latencyMs;
+    int m_effectiveTargetLatencyMs;
+    float m_clockDriftPPM;
 
 	int m_samplesCount;
 	std::size_t m_tickCount;
@@ -91,6 +99,7 @@ private:
 
 	bool m_dcBlock;
 	bool m_iqCorrection;
+	int m_targetLatencyMs;
 
     QPalette m_paletteGreenText;
     QPalette m_paletteWhiteText;
@@ -106,6 +115,7 @@ private:
 	void displayTime();
 	void configureUDPLink();
 	void configureAutoCorrections();
+	void configureLatency();
 	void updateWithAcquisition();
 	void updateWithStreamData();
 	void updateWithStreamTime();
@@ -118,6 +128,7 @@ private slots:
 	void on_applyButton_clicked(bool checked);
 	void on_dcOffset_toggled(bool checked);
 	void on_iqImbalance_toggled(bool checked);
+	void on_targetLatency_valueChanged(int value);
 	void on_address_textEdited(const QString& arg1);
 	void on_dataPort_textEdited(const QString& arg1);
 	void on_controlPort_textEdited(const QString& arg1);
@@ -31,6 +31,7 @@
 
 MESSAGE_CLASS_DEFINITION(SDRdaemonFECInput::MsgConfigureSDRdaemonUDPLink, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonFECInput::MsgConfigureSDRdaemonAutoCorr, Message)
+MESSAGE_CLASS_DEFINITION(SDRdaemonFECInput::MsgConfigureSDRdaemonLatency, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonFECInput::MsgConfigureSDRdaemonWork, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonFECInput::MsgConfigureSDRdaemonStreamTiming, Message)
 MESSAGE_CLASS_DEFINITION(SDRdaemonFECInput::MsgReportSDRdaemonAcquisition, Message)
@@ -120,6 +121,12 @@ bool SDRdaemonFECInput::handleMessage(const Message& message)
 		m_deviceAPI->configureCorrections(dcBlock, iqImbalance);
 		return true;
 	}
+	else if (MsgConfigureSDRdaemonLatency::match(message))
+	{
+		MsgConfigureSDRdaemonLatency& conf = (MsgConfigureSDRdaemonLatency&) message;
+		m_SDRdaemonUDPHandler->setTargetLatency(conf.getTargetLatencyMs());
+		return true;
+	}
 	else if (MsgConfigureSDRdaemonWork::match(message))
 	{
 		MsgConfigureSDRdaemonWork& conf = (MsgConfigureSDRdaemonWork&) message;
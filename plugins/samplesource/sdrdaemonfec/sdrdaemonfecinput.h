@@ -74,6 +74,26 @@ public:
 		{ }
 	};
 
+	class MsgConfigureSDRdaemonLatency : public Message {
+		MESSAGE_CLASS_DECLARATION
+
+	public:
+		int getTargetLatencyMs() const { return m_targetLatencyMs; }
+
+		static MsgConfigureSDRdaemonLatency* create(int targetLatencyMs)
+		{
+			return new MsgConfigureSDRdaemonLatency(targetLatencyMs);
+		}
+
+	private:
+		int m_targetLatencyMs;
+
+		MsgConfigureSDRdaemonLatency(int targetLatencyMs) :
+			Message(),
+			m_targetLatencyMs(targetLatencyMs)
+		{ }
+	};
+
 	class MsgConfigureSDRdaemonWork : public Message {
 		MESSAGE_CLASS_DECLARATION
 
@@ -178,6 +198,14 @@ public:
         float getAvgNbRecovery() const { return m_avgNbRecovery; }
         int getNbOriginalBlocksPerFrame() const { return m_nbOriginalBlocksPerFrame; }
         int getNbFECBlocksPerFrame() const { return m_nbFECBlocksPerFrame; }
+        uint32_t getNbKernelDrops() const { return m_nbKernelDrops; }
+        uint32_t getNbSizeDrops() const { return m_nbSizeDrops; }
+        float getAvgDecodeLatencyUs() const { return m_avgDecodeLatencyUs; }
+        int getMaxDecodeLatencyUs() const { return m_maxDecodeLatencyUs; }
+        int getMaxDecodeQueueDepth() const { return m_maxDecodeQueueDepth; }
+        float getLatencyMs() const { return m_latencyMs; }
+        int getTargetLatencyMs() const { return m_targetLatencyMs; }
+        float getClockDriftPPM() const { return m_clockDriftPPM; }
 
 		static MsgReportSDRdaemonFECStreamTiming* create(uint32_t tv_sec,
 				uint32_t tv_usec,
@@ -192,7 +220,15 @@ public:
                 float avgNbOriginalBlocks,
                 float avgNbRecovery,
                 int nbOriginalBlocksPerFrame,
-                int nbFECBlocksPerFrame)
+                int nbFECBlocksPerFrame,
+                uint32_t nbKernelDrops,
+                uint32_t nbSizeDrops,
+                float avgDecodeLatencyUs,
+                int maxDecodeLatencyUs,
+                int maxDecodeQueueDepth,
+                float latencyMs,
+                int targetLatencyMs,
+                float clockDriftPPM)
 		{
 			return new MsgReportSDRdaemonFECStreamTiming(tv_sec,
 					tv_usec,
@@ -207,7 +243,15 @@ public:
                     avgNbOriginalBlocks,
                     avgNbRecovery,
                     nbOriginalBlocksPerFrame,
-                    nbFECBlocksPerFrame);
+                    nbFECBlocksPerFrame,
+                    nbKernelDrops,
+                    nbSizeDrops,
+                    avgDecodeLatencyUs,
+                    maxDecodeLatencyUs,
+                    maxDecodeQueueDepth,
+                    latencyMs,
+                    targetLatencyMs,
+                    clockDriftPPM);
 		}
 
 	protected:
@@ -225,6 +269,14 @@ public:
         float    m_avgNbRecovery;
         int      m_nbOriginalBlocksPerFrame;
         int      m_nbFECBlocksPerFrame;
+        uint32_t m_nbKernelDrops;     //!< datagrams dropped by the kernel receive queue since start
+        uint32_t m_nbSizeDrops;       //!< datagrams dropped as their size does not match the stream since start
+        float    m_avgDecodeLatencyUs;  //!< FEC decoding latency moving average
+        int      m_maxDecodeLatencyUs;  //!< FEC decoding maximum latency since last poll
+        int      m_maxDecodeQueueDepth; //!< maximum number of frames waiting for FEC decoding since last poll
+        float    m_latencyMs;           //!< main buffer smoothed latency
+        int      m_targetLatencyMs;     //!< main buffer effective target latency
+        float    m_clockDriftPPM;       //!< estimated stream clock drift
 
 		MsgReportSDRdaemonFECStreamTiming(uint32_t tv_sec,
 				uint32_t tv_usec,
@@ -239,7 +291,15 @@ public:
                 float avgNbOriginalBlocks,
                 float avgNbRecovery,
                 int nbOriginalBlocksPerFrame,
-                int nbFECBlocksPerFrame) :
+                int nbFECBlocksPerFrame,
+                uint32_t nbKernelDrops,
+                uint32_t nbSizeDrops,
+                float avgDecodeLatencyUs,
+                int maxDecodeLatencyUs,
+                int maxDecodeQueueDepth,
+                float latencyMs,
+                int targetLatencyMs,
+                float clockDriftPPM) :
 			Message(),
 			m_tv_sec(tv_sec),
 			m_tv_usec(tv_usec),
@@ -254,7 +314,15 @@ public:
             m_avgNbOriginalBlocks(avgNbOriginalBlocks),
             m_avgNbRecovery(avgNbRecovery),
             m_nbOriginalBlocksPerFrame(nbOriginalBlocksPerFrame),
-            m_nbFECBlocksPerFrame(nbFECBlocksPerFrame)
+            m_nbFECBlocksPerFrame(nbFECBlocksPerFrame),
+            m_nbKernelDrops(nbKernelDrops),
+            m_nbSizeDrops(nbSizeDrops),
+            m_avgDecodeLatencyUs(avgDecodeLatencyUs),
+            m_maxDecodeLatencyUs(maxDecodeLatencyUs),
+            m_maxDecodeQueueDepth(maxDecodeQueueDepth),
+            m_latencyMs(latencyMs),
+            m_targetLatencyMs(targetLatencyMs),
+            m_clockDriftPPM(clockDriftPPM)
 		{ }
 	};
 
@@ -14,9 +14,9 @@
 // along with this program. If not, see <http://www.gnu.org/licenses/>.          //
 ///////////////////////////////////////////////////////////////////////////////////
 
-#include <QUdpSocket>
 #include <QDebug>
 #include <QTimer>
+#include <QMutexLocker>
 #include <unistd.h>
 
 #include "dsp/dspcommands.h"
@@ -27,14 +27,11 @@
 
 SDRdaemonFECUDPHandler::SDRdaemonFECUDPHandler(SampleSinkFifo *sampleFifo, MessageQueue *outputMessageQueueToGUI, DeviceSourceAPI *devieAPI) :
     m_deviceAPI(devieAPI),
-	m_sdrDaemonBuffer(m_rateDivider),
-	m_dataSocket(0),
+	m_sdrDaemonBuffer(SDRDAEMONFEC_THROTTLE_MS),
+	m_udpReceiver(m_sdrDaemonBuffer, m_bufferMutex),
 	m_dataAddress(QHostAddress::LocalHost),
-	m_remoteAddress(QHostAddress::LocalHost),
 	m_dataPort(9090),
 	m_dataConnected(false),
-	m_udpBuf(0),
-	m_udpReadBytes(0),
 	m_sampleFifo(sampleFifo),
 	m_samplerate(0),
 	m_centerFrequency(0),
@@ -45,19 +42,14 @@ SDRdaemonFECUDPHandler::SDRdaemonFECUDPHandler(SampleSinkFifo *sampleFifo, Messa
 	m_samplesCount(0),
 	m_timer(0),
     m_throttlems(SDRDAEMONFEC_THROTTLE_MS),
-    m_readLengthSamples(0),
-    m_readLength(0),
-    m_throttleToggle(false),
     m_rateDivider(1000/SDRDAEMONFEC_THROTTLE_MS),
 	m_autoCorrBuffer(true)
 {
-    m_udpBuf = new char[SDRdaemonFECBuffer::m_udpPayloadSize];
 }
 
 SDRdaemonFECUDPHandler::~SDRdaemonFECUDPHandler()
 {
 	stop();
-	delete[] m_udpBuf;
 #ifdef USE_INTERNAL_TIMER
     if (m_timer) {
         delete m_timer;
@@ -69,32 +61,15 @@ void SDRdaemonFECUDPHandler::start()
 {
 	qDebug("SDRdaemonFECUDPHandler::start");
 
-	if (!m_dataSocket)
-	{
-		m_dataSocket = new QUdpSocket(this);
-	}
-
     if (!m_dataConnected)
 	{
-        connect(m_dataSocket, SIGNAL(readyRead()), this, SLOT(dataReadyRead()), Qt::QueuedConnection); // , Qt::QueuedConnection
-
-        if (m_dataSocket->bind(m_dataAddress, m_dataPort))
-		{
-			qDebug("SDRdaemonFECUDPHandler::start: bind data socket to %s:%d", m_dataAddress.toString().toStdString().c_str(),  m_dataPort);
-			m_dataConnected = true;
-		}
-		else
-		{
-			qWarning("SDRdaemonFECUDPHandler::start: cannot bind data port %d", m_dataPort);
-	        disconnect(m_dataSocket, SIGNAL(readyRead()), this, SLOT(dataReadyRead()));
-			m_dataConnected = false;
-		}
+		m_dataConnected = m_udpReceiver.startWork(m_dataAddress, m_dataPort);
 	}
 
 	// Need to notify the DSP engine to actually start
 	DSPSignalNotification *notif = new DSPSignalNotification(m_samplerate, m_centerFrequency * 1000); // Frequency in Hz for the DSP engine
 	m_deviceAPI->getDeviceInputMessageQueue()->push(notif);
-    m_elapsedTimer.start();
+    m_pacer.start();
 }
 
 void SDRdaemonFECUDPHandler::stop()
@@ -104,13 +79,7 @@ void SDRdaemonFECUDPHandler::stop()
     if (m_dataConnected)
     {
 		m_dataConnected = false;
-	    disconnect(m_dataSocket, SIGNAL(readyRead()), this, SLOT(dataReadyRead()));
-	}
-
-	if (m_dataSocket)
-	{
-		delete m_dataSocket;
-		m_dataSocket = 0;
+		m_udpReceiver.stopWork();
 	}
 }
 
@@ -130,25 +99,8 @@ void SDRdaemonFECUDPHandler::configureUDPLink(const QString& address, quint16 po
 	start();
 }
 
-void SDRdaemonFECUDPHandler::dataReadyRead()
-{
-    m_udpReadBytes = 0;
-
-	while (m_dataSocket->hasPendingDatagrams() && m_dataConnected)
-	{
-		qint64 pendingDataSize = m_dataSocket->pendingDatagramSize();
-		m_udpReadBytes += m_dataSocket->readDatagram(&m_udpBuf[m_udpReadBytes], pendingDataSize, &m_remoteAddress, 0);
-
-		if (m_udpReadBytes == SDRdaemonFECBuffer::m_udpPayloadSize) {
-		    processData();
-		    m_udpReadBytes = 0;
-		}
-	}
-}
-
-void SDRdaemonFECUDPHandler::processData()
+void SDRdaemonFECUDPHandler::processMetaData()
 {
-    m_sdrDaemonBuffer.writeData(m_udpBuf, m_udpReadBytes);
     const SDRdaemonFECBuffer::MetaDataFEC& metaData =  m_sdrDaemonBuffer.getCurrentMeta();
 
     bool change = false;
@@ -196,29 +148,37 @@ void SDRdaemonFECUDPHandler::connectTimer(const QTimer* timer)
     connect(timer, SIGNAL(timeout()), this, SLOT(tick()));
 #endif
     m_rateDivider = 1000 / m_throttlems;
+    m_pacer.setTickMs(m_throttlems);
+}
+
+void SDRdaemonFECUDPHandler::setTargetLatency(int targetLatencyMs)
+{
+    QMutexLocker locker(&m_bufferMutex);
+    m_sdrDaemonBuffer.setTargetLatency(targetLatencyMs);
 }
 
 void SDRdaemonFECUDPHandler::tick()
 {
-    // auto throttling
-    int throttlems = m_elapsedTimer.restart();
+    QMutexLocker locker(&m_bufferMutex); // the receiver thread writes the buffer
 
-    if (throttlems != m_throttlems)
-    {
-        m_throttlems = throttlems;
-        m_readLengthSamples = (m_sdrDaemonBuffer.getCurrentMeta().m_sampleRate * (m_throttlems+(m_throttleToggle ? 1 : 0))) / 1000;
-        m_throttleToggle = !m_throttleToggle;
-    }
+    processMetaData();
 
-    if (m_autoCorrBuffer) {
-        m_readLengthSamples += m_sdrDaemonBuffer.getRWBalanceCorrection();
-    }
+    // output at the nominal sample rate in local time and read the stream at the rate of its own clock
+    int nbOutputSamples = m_pacer.getNbOutputSamples(m_sdrDaemonBuffer.getCurrentMeta().m_sampleRate);
+    m_pacer.setRatio(m_autoCorrBuffer ? m_sdrDaemonBuffer.getResamplingRatio() : 1.0);
+    int nbInputSamples = m_pacer.getNbInputSamples(nbOutputSamples);
 
-    m_readLength = m_readLengthSamples * SDRdaemonFECBuffer::m_iqSampleSize;
+    if (nbInputSamples > m_sdrDaemonBuffer.getReadableNbSamples()) { // the resampler holds the last sample if input falls short
+        nbInputSamples = m_sdrDaemonBuffer.getReadableNbSamples();
+    }
 
-    // read samples directly feeding the SampleFifo (no callback)
-    m_sampleFifo->write(reinterpret_cast<quint8*>(m_sdrDaemonBuffer.readData(m_readLength)), m_readLength);
-    m_samplesCount += m_readLengthSamples;
+    if (nbOutputSamples > 0)
+    {
+        const qint16 *input = (const qint16 *) m_sdrDaemonBuffer.readData(nbInputSamples * SDRdaemonFECBuffer::m_iqSampleSize);
+        const qint16 *output = m_pacer.resample(input, nbInputSamples, nbOutputSamples);
+        m_sampleFifo->write(reinterpret_cast<const quint8*>(output), nbOutputSamples * SDRdaemonFECBuffer::m_iqSampleSize);
+        m_samplesCount += nbOutputSamples;
+    }
 
 	if (m_tickCount < m_rateDivider)
 	{
@@ -249,7 +209,15 @@ void SDRdaemonFECUDPHandler::tick()
             m_sdrDaemonBuffer.getAvgOriginalBlocks(),
             m_sdrDaemonBuffer.getAvgNbRecovery(),
             nbOriginalBlocks,
-            nbFECblocks);
+            nbFECblocks,
+            m_udpReceiver.getKernelDropCount(),
+            m_sdrDaemonBuffer.getNbSizeDrops(),
+            m_sdrDaemonBuffer.getAvgDecodeLatencyUs(),
+            m_sdrDaemonBuffer.getMaxDecodeLatencyUs(),
+            m_sdrDaemonBuffer.getMaxDecodeQueueDepth(),
+            m_sdrDaemonBuffer.getLatencyMs(),
+            m_sdrDaemonBuffer.getTargetLatencyMs(),
+            m_sdrDaemonBuffer.getClockDriftPPM());
             m_outputMessageQueueToGUI->push(report);
 	}
 }
@@ -18,12 +18,12 @@
 #define PLUGINS_SAMPLESOURCE_SDRDAEMONFEC_SDRDAEMONFECUDPHANDLER_H_
 
 #include <QObject>
-#include <QUdpSocket>
 #include <QHostAddress>
 #include <QMutex>
-#include <QElapsedTimer>
 
+#include "dsp/streampacer.h"
 #include "sdrdaemonfecbuffer.h"
+#include "sdrdaemonfecudpreceiver.h"
 
 #define SDRDAEMONFEC_THROTTLE_MS 50
 
@@ -42,21 +42,18 @@ public:
 	void start();
 	void stop();
 	void configureUDPLink(const QString& address, quint16 port);
-	void getRemoteAddress(QString& s) const { s = m_remoteAddress.toString(); }
-    int getNbOriginalBlocks() const { return SDRdaemonFECBuffer::m_nbOriginalBlocks; }
-public slots:
-	void dataReadyRead();
+	void getRemoteAddress(QString& s) const { s = m_udpReceiver.getRemoteAddress().toString(); }
+    int getNbOriginalBlocks() const { return m_sdrDaemonBuffer.getNbOriginalBlocks(); }
+    void setTargetLatency(int targetLatencyMs);
 
 private:
 	DeviceSourceAPI *m_deviceAPI;
 	SDRdaemonFECBuffer m_sdrDaemonBuffer;
-	QUdpSocket *m_dataSocket;
+	QMutex m_bufferMutex;             //!< between the receiver thread writing the buffer and the timer reading it
+	SDRdaemonFECUDPReceiver m_udpReceiver;
 	QHostAddress m_dataAddress;
-	QHostAddress m_remoteAddress;
 	quint16 m_dataPort;
 	bool m_dataConnected;
-	char *m_udpBuf;
-	qint64 m_udpReadBytes;
 	SampleSinkFifo *m_sampleFifo;
 	uint32_t m_samplerate;
 	uint32_t m_centerFrequency;
@@ -67,15 +64,12 @@ private:
 	std::size_t m_samplesCount;
     QTimer *m_timer;
 
-	QElapsedTimer m_elapsedTimer;
 	int m_throttlems;
-    uint32_t m_readLengthSamples;
-    uint32_t m_readLength;
-    bool m_throttleToggle;
+    StreamPacer m_pacer;              //!< output at the nominal sample rate resampled to the stream clock
     int m_rateDivider;
     bool m_autoCorrBuffer;
 
-	void processData();
+	void processMetaData();
 
 private slots:
 	void tick();
@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 Edouard Griffiths, F4EXB                                   //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#include <QDebug>
+#include <QUdpSocket>
+#include <QMutexLocker>
+
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include "sdrdaemonfecudpreceiver.h"
+
+SDRdaemonFECUDPReceiver::SDRdaemonFECUDPReceiver(SDRdaemonFECBuffer& buffer, QMutex& bufferMutex) :
+    m_buffer(buffer),
+    m_bufferMutex(bufferMutex),
+    m_slots(nbSlots * SDRdaemonFECBuffer::m_maxUDPPayloadSize),
+    m_port(0),
+    m_running(0),
+    m_socket(-1),
+    m_udpSocket(0),
+    m_remoteAddress(0x7f000001),
+    m_kernelDropCount(0),
+    m_invalidCount(0)
+{
+}
+
+SDRdaemonFECUDPReceiver::~SDRdaemonFECUDPReceiver()
+{
+    stopWork();
+}
+
+bool SDRdaemonFECUDPReceiver::startWork(const QHostAddress& address, quint16 port)
+{
+    stopWork();
+    m_address = address;
+    m_port = port;
+    m_kernelDropCount = 0;
+    m_invalidCount = 0;
+
+    if (!bindSocket()) {
+        return false;
+    }
+
+    m_running.storeRelease(1);
+    start();
+    return true;
+}
+
+void SDRdaemonFECUDPReceiver::stopWork()
+{
+    m_running.storeRelease(0); // the receive calls time out every 100 ms
+    wait();
+    closeSocket();
+}
+
+#if defined(__linux__)
+
+bool SDRdaemonFECUDPReceiver::bindSocket()
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (fd < 0)
+    {
+        qCritical("SDRdaemonFECUDPReceiver::bindSocket: cannot create socket: %s", strerror(errno));
+        return false;
+    }
+
+    int one = 1;
+    int receiveBufferSize = 4<<20; // absorbs a few frames of bursts at high sample rates
+    struct timeval timeout = {0, 100000};
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &receiveBufferSize, sizeof(receiveBufferSize));
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_RXQ_OVFL
+    if (setsockopt(fd, SOL_SOCKET, SO_RXQ_OVFL, &one, sizeof(one)) < 0) {
+        qWarning("SDRdaemonFECUDPReceiver::bindSocket: kernel drop counter not available: %s", strerror(errno));
+    }
+#endif
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(m_address.toIPv4Address());
+    address.sin_port = htons(m_port);
+
+    if (bind(fd, (struct sockaddr *) &address, sizeof(address)) < 0)
+    {
+        qWarning("SDRdaemonFECUDPReceiver::bindSocket: cannot bind data port %d: %s", m_port, strerror(errno));
+        close(fd);
+        return false;
+    }
+
+    qDebug("SDRdaemonFECUDPReceiver::bindSocket: bound data socket to %s:%d", qPrintable(m_address.toString()), m_port);
+    m_socket = fd;
+    return true;
+}
+
+void SDRdaemonFECUDPReceiver::closeSocket()
+{
+    if (m_socket >= 0)
+    {
+        close(m_socket);
+        m_socket = -1;
+    }
+}
+
+void SDRdaemonFECUDPReceiver::run()
+{
+    struct mmsghdr msgs[nbSlots];
+    struct iovec iovs[nbSlots];
+    struct sockaddr_in remoteAddresses[nbSlots];
+    char controls[nbSlots][CMSG_SPACE(sizeof(quint32))];
+
+    for (int i = 0; i < nbSlots; i++)
+    {
+        iovs[i].iov_base = &m_slots[i * SDRdaemonFECBuffer::m_maxUDPPayloadSize];
+        iovs[i].iov_len = SDRdaemonFECBuffer::m_maxUDPPayloadSize;
+    }
+
+    while (m_running.loadAcquire())
+    {
+        for (int i = 0; i < nbSlots; i++)
+        {
+            memset(&msgs[i], 0, sizeof(struct mmsghdr));
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+            msgs[i].msg_hdr.msg_name = &remoteAddresses[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+            msgs[i].msg_hdr.msg_control = controls[i];
+            msgs[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+        }
+
+        // waits for the first datagram then takes what is already queued
+        int nbReceived = recvmmsg(m_socket, msgs, nbSlots, MSG_WAITFORONE, 0);
+
+        if (nbReceived < 0)
+        {
+            if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) {
+                continue;
+            }
+
+            qWarning("SDRdaemonFECUDPReceiver::run: receive error: %s", strerror(errno));
+            break;
+        }
+
+        QMutexLocker locker(&m_bufferMutex);
+
+        for (int i = 0; i < nbReceived; i++)
+        {
+#ifdef SO_RXQ_OVFL
+            for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg))
+            {
+                if ((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SO_RXQ_OVFL)) {
+                    memcpy(&m_kernelDropCount, CMSG_DATA(cmsg), sizeof(quint32));
+                }
+            }
+#endif
+            if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC)
+            {
+                m_invalidCount++;
+                continue;
+            }
+
+            m_remoteAddress = ntohl(remoteAddresses[i].sin_addr.s_addr);
+            m_buffer.writeData(&m_slots[i * SDRdaemonFECBuffer::m_maxUDPPayloadSize], msgs[i].msg_len); // the buffer follows the datagram size
+        }
+    }
+}
+
+#else
+
+bool SDRdaemonFECUDPReceiver::bindSocket()
+{
+    m_udpSocket = new QUdpSocket();
+
+    if (!m_udpSocket->bind(m_address, m_port))
+    {
+        qWarning("SDRdaemonFECUDPReceiver::bindSocket: cannot bind data port %d", m_port);
+        delete m_udpSocket;
+        m_udpSocket = 0;
+        return false;
+    }
+
+    qDebug("SDRdaemonFECUDPReceiver::bindSocket: bound data socket to %s:%d", qPrintable(m_address.toString()), m_port);
+    m_udpSocket->moveToThread(this); // only used with blocking calls in run()
+    return true;
+}
+
+void SDRdaemonFECUDPReceiver::closeSocket()
+{
+    if (m_udpSocket)
+    {
+        delete m_udpSocket;
+        m_udpSocket = 0;
+    }
+}
+
+void SDRdaemonFECUDPReceiver::run()
+{
+    QUdpSocket& socket = *m_udpSocket;
+
+    while (m_running.loadAcquire())
+    {
+        if (!socket.waitForReadyRead(100)) {
+            continue;
+        }
+
+        QHostAddress remoteAddress;
+        int nbReceived = 0;
+        int sizes[nbSlots];
+
+        while (socket.hasPendingDatagrams() && (nbReceived < nbSlots))
+        {
+            sizes[nbReceived] = socket.readDatagram(&m_slots[nbReceived * SDRdaemonFECBuffer::m_maxUDPPayloadSize],
+                SDRdaemonFECBuffer::m_maxUDPPayloadSize, &remoteAddress, 0);
+            nbReceived++;
+        }
+
+        m_remoteAddress = remoteAddress.toIPv4Address();
+        QMutexLocker locker(&m_bufferMutex);
+
+        for (int i = 0; i < nbReceived; i++)
+        {
+            if (sizes[i] <= 0)
+            {
+                m_invalidCount++;
+                continue;
+            }
+
+            m_buffer.writeData(&m_slots[i * SDRdaemonFECBuffer::m_maxUDPPayloadSize], sizes[i]);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 Edouard Griffiths, F4EXB                                   //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef PLUGINS_SAMPLESOURCE_SDRDAEMONFEC_SDRDAEMONFECUDPRECEIVER_H_
+#define PLUGINS_SAMPLESOURCE_SDRDAEMONFEC_SDRDAEMONFECUDPRECEIVER_H_
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QHostAddress>
+#include <vector>
+
+#include "sdrdaemonfecbuffer.h"
+
+class QUdpSocket;
+
+/**
+ * Network thread of the SDRdaemonFEC input. It receives the datagrams without going through the
+ * Qt event loop: on Linux up to nbSlots datagrams are taken from the socket with a single recvmmsg
+ * call directly into an array of slots of the largest payload size that are then handed to the FEC
+ * buffer without further copy. The kernel count of datagrams dropped on a full receive queue is retrieved with
+ * SO_RXQ_OVFL. Other systems read the datagrams one by one with a QUdpSocket in this thread.
+ *
+ * The socket is bound by startWork() in the caller's thread so that the caller knows if the data
+ * port could be opened. The thread is only started on success.
+ */
+class SDRdaemonFECUDPReceiver : public QThread
+{
+public:
+    SDRdaemonFECUDPReceiver(SDRdaemonFECBuffer& buffer, QMutex& bufferMutex);
+    ~SDRdaemonFECUDPReceiver();
+
+    bool startWork(const QHostAddress& address, quint16 port); //!< binds the data socket and starts the thread. Returns false if the socket cannot be bound
+    void stopWork();
+
+    QHostAddress getRemoteAddress() const { return QHostAddress(m_remoteAddress); }
+    quint32 getKernelDropCount() const { return m_kernelDropCount; } //!< datagrams dropped by the kernel on the socket since start
+    quint32 getInvalidCount() const { return m_invalidCount; }       //!< datagrams discarded because they were truncated
+
+    static const int nbSlots = 64; //!< datagrams received at most with one system call
+
+private:
+    SDRdaemonFECBuffer& m_buffer;
+    QMutex& m_bufferMutex;             //!< serializes the buffer writes with the reads of the handler
+    std::vector<char> m_slots;         //!< nbSlots datagrams of at most SDRdaemonFECBuffer::m_maxUDPPayloadSize bytes
+    QHostAddress m_address;
+    quint16 m_port;
+    QAtomicInt m_running;
+    int m_socket;                      //!< native socket used with recvmmsg
+    QUdpSocket *m_udpSocket;           //!< used where recvmmsg is not available
+    quint32 m_remoteAddress;           //!< IPv4 address of the last datagram sender
+    quint32 m_kernelDropCount;
+    quint32 m_invalidCount;
+
+    bool bindSocket();
+    void closeSocket();
+    void run();
+};
+
+#endif /* PLUGINS_SAMPLESOURCE_SDRDAEMONFEC_SDRDAEMONFECUDPRECEIVER_H_ */
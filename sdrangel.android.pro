@@ -5,8 +5,8 @@
 #--------------------------------------------------------
 
 TEMPLATE = subdirs
-SUBDIRS = sdrbase
-SUBDIRS += lz4
+SUBDIRS = lz4
+SUBDIRS += sdrbase
 #SUBDIRS += librtlsdr
 #SUBDIRS += libhackrf
 #SUBDIRS += libairspy
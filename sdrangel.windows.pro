@@ -5,9 +5,9 @@
 #--------------------------------------------------------
 
 TEMPLATE = subdirs
-SUBDIRS = sdrbase
+SUBDIRS = lz4
+SUBDIRS += sdrbase
 SUBDIRS += devices
-SUBDIRS += lz4
 CONFIG(MINGW64)SUBDIRS += nanomsg
 SUBDIRS += fcdhid
 SUBDIRS += fcdlib
@@ -36,6 +36,7 @@ DeviceSourceAPI::DeviceSourceAPI(MainWindow *mainWindow,
     m_channelWindow(channelWindow),
     m_sampleSourceSequence(0),
     m_sampleSourcePluginGUI(0),
+    m_recordCompression(true),
     m_buddySharedPtr(0)
 {
 }
@@ -114,6 +115,16 @@ void DeviceSourceAPI::configureCorrections(bool dcOffsetCorrection, bool iqImbal
     m_deviceSourceEngine->configureCorrections(dcOffsetCorrection, iqImbalanceCorrection);
 }
 
+void DeviceSourceAPI::configureChannelizerBank(bool enable, int log2NbChannels)
+{
+    m_deviceSourceEngine->configureChannelizerBank(enable, log2NbChannels);
+}
+
+void DeviceSourceAPI::configureSinkDispatch(bool parallel)
+{
+    m_deviceSourceEngine->configureSinkDispatch(parallel);
+}
+
 GLSpectrum *DeviceSourceAPI::getSpectrum()
 {
     return m_spectrum;
@@ -57,6 +57,10 @@ public:
     MessageQueue *getDeviceInputMessageQueue();
     MessageQueue *getDeviceOutputMessageQueue();
     void configureCorrections(bool dcOffsetCorrection, bool iqImbalanceCorrection); //!< Configure current device engine DSP corrections
+    void configureChannelizerBank(bool enable, int log2NbChannels = 6); //!< Feed channelizers from a polyphase filter bank slice when possible
+    void configureSinkDispatch(bool parallel); //!< Feed sinks in parallel over a pool of threads
+    void setRecordCompression(bool compression) { m_recordCompression = compression; } //!< Compression of the I/Q records started from the device GUI
+    bool getRecordCompression() const { return m_recordCompression; }
 
     // device related stuff
     GLSpectrum *getSpectrum();                           //!< Direct spectrum getter
@@ -140,6 +144,7 @@ protected:
     QString m_sampleSourceSerial;
     int m_sampleSourceSequence;
     PluginGUI* m_sampleSourcePluginGUI;
+    bool m_recordCompression;
 
     ChannelInstanceRegistrations m_channelInstanceRegistrations;
 
@@ -148,6 +153,7 @@ protected:
     void *m_buddySharedPtr;
 
     friend class MainWindow;
+    friend class MainCore;
     friend class DeviceSinkAPI;
 };
 
@@ -47,12 +47,8 @@ void BasebandSampleSource::handleWriteToFifo(int nbSamples)
     SampleVector::iterator writeAt;
     m_sampleFifo.getWriteIterator(writeAt);
     pullAudio(nbSamples); // Pre-fetch input audio samples this is mandatory to keep things running smoothly
-
-    for (int i = 0; i < nbSamples; i++)
-    {
-        pull((*writeAt));
-        m_sampleFifo.bumpIndex(writeAt);
-    }
+    pullBlock(writeAt, nbSamples);
+    m_sampleFifo.bumpIndex(writeAt, nbSamples);
 }
 
 
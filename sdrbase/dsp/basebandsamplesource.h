@@ -34,21 +34,26 @@ public:
 
 	virtual void start() = 0;
 	virtual void stop() = 0;
-	virtual void pull(Sample& sample) = 0;
+	virtual void pull(Sample& sample) = 0; //!< Pull one sample. Kept for compatibility, prefer pullBlock
 	virtual void pullAudio(int nbSamples) {}
 
+	/** Pull nbSamples samples in a row starting at begin. Sources should override this
+	 *  to take their locks and dispatch once per block. The default falls back to pull() */
+	virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+	{
+	    for (unsigned int i = 0; i < nbSamples; i++) {
+	        pull(*begin++);
+	    }
+	}
+
     /** direct feeding of sample source FIFO */
 	void feed(SampleSourceFifo* sampleFifo, int nbSamples)
 	{
 	    SampleVector::iterator writeAt;
 	    sampleFifo->getWriteIterator(writeAt);
 	    pullAudio(nbSamples); // Pre-fetch input audio samples this is mandatory to keep things running smoothly
-
-	    for (int i = 0; i < nbSamples; i++)
-	    {
-	        pull((*writeAt));
-	        sampleFifo->bumpIndex(writeAt);
-	    }
+	    pullBlock(writeAt, nbSamples);
+	    sampleFifo->bumpIndex(writeAt, nbSamples);
 	}
 
 	SampleSourceFifo& getSampleSourceFifo() { return m_sampleFifo; }
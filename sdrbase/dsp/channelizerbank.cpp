@@ -0,0 +1,173 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QDebug>
+
+#include "dsp/channelizerbank.h"
+#include "dsp/downchannelizer.h"
+#include "dsp/threadedbasebandsamplesink.h"
+
+ChannelizerBank::ChannelizerBank() :
+    m_sampleRate(0),
+    m_nbChannels(0)
+{
+}
+
+ChannelizerBank::~ChannelizerBank()
+{
+}
+
+void ChannelizerBank::configure(int log2NbChannels, int sampleRate)
+{
+    releaseAll();
+    m_sampleRate = sampleRate;
+    m_nbChannels = 1<<log2NbChannels;
+    m_filterBank.configure(log2NbChannels);
+    m_channelUsers.assign(m_nbChannels, 0);
+
+    qDebug("ChannelizerBank::configure: %d channels of %d S/s at %d S/s", m_nbChannels, 2*sampleRate/m_nbChannels, sampleRate);
+}
+
+void ChannelizerBank::release(ThreadedBasebandSampleSink *sink)
+{
+    if (m_assignments.find(sink) != m_assignments.end()) {
+        assign(sink, -1);
+    }
+}
+
+void ChannelizerBank::releaseAll()
+{
+    while (m_assignments.size() > 0) {
+        assign(m_assignments.begin()->first, -1);
+    }
+}
+
+void ChannelizerBank::clear()
+{
+    for (Assignments::const_iterator it = m_assignments.begin(); it != m_assignments.end(); ++it) {
+        m_filterBank.setChannelActive(it->second, false);
+    }
+
+    m_assignments.clear();
+    m_channelUsers.assign(m_nbChannels, 0);
+}
+
+int ChannelizerBank::findChannel(const ThreadedBasebandSampleSink *sink) const
+{
+    const DownChannelizer *channelizer = qobject_cast<const DownChannelizer*>(sink->getSink());
+
+    // slice center and rate must be whole numbers of S/s
+    if ((channelizer == 0) || (m_nbChannels <= 2) || (m_sampleRate % m_nbChannels != 0)) {
+        return -1;
+    }
+
+    qint64 rate = channelizer->getRequestedOutputSampleRate();
+    qint64 center = channelizer->getRequestedCenterFrequency();
+
+    if (rate <= 0) { // not configured yet
+        return -1;
+    }
+
+    qint64 spacing = m_sampleRate / m_nbChannels;
+    qint64 k = (center >= 0 ? center + spacing/2 : center - spacing/2) / spacing; // nearest slice
+
+    if ((k <= -m_nbChannels/2) || (k >= m_nbChannels/2)) { // Nyquist slice wraps around
+        return -1;
+    }
+
+    // the whole channel must be in the flat part of the slice
+    qint64 delta = center - k*spacing;
+
+    if ((delta - rate/2 < -spacing/2) || (delta + rate/2 > spacing/2)) {
+        return -1;
+    }
+
+    return k < 0 ? k + m_nbChannels : k;
+}
+
+void ChannelizerBank::assign(ThreadedBasebandSampleSink *sink, int channel)
+{
+    Assignments::iterator it = m_assignments.find(sink);
+
+    if (it != m_assignments.end())
+    {
+        if (--m_channelUsers[it->second] == 0) {
+            m_filterBank.setChannelActive(it->second, false);
+        }
+
+        m_assignments.erase(it);
+    }
+
+    if (channel < 0)
+    {
+        DownChannelizer::MsgChannelizerInput msg(0, 0);
+        sink->handleSinkMessage(msg);
+        qDebug() << "ChannelizerBank::assign: " << sink->getSampleSinkObjectName() << " on baseband";
+    }
+    else
+    {
+        if (m_channelUsers[channel]++ == 0) {
+            m_filterBank.setChannelActive(channel, true);
+        }
+
+        m_assignments[sink] = channel;
+        int k = channel < m_nbChannels/2 ? channel : channel - m_nbChannels;
+        DownChannelizer::MsgChannelizerInput msg(2*m_sampleRate/m_nbChannels, (qint64) k * (m_sampleRate/m_nbChannels));
+        sink->handleSinkMessage(msg);
+        qDebug() << "ChannelizerBank::assign: " << sink->getSampleSinkObjectName() << " on slice " << k;
+    }
+}
+
+void ChannelizerBank::updateAssignments(const std::list<ThreadedBasebandSampleSink*>& sinks)
+{
+    if (m_nbChannels == 0) {
+        return;
+    }
+
+    for (std::list<ThreadedBasebandSampleSink*>::const_iterator it = sinks.begin(); it != sinks.end(); ++it)
+    {
+        int channel = findChannel(*it);
+        Assignments::const_iterator assignment = m_assignments.find(*it);
+        int current = assignment == m_assignments.end() ? -1 : assignment->second;
+
+        if (channel != current) {
+            assign(*it, channel);
+        }
+    }
+}
+
+void ChannelizerBank::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool append)
+{
+    if (!append) {
+        m_filterBank.clearChannelSamples();
+    }
+
+    if (m_filterBank.hasActiveChannels()) {
+        m_filterBank.feed(begin, end);
+    }
+}
+
+const SampleVector *ChannelizerBank::getSliceSamples(ThreadedBasebandSampleSink *sink) const
+{
+    Assignments::const_iterator it = m_assignments.find(sink);
+
+    if (it == m_assignments.end()) {
+        return 0;
+    } else {
+        return &m_filterBank.getChannelSamples(it->second);
+    }
+}
@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_CHANNELIZERBANK_H_
+#define SDRBASE_DSP_CHANNELIZERBANK_H_
+
+#include <map>
+#include <list>
+#include <vector>
+#include "dsp/dsptypes.h"
+#include "dsp/polyphasefilterbank.h"
+#include "util/export.h"
+
+class ThreadedBasebandSampleSink;
+
+/**
+ * Fans out one device stream to many channels with a polyphase filter bank.
+ *
+ * Threaded sinks wrapping a DownChannelizer whose channel fits entirely in the flat part of
+ * one bank slice are fed that slice at 2*Fs/M instead of the full baseband. The channelizer
+ * is told with a DownChannelizer::MsgChannelizerInput message so it only builds the remaining
+ * half band stages. Other sinks keep receiving the full baseband.
+ * All methods are called from the device engine thread.
+ */
+class SDRANGEL_API ChannelizerBank
+{
+public:
+    ChannelizerBank();
+    ~ChannelizerBank();
+
+    void configure(int log2NbChannels, int sampleRate); //!< resets all assignments
+    void release(ThreadedBasebandSampleSink *sink);     //!< put the sink back on full baseband
+    void releaseAll();
+    void clear();                                       //!< forget assignments without notifying the sinks
+
+    /** Check each threaded sink channel against the bank slices and move it accordingly */
+    void updateAssignments(const std::list<ThreadedBasebandSampleSink*>& sinks);
+    bool hasAssignments() const { return m_assignments.size() > 0; }
+
+    /** Run the bank. With append set slice samples are added to the ones of the previous call */
+    void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool append = false);
+    /** Returns 0 if the sink is not fed by the bank */
+    const SampleVector *getSliceSamples(ThreadedBasebandSampleSink *sink) const;
+
+private:
+    typedef std::map<ThreadedBasebandSampleSink*, int> Assignments;
+
+    PolyphaseFilterBank m_filterBank;
+    int m_sampleRate;
+    int m_nbChannels;
+    Assignments m_assignments;     //!< sink to bank channel
+    std::vector<int> m_channelUsers; //!< number of sinks fed by each bank channel
+
+    int findChannel(const ThreadedBasebandSampleSink *sink) const;
+    void assign(ThreadedBasebandSampleSink *sink, int channel);
+};
+
+#endif /* SDRBASE_DSP_CHANNELIZERBANK_H_ */
@@ -18,6 +18,8 @@
 #define INCLUDE_GPL_DSP_DECIMATORS_H_
 
 #include "dsp/dsptypes.h"
+#include "dsp/decimatorssimd.h"
+#include "dsp/hbfilterselector.h"
 #ifdef USE_SSE4_1
 #include "dsp/inthalfbandfiltereo1.h"
 #else
@@ -102,6 +104,8 @@ template<typename T, uint SdrBits, uint InputBits>
 class Decimators
 {
 public:
+    Decimators();
+
     // interleaved I/Q input buffer
 	void decimate1(SampleVector::iterator* it, const T* buf, qint32 len);
 	void decimate2_u(SampleVector::iterator* it, const T* buf, qint32 len);
@@ -147,28 +151,44 @@ public:
 
 private:
 #ifdef USE_SSE4_1
-    IntHalfbandFilterEO1<DECIMATORS_HB_FILTER_ORDER> m_decimator2;  // 1st stages
-    IntHalfbandFilterEO1<DECIMATORS_HB_FILTER_ORDER> m_decimator4;  // 2nd stages
-    IntHalfbandFilterEO1<DECIMATORS_HB_FILTER_ORDER> m_decimator8;  // 3rd stages
-    IntHalfbandFilterEO1<DECIMATORS_HB_FILTER_ORDER> m_decimator16; // 4th stages
-    IntHalfbandFilterEO1<DECIMATORS_HB_FILTER_ORDER> m_decimator32; // 5th stages
-    IntHalfbandFilterEO1<DECIMATORS_HB_FILTER_ORDER> m_decimator64; // 6th stages
+    typedef IntHalfbandFilterEO1<DECIMATORS_HB_FILTER_ORDER> DefaultHBFilter; // default class of HBFilterSelector::DecimatorsStage
 #else
-	IntHalfbandFilterDB<DECIMATORS_HB_FILTER_ORDER> m_decimator2;  // 1st stages
-	IntHalfbandFilterDB<DECIMATORS_HB_FILTER_ORDER> m_decimator4;  // 2nd stages
-	IntHalfbandFilterDB<DECIMATORS_HB_FILTER_ORDER> m_decimator8;  // 3rd stages
-	IntHalfbandFilterDB<DECIMATORS_HB_FILTER_ORDER> m_decimator16; // 4th stages
-	IntHalfbandFilterDB<DECIMATORS_HB_FILTER_ORDER> m_decimator32; // 5th stages
-	IntHalfbandFilterDB<DECIMATORS_HB_FILTER_ORDER> m_decimator64; // 6th stages
+    typedef IntHalfbandFilterDB<DECIMATORS_HB_FILTER_ORDER> DefaultHBFilter;
 #endif
+    HBFilterInstance<DefaultHBFilter> m_decimator2;  // 1st stages
+    HBFilterInstance<DefaultHBFilter> m_decimator4;  // 2nd stages
+    HBFilterInstance<DefaultHBFilter> m_decimator8;  // 3rd stages
+    HBFilterInstance<DefaultHBFilter> m_decimator16; // 4th stages
+    HBFilterInstance<DefaultHBFilter> m_decimator32; // 5th stages
+    HBFilterInstance<DefaultHBFilter> m_decimator64; // 6th stages
 };
 
+template<typename T, uint SdrBits, uint InputBits>
+Decimators<T, SdrBits, InputBits>::Decimators() :
+    m_decimator2(HBFilterSelector::DecimatorsStage),
+    m_decimator4(HBFilterSelector::DecimatorsStage),
+    m_decimator8(HBFilterSelector::DecimatorsStage),
+    m_decimator16(HBFilterSelector::DecimatorsStage),
+    m_decimator32(HBFilterSelector::DecimatorsStage),
+    m_decimator64(HBFilterSelector::DecimatorsStage)
+{
+}
+
 template<typename T, uint SdrBits, uint InputBits>
 void Decimators<T, SdrBits, InputBits>::decimate1(SampleVector::iterator* it, const T* buf, qint32 len)
 {
 	qint32 xreal, yimag;
 
-	for (int pos = 0; pos < len - 1; pos += 2)
+	int pos = 0;
+	typename DecimatorsSIMD::Kernels<T>::Kernel kernel = DecimatorsSIMD::kernels<T>().decimate1;
+
+	if (kernel)
+	{
+		pos = (*kernel)(&(**it), buf, len, decimation_shifts<SdrBits, InputBits>::pre1, 0);
+		(*it) += pos / 2; // the vectorized kernel leaves a tail for the loop below
+	}
+
+	for (; pos < len - 1; pos += 2)
 	{
 		xreal = buf[pos+0];
 		yimag = buf[pos+1];
@@ -242,7 +262,16 @@ void Decimators<T, SdrBits, InputBits>::decimate2_inf(SampleVector::iterator* it
 {
 	qint32 xreal, yimag;
 
-	for (int pos = 0; pos < len - 7; pos += 8)
+	int pos = 0;
+	typename DecimatorsSIMD::Kernels<T>::Kernel kernel = DecimatorsSIMD::kernels<T>().decimate2_inf;
+
+	if (kernel)
+	{
+		pos = (*kernel)(&(**it), buf, len, decimation_shifts<SdrBits, InputBits>::pre2, decimation_shifts<SdrBits, InputBits>::post2);
+		(*it) += pos / 4; // the vectorized kernel leaves a tail for the loop below
+	}
+
+	for (; pos < len - 7; pos += 8)
 	{
 		xreal = (buf[pos+0] - buf[pos+3]) << decimation_shifts<SdrBits, InputBits>::pre2;
 		yimag = (buf[pos+1] + buf[pos+2]) << decimation_shifts<SdrBits, InputBits>::pre2;
@@ -286,7 +315,16 @@ void Decimators<T, SdrBits, InputBits>::decimate2_sup(SampleVector::iterator* it
 {
 	qint32 xreal, yimag;
 
-	for (int pos = 0; pos < len - 7; pos += 8)
+	int pos = 0;
+	typename DecimatorsSIMD::Kernels<T>::Kernel kernel = DecimatorsSIMD::kernels<T>().decimate2_sup;
+
+	if (kernel)
+	{
+		pos = (*kernel)(&(**it), buf, len, decimation_shifts<SdrBits, InputBits>::pre2, decimation_shifts<SdrBits, InputBits>::post2);
+		(*it) += pos / 4; // the vectorized kernel leaves a tail for the loop below
+	}
+
+	for (; pos < len - 7; pos += 8)
 	{
 		xreal = (buf[pos+1] - buf[pos+2]) << decimation_shifts<SdrBits, InputBits>::pre2;
 		yimag = (- buf[pos+0] - buf[pos+3]) << decimation_shifts<SdrBits, InputBits>::pre2;
@@ -330,7 +368,16 @@ void Decimators<T, SdrBits, InputBits>::decimate4_inf(SampleVector::iterator* it
 {
 	qint32 xreal, yimag;
 
-	for (int pos = 0; pos < len - 7; pos += 8)
+	int pos = 0;
+	typename DecimatorsSIMD::Kernels<T>::Kernel kernel = DecimatorsSIMD::kernels<T>().decimate4_inf;
+
+	if (kernel)
+	{
+		pos = (*kernel)(&(**it), buf, len, decimation_shifts<SdrBits, InputBits>::pre4, decimation_shifts<SdrBits, InputBits>::post4);
+		(*it) += pos / 8; // the vectorized kernel leaves a tail for the loop below
+	}
+
+	for (; pos < len - 7; pos += 8)
 	{
 		xreal = (buf[pos+0] - buf[pos+3] + buf[pos+7] - buf[pos+4]) << decimation_shifts<SdrBits, InputBits>::pre4;
 		yimag = (buf[pos+1] - buf[pos+5] + buf[pos+2] - buf[pos+6]) << decimation_shifts<SdrBits, InputBits>::pre4;
@@ -370,7 +417,16 @@ void Decimators<T, SdrBits, InputBits>::decimate4_sup(SampleVector::iterator* it
 	// [ rotate:  0, 1, -3, 2, -4, -5, 7, -6]
 	qint32 xreal, yimag;
 
-	for (int pos = 0; pos < len - 7; pos += 8)
+	int pos = 0;
+	typename DecimatorsSIMD::Kernels<T>::Kernel kernel = DecimatorsSIMD::kernels<T>().decimate4_sup;
+
+	if (kernel)
+	{
+		pos = (*kernel)(&(**it), buf, len, decimation_shifts<SdrBits, InputBits>::pre4, decimation_shifts<SdrBits, InputBits>::post4);
+		(*it) += pos / 8; // the vectorized kernel leaves a tail for the loop below
+	}
+
+	for (; pos < len - 7; pos += 8)
 	{
 		xreal = (buf[pos+1] - buf[pos+2] - buf[pos+5] + buf[pos+6]) << decimation_shifts<SdrBits, InputBits>::pre4;
 		yimag = (- buf[pos+0] - buf[pos+3] + buf[pos+4] + buf[pos+7]) << decimation_shifts<SdrBits, InputBits>::pre4;
@@ -0,0 +1,530 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsp/decimatorssimd.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define DECIMATORSSIMD_X86
+#include <emmintrin.h>
+#if defined(__GNUC__) && (defined(__clang__) || (__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 9)))
+// AVX2 code is compiled for this function only so that the library still runs on older CPUs
+#define DECIMATORSSIMD_AVX2
+#include <immintrin.h>
+#define SSE2_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define SSE2_TARGET
+#endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define DECIMATORSSIMD_NEON
+#include <arm_neon.h>
+#endif
+
+// Offset tuning decimation by 2 takes 4 I/Q pairs b0..b7 and gives 2 I/Q pairs:
+//   inf: (b0-b3, b1+b2) (b7-b4, -b5-b6)
+//   sup: (b1-b2, -b0-b3) (b6-b5, b4+b7)
+// decimation by 4 is the sum of these two pairs.
+// Computation is done on 32 bit integers then truncated to 16 bits exactly like the scalar code.
+
+#ifdef DECIMATORSSIMD_X86
+
+// Bring 16 input values to two vectors of 8 x 16 bits
+
+template<typename T> SSE2_TARGET static inline void load16SSE2(const T *buf, __m128i& a, __m128i& b);
+
+template<> SSE2_TARGET inline void load16SSE2<qint16>(const qint16 *buf, __m128i& a, __m128i& b)
+{
+    a = _mm_loadu_si128((const __m128i*) buf);
+    b = _mm_loadu_si128((const __m128i*) (buf + 8));
+}
+
+template<> SSE2_TARGET inline void load16SSE2<quint8>(const quint8 *buf, __m128i& a, __m128i& b)
+{
+    __m128i x = _mm_loadu_si128((const __m128i*) buf);
+    a = _mm_unpacklo_epi8(x, _mm_setzero_si128());
+    b = _mm_unpackhi_epi8(x, _mm_setzero_si128());
+}
+
+template<> SSE2_TARGET inline void load16SSE2<qint8>(const qint8 *buf, __m128i& a, __m128i& b)
+{
+    __m128i x = _mm_loadu_si128((const __m128i*) buf);
+    a = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+    b = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+}
+
+/** Two decimated I/Q pairs as 4 x 32 bits from 8 input values */
+template<bool Sup> SSE2_TARGET static inline __m128i decimate2SSE2(__m128i x)
+{
+    if (Sup)
+    {
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(3,0,2,1)); // b1 b2 b0 b3
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(3,0,1,2)); // b6 b5 b4 b7
+        return _mm_madd_epi16(x, _mm_setr_epi16(1, -1, -1, -1, 1, -1, 1, 1));
+    }
+    else
+    {
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2,1,3,0)); // b0 b3 b1 b2
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2,1,0,3)); // b7 b4 b5 b6
+        return _mm_madd_epi16(x, _mm_setr_epi16(1, -1, 1, 1, 1, -1, -1, -1));
+    }
+}
+
+SSE2_TARGET static inline __m128i shiftSSE2(__m128i x, __m128i preShift, __m128i postShift)
+{
+    return _mm_sra_epi32(_mm_sll_epi32(x, preShift), postShift);
+}
+
+/** 8 x 32 bits truncated to 8 x 16 bits */
+SSE2_TARGET static inline __m128i packSSE2(__m128i a, __m128i b)
+{
+    a = _mm_srai_epi32(_mm_slli_epi32(a, 16), 16);
+    b = _mm_srai_epi32(_mm_slli_epi32(b, 16), 16);
+    return _mm_packs_epi32(a, b);
+}
+
+template<typename T>
+SSE2_TARGET static int decimate1SSE2(Sample *out, const T *buf, int len, int preShift, int)
+{
+    __m128i *dst = (__m128i*) out;
+    __m128i pre = _mm_cvtsi32_si128(preShift);
+    __m128i a, b;
+    int pos = 0;
+
+    for (; pos < len - 15; pos += 16)
+    {
+        load16SSE2(buf + pos, a, b);
+        _mm_storeu_si128(dst++, _mm_sll_epi16(a, pre));
+        _mm_storeu_si128(dst++, _mm_sll_epi16(b, pre));
+    }
+
+    return pos;
+}
+
+template<typename T, bool Sup>
+SSE2_TARGET static int decimate2SSE2(Sample *out, const T *buf, int len, int preShift, int postShift)
+{
+    __m128i *dst = (__m128i*) out;
+    __m128i pre = _mm_cvtsi32_si128(preShift);
+    __m128i post = _mm_cvtsi32_si128(postShift);
+    __m128i a, b;
+    int pos = 0;
+
+    for (; pos < len - 15; pos += 16)
+    {
+        load16SSE2(buf + pos, a, b);
+        a = shiftSSE2(decimate2SSE2<Sup>(a), pre, post);
+        b = shiftSSE2(decimate2SSE2<Sup>(b), pre, post);
+        _mm_storeu_si128(dst++, packSSE2(a, b));
+    }
+
+    return pos;
+}
+
+template<typename T, bool Sup>
+SSE2_TARGET static int decimate4SSE2(Sample *out, const T *buf, int len, int preShift, int postShift)
+{
+    __m128i *dst = (__m128i*) out;
+    __m128i pre = _mm_cvtsi32_si128(preShift);
+    __m128i post = _mm_cvtsi32_si128(postShift);
+    __m128i a, b, c, d;
+    int pos = 0;
+
+    for (; pos < len - 31; pos += 32)
+    {
+        load16SSE2(buf + pos, a, b);
+        load16SSE2(buf + pos + 16, c, d);
+        a = decimate2SSE2<Sup>(a);
+        b = decimate2SSE2<Sup>(b);
+        c = decimate2SSE2<Sup>(c);
+        d = decimate2SSE2<Sup>(d);
+        // add the two pairs of each group of 8 inputs
+        a = shiftSSE2(_mm_add_epi32(_mm_unpacklo_epi64(a, b), _mm_unpackhi_epi64(a, b)), pre, post);
+        c = shiftSSE2(_mm_add_epi32(_mm_unpacklo_epi64(c, d), _mm_unpackhi_epi64(c, d)), pre, post);
+        _mm_storeu_si128(dst++, packSSE2(a, c));
+    }
+
+    return pos;
+}
+
+#endif // DECIMATORSSIMD_X86
+
+#ifdef DECIMATORSSIMD_AVX2
+
+// Same as SSE2 with two groups of 8 input values in each 128 bit lane
+
+template<typename T> AVX2_TARGET static inline void load32AVX2(const T *buf, __m256i& a, __m256i& b);
+
+template<> AVX2_TARGET inline void load32AVX2<qint16>(const qint16 *buf, __m256i& a, __m256i& b)
+{
+    a = _mm256_loadu_si256((const __m256i*) buf);
+    b = _mm256_loadu_si256((const __m256i*) (buf + 16));
+}
+
+template<> AVX2_TARGET inline void load32AVX2<quint8>(const quint8 *buf, __m256i& a, __m256i& b)
+{
+    a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*) buf));
+    b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*) (buf + 16)));
+}
+
+template<> AVX2_TARGET inline void load32AVX2<qint8>(const qint8 *buf, __m256i& a, __m256i& b)
+{
+    a = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) buf));
+    b = _mm256_cvtepi8_epi16(_mm_loadu_si128((const __m128i*) (buf + 16)));
+}
+
+template<bool Sup> AVX2_TARGET static inline __m256i decimate2AVX2(__m256i x)
+{
+    if (Sup)
+    {
+        x = _mm256_shufflelo_epi16(x, _MM_SHUFFLE(3,0,2,1));
+        x = _mm256_shufflehi_epi16(x, _MM_SHUFFLE(3,0,1,2));
+        return _mm256_madd_epi16(x, _mm256_setr_epi16(1, -1, -1, -1, 1, -1, 1, 1, 1, -1, -1, -1, 1, -1, 1, 1));
+    }
+    else
+    {
+        x = _mm256_shufflelo_epi16(x, _MM_SHUFFLE(2,1,3,0));
+        x = _mm256_shufflehi_epi16(x, _MM_SHUFFLE(2,1,0,3));
+        return _mm256_madd_epi16(x, _mm256_setr_epi16(1, -1, 1, 1, 1, -1, -1, -1, 1, -1, 1, 1, 1, -1, -1, -1));
+    }
+}
+
+AVX2_TARGET static inline __m256i shiftAVX2(__m256i x, __m128i preShift, __m128i postShift)
+{
+    return _mm256_sra_epi32(_mm256_sll_epi32(x, preShift), postShift);
+}
+
+/** 16 x 32 bits truncated to 16 x 16 bits in order */
+AVX2_TARGET static inline __m256i packAVX2(__m256i a, __m256i b)
+{
+    a = _mm256_srai_epi32(_mm256_slli_epi32(a, 16), 16);
+    b = _mm256_srai_epi32(_mm256_slli_epi32(b, 16), 16);
+    return _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), _MM_SHUFFLE(3,1,2,0));
+}
+
+template<typename T>
+AVX2_TARGET static int decimate1AVX2(Sample *out, const T *buf, int len, int preShift, int)
+{
+    __m256i *dst = (__m256i*) out;
+    __m128i pre = _mm_cvtsi32_si128(preShift);
+    __m256i a, b;
+    int pos = 0;
+
+    for (; pos < len - 31; pos += 32)
+    {
+        load32AVX2(buf + pos, a, b);
+        _mm256_storeu_si256(dst++, _mm256_sll_epi16(a, pre));
+        _mm256_storeu_si256(dst++, _mm256_sll_epi16(b, pre));
+    }
+
+    return pos;
+}
+
+template<typename T, bool Sup>
+AVX2_TARGET static int decimate2AVX2(Sample *out, const T *buf, int len, int preShift, int postShift)
+{
+    __m256i *dst = (__m256i*) out;
+    __m128i pre = _mm_cvtsi32_si128(preShift);
+    __m128i post = _mm_cvtsi32_si128(postShift);
+    __m256i a, b;
+    int pos = 0;
+
+    for (; pos < len - 31; pos += 32)
+    {
+        load32AVX2(buf + pos, a, b);
+        a = shiftAVX2(decimate2AVX2<Sup>(a), pre, post);
+        b = shiftAVX2(decimate2AVX2<Sup>(b), pre, post);
+        _mm256_storeu_si256(dst++, packAVX2(a, b));
+    }
+
+    return pos;
+}
+
+template<typename T, bool Sup>
+AVX2_TARGET static int decimate4AVX2(Sample *out, const T *buf, int len, int preShift, int postShift)
+{
+    __m256i *dst = (__m256i*) out;
+    __m128i pre = _mm_cvtsi32_si128(preShift);
+    __m128i post = _mm_cvtsi32_si128(postShift);
+    __m256i a, b, c, d;
+    int pos = 0;
+
+    for (; pos < len - 63; pos += 64)
+    {
+        load32AVX2(buf + pos, a, b);
+        load32AVX2(buf + pos + 32, c, d);
+        a = decimate2AVX2<Sup>(a);
+        b = decimate2AVX2<Sup>(b);
+        c = decimate2AVX2<Sup>(c);
+        d = decimate2AVX2<Sup>(d);
+        // groups come out as 0 2 | 1 3 in the lanes
+        a = _mm256_add_epi32(_mm256_unpacklo_epi64(a, b), _mm256_unpackhi_epi64(a, b));
+        c = _mm256_add_epi32(_mm256_unpacklo_epi64(c, d), _mm256_unpackhi_epi64(c, d));
+        a = shiftAVX2(_mm256_permute4x64_epi64(a, _MM_SHUFFLE(3,1,2,0)), pre, post);
+        c = shiftAVX2(_mm256_permute4x64_epi64(c, _MM_SHUFFLE(3,1,2,0)), pre, post);
+        _mm256_storeu_si256(dst++, packAVX2(a, c));
+    }
+
+    return pos;
+}
+
+#endif // DECIMATORSSIMD_AVX2
+
+#ifdef DECIMATORSSIMD_NEON
+
+// De-interleave 8 groups of 4 values (2 I/Q pairs): v0 = b0 b4 b8 ..., v1 = b1 b5 b9 ...
+
+template<typename T> static inline int16x8x4_t load32NEON(const T *buf);
+
+template<> inline int16x8x4_t load32NEON<qint16>(const qint16 *buf)
+{
+    return vld4q_s16(buf);
+}
+
+template<> inline int16x8x4_t load32NEON<quint8>(const quint8 *buf)
+{
+    uint8x8x4_t x = vld4_u8(buf);
+    int16x8x4_t v;
+    v.val[0] = vreinterpretq_s16_u16(vmovl_u8(x.val[0]));
+    v.val[1] = vreinterpretq_s16_u16(vmovl_u8(x.val[1]));
+    v.val[2] = vreinterpretq_s16_u16(vmovl_u8(x.val[2]));
+    v.val[3] = vreinterpretq_s16_u16(vmovl_u8(x.val[3]));
+    return v;
+}
+
+template<> inline int16x8x4_t load32NEON<qint8>(const qint8 *buf)
+{
+    int8x8x4_t x = vld4_s8(buf);
+    int16x8x4_t v;
+    v.val[0] = vmovl_s8(x.val[0]);
+    v.val[1] = vmovl_s8(x.val[1]);
+    v.val[2] = vmovl_s8(x.val[2]);
+    v.val[3] = vmovl_s8(x.val[3]);
+    return v;
+}
+
+/** Real and imaginary parts of the 8 decimated pairs, low then high halves. Second pair of each group is negated */
+template<bool Sup>
+static inline void decimate2NEON(const int16x8x4_t& v, int32x4_t *re, int32x4_t *im)
+{
+    static const int32_t signs[4] = {1, -1, 1, -1};
+    int32x4_t sign = vld1q_s32(signs);
+
+    if (Sup)
+    {
+        re[0] = vmulq_s32(vsubl_s16(vget_low_s16(v.val[1]), vget_low_s16(v.val[2])), sign);
+        re[1] = vmulq_s32(vsubl_s16(vget_high_s16(v.val[1]), vget_high_s16(v.val[2])), sign);
+        im[0] = vnegq_s32(vmulq_s32(vaddl_s16(vget_low_s16(v.val[0]), vget_low_s16(v.val[3])), sign));
+        im[1] = vnegq_s32(vmulq_s32(vaddl_s16(vget_high_s16(v.val[0]), vget_high_s16(v.val[3])), sign));
+    }
+    else
+    {
+        re[0] = vmulq_s32(vsubl_s16(vget_low_s16(v.val[0]), vget_low_s16(v.val[3])), sign);
+        re[1] = vmulq_s32(vsubl_s16(vget_high_s16(v.val[0]), vget_high_s16(v.val[3])), sign);
+        im[0] = vmulq_s32(vaddl_s16(vget_low_s16(v.val[1]), vget_low_s16(v.val[2])), sign);
+        im[1] = vmulq_s32(vaddl_s16(vget_high_s16(v.val[1]), vget_high_s16(v.val[2])), sign);
+    }
+}
+
+static inline int32x4_t shiftNEON(int32x4_t x, int32x4_t preShift, int32x4_t postShift)
+{
+    return vshlq_s32(vshlq_s32(x, preShift), postShift); // negative count is an arithmetic right shift
+}
+
+template<typename T>
+static int decimate1NEON(Sample *out, const T *buf, int len, int preShift, int)
+{
+    int16x8x4_t v;
+    int16x8_t pre = vdupq_n_s16(preShift);
+    int pos = 0;
+
+    for (; pos < len - 31; pos += 32)
+    {
+        v = load32NEON(buf + pos);
+        v.val[0] = vshlq_s16(v.val[0], pre);
+        v.val[1] = vshlq_s16(v.val[1], pre);
+        v.val[2] = vshlq_s16(v.val[2], pre);
+        v.val[3] = vshlq_s16(v.val[3], pre);
+        vst4q_s16((int16_t*) (out + pos/2), v);
+    }
+
+    return pos;
+}
+
+template<typename T, bool Sup>
+static int decimate2NEON(Sample *out, const T *buf, int len, int preShift, int postShift)
+{
+    int32x4_t re[2], im[2];
+    int32x4_t pre = vdupq_n_s32(preShift);
+    int32x4_t post = vdupq_n_s32(-postShift);
+    int16x8x2_t s;
+    int pos = 0;
+
+    for (; pos < len - 31; pos += 32)
+    {
+        decimate2NEON<Sup>(load32NEON(buf + pos), re, im);
+        s.val[0] = vcombine_s16(vmovn_s32(shiftNEON(re[0], pre, post)), vmovn_s32(shiftNEON(re[1], pre, post)));
+        s.val[1] = vcombine_s16(vmovn_s32(shiftNEON(im[0], pre, post)), vmovn_s32(shiftNEON(im[1], pre, post)));
+        vst2q_s16((int16_t*) (out + pos/4), s);
+    }
+
+    return pos;
+}
+
+template<typename T, bool Sup>
+static int decimate4NEON(Sample *out, const T *buf, int len, int preShift, int postShift)
+{
+    int32x4_t re[2], im[2];
+    int32x4_t pre = vdupq_n_s32(preShift);
+    int32x4_t post = vdupq_n_s32(-postShift);
+    int16x4x2_t s;
+    int pos = 0;
+
+    for (; pos < len - 31; pos += 32)
+    {
+        decimate2NEON<Sup>(load32NEON(buf + pos), re, im);
+        // add the two pairs of each group
+        int32x4_t re4 = vcombine_s32(vpadd_s32(vget_low_s32(re[0]), vget_high_s32(re[0])), vpadd_s32(vget_low_s32(re[1]), vget_high_s32(re[1])));
+        int32x4_t im4 = vcombine_s32(vpadd_s32(vget_low_s32(im[0]), vget_high_s32(im[0])), vpadd_s32(vget_low_s32(im[1]), vget_high_s32(im[1])));
+        s.val[0] = vmovn_s32(shiftNEON(re4, pre, post));
+        s.val[1] = vmovn_s32(shiftNEON(im4, pre, post));
+        vst2_s16((int16_t*) (out + pos/8), s);
+    }
+
+    return pos;
+}
+
+#endif // DECIMATORSSIMD_NEON
+
+DecimatorsSIMD::Level DecimatorsSIMD::m_level = DecimatorsSIMD::getDetectedLevel();
+
+DecimatorsSIMD::Level DecimatorsSIMD::getDetectedLevel()
+{
+#if defined(DECIMATORSSIMD_AVX2)
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2")) {
+        return LevelAVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return LevelSSE2;
+    } else {
+        return LevelNone;
+    }
+#elif defined(DECIMATORSSIMD_X86)
+    return LevelSSE2;
+#elif defined(DECIMATORSSIMD_NEON)
+    return LevelNEON;
+#else
+    return LevelNone;
+#endif
+}
+
+void DecimatorsSIMD::setLevel(Level level)
+{
+    Level detected = getDetectedLevel();
+
+    if ((level == LevelNone) || (level == detected) || ((level == LevelSSE2) && (detected == LevelAVX2))) {
+        m_level = level;
+    } else {
+        m_level = detected;
+    }
+}
+
+const char *DecimatorsSIMD::getLevelName(Level level)
+{
+    switch (level)
+    {
+    case LevelSSE2:
+        return "SSE2";
+    case LevelAVX2:
+        return "AVX2";
+    case LevelNEON:
+        return "NEON";
+    default:
+        return "none";
+    }
+}
+
+template<typename T>
+static const DecimatorsSIMD::Kernels<T>& selectKernels(DecimatorsSIMD::Level level)
+{
+    static const DecimatorsSIMD::Kernels<T> none = {0, 0, 0, 0, 0};
+#ifdef DECIMATORSSIMD_X86
+    static const DecimatorsSIMD::Kernels<T> sse2 = {
+        &decimate1SSE2<T>,
+        &decimate2SSE2<T, false>,
+        &decimate2SSE2<T, true>,
+        &decimate4SSE2<T, false>,
+        &decimate4SSE2<T, true>
+    };
+#endif
+#ifdef DECIMATORSSIMD_AVX2
+    static const DecimatorsSIMD::Kernels<T> avx2 = {
+        &decimate1AVX2<T>,
+        &decimate2AVX2<T, false>,
+        &decimate2AVX2<T, true>,
+        &decimate4AVX2<T, false>,
+        &decimate4AVX2<T, true>
+    };
+#endif
+#ifdef DECIMATORSSIMD_NEON
+    static const DecimatorsSIMD::Kernels<T> neon = {
+        &decimate1NEON<T>,
+        &decimate2NEON<T, false>,
+        &decimate2NEON<T, true>,
+        &decimate4NEON<T, false>,
+        &decimate4NEON<T, true>
+    };
+#endif
+
+    switch (level)
+    {
+#ifdef DECIMATORSSIMD_X86
+    case DecimatorsSIMD::LevelSSE2:
+        return sse2;
+#endif
+#ifdef DECIMATORSSIMD_AVX2
+    case DecimatorsSIMD::LevelAVX2:
+        return avx2;
+#endif
+#ifdef DECIMATORSSIMD_NEON
+    case DecimatorsSIMD::LevelNEON:
+        return neon;
+#endif
+    default:
+        return none;
+    }
+}
+
+template<>
+const DecimatorsSIMD::Kernels<quint8>& DecimatorsSIMD::kernels<quint8>()
+{
+    return selectKernels<quint8>(m_level);
+}
+
+template<>
+const DecimatorsSIMD::Kernels<qint8>& DecimatorsSIMD::kernels<qint8>()
+{
+    return selectKernels<qint8>(m_level);
+}
+
+template<>
+const DecimatorsSIMD::Kernels<qint16>& DecimatorsSIMD::kernels<qint16>()
+{
+    return selectKernels<qint16>(m_level);
+}
@@ -0,0 +1,75 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_DECIMATORSSIMD_H_
+#define SDRBASE_DSP_DECIMATORSSIMD_H_
+
+#include <QtGlobal>
+#include "dsp/dsptypes.h"
+#include "util/export.h"
+
+/**
+ * Vectorized kernels for the first Decimators stages (no decimation and the offset tuning
+ * decimations by 2 and 4) on interleaved I/Q input. The best instruction set available is
+ * selected at run time: AVX2 or SSE2 on x86, NEON on ARM when it is enabled at build time.
+ *
+ * Kernels produce exactly the same samples as the scalar code. They process whole blocks of
+ * input and return the number of input values consumed. The caller finishes with scalar code.
+ */
+class SDRANGEL_API DecimatorsSIMD
+{
+public:
+    enum Level
+    {
+        LevelNone,
+        LevelSSE2,
+        LevelAVX2,
+        LevelNEON
+    };
+
+    template<typename T>
+    struct Kernels
+    {
+        typedef int (*Kernel)(Sample *out, const T *buf, int len, int preShift, int postShift);
+        Kernel decimate1;
+        Kernel decimate2_inf;
+        Kernel decimate2_sup;
+        Kernel decimate4_inf;
+        Kernel decimate4_sup;
+    };
+
+    /** Kernels for the current level. All null for input types without vectorized kernels */
+    template<typename T> static const Kernels<T>& kernels()
+    {
+        static const Kernels<T> none = {0, 0, 0, 0, 0};
+        return none;
+    }
+
+    static Level getLevel() { return m_level; }
+    static Level getDetectedLevel();        //!< best level supported by this CPU and build
+    static void setLevel(Level level);      //!< capped to the detected level. Mostly for benchmarking.
+    static const char *getLevelName(Level level);
+
+private:
+    static Level m_level;
+};
+
+template<> SDRANGEL_API const DecimatorsSIMD::Kernels<quint8>& DecimatorsSIMD::kernels<quint8>();
+template<> SDRANGEL_API const DecimatorsSIMD::Kernels<qint8>& DecimatorsSIMD::kernels<qint8>();
+template<> SDRANGEL_API const DecimatorsSIMD::Kernels<qint16>& DecimatorsSIMD::kernels<qint16>();
+
+#endif /* SDRBASE_DSP_DECIMATORSSIMD_H_ */
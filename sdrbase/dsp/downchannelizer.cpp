@@ -23,6 +23,7 @@
 #include <QDebug>
 
 MESSAGE_CLASS_DEFINITION(DownChannelizer::MsgChannelizerNotification, Message)
+MESSAGE_CLASS_DEFINITION(DownChannelizer::MsgChannelizerInput, Message)
 
 DownChannelizer::DownChannelizer(BasebandSampleSink* sampleSink) :
 	m_sampleSink(sampleSink),
@@ -30,7 +31,11 @@ DownChannelizer::DownChannelizer(BasebandSampleSink* sampleSink) :
 	m_requestedOutputSampleRate(0),
 	m_requestedCenterFrequency(0),
 	m_currentOutputSampleRate(0),
-	m_currentCenterFrequency(0)
+	m_currentCenterFrequency(0),
+	m_normalizeFunction(0),
+	m_blockProcessing(true),
+	m_sliceSampleRate(0),
+	m_sliceCenterFrequency(0)
 {
 	QString name = "DownChannelizer(" + m_sampleSink->objectName() + ")";
 	setObjectName(name);
@@ -60,34 +65,65 @@ void DownChannelizer::feed(const SampleVector::const_iterator& begin, const Samp
 	}
 	else
 	{
-		m_mutex.lock();
+		if (m_blockProcessing) {
+			feedBlock(begin, end);
+		} else {
+			feedSampleBySample(begin, end);
+		}
 
-		for(SampleVector::const_iterator sample = begin; sample != end; ++sample)
-		{
-			Sample s(*sample);
-			FilterStages::iterator stage = m_filterStages.begin();
+		m_sampleSink->feed(m_sampleBuffer.begin(), m_sampleBuffer.end(), positiveOnly);
+		m_sampleBuffer.clear();
+	}
+}
 
-			for (; stage != m_filterStages.end(); ++stage)
-			{
-				if(!(*stage)->work(&s))
-				{
-					break;
-				}
-			}
+void DownChannelizer::feedBlock(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end)
+{
+	m_mutex.lock();
+
+	m_sampleBuffer.assign(begin, end); // keeps capacity from previous calls
+
+	if (m_sampleBuffer.size() > 0)
+	{
+		int nbSamples = m_sampleBuffer.size();
+		Sample *samples = &m_sampleBuffer[0];
+
+		for (FilterStages::iterator stage = m_filterStages.begin(); (stage != m_filterStages.end()) && (nbSamples > 0); ++stage) {
+			nbSamples = (*stage)->workBlock(samples, nbSamples);
+		}
 
-			if(stage == m_filterStages.end())
+		(*m_normalizeFunction)(samples, nbSamples);
+		m_sampleBuffer.resize(nbSamples);
+	}
+
+	m_mutex.unlock();
+}
+
+void DownChannelizer::feedSampleBySample(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end)
+{
+	m_mutex.lock();
+
+	for(SampleVector::const_iterator sample = begin; sample != end; ++sample)
+	{
+		Sample s(*sample);
+		FilterStages::iterator stage = m_filterStages.begin();
+
+		for (; stage != m_filterStages.end(); ++stage)
+		{
+			if(!(*stage)->work(&s))
 			{
-			    s.m_real /= (1<<(m_filterStages.size()));
-			    s.m_imag /= (1<<(m_filterStages.size()));
-				m_sampleBuffer.push_back(s);
+				break;
 			}
 		}
 
-		m_mutex.unlock();
-
-		m_sampleSink->feed(m_sampleBuffer.begin(), m_sampleBuffer.end(), positiveOnly);
-		m_sampleBuffer.clear();
+		if(stage == m_filterStages.end())
+		{
+			s.m_real /= (1<<(m_filterStages.size()));
+			s.m_imag /= (1<<(m_filterStages.size()));
+			m_sampleBuffer.push_back(s);
+		}
 	}
+
+	m_mutex.unlock();
 }
 
 void DownChannelizer::start()
@@ -118,6 +154,8 @@ bool DownChannelizer::handleMessage(const Message& cmd)
 	{
 		DSPSignalNotification& notif = (DSPSignalNotification&) cmd;
 		m_inputSampleRate = notif.getSampleRate();
+		m_sliceSampleRate = 0; // the engine re-assigns bank slices after a baseband change
+		m_sliceCenterFrequency = 0;
 		qDebug() << "DownChannelizer::handleMessage: DSPSignalNotification: m_inputSampleRate: " << m_inputSampleRate;
 		applyConfiguration();
 
@@ -143,6 +181,20 @@ bool DownChannelizer::handleMessage(const Message& cmd)
 
 		return true;
 	}
+	else if (MsgChannelizerInput::match(cmd))
+	{
+		MsgChannelizerInput& input = (MsgChannelizerInput&) cmd;
+		m_sliceSampleRate = input.getSampleRate();
+		m_sliceCenterFrequency = input.getFrequencyOffset();
+
+		qDebug() << "DownChannelizer::handleMessage: MsgChannelizerInput:"
+				<< " m_sliceSampleRate: " << m_sliceSampleRate
+				<< " m_sliceCenterFrequency: " << m_sliceCenterFrequency;
+
+		applyConfiguration();
+
+		return true;
+	}
 	else
 	{
 		if (m_sampleSink != 0)
@@ -164,21 +216,27 @@ void DownChannelizer::applyConfiguration()
 		return;
 	}
 
+	// when fed by a channelizer bank the chain is built over the slice only
+	int inputSampleRate = m_sliceSampleRate == 0 ? m_inputSampleRate : m_sliceSampleRate;
+	int channelCenterFrequency = m_requestedCenterFrequency - m_sliceCenterFrequency;
+
 	m_mutex.lock();
 
 	freeFilterChain();
 
 	m_currentCenterFrequency = createFilterChain(
-		m_inputSampleRate / -2, m_inputSampleRate / 2,
-		m_requestedCenterFrequency - m_requestedOutputSampleRate / 2, m_requestedCenterFrequency + m_requestedOutputSampleRate / 2);
+		inputSampleRate / -2, inputSampleRate / 2,
+		channelCenterFrequency - m_requestedOutputSampleRate / 2, channelCenterFrequency + m_requestedOutputSampleRate / 2);
+	m_normalizeFunction = getNormalizeFunction(m_filterStages.size());
 
 	m_mutex.unlock();
 
 	//debugFilterChain();
 
-	m_currentOutputSampleRate = m_inputSampleRate / (1 << m_filterStages.size());
+	m_currentOutputSampleRate = inputSampleRate / (1 << m_filterStages.size());
 
 	qDebug() << "DownChannelizer::applyConfiguration in=" << m_inputSampleRate
+			<< ", slice=" << m_sliceSampleRate
 			<< ", req=" << m_requestedOutputSampleRate
 			<< ", out=" << m_currentOutputSampleRate
 			<< ", fc=" << m_currentCenterFrequency;
@@ -190,53 +248,76 @@ void DownChannelizer::applyConfiguration()
 	}
 }
 
-#ifdef USE_SSE4_1
 DownChannelizer::FilterStage::FilterStage(Mode mode) :
-	m_filter(new IntHalfbandFilterEO1<DOWNCHANNELIZER_HB_FILTER_ORDER>),
+	m_ops(0),
+	m_filter(0),
 	m_workFunction(0),
-	m_mode(mode),
-	m_sse(true)
+	m_blockWorkFunction(0),
+	m_mode(mode)
 {
 	switch(mode) {
 		case ModeCenter:
-			m_workFunction = &IntHalfbandFilterEO1<DOWNCHANNELIZER_HB_FILTER_ORDER>::workDecimateCenter;
+			m_ops = &HBFilterSelector::get(HBFilterSelector::DownChannelizerCenter);
+			m_workFunction = m_ops->m_decimate[HBFilterOps::ModeCenter];
+			m_blockWorkFunction = m_ops->m_decimateBlock[HBFilterOps::ModeCenter];
 			break;
 
 		case ModeLowerHalf:
-			m_workFunction = &IntHalfbandFilterEO1<DOWNCHANNELIZER_HB_FILTER_ORDER>::workDecimateLowerHalf;
+			m_ops = &HBFilterSelector::get(HBFilterSelector::DownChannelizerLowerHalf);
+			m_workFunction = m_ops->m_decimate[HBFilterOps::ModeLowerHalf];
+			m_blockWorkFunction = m_ops->m_decimateBlock[HBFilterOps::ModeLowerHalf];
 			break;
 
 		case ModeUpperHalf:
-			m_workFunction = &IntHalfbandFilterEO1<DOWNCHANNELIZER_HB_FILTER_ORDER>::workDecimateUpperHalf;
+			m_ops = &HBFilterSelector::get(HBFilterSelector::DownChannelizerUpperHalf);
+			m_workFunction = m_ops->m_decimate[HBFilterOps::ModeUpperHalf];
+			m_blockWorkFunction = m_ops->m_decimateBlock[HBFilterOps::ModeUpperHalf];
 			break;
 	}
+
+	m_filter = (*m_ops->m_create)();
 }
-#else
-DownChannelizer::FilterStage::FilterStage(Mode mode) :
-	m_filter(new IntHalfbandFilterDB<DOWNCHANNELIZER_HB_FILTER_ORDER>),
-	m_workFunction(0),
-	m_mode(mode),
-	m_sse(false)
-{
-	switch(mode) {
-		case ModeCenter:
-			m_workFunction = &IntHalfbandFilterDB<DOWNCHANNELIZER_HB_FILTER_ORDER>::workDecimateCenter;
-			break;
 
-		case ModeLowerHalf:
-			m_workFunction = &IntHalfbandFilterDB<DOWNCHANNELIZER_HB_FILTER_ORDER>::workDecimateLowerHalf;
-			break;
+DownChannelizer::FilterStage::~FilterStage()
+{
+	(*m_ops->m_destroy)(m_filter);
+}
 
-		case ModeUpperHalf:
-			m_workFunction = &IntHalfbandFilterDB<DOWNCHANNELIZER_HB_FILTER_ORDER>::workDecimateUpperHalf;
-			break;
+/** Compensates the gain of Depth half band stages. Division by a constant is turned into shifts by the compiler */
+template<unsigned int Depth>
+void DownChannelizer::normalizeBlock(Sample* samples, int nbSamples)
+{
+	for (int i = 0; i < nbSamples; i++)
+	{
+		samples[i].m_real /= (1<<Depth);
+		samples[i].m_imag /= (1<<Depth);
 	}
 }
-#endif
 
-DownChannelizer::FilterStage::~FilterStage()
+DownChannelizer::NormalizeFunction DownChannelizer::getNormalizeFunction(unsigned int depth)
 {
-	delete m_filter;
+	// beyond 16 stages a 16 bit sample is shifted out completely anyway
+	static const NormalizeFunction normalizeFunctions[17] = {
+		&DownChannelizer::normalizeBlock<0>,
+		&DownChannelizer::normalizeBlock<1>,
+		&DownChannelizer::normalizeBlock<2>,
+		&DownChannelizer::normalizeBlock<3>,
+		&DownChannelizer::normalizeBlock<4>,
+		&DownChannelizer::normalizeBlock<5>,
+		&DownChannelizer::normalizeBlock<6>,
+		&DownChannelizer::normalizeBlock<7>,
+		&DownChannelizer::normalizeBlock<8>,
+		&DownChannelizer::normalizeBlock<9>,
+		&DownChannelizer::normalizeBlock<10>,
+		&DownChannelizer::normalizeBlock<11>,
+		&DownChannelizer::normalizeBlock<12>,
+		&DownChannelizer::normalizeBlock<13>,
+		&DownChannelizer::normalizeBlock<14>,
+		&DownChannelizer::normalizeBlock<15>,
+		&DownChannelizer::normalizeBlock<16>
+	};
+
+	return normalizeFunctions[depth < 16 ? depth : 16];
 }
 
 bool DownChannelizer::signalContainsChannel(Real sigStart, Real sigEnd, Real chanStart, Real chanEnd) const
@@ -304,16 +385,16 @@ void DownChannelizer::debugFilterChain()
         switch ((*it)->m_mode)
         {
         case FilterStage::ModeCenter:
-            qDebug("DownChannelizer::debugFilterChain: center %s", (*it)->m_sse ? "sse" : "no_sse");
+            qDebug("DownChannelizer::debugFilterChain: center %s%u", (*it)->m_ops->m_name, (*it)->m_ops->m_order);
             break;
         case FilterStage::ModeLowerHalf:
-            qDebug("DownChannelizer::debugFilterChain: lower %s", (*it)->m_sse ? "sse" : "no_sse");
+            qDebug("DownChannelizer::debugFilterChain: lower %s%u", (*it)->m_ops->m_name, (*it)->m_ops->m_order);
             break;
         case FilterStage::ModeUpperHalf:
-            qDebug("DownChannelizer::debugFilterChain: upper %s", (*it)->m_sse ? "sse" : "no_sse");
+            qDebug("DownChannelizer::debugFilterChain: upper %s%u", (*it)->m_ops->m_name, (*it)->m_ops->m_order);
             break;
         default:
-            qDebug("DownChannelizer::debugFilterChain: none %s", (*it)->m_sse ? "sse" : "no_sse");
+            qDebug("DownChannelizer::debugFilterChain: none %s%u", (*it)->m_ops->m_name, (*it)->m_ops->m_order);
             break;
         }
     }
@@ -19,15 +19,11 @@
 #define SDRBASE_DSP_DOWNCHANNELIZER_H
 
 #include <dsp/basebandsamplesink.h>
-#include <list>
+#include <vector>
 #include <QMutex>
 #include "util/export.h"
 #include "util/message.h"
-#ifdef USE_SSE4_1
-#include "dsp/inthalfbandfiltereo1.h"
-#else
-#include "dsp/inthalfbandfilterdb.h"
-#endif
+#include "dsp/hbfilterselector.h"
 
 #define DOWNCHANNELIZER_HB_FILTER_ORDER 48
 
@@ -54,11 +50,37 @@ public:
 		qint64 m_frequencyOffset;
 	};
 
+	/**
+	 * Sent by the device engine when the channelizer is fed with a slice of a channelizer bank
+	 * instead of the full baseband. A sample rate of 0 means back to full baseband.
+	 */
+	class SDRANGEL_API MsgChannelizerInput : public Message {
+		MESSAGE_CLASS_DECLARATION
+
+	public:
+		MsgChannelizerInput(int samplerate, qint64 frequencyOffset) :
+			Message(),
+			m_sampleRate(samplerate),
+			m_frequencyOffset(frequencyOffset)
+		{ }
+
+		int getSampleRate() const { return m_sampleRate; }             //!< slice sample rate
+		qint64 getFrequencyOffset() const { return m_frequencyOffset; } //!< slice center relative to baseband center
+
+	private:
+		int m_sampleRate;
+		qint64 m_frequencyOffset;
+	};
+
 	DownChannelizer(BasebandSampleSink* sampleSink);
 	virtual ~DownChannelizer();
 
 	void configure(MessageQueue* messageQueue, int sampleRate, int centerFrequency);
 	int getInputSampleRate() const { return m_inputSampleRate; }
+	int getRequestedOutputSampleRate() const { return m_requestedOutputSampleRate; }
+	int getRequestedCenterFrequency() const { return m_requestedCenterFrequency; }
+	void setBlockProcessing(bool blockProcessing) { m_blockProcessing = blockProcessing; } //!< true: run each stage over the whole buffer, false: legacy per sample path
+	bool getBlockProcessing() const { return m_blockProcessing; }
 
 	virtual void start();
 	virtual void stop();
@@ -73,26 +95,28 @@ protected:
 			ModeUpperHalf
 		};
 
-#ifdef USE_SSE4_1
-		typedef bool (IntHalfbandFilterEO1<DOWNCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(Sample* s);
-		IntHalfbandFilterEO1<DOWNCHANNELIZER_HB_FILTER_ORDER>* m_filter;
-#else
-		typedef bool (IntHalfbandFilterDB<DOWNCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(Sample* s);
-		IntHalfbandFilterDB<DOWNCHANNELIZER_HB_FILTER_ORDER>* m_filter;
-#endif
-		WorkFunction m_workFunction;
+		const HBFilterOps* m_ops; //!< half band filter class selected for the mode
+		void* m_filter;
+		HBFilterOps::DecimateFunction m_workFunction;
+		HBFilterOps::DecimateBlockFunction m_blockWorkFunction; //!< mode specialized block decimator bound at construction
 		Mode m_mode;
-		bool m_sse;
 
 		FilterStage(Mode mode);
 		~FilterStage();
 
 		bool work(Sample* sample)
 		{
-			return (m_filter->*m_workFunction)(sample);
+			return (*m_workFunction)(m_filter, sample);
+		}
+
+		/** Decimate nbSamples in place. Returns the number of output samples left at the start of the buffer */
+		int workBlock(Sample* samples, int nbSamples)
+		{
+			return (*m_blockWorkFunction)(m_filter, samples, nbSamples);
 		}
 	};
-	typedef std::list<FilterStage*> FilterStages;
+	typedef std::vector<FilterStage*> FilterStages;
+	typedef void (*NormalizeFunction)(Sample* samples, int nbSamples);
 	FilterStages m_filterStages;
 	BasebandSampleSink* m_sampleSink; //!< Demodulator
 	int m_inputSampleRate;
@@ -102,12 +126,21 @@ protected:
 	int m_currentCenterFrequency;
 	SampleVector m_sampleBuffer;
 	QMutex m_mutex;
+	NormalizeFunction m_normalizeFunction; //!< gain compensation specialized by decimation depth
+	bool m_blockProcessing;
+	int m_sliceSampleRate;        //!< sample rate of the channelizer bank slice or 0 if fed with full baseband
+	qint64 m_sliceCenterFrequency; //!< center of the channelizer bank slice relative to baseband center
 
 	void applyConfiguration();
 	bool signalContainsChannel(Real sigStart, Real sigEnd, Real chanStart, Real chanEnd) const;
 	Real createFilterChain(Real sigStart, Real sigEnd, Real chanStart, Real chanEnd);
 	void freeFilterChain();
 	void debugFilterChain();
+	void feedBlock(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end);
+	void feedSampleBySample(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end);
+
+	template<unsigned int Depth> static void normalizeBlock(Sample* samples, int nbSamples);
+	static NormalizeFunction getNormalizeFunction(unsigned int depth);
 
 signals:
 	void inputSampleRateChanged();
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+
+#include "dsp/driftresampler.h"
+
+DriftResampler::DriftResampler() :
+    m_ratio(1.0),
+    m_mu(0.0)
+{
+    reset();
+}
+
+void DriftResampler::reset()
+{
+    m_mu = 0.0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        m_i[i] = 0.0f;
+        m_q[i] = 0.0f;
+    }
+}
+
+int DriftResampler::getNbInputSamples(int nbOutputSamples) const
+{
+    if (nbOutputSamples <= 0) {
+        return 0;
+    }
+
+    // one input sample is taken each time the position crosses 1 before an output sample is produced
+    int nbInputSamples = (int) std::floor(m_mu + (nbOutputSamples - 1) * m_ratio);
+    return nbInputSamples < 0 ? 0 : nbInputSamples;
+}
+
+void DriftResampler::resample(const qint16 *in, int nbIn, qint16 *out, int nbOut)
+{
+    int consumed = 0;
+
+    for (int k = 0; k < nbOut; k++)
+    {
+        while ((m_mu >= 1.0) && (consumed < nbIn))
+        {
+            push(&in[2*consumed]);
+            consumed++;
+            m_mu -= 1.0;
+        }
+
+        float mu = m_mu < 0.0 ? 0.0f : m_mu > 1.0 ? 1.0f : (float) m_mu; // holds if the input falls short
+        out[2*k]   = clamp(interpolate(m_i, mu));
+        out[2*k+1] = clamp(interpolate(m_q, mu));
+        m_mu += m_ratio;
+    }
+
+    while (consumed < nbIn) // rounding of getNbInputSamples: do not lose input
+    {
+        push(&in[2*consumed]);
+        consumed++;
+        m_mu -= 1.0;
+    }
+}
@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_DRIFTRESAMPLER_H_
+#define SDRBASE_DSP_DRIFTRESAMPLER_H_
+
+#include <QtGlobal>
+#include "util/export.h"
+
+/**
+ * Fractional resampler of interleaved 16 bit I/Q samples for ratios close to 1. It absorbs the
+ * difference between the clock of a remote stream and the local clock by consuming slightly more
+ * or fewer input samples than it outputs. Samples are interpolated with a 4 point cubic (Catmull-Rom)
+ * between the two central samples of a sliding window so the phase advances smoothly instead of
+ * samples being dropped or repeated. With a ratio of exactly 1 it passes samples through unchanged
+ * with a delay of three samples.
+ *
+ * Use getNbInputSamples() to know how many samples to take from the source for the number of
+ * output samples wanted then resample() with these samples. The ratio may change between calls.
+ */
+class SDRANGEL_API DriftResampler
+{
+public:
+    DriftResampler();
+
+    void reset();
+    void setRatio(double ratio) { m_ratio = ratio; } //!< input samples consumed per output sample
+    double getRatio() const { return m_ratio; }
+
+    /** Number of I/Q samples to be given to resample() to produce nbOutputSamples */
+    int getNbInputSamples(int nbOutputSamples) const;
+    /** Produces nbOut I/Q samples in out from the nbIn I/Q samples of in */
+    void resample(const qint16 *in, int nbIn, qint16 *out, int nbOut);
+
+private:
+    double m_ratio;
+    double m_mu;      //!< position of the next output sample after m_i[1]. Input is taken when it reaches 1.
+    float m_i[4];     //!< sliding window of I components
+    float m_q[4];     //!< sliding window of Q components
+
+    inline void push(const qint16 *sample)
+    {
+        m_i[0] = m_i[1]; m_i[1] = m_i[2]; m_i[2] = m_i[3]; m_i[3] = sample[0];
+        m_q[0] = m_q[1]; m_q[1] = m_q[2]; m_q[2] = m_q[3]; m_q[3] = sample[1];
+    }
+
+    static inline float interpolate(const float *x, float mu)
+    {
+        float a = -0.5f*x[0] + 1.5f*x[1] - 1.5f*x[2] + 0.5f*x[3];
+        float b = x[0] - 2.5f*x[1] + 2.0f*x[2] - 0.5f*x[3];
+        float c = -0.5f*x[0] + 0.5f*x[2];
+        return ((a*mu + b)*mu + c)*mu + x[1];
+    }
+
+    static inline qint16 clamp(float x)
+    {
+        x = x < 0 ? x - 0.5f : x + 0.5f;
+        return x < -32768.0f ? -32768 : x > 32767.0f ? 32767 : (qint16) x;
+    }
+};
+
+#endif /* SDRBASE_DSP_DRIFTRESAMPLER_H_ */
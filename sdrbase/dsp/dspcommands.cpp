@@ -43,6 +43,8 @@ MESSAGE_CLASS_DEFINITION(DSPAddAudioSink, Message)
 MESSAGE_CLASS_DEFINITION(DSPRemoveAudioSink, Message)
 //MESSAGE_CLASS_DEFINITION(DSPConfigureSpectrumVis, Message)
 MESSAGE_CLASS_DEFINITION(DSPConfigureCorrection, Message)
+MESSAGE_CLASS_DEFINITION(DSPConfigureChannelizerBank, Message)
+MESSAGE_CLASS_DEFINITION(DSPConfigureSinkDispatch, Message)
 MESSAGE_CLASS_DEFINITION(DSPEngineReport, Message)
 MESSAGE_CLASS_DEFINITION(DSPConfigureScopeVis, Message)
 MESSAGE_CLASS_DEFINITION(DSPSignalNotification, Message)
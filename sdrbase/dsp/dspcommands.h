@@ -300,6 +300,39 @@ private:
 
 };
 
+class SDRANGEL_API DSPConfigureChannelizerBank : public Message {
+	MESSAGE_CLASS_DECLARATION
+
+public:
+	DSPConfigureChannelizerBank(bool enable, int log2NbChannels) :
+		Message(),
+		m_enable(enable),
+		m_log2NbChannels(log2NbChannels)
+	{ }
+
+	bool getEnable() const { return m_enable; }
+	int getLog2NbChannels() const { return m_log2NbChannels; }
+
+private:
+	bool m_enable;
+	int m_log2NbChannels;
+};
+
+class SDRANGEL_API DSPConfigureSinkDispatch : public Message {
+	MESSAGE_CLASS_DECLARATION
+
+public:
+	DSPConfigureSinkDispatch(bool parallel) :
+		Message(),
+		m_parallel(parallel)
+	{ }
+
+	bool getParallel() const { return m_parallel; }
+
+private:
+	bool m_parallel;
+};
+
 class SDRANGEL_API DSPEngineReport : public Message {
 	MESSAGE_CLASS_DECLARATION
 
@@ -25,6 +25,7 @@
 #include "dsp/basebandsamplesink.h"
 #include "dsp/devicesamplesink.h"
 #include "dsp/dspcommands.h"
+#include "dsp/samplesourcemixer.h"
 #include "samplesourcefifo.h"
 #include "threadedbasebandsamplesource.h"
 
@@ -38,7 +39,8 @@ DSPDeviceSinkEngine::DSPDeviceSinkEngine(uint32_t uid, QObject* parent) :
 	m_spectrumSink(0),
 	m_sampleRate(0),
 	m_centerFrequency(0),
-	m_multipleSourcesDivisionFactor(1)
+	m_multipleSourcesDivisionFactor(1),
+	m_sourceMixer(0)
 {
 	connect(&m_inputMessageQueue, SIGNAL(messageEnqueued()), this, SLOT(handleInputMessages()), Qt::QueuedConnection);
 	connect(&m_syncMessenger, SIGNAL(messageSent()), this, SLOT(handleSynchronousMessages()), Qt::QueuedConnection);
@@ -49,6 +51,10 @@ DSPDeviceSinkEngine::DSPDeviceSinkEngine(uint32_t uid, QObject* parent) :
 DSPDeviceSinkEngine::~DSPDeviceSinkEngine()
 {
 	wait();
+
+	if (m_sourceMixer) {
+	    delete m_sourceMixer;
+	}
 }
 
 void DSPDeviceSinkEngine::run()
@@ -255,55 +261,28 @@ void DSPDeviceSinkEngine::work(int nbWriteSamples)
 
 	    SampleVector::iterator writeBegin;
 	    sampleFifo->getWriteIterator(writeBegin);
-	    SampleVector::iterator writeAt = writeBegin;
-	    Sample s;
-	    int sourceOccurence = 0;
+
+	    if (!m_sourceMixer) {
+	        m_sourceMixer = new SampleSourceMixer();
+	    }
+
+	    m_sourceMixer->clear();
 
 	    for (ThreadedBasebandSampleSources::iterator it = m_threadedBasebandSampleSources.begin(); it != m_threadedBasebandSampleSources.end(); ++it)
 	    {
 	        (*it)->pullAudio(nbWriteSamples);
+	        m_sourceMixer->addSource((*it)->getSource());
 	    }
 
 	    for (BasebandSampleSources::iterator it = m_basebandSampleSources.begin(); it != m_basebandSampleSources.end(); ++it)
 	    {
 	        (*it)->pullAudio(nbWriteSamples);
+	        m_sourceMixer->addSource(*it);
 	    }
 
-	    for (int is = 0; is < nbWriteSamples; is++)
-		{
-			// pull data from threaded sources and merge them in the device sample FIFO
-			for (ThreadedBasebandSampleSources::iterator it = m_threadedBasebandSampleSources.begin(); it != m_threadedBasebandSampleSources.end(); ++it)
-			{
-				(*it)->pull(s);
-				s /= m_multipleSourcesDivisionFactor;
-
-				if (sourceOccurence == 0) {
-				    (*writeAt) = s;
-				} else {
-	                (*writeAt) += s;
-				}
-
-				sourceOccurence++;
-			}
-
-			// pull data from direct sources and merge them in the device sample FIFO
-			for (BasebandSampleSources::iterator it = m_basebandSampleSources.begin(); it != m_basebandSampleSources.end(); ++it)
-			{
-				(*it)->pull(s);
-				s /= m_multipleSourcesDivisionFactor;
-
-                if (sourceOccurence == 0) {
-                    (*writeAt) = s;
-                } else {
-                    (*writeAt) += s;
-                }
-
-                sourceOccurence++;
-			}
-
-			sampleFifo->bumpIndex(writeAt);
-            sourceOccurence = 0;
-		}
+	    // pull data from all sources in parallel and merge them in the device sample FIFO
+	    m_sourceMixer->mix(writeBegin, nbWriteSamples, m_multipleSourcesDivisionFactor);
+	    sampleFifo->bumpIndex(writeBegin, nbWriteSamples);
 
 		// feed the mix to the main spectrum sink
 //		if (m_spectrumSink)
@@ -34,6 +34,7 @@
 class DeviceSampleSink;
 class BasebandSampleSource;
 class ThreadedBasebandSampleSource;
+class SampleSourceMixer;
 class BasebandSampleSink;
 
 class SDRANGEL_API DSPDeviceSinkEngine : public QThread {
@@ -116,6 +117,7 @@ private:
 	uint32_t m_sampleRate;
 	quint64 m_centerFrequency;
 	uint32_t m_multipleSourcesDivisionFactor;
+	SampleSourceMixer *m_sourceMixer; //!< pulls multiple sources in parallel and mixes them in the device sample FIFO
 
 	void run();
 	void work(int nbWriteSamples); //!< transfer samples from beseband sources to sink if in running state
@@ -41,7 +41,11 @@ DSPDeviceSourceEngine::DSPDeviceSourceEngine(uint uid, QObject* parent) :
 	m_qOffset(0),
 	m_iRange(1 << 16),
 	m_qRange(1 << 16),
-	m_imbalance(65536)
+	m_imbalance(65536),
+	m_channelizerBankEnabled(false),
+	m_channelizerBankLog2NbChannels(6),
+	m_parallelSinkDispatch(false),
+	m_sinkDispatcher(0)
 {
 	connect(&m_inputMessageQueue, SIGNAL(messageEnqueued()), this, SLOT(handleInputMessages()), Qt::QueuedConnection);
 	connect(&m_syncMessenger, SIGNAL(messageSent()), this, SLOT(handleSynchronousMessages()), Qt::QueuedConnection);
@@ -52,6 +56,10 @@ DSPDeviceSourceEngine::DSPDeviceSourceEngine(uint uid, QObject* parent) :
 DSPDeviceSourceEngine::~DSPDeviceSourceEngine()
 {
 	wait();
+
+	if (m_sinkDispatcher) {
+		delete m_sinkDispatcher;
+	}
 }
 
 void DSPDeviceSourceEngine::run()
@@ -154,6 +162,20 @@ void DSPDeviceSourceEngine::configureCorrections(bool dcOffsetCorrection, bool i
 	m_inputMessageQueue.push(cmd);
 }
 
+void DSPDeviceSourceEngine::configureChannelizerBank(bool enable, int log2NbChannels)
+{
+	qDebug() << "DSPDeviceSourceEngine::configureChannelizerBank: " << enable << ": " << (1<<log2NbChannels);
+	DSPConfigureChannelizerBank* cmd = new DSPConfigureChannelizerBank(enable, log2NbChannels);
+	m_inputMessageQueue.push(cmd);
+}
+
+void DSPDeviceSourceEngine::configureSinkDispatch(bool parallel)
+{
+	qDebug() << "DSPDeviceSourceEngine::configureSinkDispatch: " << parallel;
+	DSPConfigureSinkDispatch* cmd = new DSPConfigureSinkDispatch(parallel);
+	m_inputMessageQueue.push(cmd);
+}
+
 QString DSPDeviceSourceEngine::errorMessage()
 {
 	qDebug() << "DSPDeviceSourceEngine::errorMessage";
@@ -246,6 +268,10 @@ void DSPDeviceSourceEngine::work()
 	std::size_t samplesDone = 0;
 	bool positiveOnly = false;
 
+	if (m_channelizerBankEnabled) {
+		m_channelizerBank.updateAssignments(m_threadedBasebandSampleSinks); // follows channel frequency changes
+	}
+
 	while ((sampleFifo->fill() > 0) && (m_inputMessageQueue.size() == 0) && (samplesDone < m_sampleRate))
 	{
 		SampleVector::iterator part1begin;
@@ -255,63 +281,160 @@ void DSPDeviceSourceEngine::work()
 
 		std::size_t count = sampleFifo->readBegin(sampleFifo->fill(), &part1begin, &part1end, &part2begin, &part2end);
 
-		// first part of FIFO data
-		if (part1begin != part1end)
+		// correct stuff on both parts before any sink sees them
+		if (m_dcOffsetCorrection)
 		{
-			// correct stuff
-			if (m_dcOffsetCorrection)
-			{
+			if (part1begin != part1end) {
 				dcOffset(part1begin, part1end);
 			}
 
-			if (m_iqImbalanceCorrection)
-			{
-				imbalance(part1begin, part1end);
+			if (part2begin != part2end) {
+				dcOffset(part2begin, part2end);
 			}
+		}
 
-			// feed data to direct sinks
-			for (BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); ++it)
-			{
-				(*it)->feed(part1begin, part1end, positiveOnly);
+		if (m_iqImbalanceCorrection)
+		{
+			if (part1begin != part1end) {
+				imbalance(part1begin, part1end);
 			}
 
-			// feed data to threaded sinks
-			for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
-			{
-				(*it)->feed(part1begin, part1end, positiveOnly);
+			if (part2begin != part2end) {
+				imbalance(part2begin, part2end);
 			}
 		}
 
-		// second part of FIFO data (used when block wraps around)
-		if(part2begin != part2end)
+		if (m_parallelSinkDispatch)
 		{
-			// correct stuff
-			if (m_dcOffsetCorrection)
+			// FIFO is committed only after all sinks have released the data
+			dispatchSinks(part1begin, part1end, part2begin, part2end, positiveOnly);
+		}
+		else
+		{
+			// first part of FIFO data
+			if (part1begin != part1end)
 			{
-				dcOffset(part2begin, part2end);
+				// feed data to direct sinks
+				for (BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); ++it)
+				{
+					(*it)->feed(part1begin, part1end, positiveOnly);
+				}
+
+				// feed data to threaded sinks
+				feedThreadedSinks(part1begin, part1end, positiveOnly);
 			}
 
-			if (m_iqImbalanceCorrection)
+			// second part of FIFO data (used when block wraps around)
+			if(part2begin != part2end)
 			{
-				imbalance(part2begin, part2end);
+				// feed data to direct sinks
+				for (BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); it++)
+				{
+					(*it)->feed(part2begin, part2end, positiveOnly);
+				}
+
+				// feed data to threaded sinks
+				feedThreadedSinks(part2begin, part2end, positiveOnly);
 			}
+		}
 
-			// feed data to direct sinks
-			for (BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); it++)
-			{
-				(*it)->feed(part2begin, part2end, positiveOnly);
+		// adjust FIFO pointers
+		sampleFifo->readCommit((unsigned int) count);
+		samplesDone += count;
+	}
+}
+
+void DSPDeviceSourceEngine::feedThreadedSinks(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
+{
+	if (m_channelizerBankEnabled && m_channelizerBank.hasAssignments())
+	{
+		m_channelizerBank.feed(begin, end);
+
+		for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
+		{
+			const SampleVector *slice = m_channelizerBank.getSliceSamples(*it);
+
+			if (slice) {
+				(*it)->feed(slice->begin(), slice->end(), positiveOnly);
+			} else {
+				(*it)->feed(begin, end, positiveOnly);
 			}
+		}
+	}
+	else
+	{
+		for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
+		{
+			(*it)->feed(begin, end, positiveOnly);
+		}
+	}
+}
 
-			// feed data to threaded sinks
-			for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
+void DSPDeviceSourceEngine::dispatchSinks(const SampleVector::const_iterator& part1Begin,
+		const SampleVector::const_iterator& part1End,
+		const SampleVector::const_iterator& part2Begin,
+		const SampleVector::const_iterator& part2End,
+		bool positiveOnly)
+{
+	bool useBank = m_channelizerBankEnabled && m_channelizerBank.hasAssignments();
+	m_sinkDispatcher->clear();
+
+	if (useBank)
+	{
+		m_channelizerBank.feed(part1Begin, part1End);
+		m_channelizerBank.feed(part2Begin, part2End, true);
+	}
+
+	for (BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); ++it)
+	{
+		m_sinkDispatcher->addSink(*it, part1Begin, part1End, part2Begin, part2End);
+	}
+
+	// threaded sinks take a reference to the block that their own thread feeds to the sink and releases
+	for (ThreadedBasebandSampleSinks::const_iterator it = m_threadedBasebandSampleSinks.begin(); it != m_threadedBasebandSampleSinks.end(); ++it)
+	{
+		const SampleVector *slice = useBank ? m_channelizerBank.getSliceSamples(*it) : 0;
+
+		if (!(*it)->isRunning()) // nobody would release the block: keep the samples in its FIFO for when it starts
+		{
+			if (slice)
+			{
+				(*it)->feed(slice->begin(), slice->end(), positiveOnly);
+			}
+			else
 			{
-				(*it)->feed(part2begin, part2end, positiveOnly);
+				if (part1Begin != part1End) {
+					(*it)->feed(part1Begin, part1End, positiveOnly);
+				}
+
+				if (part2Begin != part2End) {
+					(*it)->feed(part2Begin, part2End, positiveOnly);
+				}
 			}
 		}
+		else if (slice)
+		{
+			m_sinkDispatcher->addThreadedSink(*it, slice->begin(), slice->end(), slice->end(), slice->end());
+		}
+		else
+		{
+			m_sinkDispatcher->addThreadedSink(*it, part1Begin, part1End, part2Begin, part2End);
+		}
+	}
 
-		// adjust FIFO pointers
-		sampleFifo->readCommit((unsigned int) count);
-		samplesDone += count;
+	m_sinkDispatcher->dispatch(positiveOnly);
+}
+
+void DSPDeviceSourceEngine::resetChannelizerBank(bool notifySinks)
+{
+	if (notifySinks) {
+		m_channelizerBank.releaseAll();
+	} else {
+		m_channelizerBank.clear(); // sinks go back to baseband by themselves on DSPSignalNotification
+	}
+
+	if (m_channelizerBankEnabled && (m_sampleRate > 0)) {
+		m_channelizerBank.configure(m_channelizerBankLog2NbChannels, m_sampleRate);
 	}
 }
 
@@ -354,6 +477,16 @@ DSPDeviceSourceEngine::State DSPDeviceSourceEngine::gotoIdle()
     }
 
 	m_deviceSampleSource->stop();
+
+	SampleSinkFifo* sampleFifo = m_deviceSampleSource->getSampleFifo();
+
+	qDebug() << "DSPDeviceSourceEngine::gotoIdle: " << m_deviceDescription.toStdString().c_str() << ": sample FIFO"
+			<< " size: " << sampleFifo->size()
+			<< " max fill: " << sampleFifo->getMaxFill()
+			<< " overflows: " << sampleFifo->getNbOverflows()
+			<< " dropped samples: " << sampleFifo->getNbDroppedSamples()
+			<< " underflows: " << sampleFifo->getNbUnderflows();
+
 	m_deviceDescription.clear();
 	m_sampleRate = 0;
 
@@ -399,6 +532,7 @@ DSPDeviceSourceEngine::State DSPDeviceSourceEngine::gotoInit()
 			<< " sampleRate: " << m_sampleRate
 			<< " centerFrequency: " << m_centerFrequency;
 
+	resetChannelizerBank(false);
 	DSPSignalNotification notif(m_sampleRate, m_centerFrequency);
 
 	for (BasebandSampleSinks::const_iterator it = m_basebandSampleSinks.begin(); it != m_basebandSampleSinks.end(); ++it)
@@ -449,6 +583,8 @@ DSPDeviceSourceEngine::State DSPDeviceSourceEngine::gotoRunning()
 
 	// Start everything
 
+	m_deviceSampleSource->getSampleFifo()->resetStats(); // the FIFO statistics are logged when going back to idle
+
 	if(!m_deviceSampleSource->start())
 	{
 		return gotoError("Could not start sample source");
@@ -579,6 +715,7 @@ void DSPDeviceSourceEngine::handleSynchronousMessages()
 	else if (DSPRemoveThreadedSampleSink::match(*message))
 	{
 		ThreadedBasebandSampleSink* threadedSink = ((DSPRemoveThreadedSampleSink*) message)->getThreadedSampleSink();
+		m_channelizerBank.release(threadedSink);
 		threadedSink->stop();
 		m_threadedBasebandSampleSinks.remove(threadedSink);
 	}
@@ -618,6 +755,30 @@ void DSPDeviceSourceEngine::handleInputMessages()
 
 			delete message;
 		}
+		else if (DSPConfigureChannelizerBank::match(*message))
+		{
+			DSPConfigureChannelizerBank* conf = (DSPConfigureChannelizerBank*) message;
+			m_channelizerBankEnabled = conf->getEnable();
+			m_channelizerBankLog2NbChannels = conf->getLog2NbChannels();
+			resetChannelizerBank(true);
+
+			delete message;
+		}
+		else if (DSPConfigureSinkDispatch::match(*message))
+		{
+			DSPConfigureSinkDispatch* conf = (DSPConfigureSinkDispatch*) message;
+
+			if (conf->getParallel() && !m_parallelSinkDispatch)
+			{
+				if (m_sinkDispatcher == 0) {
+					m_sinkDispatcher = new SampleSinkDispatcher();
+				}
+			}
+
+			m_parallelSinkDispatch = conf->getParallel();
+
+			delete message;
+		}
 		else if (DSPSignalNotification::match(*message))
 		{
 			DSPSignalNotification *notif = (DSPSignalNotification *) message;
@@ -626,6 +787,7 @@ void DSPDeviceSourceEngine::handleInputMessages()
 
 			m_sampleRate = notif->getSampleRate();
 			m_centerFrequency = notif->getCenterFrequency();
+			resetChannelizerBank(false);
 
 			qDebug() << "DSPDeviceSourceEngine::handleInputMessages: DSPSignalNotification(" << m_sampleRate << "," << m_centerFrequency << ")";
 
@@ -24,6 +24,8 @@
 #include <QWaitCondition>
 #include "dsp/dsptypes.h"
 #include "dsp/fftwindow.h"
+#include "dsp/channelizerbank.h"
+#include "dsp/samplesinkdispatcher.h"
 #include "util/messagequeue.h"
 #include "util/syncmessenger.h"
 #include "util/export.h"
@@ -69,6 +71,8 @@ public:
 	void removeThreadedSink(ThreadedBasebandSampleSink* sink); //!< Remove a sample sink that runs on its own thread
 
 	void configureCorrections(bool dcOffsetCorrection, bool iqImbalanceCorrection); //!< Configure DSP corrections
+	void configureChannelizerBank(bool enable, int log2NbChannels); //!< Feed channelizers from a polyphase filter bank slice when possible
+	void configureSinkDispatch(bool parallel); //!< Feed all sinks in parallel over a pool of threads sharing the FIFO data
 
 	State state() const { return m_state; } //!< Return DSP engine current state
 
@@ -106,11 +110,25 @@ private:
 	qint32 m_qRange;
 	qint32 m_imbalance;
 
+	bool m_channelizerBankEnabled;
+	int m_channelizerBankLog2NbChannels;
+	ChannelizerBank m_channelizerBank;
+
+	bool m_parallelSinkDispatch;
+	SampleSinkDispatcher *m_sinkDispatcher; //!< allocated the first time parallel dispatch is enabled
+
 	void run();
 
 	void dcOffset(SampleVector::iterator begin, SampleVector::iterator end);
 	void imbalance(SampleVector::iterator begin, SampleVector::iterator end);
 	void work(); //!< transfer samples from source to sinks if in running state
+	void feedThreadedSinks(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly);
+	void resetChannelizerBank(bool notifySinks); //!< reconfigure bank for the current sample rate
+	void dispatchSinks(const SampleVector::const_iterator& part1Begin,
+			const SampleVector::const_iterator& part1End,
+			const SampleVector::const_iterator& part2Begin,
+			const SampleVector::const_iterator& part2End,
+			bool positiveOnly); //!< feed all sinks in parallel with both FIFO parts, threaded sinks on their own thread
 
 	State gotoIdle();     //!< Go to the idle state
 	State gotoInit();     //!< Go to the acquisition init state from idle
@@ -24,3 +24,33 @@ FFTEngine* FFTEngine::create()
 	qCritical("FFT: no engine built");
 	return NULL;
 }
+
+void FFTEngine::loadWisdom()
+{
+#ifdef USE_FFTW
+	FFTWEngine::loadWisdom();
+#endif // USE_FFTW
+}
+
+void FFTEngine::saveWisdom()
+{
+#ifdef USE_FFTW
+	FFTWEngine::saveWisdom();
+#endif // USE_FFTW
+}
+
+void FFTEngine::startPlanning(const std::vector<int>& sizes)
+{
+#ifdef USE_FFTW
+	FFTWEngine::startPlanning(sizes);
+#else
+	(void) sizes;
+#endif // USE_FFTW
+}
+
+void FFTEngine::stopPlanning()
+{
+#ifdef USE_FFTW
+	FFTWEngine::stopPlanning();
+#endif // USE_FFTW
+}
@@ -1,6 +1,7 @@
 #ifndef INCLUDE_FFTENGINE_H
 #define INCLUDE_FFTENGINE_H
 
+#include <vector>
 #include "dsp/dsptypes.h"
 #include "util/export.h"
 
@@ -15,6 +16,12 @@ public:
 	virtual Complex* out() = 0;
 
 	static FFTEngine* create();
+
+	// Plan cache of the engine. These do nothing for engines without planning (KissFFT).
+	static void loadWisdom();   //!< imports the plans saved in the user configuration directory
+	static void saveWisdom();   //!< saves the plans made so far in the user configuration directory
+	static void startPlanning(const std::vector<int>& sizes); //!< plans the forward transforms of these sizes in a background thread
+	static void stopPlanning(); //!< waits for the size being planned and stops background planning
 };
 
 #endif // INCLUDE_FFTENGINE_H
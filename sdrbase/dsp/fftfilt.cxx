@@ -39,19 +39,67 @@
 #include <unistd.h>
 #include <memory.h>
 
+#include <algorithm>
+#include <list>
+#include <map>
+#include <QMutex>
+
 #include <dsp/misc.h>
 #include <dsp/fftfilt.h>
 
+//------------------------------------------------------------------------------
+// Filter designs are cached by parameters and FFT length as channels often
+// come back to the same bandwidths. Windows are cached by length. When the
+// filter cache is full the least recently used design is evicted.
+//------------------------------------------------------------------------------
+
+namespace {
+
+struct FilterKey {
+	bool dsb;
+	float f1;
+	float f2;
+	int flen;
+
+	FilterKey(bool dsb, float f1, float f2, int flen) : dsb(dsb), f1(f1), f2(f2), flen(flen) {}
+
+	bool operator<(const FilterKey& other) const
+	{
+		if (flen != other.flen) return flen < other.flen;
+		if (dsb != other.dsb) return dsb < other.dsb;
+		if (f1 != other.f1) return f1 < other.f1;
+		return f2 < other.f2;
+	}
+};
+
+struct FilterEntry {
+	std::vector<fftfilt::cmplx> spectrum;
+	std::list<FilterKey>::iterator lruPos; //!< position in the use order list
+};
+
+typedef std::map<FilterKey, FilterEntry> FilterCache;
+typedef std::map<int, std::vector<float> > WindowCache;
+
+QMutex cacheMutex;
+FilterCache filterCache;
+std::list<FilterKey> filterLRU; //!< most recently used first
+WindowCache windowCache;
+const unsigned int filterCacheMaxSize = 64;
+
+}
+
 //------------------------------------------------------------------------------
 // initialize the filter
 // create forward and reverse FFTs
 //------------------------------------------------------------------------------
 
-// Only need a single instance of g_fft, used for both forward and reverse
 void fftfilt::init_filter()
 {
 	flen2	= flen >> 1;
-	fft	= new g_fft<float>(flen);
+	fft	= FFTEngine::create();
+	fft->configure(flen, false);
+	ift	= FFTEngine::create();
+	ift->configure(flen, true);
 
 	filter		= new cmplx[flen];
     filterOpp   = new cmplx[flen];
@@ -92,6 +140,7 @@ fftfilt::fftfilt(float f2, int len)
 fftfilt::~fftfilt()
 {
 	if (fft) delete fft;
+	if (ift) delete ift;
 
 	if (filter) delete [] filter;
     if (filterOpp) delete [] filterOpp;
@@ -100,118 +149,179 @@ fftfilt::~fftfilt()
 	if (ovlbuf) delete [] ovlbuf;
 }
 
-void fftfilt::create_filter(float f1, float f2)
+// Windowed sinc of flen2 taps zero padded to flen, transformed and normalized
+// for unity gain. Plain low pass when dsb else band pass / band reject.
+void fftfilt::design_filter(bool dsb, float f1, float f2, cmplx *target)
 {
-	// initialize the filter to zero
-	memset(filter, 0, flen * sizeof(cmplx));
+	QMutexLocker mutexLocker(&cacheMutex);
+	FilterKey key(dsb, f1, f2, flen);
+	FilterCache::iterator it = filterCache.find(key);
 
-	// create the filter shape coefficients by fft
-	bool b_lowpass, b_highpass;
-	b_lowpass = (f2 != 0);
-	b_highpass = (f1 != 0);
+	if (it != filterCache.end())
+	{
+		filterLRU.splice(filterLRU.begin(), filterLRU, it->second.lruPos);
+		std::copy(it->second.spectrum.begin(), it->second.spectrum.end(), target);
+		return;
+	}
 
-	for (int i = 0; i < flen2; i++) {
-		filter[i] = 0;
-	// lowpass @ f2
-		if (b_lowpass)
-			filter[i] += fsinc(f2, i, flen2);
-	// highighpass @ f1
-		if (b_highpass)
-			filter[i] -= fsinc(f1, i, flen2);
+	std::vector<float>& window = windowCache[flen2];
+
+	if (window.size() == 0)
+	{
+		window.resize(flen2);
+
+		for (int i = 0; i < flen2; i++)
+			window[i] = _blackman(i, flen2);
+	}
+
+	// create the filter shape coefficients by fft. A separate engine is used
+	// so that a redesign does not disturb the running filter buffers.
+	FFTEngine *designFFT = FFTEngine::create();
+	designFFT->configure(flen, false);
+	cmplx *h = designFFT->in();
+	memset(h, 0, flen * sizeof(cmplx));
+
+	if (dsb)
+	{
+		for (int i = 0; i < flen2; i++)
+			h[i] = fsinc(f2, i, flen2);
+	}
+	else
+	{
+		bool b_lowpass, b_highpass;
+		b_lowpass = (f2 != 0);
+		b_highpass = (f1 != 0);
+
+		for (int i = 0; i < flen2; i++) {
+			h[i] = 0;
+		// lowpass @ f2
+			if (b_lowpass)
+				h[i] += fsinc(f2, i, flen2);
+		// highighpass @ f1
+			if (b_highpass)
+				h[i] -= fsinc(f1, i, flen2);
+		}
+		// highpass is delta[flen2/2] - h(t)
+		if (b_highpass && f2 < f1)
+			h[flen2 / 2] += 1;
 	}
-	// highpass is delta[flen2/2] - h(t)
-	if (b_highpass && f2 < f1)
-		filter[flen2 / 2] += 1;
 
 	for (int i = 0; i < flen2; i++)
-		filter[i] *= _blackman(i, flen2);
+		h[i] *= window[i];
 
-	fft->ComplexFFT(filter);
+	designFFT->transform();
+	cmplx *H = designFFT->out();
 
 	// normalize the output filter for unity gain
 	float scale = 0, mag;
 	for (int i = 0; i < flen2; i++) {
-		mag = abs(filter[i]);
+		mag = abs(H[i]);
 		if (mag > scale) scale = mag;
 	}
-	if (scale != 0) {
-		for (int i = 0; i < flen; i++)
-			filter[i] /= scale;
+	// the inverse transform of the engines is not normalized
+	scale = (scale != 0) ? 1.0f / (scale * flen) : 1.0f / flen;
+
+	for (int i = 0; i < flen; i++)
+		target[i] = H[i] * scale;
+
+	if (filterCache.size() >= filterCacheMaxSize)
+	{
+		filterCache.erase(filterLRU.back());
+		filterLRU.pop_back();
 	}
+
+	filterLRU.push_front(key);
+	FilterEntry& entry = filterCache[key];
+	entry.spectrum.assign(target, target + flen);
+	entry.lruPos = filterLRU.begin();
+	delete designFFT;
+}
+
+void fftfilt::create_filter(float f1, float f2)
+{
+	design_filter(false, f1, f2, filter);
 }
 
 // Double the size of FFT used for equivalent SSB filter or assume FFT is half the size of the one used for SSB
 void fftfilt::create_dsb_filter(float f2)
 {
-	// initialize the filter to zero
-	memset(filter, 0, flen * sizeof(cmplx));
+	design_filter(true, 0, f2, filter);
+}
 
-	for (int i = 0; i < flen2; i++) {
-		filter[i] = fsinc(f2, i, flen2);
-		filter[i] *= _blackman(i, flen2);
+// Double the size of FFT used for equivalent SSB filter or assume FFT is half the size of the one used for SSB
+// used with runAsym for in band / opposite band asymmetrical filtering. Can be used for vestigial sideband modulation.
+void fftfilt::create_asym_filter(float fopp, float fin)
+{
+	design_filter(true, 0, fin, filter);     // in band
+	design_filter(true, 0, fopp, filterOpp); // opposite band
+}
+
+// Filter with fast convolution (overlap-add algorithm) the current input block
+// zero padded to flen. Returns the flen2 output samples.
+fftfilt::cmplx *fftfilt::process(Mode mode, bool usb, bool getDC)
+{
+	memcpy(fft->in(), data, flen2 * sizeof(cmplx));
+	memset(fft->in() + flen2, 0, flen2 * sizeof(cmplx));
+	fft->transform();
+
+	const cmplx *X = fft->out();
+	cmplx *Y = ift->in();
+
+	if (mode == ModeFilt)
+	{
+		for (int i = 0; i < flen; i++)
+			Y[i] = X[i] * filter[i];
+	}
+	else
+	{
+		// get or reject DC component. Asymmetrical always keeps DC.
+		Y[0] = (getDC || (mode == ModeAsym)) ? X[0] * filter[0] : 0;
+		Y[flen2] = X[flen2] * (1.0f / flen); // Nyquist bin is kept as is
+
+		// Discard frequencies for ssb or use the opposite band filter
+		const cmplx *filterLow = (mode == ModeAsym) ? (usb ? filter : filterOpp) : filter;
+		const cmplx *filterHigh = (mode == ModeAsym) ? (usb ? filterOpp : filter) : filter;
+
+		for (int i = 1; i < flen2; i++)
+		{
+			Y[i] = ((mode == ModeSSB) && !usb) ? 0 : X[i] * filterLow[i];
+			Y[flen2 + i] = ((mode == ModeSSB) && usb) ? 0 : X[flen2 + i] * filterHigh[flen2 + i];
+		}
 	}
 
-	fft->ComplexFFT(filter);
+	ift->transform();
+	const cmplx *y = ift->out();
 
-	// normalize the output filter for unity gain
-	float scale = 0, mag;
+	// overlap and add
 	for (int i = 0; i < flen2; i++) {
-		mag = abs(filter[i]);
-		if (mag > scale) scale = mag;
-	}
-	if (scale != 0) {
-		for (int i = 0; i < flen; i++)
-			filter[i] /= scale;
+		output[i] = ovlbuf[i] + y[i];
+		ovlbuf[i] = y[flen2 + i];
 	}
+
+	return output;
 }
 
-// Double the size of FFT used for equivalent SSB filter or assume FFT is half the size of the one used for SSB
-// used with runAsym for in band / opposite band asymmetrical filtering. Can be used for vestigial sideband modulation.
-void fftfilt::create_asym_filter(float fopp, float fin)
+int fftfilt::runBlock(const cmplx *in, int nbIn, cmplx *out, Mode mode, bool usb, bool getDC)
 {
-    // in band
-    // initialize the filter to zero
-    memset(filter, 0, flen * sizeof(cmplx));
-
-    for (int i = 0; i < flen2; i++) {
-        filter[i] = fsinc(fin, i, flen2);
-        filter[i] *= _blackman(i, flen2);
-    }
-
-    fft->ComplexFFT(filter);
-
-    // normalize the output filter for unity gain
-    float scale = 0, mag;
-    for (int i = 0; i < flen2; i++) {
-        mag = abs(filter[i]);
-        if (mag > scale) scale = mag;
-    }
-    if (scale != 0) {
-        for (int i = 0; i < flen; i++)
-            filter[i] /= scale;
-    }
-
-    // opposite band
-    // initialize the filter to zero
-    memset(filterOpp, 0, flen * sizeof(cmplx));
+	int nbOut = 0;
 
-    for (int i = 0; i < flen2; i++) {
-        filterOpp[i] = fsinc(fopp, i, flen2);
-        filterOpp[i] *= _blackman(i, flen2);
-    }
-
-    fft->ComplexFFT(filterOpp);
-
-    // normalize the output filter for unity gain
-    scale = 0;
-    for (int i = 0; i < flen2; i++) {
-        mag = abs(filterOpp[i]);
-        if (mag > scale) scale = mag;
-    }
-    if (scale != 0) {
-        for (int i = 0; i < flen; i++)
-            filterOpp[i] /= scale;
-    }
+	while (nbIn > 0)
+	{
+		int n = std::min(flen2 - inptr, nbIn);
+		memcpy(data + inptr, in, n * sizeof(cmplx));
+		inptr += n;
+		in += n;
+		nbIn -= n;
+
+		if (inptr == flen2)
+		{
+			inptr = 0;
+			memcpy(out + nbOut, process(mode, usb, getDC), flen2 * sizeof(cmplx));
+			nbOut += flen2;
+		}
+	}
+
+	return nbOut;
 }
 
 // test bypass
@@ -226,7 +336,6 @@ int fftfilt::noFilt(const cmplx & in, cmplx **out)
 	return flen2;
 }
 
-// Filter with fast convolution (overlap-add algorithm).
 int fftfilt::runFilt(const cmplx & in, cmplx **out)
 {
 	data[inptr++] = in;
@@ -234,19 +343,7 @@ int fftfilt::runFilt(const cmplx & in, cmplx **out)
 		return 0;
 	inptr = 0;
 
-	fft->ComplexFFT(data);
-	for (int i = 0; i < flen; i++)
-		data[i] *= filter[i];
-
-	fft->InverseComplexFFT(data);
-
-	for (int i = 0; i < flen2; i++) {
-		output[i] = ovlbuf[i] + data[i];
-		ovlbuf[i] = data[flen2 + i];
-	}
-	memset (data, 0, flen * sizeof(cmplx));
-
-	*out = output;
+	*out = process(ModeFilt, true, true);
 	return flen2;
 }
 
@@ -258,69 +355,14 @@ int fftfilt::runSSB(const cmplx & in, cmplx **out, bool usb, bool getDC)
 		return 0;
 	inptr = 0;
 
-	fft->ComplexFFT(data);
-
-	// get or reject DC component
-	data[0] = getDC ? data[0]*filter[0] : 0;
-
-	// Discard frequencies for ssb
-	if (usb)
-	{
-		for (int i = 1; i < flen2; i++) {
-			data[i] *= filter[i];
-			data[flen2 + i] = 0;
-		}
-	}
-	else
-	{
-		for (int i = 1; i < flen2; i++) {
-			data[i] = 0;
-			data[flen2 + i] *= filter[flen2 + i];
-		}
-	}
-
-	// in-place FFT: freqdata overwritten with filtered timedata
-	fft->InverseComplexFFT(data);
-
-	// overlap and add
-	for (int i = 0; i < flen2; i++) {
-		output[i] = ovlbuf[i] + data[i];
-		ovlbuf[i] = data[i+flen2];
-	}
-	memset (data, 0, flen * sizeof(cmplx));
-
-	*out = output;
+	*out = process(ModeSSB, usb, getDC);
 	return flen2;
 }
 
 // Version for double sideband. You have to double the FFT size used for SSB.
 int fftfilt::runDSB(const cmplx & in, cmplx **out)
 {
-	data[inptr++] = in;
-	if (inptr < flen2)
-		return 0;
-	inptr = 0;
-
-	fft->ComplexFFT(data);
-
-	for (int i = 0; i < flen2; i++) {
-		data[i] *= filter[i];
-		data[flen2 + i] *= filter[flen2 + i];
-	}
-
-	// in-place FFT: freqdata overwritten with filtered timedata
-	fft->InverseComplexFFT(data);
-
-	// overlap and add
-	for (int i = 0; i < flen2; i++) {
-		output[i] = ovlbuf[i] + data[i];
-		ovlbuf[i] = data[i+flen2];
-	}
-
-	memset (data, 0, flen * sizeof(cmplx));
-
-	*out = output;
-	return flen2;
+	return runFilt(in, out);
 }
 
 // Version for asymmetrical sidebands. You have to double the FFT size used for SSB.
@@ -331,42 +373,30 @@ int fftfilt::runAsym(const cmplx & in, cmplx **out, bool usb)
         return 0;
     inptr = 0;
 
-    fft->ComplexFFT(data);
-
-    data[0] *= filter[0]; // always keep DC
-
-    if (usb)
-    {
-        for (int i = 1; i < flen2; i++)
-        {
-            data[i] *= filter[i]; // usb
-            data[flen2 + i] *= filterOpp[flen2 + i]; // lsb is the opposite
-        }
-    }
-    else
-    {
-        for (int i = 1; i < flen2; i++)
-        {
-            data[i] *= filterOpp[i]; // usb is the opposite
-            data[flen2 + i] *= filter[flen2 + i]; // lsb
-        }
-    }
-
-    // in-place FFT: freqdata overwritten with filtered timedata
-    fft->InverseComplexFFT(data);
-
-    // overlap and add
-    for (int i = 0; i < flen2; i++) {
-        output[i] = ovlbuf[i] + data[i];
-        ovlbuf[i] = data[i+flen2];
-    }
-
-    memset (data, 0, flen * sizeof(cmplx));
-
-    *out = output;
+    *out = process(ModeAsym, usb, true);
     return flen2;
 }
 
+int fftfilt::runFilt(const cmplx *in, int nbIn, cmplx *out)
+{
+	return runBlock(in, nbIn, out, ModeFilt, true, true);
+}
+
+int fftfilt::runSSB(const cmplx *in, int nbIn, cmplx *out, bool usb, bool getDC)
+{
+	return runBlock(in, nbIn, out, ModeSSB, usb, getDC);
+}
+
+int fftfilt::runDSB(const cmplx *in, int nbIn, cmplx *out)
+{
+	return runBlock(in, nbIn, out, ModeFilt, true, true);
+}
+
+int fftfilt::runAsym(const cmplx *in, int nbIn, cmplx *out, bool usb)
+{
+	return runBlock(in, nbIn, out, ModeAsym, usb, true);
+}
+
 /* Sliding FFT from Fldigi */
 
 struct sfft::vrot_bins_pair {
@@ -6,7 +6,9 @@
 #define	_FFTFILT_H
 
 #include <complex>
-#include "gfft.h"
+#include <cmath>
+#include <vector>
+#include "dsp/fftengine.h"
 
 //----------------------------------------------------------------------
 
@@ -25,25 +27,34 @@ public:
 	void create_dsb_filter(float f2);
     void create_asym_filter(float fopp, float fin); //!< two different filters for in band and opposite band
 
+	// Sample by sample processing. Returns the size of the output block pointed by out when one is completed else 0.
 	int noFilt(const cmplx& in, cmplx **out);
 	int runFilt(const cmplx& in, cmplx **out);
 	int runSSB(const cmplx& in, cmplx **out, bool usb, bool getDC = true);
 	int runDSB(const cmplx& in, cmplx **out);
 	int runAsym(const cmplx & in, cmplx **out, bool usb); //!< Asymmetrical fitering can be used for vestigial sideband
 
+	// Block processing of nbIn input samples. All completed output blocks are copied to out
+	// that must have room for outputSize(nbIn) samples. Returns the number of samples written.
+	int outputSize(int nbIn) const { return ((inptr + nbIn) / flen2) * flen2; }
+	int runFilt(const cmplx *in, int nbIn, cmplx *out);
+	int runSSB(const cmplx *in, int nbIn, cmplx *out, bool usb, bool getDC = true);
+	int runDSB(const cmplx *in, int nbIn, cmplx *out);
+	int runAsym(const cmplx *in, int nbIn, cmplx *out, bool usb);
+
 protected:
+	enum Mode {ModeFilt, ModeSSB, ModeAsym}; // DSB is plain filtering with a DSB filter
+
 	int flen;
 	int flen2;
-	g_fft<float> *fft;
-	g_fft<float> *ift;
-	cmplx *filter;
+	FFTEngine *fft; //!< forward transform of the input window
+	FFTEngine *ift; //!< inverse transform of the filtered spectrum
+	cmplx *filter;    //!< spectrum of the filter scaled by 1/flen for the unnormalized inverse FFT
     cmplx *filterOpp;
-	cmplx *data;
+	cmplx *data;      //!< current input block of flen2 samples
 	cmplx *ovlbuf;
 	cmplx *output;
 	int inptr;
-	int pass;
-	int window;
 
 	inline float fsinc(float fc, int i, int len) {
 		return (i == len/2) ? 2.0 * fc:
@@ -57,7 +68,9 @@ protected:
 	}
 
 	void init_filter();
-	void init_dsb_filter();
+	void design_filter(bool dsb, float f1, float f2, cmplx *target);
+	cmplx *process(Mode mode, bool usb, bool getDC);
+	int runBlock(const cmplx *in, int nbIn, cmplx *out, Mode mode, bool usb, bool getDC);
 };
 
 
@@ -1,6 +1,43 @@
 #include <QTime>
+#include <QThread>
+#include <QAtomicInt>
+#include <QDir>
+#include <QFileInfo>
+#include <QCoreApplication>
+#include <QStandardPaths>
 #include "dsp/fftwengine.h"
 
+/** Plans sizes in the background so that configuring an engine finds them in the registry */
+class FFTWEngine::Planner : public QThread {
+public:
+	Planner(const std::vector<int>& sizes) :
+		m_sizes(sizes),
+		m_stop(0)
+	{ }
+
+	void stop() { m_stop.storeRelease(1); }
+
+protected:
+	void run()
+	{
+		QTime t;
+		t.start();
+
+		for(std::vector<int>::const_iterator it = m_sizes.begin(); it != m_sizes.end(); ++it) {
+			if(m_stop.loadAcquire())
+				return;
+			getPlan(*it, false, 0); // buffers from fftwf_malloc are aligned
+		}
+
+		qDebug("FFT: background planning of %d sizes took %dms", (int) m_sizes.size(), t.elapsed());
+		saveWisdom();
+	}
+
+private:
+	std::vector<int> m_sizes;
+	QAtomicInt m_stop;
+};
+
 FFTWEngine::FFTWEngine() :
 	m_plans(),
 	m_currentPlan(NULL)
@@ -26,19 +63,14 @@ void FFTWEngine::configure(int n, bool inverse)
 	m_currentPlan->inverse = inverse;
 	m_currentPlan->in = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
 	m_currentPlan->out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
-	QTime t;
-	t.start();
-	m_globalPlanMutex.lock();
-	m_currentPlan->plan = fftwf_plan_dft_1d(n, m_currentPlan->in, m_currentPlan->out, inverse ? FFTW_BACKWARD : FFTW_FORWARD, FFTW_PATIENT);
-	m_globalPlanMutex.unlock();
-	qDebug("FFT: creating FFTW plan (n=%d,%s) took %dms", n, inverse ? "inverse" : "forward", t.elapsed());
+	m_currentPlan->plan = getPlan(n, inverse, fftwf_alignment_of((float*) m_currentPlan->in));
 	m_plans.push_back(m_currentPlan);
 }
 
 void FFTWEngine::transform()
 {
 	if(m_currentPlan != NULL)
-		fftwf_execute(m_currentPlan->plan);
+		fftwf_execute_dft(m_currentPlan->plan, m_currentPlan->in, m_currentPlan->out);
 }
 
 Complex* FFTWEngine::in()
@@ -56,14 +88,94 @@ Complex* FFTWEngine::out()
 }
 
 QMutex FFTWEngine::m_globalPlanMutex;
+FFTWEngine::PlanRegistry FFTWEngine::m_globalPlans;
+FFTWEngine::Planner *FFTWEngine::m_planner = NULL;
 
 void FFTWEngine::freeAll()
 {
+	// plans belong to the registry and live until the end of the process
 	for(Plans::iterator it = m_plans.begin(); it != m_plans.end(); ++it) {
-		fftwf_destroy_plan((*it)->plan);
 		fftwf_free((*it)->in);
 		fftwf_free((*it)->out);
 		delete *it;
 	}
 	m_plans.clear();
 }
+
+fftwf_plan FFTWEngine::getPlan(int n, bool inverse, int alignment)
+{
+	QMutexLocker mutexLocker(&m_globalPlanMutex);
+	PlanKey key(n, inverse, alignment);
+	PlanRegistry::const_iterator it = m_globalPlans.find(key);
+
+	if(it != m_globalPlans.end())
+		return it->second;
+
+	// planning overwrites the arrays so plan on scratch buffers with the same alignment
+	fftwf_complex* inBuffer = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * (n + 4));
+	fftwf_complex* in = (fftwf_complex*)((char*) inBuffer + alignment);
+	fftwf_complex* out = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex) * n);
+	QTime t;
+	t.start();
+	fftwf_plan plan = fftwf_plan_dft_1d(n, in, out, inverse ? FFTW_BACKWARD : FFTW_FORWARD, FFTW_PATIENT);
+	qDebug("FFT: creating FFTW plan (n=%d,%s) took %dms", n, inverse ? "inverse" : "forward", t.elapsed());
+	fftwf_free(inBuffer);
+	fftwf_free(out);
+
+	m_globalPlans.insert(PlanRegistry::value_type(key, plan));
+	return plan;
+}
+
+QString FFTWEngine::getWisdomFileName()
+{
+	QString dir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
+
+	if(!QCoreApplication::organizationName().isEmpty())
+		dir += "/" + QCoreApplication::organizationName();
+
+	return dir + "/fftw-wisdom";
+}
+
+void FFTWEngine::loadWisdom()
+{
+	QMutexLocker mutexLocker(&m_globalPlanMutex);
+	QString fileName = getWisdomFileName();
+
+	if(fftwf_import_wisdom_from_filename(fileName.toLocal8Bit().constData()))
+		qDebug("FFT: imported FFTW wisdom from %s", qPrintable(fileName));
+	else
+		qDebug("FFT: no FFTW wisdom imported from %s", qPrintable(fileName));
+}
+
+void FFTWEngine::saveWisdom()
+{
+	QMutexLocker mutexLocker(&m_globalPlanMutex);
+	QString fileName = getWisdomFileName();
+	QDir().mkpath(QFileInfo(fileName).absolutePath());
+
+	if(!fftwf_export_wisdom_to_filename(fileName.toLocal8Bit().constData()))
+		qWarning("FFT: cannot export FFTW wisdom to %s", qPrintable(fileName));
+}
+
+void FFTWEngine::startPlanning(const std::vector<int>& sizes)
+{
+	if(m_planner != NULL) {
+		if(m_planner->isRunning())
+			return;
+		delete m_planner;
+	}
+
+	m_planner = new Planner(sizes);
+	m_planner->start(QThread::LowPriority);
+}
+
+void FFTWEngine::stopPlanning()
+{
+	if(m_planner == NULL)
+		return;
+
+	m_planner->stop();
+	m_planner->wait(); // the size being planned is completed
+	delete m_planner;
+	m_planner = NULL;
+}
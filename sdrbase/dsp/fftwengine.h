@@ -2,8 +2,11 @@
 #define INCLUDE_FFTWENGINE_H
 
 #include <QMutex>
+#include <QString>
 #include <fftw3.h>
 #include <list>
+#include <map>
+#include <vector>
 #include "dsp/fftengine.h"
 
 class FFTWEngine : public FFTEngine {
@@ -17,13 +20,46 @@ public:
 	Complex* in();
 	Complex* out();
 
+	static void loadWisdom();
+	static void saveWisdom();
+	static void startPlanning(const std::vector<int>& sizes);
+	static void stopPlanning();
+
 protected:
-	static QMutex m_globalPlanMutex;
+	class Planner;
+
+	/** Key of the process wide plan registry. Plans are shared by all engines
+	 *  and executed on the buffers of each engine with fftwf_execute_dft */
+	struct PlanKey {
+		int n;
+		bool inverse;
+		int alignment; //!< fftwf_alignment_of the input buffer
+
+		PlanKey(int n, bool inverse, int alignment) :
+			n(n),
+			inverse(inverse),
+			alignment(alignment)
+		{ }
+
+		bool operator<(const PlanKey& other) const
+		{
+			if(n != other.n)
+				return n < other.n;
+			if(inverse != other.inverse)
+				return inverse < other.inverse;
+			return alignment < other.alignment;
+		}
+	};
+	typedef std::map<PlanKey, fftwf_plan> PlanRegistry;
+
+	static QMutex m_globalPlanMutex; //!< FFTW planner is not thread safe. Guards also the registry and wisdom.
+	static PlanRegistry m_globalPlans;
+	static Planner *m_planner;
 
 	struct Plan {
 		int n;
 		bool inverse;
-		fftwf_plan plan;
+		fftwf_plan plan; //!< shared plan from the registry
 		fftwf_complex* in;
 		fftwf_complex* out;
 	};
@@ -32,6 +68,9 @@ protected:
 	Plan* m_currentPlan;
 
 	void freeAll();
+
+	static fftwf_plan getPlan(int n, bool inverse, int alignment);
+	static QString getWisdomFileName();
 };
 
 #endif // INCLUDE_FFTWENGINE_H
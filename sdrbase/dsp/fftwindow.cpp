@@ -16,6 +16,7 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include "dsp/fftwindow.h"
+#include "dsp/spectrumsimd.h"
 
 void FFTWindow::create(Function function, int n)
 {
@@ -62,12 +63,10 @@ void FFTWindow::apply(const std::vector<Real>& in, std::vector<Real>* out)
 
 void FFTWindow::apply(const std::vector<Complex>& in, std::vector<Complex>* out)
 {
-	for(size_t i = 0; i < m_window.size(); i++)
-		(*out)[i] = in[i] * m_window[i];
+	SpectrumSIMD::applyWindow(&in[0], &m_window[0], &(*out)[0], m_window.size());
 }
 
 void FFTWindow::apply(const Complex* in, Complex* out)
 {
-	for(size_t i = 0; i < m_window.size(); i++)
-		out[i] = in[i] * m_window[i];
+	SpectrumSIMD::applyWindow(in, &m_window[0], out, m_window.size());
 }
@@ -4,6 +4,165 @@
 #include "util/message.h"
 
 #include <QDebug>
+#include <QDateTime>
+#include <QThread>
+#include <QQueue>
+#include <QWaitCondition>
+#include <cstddef>
+#include <cstring>
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+
+const char FileRecord::chunkedMagic[8] = {'S', 'D', 'R', 'I', 'Q', 'C', 'H', 'K'};
+
+/**
+ * Encodes and writes the chunks filled by the DSP thread. Chunks are passed in a fixed
+ * set of buffers so the DSP thread never waits for the disk: when all buffers are
+ * queued it drops samples instead.
+ */
+class FileRecord::Writer : public QThread {
+public:
+    Writer(const std::string& fileName, quint32 chunkSamples, bool compression) :
+        m_compression(compression),
+        m_buffers(nbChunkBuffers, SampleVector(chunkSamples)),
+        m_finish(false),
+        m_offset(sizeof(ChunkedHeader))
+    {
+        m_file.open(fileName.c_str(), std::ios::binary);
+
+        ChunkedHeader header;
+        memcpy(header.magic, chunkedMagic, sizeof(header.magic));
+        header.version = chunkedVersion;
+        header.chunkSamples = chunkSamples;
+        header.indexOffset = 0;
+        header.startTimeStamp = QDateTime::currentMSecsSinceEpoch();
+        m_file.write((const char *) &header, sizeof(ChunkedHeader));
+
+        for (int i = 0; i < nbChunkBuffers; i++) {
+            m_freeBuffers.push_back(i);
+        }
+    }
+
+    SampleVector& getBuffer(int bufferIndex) { return m_buffers[bufferIndex]; }
+
+    /** Free buffer index or -1 if all buffers are waiting to be written */
+    int takeBuffer()
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if (m_freeBuffers.empty()) {
+            return -1;
+        }
+
+        int bufferIndex = m_freeBuffers.back();
+        m_freeBuffers.pop_back();
+        return bufferIndex;
+    }
+
+    void queueChunk(int bufferIndex, const ChunkHeader& header)
+    {
+        QueuedChunk chunk;
+        chunk.buffer = bufferIndex;
+        chunk.header = header;
+        QMutexLocker locker(&m_mutex);
+        m_queue.enqueue(chunk);
+        m_queueNotEmpty.wakeOne();
+    }
+
+    /** Writes the queued chunks and the seek index then closes the file */
+    void finish()
+    {
+        m_mutex.lock();
+        m_finish = true;
+        m_queueNotEmpty.wakeOne();
+        m_mutex.unlock();
+        wait();
+    }
+
+protected:
+    void run()
+    {
+        m_mutex.lock();
+
+        while (true)
+        {
+            while (m_queue.isEmpty() && !m_finish) {
+                m_queueNotEmpty.wait(&m_mutex);
+            }
+
+            if (m_queue.isEmpty()) {
+                break;
+            }
+
+            QueuedChunk chunk = m_queue.dequeue();
+            m_mutex.unlock();
+            writeChunk(chunk);
+            m_mutex.lock();
+            m_freeBuffers.push_back(chunk.buffer);
+        }
+
+        m_mutex.unlock();
+        writeIndex();
+        m_file.close();
+    }
+
+private:
+    struct QueuedChunk
+    {
+        int buffer;
+        ChunkHeader header;
+    };
+
+    std::ofstream m_file;
+    bool m_compression;
+    std::vector<SampleVector> m_buffers;
+    std::vector<int> m_freeBuffers;
+    QQueue<QueuedChunk> m_queue;
+    QMutex m_mutex;
+    QWaitCondition m_queueNotEmpty;
+    bool m_finish;
+    quint64 m_offset;                //!< file offset of the next chunk
+    std::vector<IndexEntry> m_index;
+    std::vector<quint8> m_data;
+    std::vector<quint8> m_work;
+
+    void writeChunk(const QueuedChunk& chunk)
+    {
+        IndexEntry entry;
+        entry.header = chunk.header;
+        entry.offset = m_offset;
+        encodeSamples(&m_buffers[chunk.buffer][0], entry.header.nbSamples, m_compression, entry.header, m_data, m_work);
+
+        // sample data is padded to 8 bytes so that native samples are aligned in a mapping of the file
+        static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+        quint32 paddingSize = (8 - (entry.header.dataSize % 8)) % 8;
+
+        m_file.write((const char *) &entry.header, sizeof(ChunkHeader));
+        m_file.write((const char *) &m_data[0], entry.header.dataSize);
+        m_file.write(padding, paddingSize);
+        m_offset += sizeof(ChunkHeader) + entry.header.dataSize + paddingSize;
+        m_index.push_back(entry);
+    }
+
+    void writeIndex()
+    {
+        quint32 magic = indexMagic;
+        quint32 nbChunks = m_index.size();
+        m_file.write((const char *) &magic, sizeof(quint32));
+        m_file.write((const char *) &nbChunks, sizeof(quint32));
+
+        if (nbChunks > 0) {
+            m_file.write((const char *) &m_index[0], nbChunks * sizeof(IndexEntry));
+        }
+
+        m_file.seekp(offsetof(ChunkedHeader, indexOffset));
+        m_file.write((const char *) &m_offset, sizeof(quint64));
+
+        qDebug("FileRecord::Writer::writeIndex: %u chunks %llu bytes", nbChunks, m_offset);
+    }
+};
 
 FileRecord::FileRecord() :
 	BasebandSampleSink(),
@@ -11,8 +170,17 @@ FileRecord::FileRecord() :
     m_sampleRate(0),
     m_centerFrequency(0),
 	m_recordOn(false),
-    m_recordStart(false),
-    m_byteCount(0)
+#ifdef USE_LZ4
+    m_compression(true),
+#else
+    m_compression(false),
+#endif
+    m_byteCount(0),
+    m_droppedCount(0),
+    m_writer(0),
+    m_chunkSamples(defaultChunkSamples),
+    m_recordSamples(0),
+    m_chunkBuffer(-1)
 {
 	setObjectName("FileSink");
 }
@@ -23,8 +191,17 @@ FileRecord::FileRecord(const std::string& filename) :
     m_sampleRate(0),
     m_centerFrequency(0),
     m_recordOn(false),
-    m_recordStart(false),
-    m_byteCount(0)
+#ifdef USE_LZ4
+    m_compression(true),
+#else
+    m_compression(false),
+#endif
+    m_byteCount(0),
+    m_droppedCount(0),
+    m_writer(0),
+    m_chunkSamples(defaultChunkSamples),
+    m_recordSamples(0),
+    m_chunkBuffer(-1)
 {
     setObjectName("FileRecord");
 }
@@ -42,21 +219,51 @@ void FileRecord::setFileName(const std::string& filename)
     }
 }
 
+void FileRecord::setCompression(bool compression)
+{
+#ifdef USE_LZ4
+    m_compression = compression;
+#else
+    (void) compression;
+#endif
+}
+
 void FileRecord::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
 {
     // if no recording is active, send the samples to /dev/null
     if(!m_recordOn)
         return;
 
-    if (begin < end) // if there is something to put out
+    QMutexLocker mutexLocker(&m_mutex);
+
+    if ((begin < end) && (m_writer != 0)) // if there is something to put out
     {
-        if (m_recordStart)
+        if ((m_chunkBuffer >= 0) && ((m_chunk.sampleRate != m_sampleRate) || (m_chunk.centerFrequency != m_centerFrequency))) {
+            closeChunk(); // following samples go with the new values
+        }
+
+        SampleVector::const_iterator it = begin;
+
+        while (it < end)
         {
-            writeHeader();
-            m_recordStart = false;
+            if ((m_chunkBuffer < 0) && !openChunk())
+            {
+                m_droppedCount += end - it;
+                break;
+            }
+
+            quint32 room = m_chunkSamples - m_chunk.nbSamples;
+            quint32 count = (end - it) < room ? end - it : room;
+            std::copy(it, it + count, m_chunkIt);
+            m_chunkIt += count;
+            m_chunk.nbSamples += count;
+            it += count;
+
+            if (m_chunk.nbSamples == m_chunkSamples) {
+                closeChunk();
+            }
         }
 
-        m_sampleFile.write(reinterpret_cast<const char*>(&*(begin)), (end - begin)*sizeof(Sample));
         m_byteCount += end - begin;
     }
 }
@@ -72,24 +279,35 @@ void FileRecord::stop()
 
 void FileRecord::startRecording()
 {
-    if (!m_sampleFile.is_open())
+    QMutexLocker mutexLocker(&m_mutex);
+
+    if (m_writer == 0)
     {
     	qDebug() << "FileRecord::startRecording";
-        m_sampleFile.open(m_fileName.c_str(), std::ios::binary);
+        m_writer = new Writer(m_fileName, m_chunkSamples, m_compression);
+        m_writer->start();
         m_recordOn = true;
-        m_recordStart = true;
         m_byteCount = 0;
+        m_droppedCount = 0;
+        m_recordSamples = 0;
+        m_chunkBuffer = -1;
     }
 }
 
 void FileRecord::stopRecording()
 {
-    if (m_sampleFile.is_open())
+    QMutexLocker mutexLocker(&m_mutex);
+
+    if (m_writer != 0)
     {
-    	qDebug() << "FileRecord::stopRecording";
-        m_sampleFile.close();
+    	qDebug() << "FileRecord::stopRecording: dropped samples: " << m_droppedCount;
+        closeChunk();
+        Writer *writer = m_writer;
+        m_writer = 0;
         m_recordOn = false;
-        m_recordStart = false;
+        mutexLocker.unlock(); // the DSP thread may go on while the writer drains its queue
+        writer->finish();
+        delete writer;
     }
 }
 
@@ -100,6 +318,7 @@ bool FileRecord::handleMessage(const Message& message)
 	if (DSPSignalNotification::match(message))
 	{
 		DSPSignalNotification& notif = (DSPSignalNotification&) message;
+		QMutexLocker mutexLocker(&m_mutex); // may come from the GUI thread
 		m_sampleRate = notif.getSampleRate();
 		m_centerFrequency = notif.getCenterFrequency();
 		qDebug() << "FileRecord::handleMessage: DSPSignalNotification: m_inputSampleRate: " << m_sampleRate
@@ -122,12 +341,191 @@ void FileRecord::handleConfigure(const std::string& fileName)
 	m_fileName = fileName;
 }
 
-void FileRecord::writeHeader()
+bool FileRecord::openChunk()
+{
+    m_chunkBuffer = m_writer->takeBuffer();
+
+    if (m_chunkBuffer < 0) {
+        return false;
+    }
+
+    memset(&m_chunk, 0, sizeof(ChunkHeader));
+    m_chunk.magic = chunkMagic;
+    m_chunk.firstSample = m_recordSamples;
+    m_chunk.timeStamp = QDateTime::currentMSecsSinceEpoch();
+    m_chunk.centerFrequency = m_centerFrequency;
+    m_chunk.sampleRate = m_sampleRate;
+    m_chunkIt = m_writer->getBuffer(m_chunkBuffer).begin();
+
+    return true;
+}
+
+void FileRecord::closeChunk()
+{
+    if (m_chunkBuffer < 0) {
+        return;
+    }
+
+    m_writer->queueChunk(m_chunkBuffer, m_chunk);
+    m_recordSamples += m_chunk.nbSamples;
+    m_chunkBuffer = -1;
+}
+
+void FileRecord::encodeSamples(const Sample *samples, quint32 nbSamples, bool compression, ChunkHeader& header, std::vector<quint8>& data, std::vector<quint8>& work)
+{
+    const FixReal *components = &samples[0].m_real;
+    quint32 nbComponents = 2*nbSamples;
+    FixReal minValue = components[0];
+    FixReal maxValue = components[0];
+
+    for (quint32 i = 1; i < nbComponents; i++)
+    {
+        minValue = components[i] < minValue ? components[i] : minValue;
+        maxValue = components[i] > maxValue ? components[i] : maxValue;
+    }
+
+    // low bits that are zero in all components such as in the 8 bit samples scaled up by the decimators
+    quint32 offsetBits = 0;
+
+    for (quint32 i = 0; i < nbComponents; i++) {
+        offsetBits |= (quint32) (components[i] - minValue);
+    }
+
+    quint32 shift = 0;
+
+    while ((offsetBits != 0) && ((offsetBits & 1) == 0))
+    {
+        offsetBits >>= 1;
+        shift++;
+    }
+
+    quint32 range = ((quint32) (maxValue - minValue)) >> shift;
+    header.sampleBits = range < (1<<8) ? 8 : range < (1<<12) ? 12 : 16;
+    header.sampleBase = header.sampleBits == 16 ? 0 : minValue;
+    header.sampleShift = header.sampleBits == 16 ? 0 : shift;
+
+    std::vector<quint8>& packed = compression ? work : data;
+
+    if (header.sampleBits == 16)
+    {
+        packed.resize(nbSamples * sizeof(Sample));
+        memcpy(&packed[0], samples, nbSamples * sizeof(Sample));
+    }
+    else if (header.sampleBits == 12)
+    {
+        packed.resize(nbSamples * 3);
+
+        for (quint32 i = 0; i < nbSamples; i++)
+        {
+            quint32 u0 = ((quint32) (components[2*i] - minValue)) >> shift;
+            quint32 u1 = ((quint32) (components[2*i+1] - minValue)) >> shift;
+            packed[3*i]   = u0 & 0xff;
+            packed[3*i+1] = (u0 >> 8) | ((u1 & 0x0f) << 4);
+            packed[3*i+2] = u1 >> 4;
+        }
+    }
+    else
+    {
+        packed.resize(nbComponents);
+
+        for (quint32 i = 0; i < nbComponents; i++) {
+            packed[i] = ((quint32) (components[i] - minValue)) >> shift;
+        }
+    }
+
+    header.encoding = EncodingRaw;
+    header.dataSize = packed.size();
+
+#ifdef USE_LZ4
+    if (compression)
+    {
+        data.resize(LZ4_compressBound(packed.size()));
+        int compressedSize = LZ4_compress_default((const char *) &packed[0], (char *) &data[0], packed.size(), data.size());
+
+        if ((compressedSize > 0) && ((quint32) compressedSize < packed.size()))
+        {
+            header.encoding = EncodingLZ4;
+            header.dataSize = compressedSize;
+            return;
+        }
+    }
+#endif
+
+    if (compression) { // not worth it
+        data.swap(work);
+    }
+}
+
+bool FileRecord::checkChunkHeader(const ChunkHeader& header)
 {
-    m_sampleFile.write((const char *) &m_sampleRate, sizeof(int));
-    m_sampleFile.write((const char *) &m_centerFrequency, sizeof(quint64));
-    std::time_t ts = time(0);
-    m_sampleFile.write((const char *) &ts, sizeof(std::time_t));
+    if ((header.nbSamples > maxChunkSamples) || ((header.sampleBits != 16) && (header.sampleBits != 12) && (header.sampleBits != 8))) {
+        return false;
+    }
+
+    quint64 packedSize = (quint64) header.nbSamples * (header.sampleBits == 16 ? sizeof(Sample) : header.sampleBits == 12 ? 3 : 2);
+
+    if (header.encoding == EncodingRaw) {
+        return header.dataSize >= packedSize;
+    } else if (header.encoding == EncodingLZ4) {
+        return packedSize <= 256 * (quint64) header.dataSize; // LZ4 cannot expand its input more than 255 times
+    } else {
+        return false;
+    }
+}
+
+bool FileRecord::decodeSamples(const ChunkHeader& header, const quint8 *data, Sample *samples, std::vector<quint8>& work)
+{
+    quint32 packedSize = header.nbSamples * (header.sampleBits == 16 ? sizeof(Sample) : header.sampleBits == 12 ? 3 : 2);
+    const quint8 *packed = data;
+
+    if (header.encoding == EncodingLZ4)
+    {
+#ifdef USE_LZ4
+        work.resize(packedSize);
+
+        if (LZ4_decompress_safe((const char *) data, (char *) &work[0], header.dataSize, packedSize) != (int) packedSize) {
+            return false;
+        }
+
+        packed = &work[0];
+#else
+        qWarning("FileRecord::decodeSamples: built without LZ4 support");
+        return false;
+#endif
+    }
+    else if ((header.encoding != EncodingRaw) || (header.dataSize < packedSize))
+    {
+        return false;
+    }
+
+    FixReal *components = &samples[0].m_real;
+
+    if (header.sampleBits == 16)
+    {
+        memcpy(samples, packed, packedSize);
+    }
+    else if (header.sampleBits == 12)
+    {
+        for (quint32 i = 0; i < header.nbSamples; i++)
+        {
+            quint32 u0 = packed[3*i] | ((packed[3*i+1] & 0x0f) << 8);
+            quint32 u1 = (packed[3*i+1] >> 4) | (packed[3*i+2] << 4);
+            components[2*i]   = header.sampleBase + (FixReal) (u0 << header.sampleShift);
+            components[2*i+1] = header.sampleBase + (FixReal) (u1 << header.sampleShift);
+        }
+    }
+    else if (header.sampleBits == 8)
+    {
+        for (quint32 i = 0; i < 2*header.nbSamples; i++) {
+            components[i] = header.sampleBase + (FixReal) (packed[i] << header.sampleShift);
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    return true;
 }
 
 void FileRecord::readHeader(std::ifstream& sampleFile, Header& header)
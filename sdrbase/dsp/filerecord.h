@@ -2,9 +2,11 @@
 #define INCLUDE_FILESINK_H
 
 #include <dsp/basebandsamplesink.h>
+#include <QMutex>
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <vector>
 
 #include <ctime>
 #include "util/export.h"
@@ -21,13 +23,69 @@ public:
         std::time_t startTimeStamp;
     };
 
+    /**
+     * Chunked record container. The file header is followed by chunks of at most chunkSamples
+     * I/Q samples each made of a chunk header and the sample data. A chunk is closed early when
+     * the sample rate or center frequency changes. On stop the chunk headers with their file
+     * offsets are appended as the seek index and the index offset is patched into the file header.
+     *
+     * The sample data of a chunk is either the native samples or the components packed on 8 or
+     * 12 bits when the range of the chunk allows it without loss. It may then be LZ4 compressed.
+     */
+    struct ChunkedHeader
+    {
+        char    magic[8];         //!< "SDRIQCHK"
+        quint32 version;
+        quint32 chunkSamples;     //!< maximum number of I/Q samples in a chunk
+        quint64 indexOffset;      //!< file offset of the seek index or 0 if the record was not closed
+        qint64  startTimeStamp;   //!< ms since epoch
+    };
+
+    struct ChunkHeader
+    {
+        quint32 magic;            //!< FileRecord::chunkMagic
+        quint32 nbSamples;
+        quint64 firstSample;      //!< index of the first I/Q sample of the chunk in the record
+        qint64  timeStamp;        //!< ms since epoch of the first sample
+        quint64 centerFrequency;
+        qint32  sampleRate;
+        quint32 dataSize;         //!< bytes of sample data following the header
+        qint16  sampleBase;       //!< component value stored as 0 when packed
+        quint8  sampleShift;      //!< packed components are shifted left by this before adding the base
+        quint8  sampleBits;       //!< bits per stored component: 16 (native samples), 12 or 8
+        quint32 encoding;         //!< EncodingRaw or EncodingLZ4
+    };
+
+    struct IndexEntry
+    {
+        ChunkHeader header;
+        quint64 offset;           //!< file offset of the chunk header
+    };
+
+    enum Encoding
+    {
+        EncodingRaw = 0,
+        EncodingLZ4 = 1
+    };
+
+    static const char chunkedMagic[8];
+    static const quint32 chunkMagic = 0x4b4e4843;  //!< "CHNK"
+    static const quint32 indexMagic = 0x58444e49;  //!< "INDX"
+    static const quint32 chunkedVersion = 2;
+    static const quint32 defaultChunkSamples = 1<<16;
+    static const quint32 maxChunkSamples = 1<<24;  //!< chunks announcing more samples are rejected as corrupt
+    static const int nbChunkBuffers = 16;          //!< chunks that can wait for the writer before samples are dropped
+
 	FileRecord();
     FileRecord(const std::string& filename);
 	virtual ~FileRecord();
 
     quint64 getByteCount() const { return m_byteCount; }
+    quint64 getDroppedCount() const { return m_droppedCount; } //!< samples lost because the writer could not keep up
 
     void setFileName(const std::string& filename);
+    void setCompression(bool compression); //!< LZ4 compress chunks if it reduces their size. Effective from next recording
+    bool getCompression() const { return m_compression; }
 
 	virtual void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly);
 	virtual void start();
@@ -37,17 +95,34 @@ public:
     void stopRecording();
     static void readHeader(std::ifstream& samplefile, Header& header);
 
+    /** Encodes nbSamples samples in data and fills the encoding fields and data size of the header */
+    static void encodeSamples(const Sample *samples, quint32 nbSamples, bool compression, ChunkHeader& header, std::vector<quint8>& data, std::vector<quint8>& work);
+    /** Checks that the sample data size of a chunk can hold its samples at their encoding. Returns false if the header is corrupt */
+    static bool checkChunkHeader(const ChunkHeader& header);
+    /** Decodes the sample data of a chunk. Returns false if the data is corrupt */
+    static bool decodeSamples(const ChunkHeader& header, const quint8 *data, Sample *samples, std::vector<quint8>& work);
+
 private:
+    class Writer;
+
 	std::string m_fileName;
 	int m_sampleRate;
 	quint64 m_centerFrequency;
 	bool m_recordOn;
-    bool m_recordStart;
-    std::ofstream m_sampleFile;
+    bool m_compression;
     quint64 m_byteCount;
+    quint64 m_droppedCount;
+    QMutex m_mutex;               //!< between the DSP thread feeding and the GUI starting and stopping
+    Writer *m_writer;
+    quint32 m_chunkSamples;
+    quint64 m_recordSamples;      //!< samples handed to the writer
+    int m_chunkBuffer;            //!< buffer being filled or -1
+    ChunkHeader m_chunk;          //!< header of the chunk being filled
+    SampleVector::iterator m_chunkIt;
 
 	void handleConfigure(const std::string& fileName);
-    void writeHeader();
+    bool openChunk();
+    void closeChunk();
 };
 
 #endif // INCLUDE_FILESINK_H
@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QDebug>
+#include <cstring>
+#include <ctime>
+
+#include "dsp/dsptypes.h"
+#include "dsp/filerecordreader.h"
+
+FileRecordReader::FileRecordReader() :
+    m_chunked(false),
+    m_nbSamples(0),
+    m_startTimeStamp(0),
+    m_decodedChunk(-1)
+{
+}
+
+FileRecordReader::~FileRecordReader()
+{
+    close();
+}
+
+bool FileRecordReader::open(const QString& fileName)
+{
+    close();
+    m_file.setFileName(fileName);
+
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    quint64 fileSize = m_file.size();
+    const quint8 *mapped = fileSize > sizeof(FileRecord::Header) ? m_file.map(0, fileSize) : 0;
+
+    if (mapped == 0)
+    {
+        m_file.close();
+        return false;
+    }
+
+    if ((fileSize >= sizeof(FileRecord::ChunkedHeader)) && (memcmp(mapped, FileRecord::chunkedMagic, sizeof(FileRecord::chunkedMagic)) == 0)) {
+        m_chunked = openChunked(mapped, fileSize);
+    } else {
+        openLegacy(mapped, fileSize);
+    }
+
+    if (m_nbSamples == 0)
+    {
+        close();
+        return false;
+    }
+
+    return true;
+}
+
+void FileRecordReader::close()
+{
+    if (m_file.isOpen()) {
+        m_file.close(); // also unmaps
+    }
+
+    m_chunked = false;
+    m_nbSamples = 0;
+    m_startTimeStamp = 0;
+    m_chunks.clear();
+    m_decodedChunk = -1;
+}
+
+int FileRecordReader::getMaxSampleRate() const
+{
+    int maxSampleRate = 0;
+
+    for (std::vector<Chunk>::const_iterator it = m_chunks.begin(); it != m_chunks.end(); ++it)
+    {
+        if (it->sampleRate > maxSampleRate) {
+            maxSampleRate = it->sampleRate;
+        }
+    }
+
+    return maxSampleRate;
+}
+
+int FileRecordReader::findChunk(quint64 sampleIndex) const
+{
+    int low = 0;
+    int high = m_chunks.size() - 1;
+
+    while (low < high)
+    {
+        int mid = (low + high + 1) / 2;
+
+        if (m_chunks[mid].firstSample <= sampleIndex) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return low;
+}
+
+const quint8 *FileRecordReader::getSamples(int chunkIndex)
+{
+    const Chunk& chunk = m_chunks[chunkIndex];
+
+    if ((chunk.header.sampleBits == 16) && (chunk.header.encoding == FileRecord::EncodingRaw)) {
+        return chunk.data;
+    }
+
+    if (chunkIndex != m_decodedChunk)
+    {
+        if (m_decoded.size() < chunk.nbSamples) {
+            m_decoded.resize(chunk.nbSamples);
+        }
+
+        if (!FileRecord::decodeSamples(chunk.header, chunk.data, &m_decoded[0], m_work))
+        {
+            qWarning("FileRecordReader::getSamples: chunk %d is corrupt", chunkIndex);
+            m_decodedChunk = -1;
+            return 0;
+        }
+
+        m_decodedChunk = chunkIndex;
+    }
+
+    return (const quint8 *) &m_decoded[0];
+}
+
+bool FileRecordReader::openLegacy(const quint8 *mapped, quint64 fileSize)
+{
+    Chunk chunk;
+    std::time_t startTimeStamp;
+
+    // header fields are written one after the other without padding
+    memcpy(&chunk.sampleRate, mapped, sizeof(int));
+    memcpy(&chunk.centerFrequency, mapped + sizeof(int), sizeof(quint64));
+    memcpy(&startTimeStamp, mapped + sizeof(int) + sizeof(quint64), sizeof(std::time_t));
+    m_startTimeStamp = (qint64) startTimeStamp * 1000;
+
+    chunk.firstSample = 0;
+    chunk.nbSamples = (fileSize - sizeof(FileRecord::Header)) / sizeof(Sample);
+    chunk.timeStamp = m_startTimeStamp;
+    chunk.data = mapped + sizeof(FileRecord::Header);
+    memset(&chunk.header, 0, sizeof(FileRecord::ChunkHeader));
+    chunk.header.sampleBits = 16;
+    chunk.header.encoding = FileRecord::EncodingRaw;
+    m_chunks.push_back(chunk);
+    m_nbSamples = chunk.nbSamples;
+
+    return true;
+}
+
+bool FileRecordReader::openChunked(const quint8 *mapped, quint64 fileSize)
+{
+    FileRecord::ChunkedHeader fileHeader;
+    memcpy(&fileHeader, mapped, sizeof(FileRecord::ChunkedHeader));
+    m_startTimeStamp = fileHeader.startTimeStamp;
+
+    if (fileHeader.version != FileRecord::chunkedVersion)
+    {
+        qWarning("FileRecordReader::openChunked: unsupported version %u", fileHeader.version);
+        return false;
+    }
+
+    quint64 dataEnd = fileSize;
+
+    if ((fileHeader.indexOffset >= sizeof(FileRecord::ChunkedHeader)) && (fileHeader.indexOffset + 2*sizeof(quint32) <= fileSize))
+    {
+        quint32 indexMagic, nbChunks;
+        memcpy(&indexMagic, mapped + fileHeader.indexOffset, sizeof(quint32));
+        memcpy(&nbChunks, mapped + fileHeader.indexOffset + sizeof(quint32), sizeof(quint32));
+        const quint8 *index = mapped + fileHeader.indexOffset + 2*sizeof(quint32);
+        dataEnd = fileHeader.indexOffset;
+
+        if ((indexMagic == FileRecord::indexMagic)
+         && (fileHeader.indexOffset + 2*sizeof(quint32) + (quint64) nbChunks * sizeof(FileRecord::IndexEntry) <= fileSize))
+        {
+            FileRecord::IndexEntry entry;
+            quint32 i = 0;
+
+            for (; i < nbChunks; i++)
+            {
+                memcpy(&entry, index + i*sizeof(FileRecord::IndexEntry), sizeof(FileRecord::IndexEntry));
+
+                if ((entry.header.firstSample != m_nbSamples)
+                 || (entry.offset + sizeof(FileRecord::ChunkHeader) + entry.header.dataSize > dataEnd)
+                 || !addChunk(entry.header, mapped + entry.offset + sizeof(FileRecord::ChunkHeader))) {
+                    break;
+                }
+            }
+
+            if (i == nbChunks) {
+                return true;
+            }
+
+            m_chunks.clear();
+            m_nbSamples = 0;
+        }
+    }
+
+    // the record was not closed properly: rebuild the index from the chunk headers
+    qWarning("FileRecordReader::openChunked: no valid seek index. Scanning chunks");
+    quint64 offset = sizeof(FileRecord::ChunkedHeader);
+
+    while (offset + sizeof(FileRecord::ChunkHeader) <= dataEnd)
+    {
+        FileRecord::ChunkHeader header;
+        memcpy(&header, mapped + offset, sizeof(FileRecord::ChunkHeader));
+
+        if ((header.magic != FileRecord::chunkMagic) || (offset + sizeof(FileRecord::ChunkHeader) + header.dataSize > dataEnd)) {
+            break; // chunk being written when the record was interrupted
+        }
+
+        header.firstSample = m_nbSamples;
+
+        if (!addChunk(header, mapped + offset + sizeof(FileRecord::ChunkHeader))) {
+            break; // torn header: the following chunks cannot be located
+        }
+
+        offset += sizeof(FileRecord::ChunkHeader) + header.dataSize + (8 - (header.dataSize % 8)) % 8;
+    }
+
+    return true;
+}
+
+bool FileRecordReader::addChunk(const FileRecord::ChunkHeader& header, const quint8 *data)
+{
+    if (!FileRecord::checkChunkHeader(header))
+    {
+        qWarning("FileRecordReader::addChunk: corrupt chunk header at sample %llu: %u samples of %u bits in %u bytes",
+                header.firstSample, header.nbSamples, header.sampleBits, header.dataSize);
+        return false;
+    }
+
+    Chunk chunk;
+    chunk.firstSample = header.firstSample;
+    chunk.nbSamples = header.nbSamples;
+    chunk.sampleRate = header.sampleRate;
+    chunk.centerFrequency = header.centerFrequency;
+    chunk.timeStamp = header.timeStamp;
+    chunk.data = data;
+    chunk.header = header;
+    m_chunks.push_back(chunk);
+    m_nbSamples += chunk.nbSamples;
+    return true;
+}
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_FILERECORDREADER_H_
+#define SDRBASE_DSP_FILERECORDREADER_H_
+
+#include <QFile>
+#include <QString>
+#include <vector>
+
+#include "dsp/dsptypes.h"
+#include "dsp/filerecord.h"
+#include "util/export.h"
+
+/**
+ * Memory maps a record written by FileRecord and gives access to its samples chunk by chunk.
+ * Both the chunked container and the legacy format with a single header are handled. The
+ * legacy format is presented as a single chunk. Chunks of a closed chunked record are read
+ * from the seek index at the end of the file. If the record was not closed properly the chunk
+ * headers are walked from the start of the file instead. Native samples are read from the
+ * mapping directly while packed or compressed chunks are decoded on demand.
+ */
+class SDRANGEL_API FileRecordReader
+{
+public:
+    struct Chunk
+    {
+        quint64 firstSample;      //!< index of the first I/Q sample of the chunk in the record
+        quint64 nbSamples;
+        int sampleRate;
+        quint64 centerFrequency;
+        qint64 timeStamp;         //!< ms since epoch of the first sample
+        const quint8 *data;       //!< sample data of the chunk in the mapping
+        FileRecord::ChunkHeader header; //!< sample data encoding
+    };
+
+    FileRecordReader();
+    ~FileRecordReader();
+
+    bool open(const QString& fileName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_file.errorString(); }
+
+    bool isChunked() const { return m_chunked; }
+    quint64 getNbSamples() const { return m_nbSamples; }
+    int getNbChunks() const { return m_chunks.size(); }
+    const Chunk& getChunk(int chunkIndex) const { return m_chunks[chunkIndex]; }
+    qint64 getStartTimeStamp() const { return m_startTimeStamp; } //!< ms since epoch
+    int getMaxSampleRate() const;
+
+    /** Index of the chunk containing the given sample or of the last chunk past the end of record */
+    int findChunk(quint64 sampleIndex) const;
+    /** I/Q samples of a chunk. Decoded samples stay valid until another chunk is decoded. 0 if the chunk is corrupt */
+    const quint8 *getSamples(int chunkIndex);
+
+private:
+    QFile m_file;
+    bool m_chunked;
+    quint64 m_nbSamples;
+    qint64 m_startTimeStamp;
+    std::vector<Chunk> m_chunks;
+    int m_decodedChunk;           //!< chunk held in m_decoded or -1
+    SampleVector m_decoded;
+    std::vector<quint8> m_work;
+
+    bool openLegacy(const quint8 *mapped, quint64 fileSize);
+    bool openChunked(const quint8 *mapped, quint64 fileSize);
+    bool addChunk(const FileRecord::ChunkHeader& header, const quint8 *data); //!< false if the header is corrupt
+};
+
+#endif /* SDRBASE_DSP_FILERECORDREADER_H_ */
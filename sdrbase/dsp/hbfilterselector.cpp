@@ -0,0 +1,551 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QSettings>
+#include <QSysInfo>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QElapsedTimer>
+#include <QDebug>
+
+#include "dsp/inthalfbandfilter.h"
+#include "dsp/inthalfbandfilterdb.h"
+#include "dsp/inthalfbandfiltereo1.h"
+#include "dsp/inthalfbandfilterst.h"
+#include "dsp/downchannelizer.h"
+#include "dsp/upchannelizer.h"
+#include "dsp/decimators.h"
+#include "dsp/hbfilterselector.h"
+
+/** Binds the functions of HBFilterOps to a half band filter class */
+template<class HBFilter>
+struct HBFilterFunctions
+{
+    static void *create() { return new HBFilter; }
+    static void destroy(void *filter) { delete static_cast<HBFilter*>(filter); }
+    static int getState(const void *filter) { return static_cast<const HBFilter*>(filter)->getState(); }
+
+    static bool decimateCenter(void *filter, Sample *sample) { return static_cast<HBFilter*>(filter)->workDecimateCenter(sample); }
+    static bool decimateLowerHalf(void *filter, Sample *sample) { return static_cast<HBFilter*>(filter)->workDecimateLowerHalf(sample); }
+    static bool decimateUpperHalf(void *filter, Sample *sample) { return static_cast<HBFilter*>(filter)->workDecimateUpperHalf(sample); }
+
+    static bool interpolateCenter(void *filter, Sample *sampleIn, Sample *sampleOut) { return static_cast<HBFilter*>(filter)->workInterpolateCenter(sampleIn, sampleOut); }
+    static bool interpolateLowerHalf(void *filter, Sample *sampleIn, Sample *sampleOut) { return static_cast<HBFilter*>(filter)->workInterpolateLowerHalf(sampleIn, sampleOut); }
+    static bool interpolateUpperHalf(void *filter, Sample *sampleIn, Sample *sampleOut) { return static_cast<HBFilter*>(filter)->workInterpolateUpperHalf(sampleIn, sampleOut); }
+
+    static void myDecimate(void *filter, qint32 x1, qint32 y1, qint32 *x2, qint32 *y2) { static_cast<HBFilter*>(filter)->myDecimate(x1, y1, x2, y2); }
+    static bool decimateCenterInt(void *filter, qint32 *x, qint32 *y) { return static_cast<HBFilter*>(filter)->workDecimateCenter(x, y); }
+
+    static int decimateBlockCenter(void *filter, Sample *samples, int nbSamples);
+    static int decimateBlockLowerHalf(void *filter, Sample *samples, int nbSamples);
+    static int decimateBlockUpperHalf(void *filter, Sample *samples, int nbSamples);
+
+    /** One input is consumed every other output: the filter tells when */
+    template<bool (HBFilter::*WorkInterpolate)(Sample*, Sample*)>
+    static void interpolateBlock(void *filter, Sample *samplesIn, Sample *samplesOut, unsigned int nbSamplesOut)
+    {
+        HBFilter *hbFilter = static_cast<HBFilter*>(filter);
+
+        for (unsigned int i = 0; i < nbSamplesOut; i++)
+        {
+            if ((hbFilter->*WorkInterpolate)(samplesIn, &samplesOut[i])) {
+                samplesIn++;
+            }
+        }
+    }
+
+    static const HBFilterOps *getOps(const char *name, unsigned int order)
+    {
+        static HBFilterOps ops = {
+            name,
+            order,
+            &create,
+            &destroy,
+            {&decimateCenter, &decimateLowerHalf, &decimateUpperHalf},
+            {&decimateBlockCenter, &decimateBlockLowerHalf, &decimateBlockUpperHalf},
+            {&interpolateCenter, &interpolateLowerHalf, &interpolateUpperHalf},
+            {
+                &interpolateBlock<&HBFilter::workInterpolateCenter>,
+                &interpolateBlock<&HBFilter::workInterpolateLowerHalf>,
+                &interpolateBlock<&HBFilter::workInterpolateUpperHalf>
+            },
+            &getState,
+            &myDecimate,
+            &decimateCenterInt
+        };
+
+        return &ops;
+    }
+};
+
+template<class HBFilter>
+int HBFilterFunctions<HBFilter>::decimateBlockCenter(void *filter, Sample *samples, int nbSamples)
+{
+    HBFilter *hbFilter = static_cast<HBFilter*>(filter);
+    Sample *out = samples;
+    int i = 0;
+
+    // run the state machine until it is back to its initial state
+    for (; (i < nbSamples) && (hbFilter->getState() != 0); i++)
+    {
+        Sample s(samples[i]);
+
+        if (hbFilter->workDecimateCenter(&s)) {
+            *out++ = s;
+        }
+    }
+
+    // then the state is implicit: one output every two inputs
+    for (; i < nbSamples - 1; i += 2)
+    {
+        Sample s(samples[i+1]);
+        hbFilter->myDecimate(&samples[i], &s);
+        *out++ = s;
+    }
+
+    // leftover input goes through the state machine
+    for (; i < nbSamples; i++)
+    {
+        Sample s(samples[i]);
+
+        if (hbFilter->workDecimateCenter(&s)) {
+            *out++ = s;
+        }
+    }
+
+    return out - samples;
+}
+
+template<class HBFilter>
+int HBFilterFunctions<HBFilter>::decimateBlockLowerHalf(void *filter, Sample *samples, int nbSamples)
+{
+    HBFilter *hbFilter = static_cast<HBFilter*>(filter);
+    Sample *out = samples;
+    int i = 0;
+
+    for (; (i < nbSamples) && (hbFilter->getState() != 0); i++)
+    {
+        Sample s(samples[i]);
+
+        if (hbFilter->workDecimateLowerHalf(&s)) {
+            *out++ = s;
+        }
+    }
+
+    // rotate by +1/4 four samples at a time: the state sequence is implicit
+    for (; i < nbSamples - 3; i += 4)
+    {
+        Sample s0(-samples[i].imag(), samples[i].real());
+        Sample s1(-samples[i+1].real(), -samples[i+1].imag());
+        Sample s2(samples[i+2].imag(), -samples[i+2].real());
+        Sample s3(samples[i+3]);
+        hbFilter->myDecimate(&s0, &s1);
+        hbFilter->myDecimate(&s2, &s3);
+        *out++ = s1;
+        *out++ = s3;
+    }
+
+    for (; i < nbSamples; i++)
+    {
+        Sample s(samples[i]);
+
+        if (hbFilter->workDecimateLowerHalf(&s)) {
+            *out++ = s;
+        }
+    }
+
+    return out - samples;
+}
+
+template<class HBFilter>
+int HBFilterFunctions<HBFilter>::decimateBlockUpperHalf(void *filter, Sample *samples, int nbSamples)
+{
+    HBFilter *hbFilter = static_cast<HBFilter*>(filter);
+    Sample *out = samples;
+    int i = 0;
+
+    for (; (i < nbSamples) && (hbFilter->getState() != 0); i++)
+    {
+        Sample s(samples[i]);
+
+        if (hbFilter->workDecimateUpperHalf(&s)) {
+            *out++ = s;
+        }
+    }
+
+    // rotate by -1/4 four samples at a time: the state sequence is implicit
+    for (; i < nbSamples - 3; i += 4)
+    {
+        Sample s0(samples[i].imag(), -samples[i].real());
+        Sample s1(-samples[i+1].real(), -samples[i+1].imag());
+        Sample s2(-samples[i+2].imag(), samples[i+2].real());
+        Sample s3(samples[i+3]);
+        hbFilter->myDecimate(&s0, &s1);
+        hbFilter->myDecimate(&s2, &s3);
+        *out++ = s1;
+        *out++ = s3;
+    }
+
+    for (; i < nbSamples; i++)
+    {
+        Sample s(samples[i]);
+
+        if (hbFilter->workDecimateUpperHalf(&s)) {
+            *out++ = s;
+        }
+    }
+
+    return out - samples;
+}
+
+namespace {
+
+QMutex selectorMutex;
+
+struct UseSiteInfo
+{
+    const char *m_name;
+    unsigned int m_order;
+    enum { Decimate, Interpolate, DecimatorsPair } m_kind;
+    HBFilterOps::Mode m_mode;
+};
+
+const UseSiteInfo useSites[HBFilterSelector::NbUseSites] = {
+    {"downchannelizer_center", DOWNCHANNELIZER_HB_FILTER_ORDER, UseSiteInfo::Decimate, HBFilterOps::ModeCenter},
+    {"downchannelizer_lower", DOWNCHANNELIZER_HB_FILTER_ORDER, UseSiteInfo::Decimate, HBFilterOps::ModeLowerHalf},
+    {"downchannelizer_upper", DOWNCHANNELIZER_HB_FILTER_ORDER, UseSiteInfo::Decimate, HBFilterOps::ModeUpperHalf},
+    {"upchannelizer_center", UPCHANNELIZER_HB_FILTER_ORDER, UseSiteInfo::Interpolate, HBFilterOps::ModeCenter},
+    {"upchannelizer_lower", UPCHANNELIZER_HB_FILTER_ORDER, UseSiteInfo::Interpolate, HBFilterOps::ModeLowerHalf},
+    {"upchannelizer_upper", UPCHANNELIZER_HB_FILTER_ORDER, UseSiteInfo::Interpolate, HBFilterOps::ModeUpperHalf},
+    {"decimators", DECIMATORS_HB_FILTER_ORDER, UseSiteInfo::DecimatorsPair, HBFilterOps::ModeCenter}
+};
+
+const int calibrationVersion = 2;   //!< changes when the classes or the measurement change
+const int calibrationSamples = 8192; //!< input samples per timed run
+const int calibrationTrials = 5;     //!< the best of these runs is kept
+
+/** True if both outputs have the same samples, filter transients included */
+bool isIdentical(const SampleVector& reference, const SampleVector& output)
+{
+    if (reference.size() != output.size()) {
+        return false;
+    }
+
+    for (unsigned int j = 0; j < reference.size(); j++)
+    {
+        if ((output[j].real() != reference[j].real()) || (output[j].imag() != reference[j].imag())) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template<unsigned int HBFilterOrder>
+const HBFilterOps* const *getOrderCandidates()
+{
+    static const HBFilterOps* candidates[] = {
+#ifdef USE_SSE4_1
+        HBFilterFunctions<IntHalfbandFilterEO1<HBFilterOrder> >::getOps("EO1", HBFilterOrder),
+        HBFilterFunctions<IntHalfbandFilterDB<HBFilterOrder> >::getOps("DB", HBFilterOrder),
+#else
+        HBFilterFunctions<IntHalfbandFilterDB<HBFilterOrder> >::getOps("DB", HBFilterOrder),
+        HBFilterFunctions<IntHalfbandFilterEO1<HBFilterOrder> >::getOps("EO1", HBFilterOrder),
+#endif
+        HBFilterFunctions<IntHalfbandFilterST<HBFilterOrder> >::getOps("ST", HBFilterOrder),
+        HBFilterFunctions<IntHalfbandFilter<HBFilterOrder> >::getOps("plain", HBFilterOrder)
+    };
+
+    return candidates;
+}
+
+}
+
+const HBFilterOps *HBFilterSelector::m_selected[HBFilterSelector::NbUseSites] = {0, 0, 0, 0, 0, 0, 0};
+
+const HBFilterOps* const *HBFilterSelector::getCandidates(UseSite useSite)
+{
+    switch (useSites[useSite].m_order)
+    {
+    case DOWNCHANNELIZER_HB_FILTER_ORDER:
+        return getOrderCandidates<DOWNCHANNELIZER_HB_FILTER_ORDER>();
+    case UPCHANNELIZER_HB_FILTER_ORDER:
+        return getOrderCandidates<UPCHANNELIZER_HB_FILTER_ORDER>();
+    default:
+        return getOrderCandidates<DECIMATORS_HB_FILTER_ORDER>();
+    }
+}
+
+const HBFilterOps& HBFilterSelector::get(UseSite useSite)
+{
+    QMutexLocker mutexLocker(&selectorMutex);
+
+    if (m_selected[useSite] == 0) {
+        m_selected[useSite] = getCandidates(useSite)[0];
+    }
+
+    return *m_selected[useSite];
+}
+
+bool HBFilterSelector::isDefault(UseSite useSite)
+{
+    return &get(useSite) == getCandidates(useSite)[0];
+}
+
+const char *HBFilterSelector::getUseSiteName(UseSite useSite)
+{
+    return useSites[useSite].m_name;
+}
+
+QString HBFilterSelector::getCacheFileName()
+{
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::ConfigLocation);
+
+    if (!QCoreApplication::organizationName().isEmpty()) {
+        dir += "/" + QCoreApplication::organizationName();
+    }
+
+    return dir + "/halfband-calibration";
+}
+
+/** Build options and CPU model: a choice made on another machine or build is measured again */
+QString HBFilterSelector::getSignature()
+{
+    QString signature = QString("%1 %2").arg(calibrationVersion).arg(QSysInfo::buildAbi());
+#ifdef USE_SSE2
+    signature += " sse2";
+#endif
+#ifdef USE_SSE4_1
+    signature += " sse4.1";
+#endif
+#ifdef USE_AVX2
+    signature += " avx2";
+#endif
+#ifdef USE_NEON
+    signature += " neon";
+#endif
+    QFile cpuInfo("/proc/cpuinfo");
+
+    if (cpuInfo.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        while (!cpuInfo.atEnd())
+        {
+            QString line = QString(cpuInfo.readLine()).trimmed();
+
+            if (line.startsWith("model name") || line.startsWith("CPU part"))
+            {
+                signature += " " + line.section(':', 1).trimmed();
+                break;
+            }
+        }
+    }
+    else
+    {
+        signature += " " + QSysInfo::currentCpuArchitecture();
+    }
+
+    return signature;
+}
+
+void HBFilterSelector::calibrate(bool force)
+{
+    QMutexLocker mutexLocker(&selectorMutex);
+
+    if (!force && load()) {
+        return;
+    }
+
+    double nsPerSample[NbUseSites][NbClasses];
+    measure(nsPerSample);
+    save(nsPerSample);
+}
+
+bool HBFilterSelector::load()
+{
+    QSettings settings(getCacheFileName(), QSettings::IniFormat);
+
+    if (settings.value("signature").toString() != getSignature()) {
+        return false;
+    }
+
+    const HBFilterOps *selected[NbUseSites];
+
+    for (int useSite = 0; useSite < NbUseSites; useSite++)
+    {
+        QString name = settings.value(QString("%1/selected").arg(useSites[useSite].m_name)).toString();
+        const HBFilterOps* const *candidates = getCandidates((UseSite) useSite);
+        selected[useSite] = 0;
+
+        for (int i = 0; i < NbClasses; i++)
+        {
+            if (name == candidates[i]->m_name) {
+                selected[useSite] = candidates[i];
+            }
+        }
+
+        if (selected[useSite] == 0) {
+            return false;
+        }
+    }
+
+    for (int useSite = 0; useSite < NbUseSites; useSite++)
+    {
+        m_selected[useSite] = selected[useSite];
+        qDebug("HBFilterSelector::load: %s: %s%u", useSites[useSite].m_name, m_selected[useSite]->m_name, m_selected[useSite]->m_order);
+    }
+
+    return true;
+}
+
+void HBFilterSelector::measure(double nsPerSample[NbUseSites][NbClasses])
+{
+    SampleVector input(calibrationSamples);
+    SampleVector reference, output;
+    std::srand(1);
+
+    for (int i = 0; i < calibrationSamples; i++) {
+        input[i] = Sample((std::rand() % 16384) - 8192, (std::rand() % 16384) - 8192);
+    }
+
+    for (int useSite = 0; useSite < NbUseSites; useSite++)
+    {
+        const HBFilterOps* const *candidates = getCandidates((UseSite) useSite);
+        int best = 0;
+        nsPerSample[useSite][0] = timeCandidate((UseSite) useSite, *candidates[0], input, reference, calibrationTrials);
+
+        for (int i = 1; i < NbClasses; i++)
+        {
+            nsPerSample[useSite][i] = timeCandidate((UseSite) useSite, *candidates[i], input, output, calibrationTrials);
+
+            if (!isEquivalent((UseSite) useSite, *candidates[i], input, reference))
+            {
+                qDebug("HBFilterSelector::measure: %s: %s%u rejected: output differs from %s%u",
+                        useSites[useSite].m_name, candidates[i]->m_name, candidates[i]->m_order, candidates[0]->m_name, candidates[0]->m_order);
+                nsPerSample[useSite][i] = -1.0;
+            }
+            else if (nsPerSample[useSite][i] < 0.95 * nsPerSample[useSite][best]) // a class must be clearly faster to replace the default
+            {
+                best = i;
+            }
+        }
+
+        m_selected[useSite] = candidates[best];
+        qDebug("HBFilterSelector::measure: %s: %s%u %.2f ns/S (%s%u %.2f ns/S)",
+                useSites[useSite].m_name,
+                candidates[best]->m_name, candidates[best]->m_order, nsPerSample[useSite][best],
+                candidates[0]->m_name, candidates[0]->m_order, nsPerSample[useSite][0]);
+    }
+}
+
+/**
+ * Classes compute the same filter but some do not keep the same input samples when decimating or do
+ * not have the same latency. Swapping them in would change the phase and timing of the use site output
+ * so a class qualifies only if its output is identical to the one of the default class.
+ */
+bool HBFilterSelector::isEquivalent(UseSite useSite, const HBFilterOps& ops, const SampleVector& input, const SampleVector& reference)
+{
+    SampleVector output;
+    timeCandidate(useSite, ops, input, output, 1);
+    return isIdentical(reference, output);
+}
+
+/** Returns the best time per input sample of the use site operation and the output of the first run */
+double HBFilterSelector::timeCandidate(UseSite useSite, const HBFilterOps& ops, const SampleVector& input, SampleVector& output, int nbTrials)
+{
+    const UseSiteInfo& info = useSites[useSite];
+    SampleVector in(input.size());
+    SampleVector work(2 * input.size());
+    qint64 bestTime = 0;
+
+    for (int trial = 0; trial < nbTrials; trial++)
+    {
+        void *filter = (*ops.m_create)();
+        int nbOut = 0;
+        std::copy(input.begin(), input.end(), in.begin());
+        QElapsedTimer timer;
+        timer.start();
+
+        if (info.m_kind == UseSiteInfo::Decimate)
+        {
+            nbOut = (*ops.m_decimateBlock[info.m_mode])(filter, &in[0], in.size());
+            std::copy(in.begin(), in.begin() + nbOut, work.begin());
+        }
+        else if (info.m_kind == UseSiteInfo::Interpolate)
+        {
+            nbOut = 2 * in.size() - 2; // consumes at most in.size() samples whatever the initial state
+            (*ops.m_interpolateBlock[info.m_mode])(filter, &in[0], &work[0], nbOut);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < input.size() - 1; i += 2, nbOut++)
+            {
+                qint32 x = input[i+1].real();
+                qint32 y = input[i+1].imag();
+                (*ops.m_myDecimate)(filter, input[i].real(), input[i].imag(), &x, &y);
+                work[nbOut].setReal(x);
+                work[nbOut].setImag(y);
+            }
+        }
+
+        qint64 time = timer.nsecsElapsed();
+        (*ops.m_destroy)(filter);
+
+        if (trial == 0) {
+            output.assign(work.begin(), work.begin() + nbOut);
+        }
+
+        if ((trial == 0) || (time < bestTime)) {
+            bestTime = time;
+        }
+    }
+
+    return (double) bestTime / input.size();
+}
+
+void HBFilterSelector::save(const double nsPerSample[NbUseSites][NbClasses])
+{
+    QString fileName = getCacheFileName();
+    QDir().mkpath(QFileInfo(fileName).absolutePath());
+    QSettings settings(fileName, QSettings::IniFormat);
+    settings.clear();
+    settings.setValue("signature", getSignature());
+
+    for (int useSite = 0; useSite < NbUseSites; useSite++)
+    {
+        const HBFilterOps* const *candidates = getCandidates((UseSite) useSite);
+        settings.beginGroup(useSites[useSite].m_name);
+        settings.setValue("selected", m_selected[useSite]->m_name);
+
+        for (int i = 0; i < NbClasses; i++) {
+            settings.setValue(QString("%1%2_ns").arg(candidates[i]->m_name).arg(candidates[i]->m_order), nsPerSample[useSite][i]);
+        }
+
+        settings.endGroup();
+    }
+
+    settings.sync();
+
+    if (settings.status() != QSettings::NoError) {
+        qWarning("HBFilterSelector::save: cannot write %s", qPrintable(fileName));
+    }
+}
@@ -0,0 +1,159 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_HBFILTERSELECTOR_H_
+#define SDRBASE_DSP_HBFILTERSELECTOR_H_
+
+#include <QString>
+#include "dsp/dsptypes.h"
+#include "util/export.h"
+
+/**
+ * Functions of one half band filter class (IntHalfbandFilter, IntHalfbandFilterDB,
+ * IntHalfbandFilterEO1 or IntHalfbandFilterST) of a given order operating on an
+ * instance created by m_create. Tables are indexed by Mode.
+ */
+struct HBFilterOps
+{
+    enum Mode {
+        ModeCenter,
+        ModeLowerHalf,
+        ModeUpperHalf,
+        NbModes
+    };
+
+    typedef void* (*CreateFunction)();
+    typedef void (*DestroyFunction)(void *filter);
+    typedef bool (*DecimateFunction)(void *filter, Sample *sample);
+    typedef int (*DecimateBlockFunction)(void *filter, Sample *samples, int nbSamples);
+    typedef bool (*InterpolateFunction)(void *filter, Sample *sampleIn, Sample *sampleOut);
+    typedef void (*InterpolateBlockFunction)(void *filter, Sample *samplesIn, Sample *samplesOut, unsigned int nbSamplesOut);
+    typedef int (*StateFunction)(const void *filter);
+    typedef void (*DecimatePairFunction)(void *filter, qint32 x1, qint32 y1, qint32 *x2, qint32 *y2);
+    typedef bool (*DecimateCenterFunction)(void *filter, qint32 *x, qint32 *y);
+
+    const char *m_name;   //!< filter class name without the IntHalfbandFilter prefix ("plain" for IntHalfbandFilter)
+    unsigned int m_order;
+    CreateFunction m_create;
+    DestroyFunction m_destroy;
+    DecimateFunction m_decimate[NbModes];                 //!< workDecimateXxx on one sample
+    DecimateBlockFunction m_decimateBlock[NbModes];       //!< in place decimation of a block, returns the number of samples left
+    InterpolateFunction m_interpolate[NbModes];           //!< workInterpolateXxx on one sample
+    InterpolateBlockFunction m_interpolateBlock[NbModes]; //!< produces nbSamplesOut samples consuming one input every other output
+    StateFunction m_getState;
+    DecimatePairFunction m_myDecimate;                    //!< myDecimate on integer I/Q as used by Decimators
+    DecimateCenterFunction m_decimateCenter;              //!< workDecimateCenter on integer I/Q as used by Decimators
+};
+
+/**
+ * Chooses the half band filter class used at each place the tree runs half band filters.
+ * All classes compute the same filter with different code but not all with the same latency
+ * and decimation phase. calibrate() times each of them for the decimation or interpolation
+ * done at each use site on the running CPU, keeps the fastest whose output is identical to
+ * the one of the default class and saves the choice in the user
+ * configuration directory so that next runs on the same machine and build only read it back.
+ * Without calibration get() returns the class that was hard wired before: IntHalfbandFilterEO1
+ * with SSE4.1 else IntHalfbandFilterDB. The filter order is part of the use site as it sets
+ * the filter response.
+ */
+class SDRANGEL_API HBFilterSelector
+{
+public:
+    enum UseSite {
+        DownChannelizerCenter,
+        DownChannelizerLowerHalf,
+        DownChannelizerUpperHalf,
+        UpChannelizerCenter,
+        UpChannelizerLowerHalf,
+        UpChannelizerUpperHalf,
+        DecimatorsStage,
+        NbUseSites
+    };
+
+    static const HBFilterOps& get(UseSite useSite);
+    static bool isDefault(UseSite useSite); //!< true if the default class of the use site is selected
+    static void calibrate(bool force = false); //!< loads the cached choice or measures if there is none for this machine and build
+    static const char *getUseSiteName(UseSite useSite);
+    static QString getCacheFileName();
+
+private:
+    enum {
+        NbClasses = 4 //!< plain, DB, EO1 and ST
+    };
+
+    static const HBFilterOps* const *getCandidates(UseSite useSite); //!< NbClasses entries, the default class first
+    static bool load();
+    static void measure(double nsPerSample[NbUseSites][NbClasses]);
+    static void save(const double nsPerSample[NbUseSites][NbClasses]);
+    static double timeCandidate(UseSite useSite, const HBFilterOps& ops, const SampleVector& input, SampleVector& output, int nbTrials);
+    static bool isEquivalent(UseSite useSite, const HBFilterOps& ops, const SampleVector& input, const SampleVector& reference);
+    static QString getSignature();
+    static const HBFilterOps *m_selected[NbUseSites];
+};
+
+/**
+ * Half band filter of the class selected for a use site. DefaultHBFilter must be the default
+ * class of the use site. While it is selected its calls are inlined else the integer I/Q calls
+ * of Decimators are forwarded to the selected class.
+ */
+template<class DefaultHBFilter>
+class HBFilterInstance
+{
+public:
+    HBFilterInstance(HBFilterSelector::UseSite useSite) :
+        m_ops(&HBFilterSelector::get(useSite)),
+        m_filter(HBFilterSelector::isDefault(useSite) ? 0 : (*m_ops->m_create)())
+    {
+    }
+
+    ~HBFilterInstance()
+    {
+        if (m_filter) {
+            (*m_ops->m_destroy)(m_filter);
+        }
+    }
+
+    void myDecimate(qint32 x1, qint32 y1, qint32 *x2, qint32 *y2)
+    {
+        if (m_filter) {
+            (*m_ops->m_myDecimate)(m_filter, x1, y1, x2, y2);
+        } else {
+            m_default.myDecimate(x1, y1, x2, y2);
+        }
+    }
+
+    bool workDecimateCenter(qint32 *x, qint32 *y)
+    {
+        if (m_filter) {
+            return (*m_ops->m_decimateCenter)(m_filter, x, y);
+        } else {
+            return m_default.workDecimateCenter(x, y);
+        }
+    }
+
+    const HBFilterOps& getOps() const { return *m_ops; }
+
+private:
+    const HBFilterOps *m_ops;
+    void *m_filter;             //!< instance of the selected class or 0 when the default class is used
+    DefaultHBFilter m_default;
+
+    HBFilterInstance(const HBFilterInstance&);
+    HBFilterInstance& operator=(const HBFilterInstance&);
+};
+
+#endif /* SDRBASE_DSP_HBFILTERSELECTOR_H_ */
@@ -1,8 +1,15 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <algorithm>
 #include <vector>
 #include "dsp/interpolator.h"
 
+#if defined(USE_AVX2)
+#include <immintrin.h>
+#elif defined(USE_NEON)
+#include <arm_neon.h>
+#endif
+
 
 void Interpolator::createPolyphaseLowPass(
         std::vector<Real>& taps,
@@ -62,7 +69,10 @@ Interpolator::Interpolator() :
 	m_ptr(0),
 	m_taps2(0),
 	m_alignedTaps2(0),
-	m_phaseSteps(1)
+	m_phaseSteps(1),
+	m_blockTaps(0),
+	m_alignedBlockTaps(0),
+	m_nBlockTaps(4)
 {
 }
 
@@ -126,6 +136,20 @@ void Interpolator::create(int phaseSteps, double sampleRate, double cutoff, doub
 		m_alignedTaps2[2 * (i - 1) + 0] = polyphase[i];
 		m_alignedTaps2[2 * (i - 1) + 1] = polyphase[i];
 	}
+
+	// time reversed and zero padded in front for the block dot product on contiguous samples
+	m_nBlockTaps = (m_nTaps + 3) & ~3;
+	m_blockTaps = new float[2 * m_nBlockTaps * phaseSteps + 8];
+	for(int i = 0; i < 2 * m_nBlockTaps * phaseSteps + 8; ++i)
+		m_blockTaps[i] = 0;
+	m_alignedBlockTaps = (float*)((((quint64)m_blockTaps) + 31) & ~31);
+	for(int phase = 0; phase < phaseSteps; phase++) {
+		for(int i = 0; i < m_nTaps; i++) {
+			int k = m_nBlockTaps - 1 - i;
+			m_alignedBlockTaps[2 * (phase * m_nBlockTaps + k) + 0] = polyphase[phase * m_nTaps + i];
+			m_alignedBlockTaps[2 * (phase * m_nBlockTaps + k) + 1] = polyphase[phase * m_nTaps + i];
+		}
+	}
 }
 
 void Interpolator::free()
@@ -137,5 +161,142 @@ void Interpolator::free()
 		delete[] m_taps2;
 		m_taps2 = NULL;
 		m_alignedTaps2 = NULL;
+		delete[] m_blockTaps;
+		m_blockTaps = NULL;
+		m_alignedBlockTaps = NULL;
+	}
+}
+
+// Lays out the filter history from the ring buffer (oldest first) followed by the input block
+// so that each output is a dot product on contiguous samples.
+void Interpolator::loadBlock(const Complex *in, int nbIn)
+{
+	m_blockSamples.resize(m_nBlockTaps + nbIn);
+
+	for(int i = 0; i < m_nBlockTaps; i++) {
+		m_blockSamples[m_nBlockTaps - 1 - i] = i < m_nTaps ? m_samples[(m_ptr + i) % m_nTaps] : Complex(0, 0);
+	}
+
+	std::copy(in, in + nbIn, m_blockSamples.begin() + m_nBlockTaps);
+}
+
+// Puts back the most recent samples in the ring buffer so that single sample and block calls can be mixed.
+void Interpolator::storeBlock(int nbIn)
+{
+	m_ptr = 0;
+
+	for(int i = 0; i < m_nTaps; i++) {
+		m_samples[i] = m_blockSamples[m_nBlockTaps + nbIn - 1 - i];
+	}
+}
+
+// Filter output for the window of m_nBlockTaps samples starting at start.
+Complex Interpolator::blockInterpolate(int phase, int start) const
+{
+	if (phase < 0)
+		phase = 0;
+
+	const float* src = (const float*) &m_blockSamples[start];
+	const float* coeff = &m_alignedBlockTaps[2 * phase * m_nBlockTaps];
+	float r[2];
+#if defined(USE_AVX2)
+	__m256 sum = _mm256_setzero_ps();
+
+	for(int i = 0; i < m_nBlockTaps; i += 4) {
+		sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(src), _mm256_load_ps(coeff)));
+		src += 8;
+		coeff += 8;
+	}
+
+	__m128 sum4 = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+	_mm_storel_pi((__m64*) r, _mm_add_ps(sum4, _mm_movehl_ps(sum4, sum4)));
+#elif defined(USE_SSE2)
+	__m128 sum = _mm_setzero_ps();
+
+	for(int i = 0; i < m_nBlockTaps; i += 2) {
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(src), _mm_load_ps(coeff)));
+		src += 4;
+		coeff += 4;
+	}
+
+	_mm_storel_pi((__m64*) r, _mm_add_ps(sum, _mm_movehl_ps(sum, sum)));
+#elif defined(USE_NEON)
+	float32x4_t sum = vdupq_n_f32(0.0f);
+
+	for(int i = 0; i < m_nBlockTaps; i += 2) {
+		sum = vmlaq_f32(sum, vld1q_f32(src), vld1q_f32(coeff));
+		src += 4;
+		coeff += 4;
+	}
+
+	vst1_f32(r, vadd_f32(vget_low_f32(sum), vget_high_f32(sum)));
+#else
+	r[0] = 0;
+	r[1] = 0;
+
+	for(int i = 0; i < m_nBlockTaps; i++) {
+		r[0] += coeff[0] * src[0];
+		r[1] += coeff[1] * src[1];
+		src += 2;
+		coeff += 2;
+	}
+#endif
+	return Complex(r[0], r[1]);
+}
+
+int Interpolator::decimate(Real *distance, Real distanceIncrement, const Complex *in, int nbIn, Complex *out)
+{
+	int nbOut = 0;
+
+	if (nbIn <= 0)
+		return 0;
+
+	loadBlock(in, nbIn);
+
+	for(int i = 0; i < nbIn; i++)
+	{
+		*distance -= 1.0;
+
+		if (*distance < 1.0)
+		{
+			// window ends with input sample i
+			out[nbOut++] = blockInterpolate((int) floor(*distance * (Real)m_phaseSteps), i + 1);
+			*distance += distanceIncrement;
+		}
+	}
+
+	storeBlock(nbIn);
+
+	return nbOut;
+}
+
+int Interpolator::resample(Real *distance, Real distanceIncrement, const Complex *in, int nbIn, std::vector<Complex>& out)
+{
+	int nbOut = 0;
+	int consumed = 0;
+
+	if (nbIn <= 0)
+		return 0;
+
+	loadBlock(in, nbIn);
+
+	while (true)
+	{
+		while (*distance >= 1.0)
+		{
+			if (consumed == nbIn)
+			{
+				storeBlock(nbIn);
+				return nbOut;
+			}
+
+			consumed++;
+			*distance -= 1.0;
+		}
+
+		// window ends with the last consumed sample
+		out.push_back(blockInterpolate((int) floor(*distance * (Real)m_phaseSteps), consumed));
+		nbOut++;
+		*distance += distanceIncrement;
 	}
 }
@@ -4,6 +4,7 @@
 #ifdef USE_SSE2
 #include <emmintrin.h>
 #endif
+#include <vector>
 #include "dsp/dsptypes.h"
 #include "util/export.h"
 #include <stdio.h>
@@ -75,6 +76,23 @@ public:
 		return true;
 	}
 
+	/**
+	 * Block version of decimate(): runs all nbIn input samples through the filter and writes
+	 * at most nbIn output samples to out. The distance is incremented by distanceIncrement after
+	 * each output like callers of decimate() do. out can be the same buffer as in.
+	 * Returns the number of output samples.
+	 */
+	int decimate(Real *distance, Real distanceIncrement, const Complex *in, int nbIn, Complex *out);
+
+	/**
+	 * Block version of resample(): consumes all nbIn input samples and appends the output samples
+	 * to out. The distance is incremented by distanceIncrement after each output.
+	 * Returns the number of output samples.
+	 */
+	int resample(Real *distance, Real distanceIncrement, const Complex *in, int nbIn, std::vector<Complex>& out);
+
+	int getNbTaps() const { return m_nTaps; } //!< number of taps per phase set by create()
+
 private:
 	float* m_taps;
 	float* m_alignedTaps;
@@ -84,6 +102,14 @@ private:
 	int m_ptr;
 	int m_phaseSteps;
 	int m_nTaps;
+	float* m_blockTaps;              //!< time reversed taps of each phase padded to m_nBlockTaps for block processing
+	float* m_alignedBlockTaps;
+	int m_nBlockTaps;                //!< m_nTaps rounded up to a multiple of 4
+	std::vector<Complex> m_blockSamples; //!< m_nBlockTaps history samples followed by the input block
+
+	void loadBlock(const Complex *in, int nbIn);
+	void storeBlock(int nbIn);
+	Complex blockInterpolate(int phase, int start) const;
 
 	static void createPolyphaseLowPass(
 	    std::vector<Real>& taps,
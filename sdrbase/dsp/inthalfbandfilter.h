@@ -747,6 +747,9 @@ public:
         doInterpolateFIR(x2, y2);
     }
 
+    /** Position in the work* state machines. Block processing uses it to resynchronize with the my* functions */
+    int getState() const { return m_state; }
+
 protected:
 	qint32 m_samples[HBFIRFilterTraits<HBFilterOrder>::hbOrder + 1][2];     // Valgrind optim (from qint16)
 	qint16 m_ptr;
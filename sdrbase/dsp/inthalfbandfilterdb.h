@@ -618,6 +618,9 @@ public:
         doInterpolateFIR(x2, y2);
     }
 
+    /** Position in the work* state machines. Block processing uses it to resynchronize with the my* functions */
+    int getState() const { return m_state; }
+
 protected:
 	qint32 m_samplesDB[2*(HBFIRFilterTraits<HBFilterOrder>::hbOrder - 1)][2]; // double buffer technique
 	int m_ptr;
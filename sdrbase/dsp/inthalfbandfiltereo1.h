@@ -621,6 +621,9 @@ public:
         doInterpolateFIR(x2, y2);
     }
 
+    /** Position in the work* state machines. Block processing uses it to resynchronize with the my* functions */
+    int getState() const { return m_state; }
+
 protected:
     int32_t m_even[2][HBFIRFilterTraits<HBFilterOrder>::hbOrder]; // double buffer technique
     int32_t m_odd[2][HBFIRFilterTraits<HBFilterOrder>::hbOrder]; // double buffer technique
@@ -425,6 +425,9 @@ public:
         advancePointer();
     }
 
+    /** Position in the work* state machines. Block processing uses it to resynchronize with the my* functions */
+    int getState() const { return m_state; }
+
 protected:
 	int32_t m_samplesDB[2*HBFilterOrder][2]; // double buffer technique with even/odd amnd I/Q stride
 	int32_t m_samplesAligned[HBFilterOrder][2] __attribute__ ((aligned (16)));
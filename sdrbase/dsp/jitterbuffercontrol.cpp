@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QDebug>
+
+#include "dsp/jitterbuffercontrol.h"
+
+JitterBufferControl::JitterBufferControl() :
+    m_sampleRate(0),
+    m_targetLatency(0),
+    m_windowPointValid(false),
+    m_windowStartUs(0),
+    m_pointIndex(0),
+    m_driftRatio(1.0),
+    m_ratio(1.0),
+    m_driftPPM(0.0f),
+    m_latency(0.0f),
+    m_lastLatencyUs(0),
+    m_latencyValid(false)
+{
+    m_localClock.start();
+}
+
+void JitterBufferControl::reset()
+{
+    m_points.clear();
+    m_pointIndex = 0;
+    m_windowPointValid = false;
+    m_windowStartUs = m_localClock.nsecsElapsed() / 1000;
+    m_driftRatio = 1.0;
+    m_ratio = 1.0;
+    m_driftPPM = 0.0f;
+    m_latencyValid = false;
+}
+
+void JitterBufferControl::setSampleRate(int sampleRate)
+{
+    if (sampleRate != m_sampleRate)
+    {
+        m_sampleRate = sampleRate;
+        reset();
+    }
+}
+
+void JitterBufferControl::frameReceived(qint64 sampleIndex, quint32 tv_sec, quint32 tv_usec)
+{
+    ClockPoint point;
+    point.m_localUs = m_localClock.nsecsElapsed() / 1000;
+    point.m_senderUs = tv_sec * 1000000LL + tv_usec;
+    point.m_sampleIndex = sampleIndex;
+
+    // keep the frame with the smallest delay i.e. local minus sender time
+    if (!m_windowPointValid
+        || (point.m_localUs - point.m_senderUs < m_windowPoint.m_localUs - m_windowPoint.m_senderUs))
+    {
+        m_windowPoint = point;
+        m_windowPointValid = true;
+    }
+
+    if (point.m_localUs - m_windowStartUs >= windowMs * 1000LL)
+    {
+        if (m_points.size() < nbWindows) {
+            m_points.push_back(m_windowPoint);
+        } else {
+            m_points[m_pointIndex] = m_windowPoint;
+        }
+
+        m_pointIndex = (m_pointIndex + 1) % nbWindows;
+        m_windowPointValid = false;
+        m_windowStartUs = point.m_localUs;
+        estimateDrift();
+    }
+}
+
+void JitterBufferControl::estimateDrift()
+{
+    if ((m_points.size() < 3) || (m_sampleRate <= 0)) {
+        return;
+    }
+
+    // least squares slope of sample index over local time relative to the first point
+    const ClockPoint& origin = m_points[m_points.size() < nbWindows ? 0 : m_pointIndex];
+    double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+    double n = m_points.size();
+
+    for (unsigned int i = 0; i < m_points.size(); i++)
+    {
+        double x = (m_points[i].m_localUs - origin.m_localUs) * 1e-6;
+        double y = m_points[i].m_sampleIndex - origin.m_sampleIndex;
+        sx += x;
+        sy += y;
+        sxx += x*x;
+        sxy += x*y;
+    }
+
+    double d = n*sxx - sx*sx;
+
+    if (d <= 0.0) {
+        return;
+    }
+
+    double driftRatio = ((n*sxy - sx*sy) / d) / m_sampleRate;
+
+    if ((driftRatio < 1.0 - maxDriftPPM * 1e-6) || (driftRatio > 1.0 + maxDriftPPM * 1e-6))
+    {
+        qDebug("JitterBufferControl::estimateDrift: rejected drift estimate of %.0f ppm", (driftRatio - 1.0) * 1e6);
+        return;
+    }
+
+    m_driftRatio = driftRatio;
+    m_driftPPM = (driftRatio - 1.0) * 1e6;
+}
+
+void JitterBufferControl::latencyMeasured(int latencySamples)
+{
+    qint64 nowUs = m_localClock.nsecsElapsed() / 1000;
+
+    if (m_latencyValid)
+    {
+        float dt = (nowUs - m_lastLatencyUs) * 1e-3f;
+        float alpha = dt / (dt + latencyTimeConstantMs);
+        m_latency += alpha * (latencySamples - m_latency);
+    }
+    else
+    {
+        m_latency = latencySamples;
+        m_latencyValid = true;
+    }
+
+    m_lastLatencyUs = nowUs;
+
+    if (m_sampleRate <= 0) {
+        return;
+    }
+
+    // read faster when more than the target is buffered
+    double correction = ((m_latency - m_targetLatency) / m_sampleRate) / correctionTimeConstantS;
+    double maxCorrection = maxCorrectionPPM * 1e-6;
+    correction = correction < -maxCorrection ? -maxCorrection : correction > maxCorrection ? maxCorrection : correction;
+    m_ratio = m_driftRatio * (1.0 + correction);
+}
@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_JITTERBUFFERCONTROL_H_
+#define SDRBASE_DSP_JITTERBUFFERCONTROL_H_
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <vector>
+
+#include "util/export.h"
+
+/**
+ * Controls the read side of a buffer receiving a sample stream from a remote sender so that it
+ * holds a target latency despite the drift between the sender and local clocks. It gives the
+ * ratio of input samples to consume per output sample at the nominal sample rate which is meant
+ * to drive a DriftResampler.
+ *
+ * The rate of the stream in local time is estimated from the frames timestamps given by the
+ * sender. For each frame the index of its first sample, the sender timestamp and the local
+ * arrival time are recorded. Within each estimation window the frame with the smallest arrival
+ * delay relative to the sender clock is kept, as it is the least affected by network and
+ * processing jitter, and the rate is the least squares slope of the sample index over local time
+ * of these frames. A proportional correction on the measured latency brings the buffer back to
+ * the target latency. It is bounded so that the resampling stays inaudible.
+ */
+class SDRANGEL_API JitterBufferControl
+{
+public:
+    JitterBufferControl();
+
+    void reset();                                  //!< restarts the clock estimation e.g. on a stream discontinuity
+    void setSampleRate(int sampleRate);            //!< nominal sample rate. Restarts the clock estimation on change
+    void setTargetLatency(int targetLatencySamples) { m_targetLatency = targetLatencySamples; }
+    int getTargetLatency() const { return m_targetLatency; }
+
+    /** Records a frame received from the sender with the index in the stream of its first sample */
+    void frameReceived(qint64 sampleIndex, quint32 tv_sec, quint32 tv_usec);
+    /** Updates the ratio with a measurement of the samples held in the buffer */
+    void latencyMeasured(int latencySamples);
+
+    double getRatio() const { return m_ratio; }      //!< input samples to consume per output sample
+    float getDriftPPM() const { return m_driftPPM; } //!< estimated stream clock drift in ppm
+    float getLatency() const { return m_latency; }   //!< smoothed latency in samples
+
+    static const int maxDriftPPM = 1000;      //!< estimates beyond are rejected
+    static const int maxCorrectionPPM = 1000; //!< limit of the latency correction
+
+private:
+    struct ClockPoint
+    {
+        qint64 m_localUs;
+        qint64 m_senderUs;
+        qint64 m_sampleIndex;
+    };
+
+    QElapsedTimer m_localClock;
+    int m_sampleRate;
+    int m_targetLatency;
+    ClockPoint m_windowPoint;       //!< frame with the smallest delay in the current window
+    bool m_windowPointValid;
+    qint64 m_windowStartUs;
+    std::vector<ClockPoint> m_points; //!< best frames of the last windows
+    unsigned int m_pointIndex;
+    double m_driftRatio;            //!< estimated stream rate over nominal sample rate
+    double m_ratio;
+    float m_driftPPM;
+    float m_latency;
+    qint64 m_lastLatencyUs;
+    bool m_latencyValid;
+
+    void estimateDrift();
+
+    static const int windowMs = 2000;        //!< estimation window length
+    static const unsigned int nbWindows = 30;
+    static const int latencyTimeConstantMs = 1000;
+    static const int correctionTimeConstantS = 20; //!< a latency error of this duration gives a correction of 1
+};
+
+#endif /* SDRBASE_DSP_JITTERBUFFERCONTROL_H_ */
@@ -20,6 +20,7 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include "dsp/nco.h"
+#include "dsp/ncomixer.h"
 
 Real NCO::m_table[NCO::TableSize];
 bool NCO::m_tableInitialized = false;
@@ -102,3 +103,27 @@ void NCO::getQI(Complex& c)
 	c.imag(m_table[m_phase]);
 	c.real(-m_table[(m_phase + TableSize / 4) % TableSize]);
 }
+
+void NCO::mixIQ(const Sample *in, Complex *out, unsigned int nbSamples, Real scale)
+{
+	Complex phasors[NCOMixer::NbLanes];
+	int stepPhase = (NCOMixer::NbLanes * m_phaseIncrement) & (TableSize - 1);
+	Complex step(m_table[stepPhase], -m_table[(stepPhase + TableSize / 4) % TableSize]);
+	unsigned int i = 0;
+
+	while (i < nbSamples)
+	{
+		unsigned int n = nbSamples - i < (unsigned int) NCOMixer::BlockSize ? nbSamples - i : (unsigned int) NCOMixer::BlockSize;
+
+		// seed the phasors from the table
+		for (int k = 0; k < NCOMixer::NbLanes; k++)
+		{
+			int phase = (m_phase + (k + 1) * m_phaseIncrement) & (TableSize - 1);
+			phasors[k] = Complex(m_table[phase], -m_table[(phase + TableSize / 4) % TableSize]) * scale;
+		}
+
+		NCOMixer::mix(&in[i], &out[i], n, phasors, step);
+		m_phase = (m_phase + (int) n * m_phaseIncrement) & (TableSize - 1);
+		i += n;
+	}
+}
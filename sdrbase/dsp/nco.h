@@ -18,6 +18,7 @@
 #ifndef INCLUDE_NCO_H
 #define INCLUDE_NCO_H
 
+#include <vector>
 #include "dsp/dsptypes.h"
 #include "util/export.h"
 
@@ -58,6 +59,16 @@ public:
 	void getIQ(Complex& c); //!< Sets to the current complex sample (no phase increment)
 	Complex getQI();        //!< Return current complex sample (no phase increment, reversed)
 	void getQI(Complex& c); //!< Sets to the current complex sample (no phase increment, reversed)
+	/** Mixes a block of samples: out[i] = scale * in[i] * nextIQ(). Advances the phase by nbSamples */
+	void mixIQ(const Sample *in, Complex *out, unsigned int nbSamples, Real scale = 1.0f);
+	/** Mixes the samples from begin to end into out resized to fit */
+	void mixIQ(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, std::vector<Complex>& out, Real scale = 1.0f)
+	{
+		out.resize(end - begin);
+		if (begin != end) {
+			mixIQ(&(*begin), out.data(), out.size(), scale);
+		}
+	}
 };
 
 #endif // INCLUDE_NCO_H
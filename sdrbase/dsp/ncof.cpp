@@ -19,6 +19,7 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include "dsp/ncof.h"
+#include "dsp/ncomixer.h"
 
 Real NCOF::m_table[NCOF::TableSize];
 bool NCOF::m_tableInitialized = false;
@@ -90,3 +91,32 @@ void NCOF::getQI(Complex& c)
 	c.imag(m_table[(int) m_phase]);
 	c.real(-m_table[((int) m_phase + TableSize / 4) % TableSize]);
 }
+
+void NCOF::mixIQ(const Sample *in, Complex *out, unsigned int nbSamples, Real scale)
+{
+	Complex phasors[NCOMixer::NbLanes];
+	double radPerStep = (2.0 * M_PI) / TableSize;
+	Complex step(cos(NCOMixer::NbLanes * m_phaseIncrement * radPerStep), sin(NCOMixer::NbLanes * m_phaseIncrement * radPerStep));
+	unsigned int i = 0;
+
+	while (i < nbSamples)
+	{
+		unsigned int n = nbSamples - i < (unsigned int) NCOMixer::BlockSize ? nbSamples - i : (unsigned int) NCOMixer::BlockSize;
+
+		// seed the phasors from the exact phase
+		for (int k = 0; k < NCOMixer::NbLanes; k++)
+		{
+			double phase = (m_phase + (k + 1) * m_phaseIncrement) * radPerStep;
+			phasors[k] = Complex(cos(phase) * scale, sin(phase) * scale);
+		}
+
+		NCOMixer::mix(&in[i], &out[i], n, phasors, step);
+		m_phase = fmod(m_phase + n * m_phaseIncrement, (Real) TableSize);
+
+		if (m_phase < 0) {
+			m_phase += TableSize;
+		}
+
+		i += n;
+	}
+}
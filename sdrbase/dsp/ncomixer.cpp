@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsp/ncomixer.h"
+
+#if defined(USE_SSE2)
+#include <emmintrin.h>
+#elif defined(USE_NEON)
+#include <arm_neon.h>
+#endif
+
+void NCOMixer::mix(const Sample *in, Complex *out, unsigned int nbSamples, const Complex *phasors, const Complex& step)
+{
+    unsigned int i = 0;
+    const qint16 *x = (const qint16 *) in;
+    float *y = (float *) out;
+    float pr[NbLanes], pi[NbLanes];
+
+    for (int k = 0; k < NbLanes; k++)
+    {
+        pr[k] = phasors[k].real();
+        pi[k] = phasors[k].imag();
+    }
+
+#if defined(USE_SSE2)
+    __m128 vpr = _mm_loadu_ps(pr);
+    __m128 vpi = _mm_loadu_ps(pi);
+    __m128 sr = _mm_set1_ps(step.real());
+    __m128 si = _mm_set1_ps(step.imag());
+
+    for (; i + NbLanes <= nbSamples; i += NbLanes)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) &x[2*i]);
+        __m128 lo = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16)); // r0 i0 r1 i1
+        __m128 hi = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16)); // r2 i2 r3 i3
+        __m128 xr = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+        __m128 xi = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+        __m128 yr = _mm_sub_ps(_mm_mul_ps(xr, vpr), _mm_mul_ps(xi, vpi));
+        __m128 yi = _mm_add_ps(_mm_mul_ps(xr, vpi), _mm_mul_ps(xi, vpr));
+        _mm_storeu_ps(&y[2*i], _mm_unpacklo_ps(yr, yi));
+        _mm_storeu_ps(&y[2*i + 4], _mm_unpackhi_ps(yr, yi));
+        __m128 npr = _mm_sub_ps(_mm_mul_ps(vpr, sr), _mm_mul_ps(vpi, si));
+        vpi = _mm_add_ps(_mm_mul_ps(vpr, si), _mm_mul_ps(vpi, sr));
+        vpr = npr;
+    }
+
+    _mm_storeu_ps(pr, vpr);
+    _mm_storeu_ps(pi, vpi);
+#elif defined(USE_NEON)
+    float32x4_t vpr = vld1q_f32(pr);
+    float32x4_t vpi = vld1q_f32(pi);
+    float32x4_t sr = vdupq_n_f32(step.real());
+    float32x4_t si = vdupq_n_f32(step.imag());
+
+    for (; i + NbLanes <= nbSamples; i += NbLanes)
+    {
+        int16x4x2_t v = vld2_s16(&x[2*i]); // deinterleaved real and imaginary parts
+        float32x4_t xr = vcvtq_f32_s32(vmovl_s16(v.val[0]));
+        float32x4_t xi = vcvtq_f32_s32(vmovl_s16(v.val[1]));
+        float32x4x2_t w;
+        w.val[0] = vmlsq_f32(vmulq_f32(xr, vpr), xi, vpi);
+        w.val[1] = vmlaq_f32(vmulq_f32(xr, vpi), xi, vpr);
+        vst2q_f32(&y[2*i], w);
+        float32x4_t npr = vmlsq_f32(vmulq_f32(vpr, sr), vpi, si);
+        vpi = vmlaq_f32(vmulq_f32(vpr, si), vpi, sr);
+        vpr = npr;
+    }
+
+    vst1q_f32(pr, vpr);
+    vst1q_f32(pi, vpi);
+#else
+    for (; i + NbLanes <= nbSamples; i += NbLanes)
+    {
+        for (int k = 0; k < NbLanes; k++)
+        {
+            float xr = x[2*(i+k)];
+            float xi = x[2*(i+k) + 1];
+            y[2*(i+k)] = xr * pr[k] - xi * pi[k];
+            y[2*(i+k) + 1] = xr * pi[k] + xi * pr[k];
+            float npr = pr[k] * step.real() - pi[k] * step.imag();
+            pi[k] = pr[k] * step.imag() + pi[k] * step.real();
+            pr[k] = npr;
+        }
+    }
+#endif
+
+    for (int k = 0; i < nbSamples; i++, k++)
+    {
+        float xr = x[2*i];
+        float xi = x[2*i + 1];
+        y[2*i] = xr * pr[k] - xi * pi[k];
+        y[2*i + 1] = xr * pi[k] + xi * pr[k];
+    }
+}
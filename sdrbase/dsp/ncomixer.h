@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_NCOMIXER_H_
+#define SDRBASE_DSP_NCOMIXER_H_
+
+#include "dsp/dsptypes.h"
+#include "util/export.h"
+
+/**
+ * Block mixing kernel of the NCO and NCOF classes. Instead of one table lookup per sample
+ * four interleaved phasors are rotated by four phase increments at each step (phase rotator
+ * recurrence) and the products are vectorized with SSE2 or NEON when the build defines
+ * USE_SSE2 or USE_NEON. The caller seeds the phasors from the exact phase at most every
+ * BlockSize samples which renormalizes them before the rotation error grows: the error
+ * relative to the exact product stays below 1e-6 over a block.
+ */
+class SDRANGEL_API NCOMixer
+{
+public:
+    enum {
+        NbLanes = 4,    //!< number of interleaved phasors
+        BlockSize = 64  //!< maximum number of samples mixed from one seed
+    };
+
+    /**
+     * out[i] = in[i] * phasors[i % NbLanes] * step^(i / NbLanes) for i < nbSamples <= BlockSize.
+     * Phasors are the values of the oscillator at the first NbLanes samples (with any scale
+     * factor applied) and step is the unity phasor of NbLanes phase increments.
+     */
+    static void mix(const Sample *in, Complex *out, unsigned int nbSamples, const Complex *phasors, const Complex& step);
+};
+
+#endif /* SDRBASE_DSP_NCOMIXER_H_ */
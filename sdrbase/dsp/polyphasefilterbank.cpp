@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <algorithm>
+
+#include "dsp/fftengine.h"
+#include "dsp/polyphasefilterbank.h"
+
+PolyphaseFilterBank::PolyphaseFilterBank() :
+    m_nbChannels(0),
+    m_nbTaps(0),
+    m_ptr(0),
+    m_hopCount(0),
+    m_oddHop(false),
+    m_fft(0)
+{
+}
+
+PolyphaseFilterBank::~PolyphaseFilterBank()
+{
+    if (m_fft) {
+        delete m_fft;
+    }
+}
+
+void PolyphaseFilterBank::configure(int log2NbChannels, int nbTapsPerBranch)
+{
+    m_nbChannels = 1<<log2NbChannels;
+    m_nbTaps = m_nbChannels * nbTapsPerBranch;
+
+    createPrototype();
+
+    m_samples.assign(2*m_nbTaps, Complex(0.0, 0.0));
+    m_ptr = 0;
+    m_hopCount = 0;
+    m_oddHop = false;
+
+    if (m_fft == 0) {
+        m_fft = FFTEngine::create();
+    }
+
+    m_fft->configure(m_nbChannels, true);
+
+    m_channelActive.assign(m_nbChannels, false);
+    m_activeChannels.clear();
+    m_channelSamples.assign(m_nbChannels, SampleVector());
+}
+
+void PolyphaseFilterBank::createPrototype()
+{
+    // Blackman windowed sinc with -6dB cutoff at 3/4 of the channel spacing.
+    // The transition band of about 5.5/L spans from Fs/(2M) to Fs/M.
+    double fc = 0.75 / m_nbChannels;
+    double sum = 0.0;
+    m_taps.resize(m_nbTaps);
+
+    for (int i = 0; i < m_nbTaps; i++)
+    {
+        double x = i - (m_nbTaps - 1) / 2.0;
+        double sinc = (x == 0.0) ? 2.0 * fc : sin(2.0 * M_PI * fc * x) / (M_PI * x);
+        double window = 0.42 - 0.5 * cos((2.0 * M_PI * i) / (m_nbTaps - 1)) + 0.08 * cos((4.0 * M_PI * i) / (m_nbTaps - 1));
+        m_taps[i] = sinc * window;
+        sum += m_taps[i];
+    }
+
+    for (int i = 0; i < m_nbTaps; i++) {
+        m_taps[i] /= sum; // unity gain at DC
+    }
+}
+
+void PolyphaseFilterBank::setChannelActive(int channel, bool active)
+{
+    if ((channel < 0) || (channel >= m_nbChannels) || (m_channelActive[channel] == active)) {
+        return;
+    }
+
+    m_channelActive[channel] = active;
+
+    if (active) {
+        m_activeChannels.push_back(channel);
+    } else {
+        m_activeChannels.erase(std::remove(m_activeChannels.begin(), m_activeChannels.end(), channel), m_activeChannels.end());
+    }
+
+    m_channelSamples[channel].clear();
+}
+
+void PolyphaseFilterBank::clearChannelSamples()
+{
+    for (std::vector<int>::const_iterator it = m_activeChannels.begin(); it != m_activeChannels.end(); ++it) {
+        m_channelSamples[*it].clear();
+    }
+}
+
+void PolyphaseFilterBank::feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end)
+{
+    int decimation = m_nbChannels / 2;
+
+    for (SampleVector::const_iterator it = begin; it != end; ++it)
+    {
+        Complex c(it->real(), it->imag());
+        m_samples[m_ptr] = c;
+        m_samples[m_ptr + m_nbTaps] = c;
+        m_ptr = m_ptr < m_nbTaps - 1 ? m_ptr + 1 : 0;
+
+        if (++m_hopCount == decimation)
+        {
+            runFFT();
+            m_hopCount = 0;
+        }
+    }
+}
+
+void PolyphaseFilterBank::runFFT()
+{
+    // the newest sample is at m_ptr + m_nbTaps - 1 so x[n-l] is w[m_nbTaps - 1 - l]
+    const Complex *w = &m_samples[m_ptr];
+    Complex *in = m_fft->in();
+
+    // fold the filtered history into the M polyphase branches
+    for (int m = 0; m < m_nbChannels; m++)
+    {
+        Complex acc(0.0, 0.0);
+
+        for (int l = m; l < m_nbTaps; l += m_nbChannels) {
+            acc += m_taps[l] * w[m_nbTaps - 1 - l];
+        }
+
+        in[m] = acc;
+    }
+
+    m_fft->transform();
+
+    // channel k has to be brought back to baseband by exp(-j*2*pi*k*n/M) with n advancing by M/2
+    // between FFTs. This is a sign change on odd channels every other FFT.
+    const Complex *out = m_fft->out();
+
+    for (std::vector<int>::const_iterator it = m_activeChannels.begin(); it != m_activeChannels.end(); ++it)
+    {
+        Complex y = (m_oddHop && (*it % 2 == 1)) ? -out[*it] : out[*it];
+        Real re = y.real() < 0 ? y.real() - 0.5f : y.real() + 0.5f;
+        Real im = y.imag() < 0 ? y.imag() - 0.5f : y.imag() + 0.5f;
+        re = re < -32768.0f ? -32768.0f : re > 32767.0f ? 32767.0f : re;
+        im = im < -32768.0f ? -32768.0f : im > 32767.0f ? 32767.0f : im;
+        m_channelSamples[*it].push_back(Sample((FixReal) re, (FixReal) im));
+    }
+
+    m_oddHop = !m_oddHop;
+}
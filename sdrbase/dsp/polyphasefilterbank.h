@@ -0,0 +1,72 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_POLYPHASEFILTERBANK_H_
+#define SDRBASE_DSP_POLYPHASEFILTERBANK_H_
+
+#include <vector>
+#include "dsp/dsptypes.h"
+#include "util/export.h"
+
+class FFTEngine;
+
+/**
+ * Polyphase FFT analysis filter bank.
+ *
+ * Splits the input in M channels spaced by Fs/M. Channel k is centered at k*Fs/M for k < M/2
+ * and at (k-M)*Fs/M for k >= M/2. The bank is 2x oversampled: a new FFT is run every M/2 input
+ * samples so each channel is output at 2*Fs/M. The prototype low pass passband is flat over
+ * +/- Fs/(2M) and its stopband starts just below Fs/M so that the output is not aliased.
+ * Only the channels marked active are converted back to samples.
+ */
+class SDRANGEL_API PolyphaseFilterBank
+{
+public:
+    PolyphaseFilterBank();
+    ~PolyphaseFilterBank();
+
+    void configure(int log2NbChannels, int nbTapsPerBranch = 12);
+    int getNbChannels() const { return m_nbChannels; }
+    int getDecimation() const { return m_nbChannels / 2; }
+
+    void setChannelActive(int channel, bool active);
+    bool isChannelActive(int channel) const { return m_channelActive[channel]; }
+    bool hasActiveChannels() const { return m_activeChannels.size() > 0; }
+
+    /** Run the bank over the samples. Outputs are appended to the active channels sample vectors */
+    void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end);
+    const SampleVector& getChannelSamples(int channel) const { return m_channelSamples[channel]; }
+    void clearChannelSamples();
+
+private:
+    int m_nbChannels;
+    int m_nbTaps;
+    std::vector<Real> m_taps;              //!< prototype low pass filter
+    std::vector<Complex> m_samples;        //!< double buffered input history
+    int m_ptr;                             //!< next write position in history
+    int m_hopCount;                        //!< samples received since last FFT
+    bool m_oddHop;                         //!< parity of the FFT index for the channel phase correction
+    FFTEngine *m_fft;
+    std::vector<bool> m_channelActive;
+    std::vector<int> m_activeChannels;
+    std::vector<SampleVector> m_channelSamples;
+
+    void createPrototype();
+    void runFFT();
+};
+
+#endif /* SDRBASE_DSP_POLYPHASEFILTERBANK_H_ */
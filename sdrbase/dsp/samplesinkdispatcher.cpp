@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QThread>
+#include <QDebug>
+
+#include "dsp/basebandsamplesink.h"
+#include "dsp/threadedbasebandsamplesink.h"
+#include "dsp/samplesinkdispatcher.h"
+
+SampleSinkDispatcher::SampleSinkDispatcher() :
+    m_nextJob(0),
+    m_refCount(0),
+    m_released(0),
+    m_positiveOnly(false)
+{
+    // the calling thread takes its share of the work
+    int nbWorkers = QThread::idealThreadCount() - 1;
+    nbWorkers = nbWorkers < 1 ? 1 : nbWorkers;
+    m_threadPool.setMaxThreadCount(nbWorkers);
+    m_threadPool.setExpiryTimeout(-1); // keep threads around between blocks
+
+    for (int i = 0; i < nbWorkers; i++) {
+        m_workers.push_back(new Worker(this));
+    }
+
+    qDebug("SampleSinkDispatcher::SampleSinkDispatcher: %d worker threads", nbWorkers);
+}
+
+SampleSinkDispatcher::~SampleSinkDispatcher()
+{
+    m_threadPool.waitForDone();
+
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it) {
+        delete *it;
+    }
+}
+
+void SampleSinkDispatcher::clear()
+{
+    m_jobs.clear();
+    m_threadedJobs.clear();
+}
+
+void SampleSinkDispatcher::addSink(BasebandSampleSink *sink,
+        const SampleVector::const_iterator& part1Begin,
+        const SampleVector::const_iterator& part1End,
+        const SampleVector::const_iterator& part2Begin,
+        const SampleVector::const_iterator& part2End)
+{
+    Job job;
+    job.m_sink = sink;
+    job.m_part1Begin = part1Begin;
+    job.m_part1End = part1End;
+    job.m_part2Begin = part2Begin;
+    job.m_part2End = part2End;
+    m_jobs.push_back(job);
+}
+
+void SampleSinkDispatcher::addThreadedSink(ThreadedBasebandSampleSink *sink,
+        const SampleVector::const_iterator& part1Begin,
+        const SampleVector::const_iterator& part1End,
+        const SampleVector::const_iterator& part2Begin,
+        const SampleVector::const_iterator& part2End)
+{
+    ThreadedJob job;
+    job.m_sink = sink;
+    job.m_blockRef.m_part1Begin = part1Begin;
+    job.m_blockRef.m_part1End = part1End;
+    job.m_blockRef.m_part2Begin = part2Begin;
+    job.m_blockRef.m_part2End = part2End;
+    job.m_blockRef.m_positiveOnly = false;
+    job.m_blockRef.m_dispatcher = this;
+    m_threadedJobs.push_back(job);
+}
+
+void SampleSinkDispatcher::dispatch(bool positiveOnly)
+{
+    int nbJobs = m_jobs.size();
+    int nbThreadedJobs = m_threadedJobs.size();
+
+    if (nbJobs + nbThreadedJobs == 0) {
+        return;
+    }
+
+    // no need to wake up more workers than there are sinks left for them
+    int nbWorkers = nbJobs - 1 < (int) m_workers.size() ? nbJobs - 1 : m_workers.size();
+    nbWorkers = nbWorkers < 0 ? 0 : nbWorkers;
+
+    m_positiveOnly = positiveOnly;
+    m_nextJob.store(0);
+    // workers hold a reference too so that none of them is still looking at the job list when we return
+    m_refCount.store(nbJobs + nbThreadedJobs + nbWorkers);
+
+    // threaded sinks start first as their threads run for the whole block duration
+    for (std::vector<ThreadedJob>::iterator it = m_threadedJobs.begin(); it != m_threadedJobs.end(); ++it)
+    {
+        it->m_blockRef.m_positiveOnly = positiveOnly;
+        it->m_sink->feed(it->m_blockRef);
+    }
+
+    for (int i = 0; i < nbWorkers; i++) {
+        m_threadPool.start(m_workers[i]);
+    }
+
+    work();
+    m_released.acquire();
+}
+
+void SampleSinkDispatcher::work()
+{
+    int nbJobs = m_jobs.size();
+    int i;
+
+    while ((i = m_nextJob.fetchAndAddOrdered(1)) < nbJobs)
+    {
+        Job& job = m_jobs[i];
+
+        if (job.m_part1Begin != job.m_part1End) {
+            job.m_sink->feed(job.m_part1Begin, job.m_part1End, m_positiveOnly);
+        }
+
+        if (job.m_part2Begin != job.m_part2End) {
+            job.m_sink->feed(job.m_part2Begin, job.m_part2End, m_positiveOnly);
+        }
+
+        release(); // this sink is done with the block
+    }
+}
+
+void SampleSinkDispatcher::release()
+{
+    if (m_refCount.fetchAndAddOrdered(-1) == 1) {
+        m_released.release();
+    }
+}
+
+void SampleSinkDispatcher::Worker::run()
+{
+    m_dispatcher->work();
+    m_dispatcher->release();
+}
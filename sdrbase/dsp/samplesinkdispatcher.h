@@ -0,0 +1,118 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_SAMPLESINKDISPATCHER_H_
+#define SDRBASE_DSP_SAMPLESINKDISPATCHER_H_
+
+#include <vector>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include "dsp/dsptypes.h"
+#include "util/export.h"
+
+class BasebandSampleSink;
+class ThreadedBasebandSampleSink;
+
+/**
+ * Feeds one block of samples to several sinks in parallel.
+ *
+ * The block is shared read-only between all sinks and is reference counted: each sink holds it
+ * while it is being fed and dispatch() returns once the last holder has released it so the
+ * caller can then commit its FIFO. Direct sinks are fed over a fixed pool of worker threads and
+ * are picked dynamically from a common job index so an idle worker takes the next pending sink
+ * while slower sinks are still running. The calling thread works on the block too. Threaded sinks
+ * are handed a reference to the block that their own thread feeds to the sink and releases so
+ * they do not take a copy of the samples. A sink is fed from one thread only per block and
+ * blocks are dispatched one after the other so each sink still receives samples in order.
+ */
+class SDRANGEL_API SampleSinkDispatcher
+{
+public:
+    /** Reference to the block held by a threaded sink until its thread has been fed with it */
+    struct BlockRef
+    {
+        SampleVector::const_iterator m_part1Begin;
+        SampleVector::const_iterator m_part1End;
+        SampleVector::const_iterator m_part2Begin;
+        SampleVector::const_iterator m_part2End;
+        bool m_positiveOnly;
+        SampleSinkDispatcher *m_dispatcher;
+
+        void release() { m_dispatcher->release(); }
+    };
+
+    SampleSinkDispatcher();
+    ~SampleSinkDispatcher();
+
+    void clear(); //!< start a new block
+    /** Add a sink to the block with the two parts of the FIFO data it must be fed with */
+    void addSink(BasebandSampleSink *sink,
+            const SampleVector::const_iterator& part1Begin,
+            const SampleVector::const_iterator& part1End,
+            const SampleVector::const_iterator& part2Begin,
+            const SampleVector::const_iterator& part2End);
+    /** Add a sink running on its own thread that will be handed a reference to the block */
+    void addThreadedSink(ThreadedBasebandSampleSink *sink,
+            const SampleVector::const_iterator& part1Begin,
+            const SampleVector::const_iterator& part1End,
+            const SampleVector::const_iterator& part2Begin,
+            const SampleVector::const_iterator& part2End);
+    void dispatch(bool positiveOnly); //!< returns when all sinks have released the block
+    int getNbThreads() const { return m_workers.size() + 1; }
+
+private:
+    struct Job
+    {
+        BasebandSampleSink *m_sink;
+        SampleVector::const_iterator m_part1Begin;
+        SampleVector::const_iterator m_part1End;
+        SampleVector::const_iterator m_part2Begin;
+        SampleVector::const_iterator m_part2End;
+    };
+
+    class Worker : public QRunnable
+    {
+    public:
+        Worker(SampleSinkDispatcher *dispatcher) : m_dispatcher(dispatcher) { setAutoDelete(false); }
+        virtual void run();
+    private:
+        SampleSinkDispatcher *m_dispatcher;
+    };
+
+    struct ThreadedJob
+    {
+        ThreadedBasebandSampleSink *m_sink;
+        BlockRef m_blockRef;
+    };
+
+    std::vector<Job> m_jobs;
+    std::vector<ThreadedJob> m_threadedJobs;
+    std::vector<Worker*> m_workers;
+    QThreadPool m_threadPool;
+    QAtomicInt m_nextJob;  //!< index of the next sink to be fed
+    QAtomicInt m_refCount; //!< pending sinks, threaded sinks and running workers holding the block
+    QSemaphore m_released; //!< signaled when the block reference count drops to zero
+    bool m_positiveOnly;
+
+    void work();
+    void release();
+};
+
+#endif /* SDRBASE_DSP_SAMPLESINKDISPATCHER_H_ */
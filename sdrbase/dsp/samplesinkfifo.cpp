@@ -22,41 +22,49 @@
 void SampleSinkFifo::create(uint s)
 {
 	m_size = 0;
-	m_fill = 0;
-	m_head = 0;
-	m_tail = 0;
+	m_head.store(0);
+	m_tail.store(0);
 
 	m_data.resize(s);
 	m_size = m_data.size();
 
 	if(m_size != s)
 		qCritical("SampleSinkFifo: out of memory");
+
+	resetStats();
 }
 
 SampleSinkFifo::SampleSinkFifo(QObject* parent) :
 	QObject(parent),
-	m_data()
+	m_data(),
+	m_size(0),
+	m_tail(0),
+	m_nbOverflows(0),
+	m_nbDroppedSamples(0),
+	m_maxFill(0),
+	m_suppressed(-1),
+	m_head(0),
+	m_nbUnderflows(0)
 {
-	m_suppressed = -1;
-	m_size = 0;
-	m_fill = 0;
-	m_head = 0;
-	m_tail = 0;
 }
 
 SampleSinkFifo::SampleSinkFifo(int size, QObject* parent) :
 	QObject(parent),
-	m_data()
+	m_data(),
+	m_size(0),
+	m_tail(0),
+	m_nbOverflows(0),
+	m_nbDroppedSamples(0),
+	m_maxFill(0),
+	m_suppressed(-1),
+	m_head(0),
+	m_nbUnderflows(0)
 {
-	m_suppressed = -1;
-
 	create(size);
 }
 
 SampleSinkFifo::~SampleSinkFifo()
 {
-	QMutexLocker mutexLocker(&m_mutex);
-
 	m_size = 0;
 }
 
@@ -67,59 +75,42 @@ bool SampleSinkFifo::setSize(int size)
 	return m_data.size() == (uint)size;
 }
 
-uint SampleSinkFifo::write(const quint8* data, uint count)
+void SampleSinkFifo::resetStats()
 {
-	QMutexLocker mutexLocker(&m_mutex);
-	uint total;
-	uint remaining;
-	uint len;
-	const Sample* begin = (const Sample*)data;
-	count /= 4;
+	m_nbOverflows.store(0);
+	m_nbDroppedSamples.store(0);
+	m_maxFill.store(0);
+	m_nbUnderflows.store(0);
+	m_suppressed = -1;
+}
 
-	total = MIN(count, m_size - m_fill);
-	if(total < count) {
-		if(m_suppressed < 0) {
-			m_suppressed = 0;
-			m_msgRateTimer.start();
-			qCritical("SampleSinkFifo: overflow - dropping %u samples", count - total);
-		} else {
-			if(m_msgRateTimer.elapsed() > 2500) {
-				qCritical("SampleSinkFifo: %u messages dropped", m_suppressed);
-				qCritical("SampleSinkFifo: overflow - dropping %u samples", count - total);
-				m_suppressed = -1;
-			} else {
-				m_suppressed++;
-			}
-		}
-	}
+uint SampleSinkFifo::write(const quint8* data, uint count)
+{
+	return writeSamples((const Sample*) data, count / 4);
+}
 
-	remaining = total;
-	while(remaining > 0) {
-		len = MIN(remaining, m_size - m_tail);
-		std::copy(begin, begin + len, m_data.begin() + m_tail);
-		m_tail += len;
-		m_tail %= m_size;
-		m_fill += len;
-		begin += len;
-		remaining -= len;
+uint SampleSinkFifo::write(SampleVector::const_iterator begin, SampleVector::const_iterator end)
+{
+	if (begin == end) {
+		return 0;
 	}
 
-	if(m_fill > 0)
-		emit dataReady();
-
-	return total;
+	return writeSamples(&(*begin), end - begin);
 }
 
-uint SampleSinkFifo::write(SampleVector::const_iterator begin, SampleVector::const_iterator end)
+uint SampleSinkFifo::writeSamples(const Sample* begin, uint count)
 {
-	QMutexLocker mutexLocker(&m_mutex);
-	uint count = end - begin;
-	uint total;
+	uint tail = m_tail.load(); // only this side writes it
+	uint fill = distance(m_head.loadAcquire(), tail);
+	uint total = MIN(count, m_size - fill);
 	uint remaining;
 	uint len;
 
-	total = MIN(count, m_size - m_fill);
-	if(total < count) {
+	if (total < count)
+	{
+		m_nbOverflows.fetchAndAddRelaxed(1);
+		m_nbDroppedSamples.fetchAndAddRelaxed(count - total);
+
 		if(m_suppressed < 0) {
 			m_suppressed = 0;
 			m_msgRateTimer.start();
@@ -127,7 +118,8 @@ uint SampleSinkFifo::write(SampleVector::const_iterator begin, SampleVector::con
 		} else {
 			if(m_msgRateTimer.elapsed() > 2500) {
 				qCritical("SampleSinkFifo: %u messages dropped", m_suppressed);
-				qCritical("SampleSinkFifo: overflow - dropping %u samples", count - total);
+				qCritical("SampleSinkFifo: overflow - dropping %u samples (%u overflows %u samples dropped since reset)",
+					count - total, getNbOverflows(), getNbDroppedSamples());
 				m_suppressed = -1;
 			} else {
 				m_suppressed++;
@@ -136,17 +128,24 @@ uint SampleSinkFifo::write(SampleVector::const_iterator begin, SampleVector::con
 	}
 
 	remaining = total;
-	while(remaining > 0) {
-		len = MIN(remaining, m_size - m_tail);
-		std::copy(begin, begin + len, m_data.begin() + m_tail);
-		m_tail += len;
-		m_tail %= m_size;
-		m_fill += len;
+
+	while (remaining > 0)
+	{
+		uint i = index(tail);
+		len = MIN(remaining, m_size - i);
+		std::copy(begin, begin + len, m_data.begin() + i);
+		tail = advance(tail, len);
 		begin += len;
 		remaining -= len;
 	}
 
-	if(m_fill > 0)
+	m_tail.storeRelease(tail); // publish the samples to the consumer
+
+	if (fill + total > (uint) m_maxFill.load()) {
+		m_maxFill.store(fill + total);
+	}
+
+	if (fill + total > 0)
 		emit dataReady();
 
 	return total;
@@ -154,27 +153,33 @@ uint SampleSinkFifo::write(SampleVector::const_iterator begin, SampleVector::con
 
 uint SampleSinkFifo::read(SampleVector::iterator begin, SampleVector::iterator end)
 {
-	QMutexLocker mutexLocker(&m_mutex);
+	uint head = m_head.load(); // only this side writes it
+	uint fill = distance(head, m_tail.loadAcquire());
 	uint count = end - begin;
 	uint total;
 	uint remaining;
 	uint len;
 
-	total = MIN(count, m_fill);
-	if(total < count)
-		qCritical("SampleSinkFifo: underflow - missing %u samples", count - total);
+	total = MIN(count, fill);
+
+	if (total < count) {
+		m_nbUnderflows.fetchAndAddRelaxed(1);
+	}
 
 	remaining = total;
-	while(remaining > 0) {
-		len = MIN(remaining, m_size - m_head);
-		std::copy(m_data.begin() + m_head, m_data.begin() + m_head + len, begin);
-		m_head += len;
-		m_head %= m_size;
-		m_fill -= len;
+
+	while (remaining > 0)
+	{
+		uint i = index(head);
+		len = MIN(remaining, m_size - i);
+		std::copy(m_data.begin() + i, m_data.begin() + i + len, begin);
+		head = advance(head, len);
 		begin += len;
 		remaining -= len;
 	}
 
+	m_head.storeRelease(head); // give the slots back to the producer
+
 	return total;
 }
 
@@ -182,32 +187,34 @@ uint SampleSinkFifo::readBegin(uint count,
 	SampleVector::iterator* part1Begin, SampleVector::iterator* part1End,
 	SampleVector::iterator* part2Begin, SampleVector::iterator* part2End)
 {
-	QMutexLocker mutexLocker(&m_mutex);
+	uint head = m_head.load();
+	uint fill = distance(head, m_tail.loadAcquire());
 	uint total;
 	uint remaining;
 	uint len;
-	uint head = m_head;
+	uint i = index(head);
 
-	total = MIN(count, m_fill);
-	if(total < count)
-		qCritical("SampleSinkFifo: underflow - missing %u samples", count - total);
+	total = MIN(count, fill);
+
+	if (total < count) {
+		m_nbUnderflows.fetchAndAddRelaxed(1);
+	}
 
 	remaining = total;
 	if(remaining > 0) {
-		len = MIN(remaining, m_size - head);
-		*part1Begin = m_data.begin() + head;
-		*part1End = m_data.begin() + head + len;
-		head += len;
-		head %= m_size;
+		len = MIN(remaining, m_size - i);
+		*part1Begin = m_data.begin() + i;
+		*part1End = m_data.begin() + i + len;
+		i = (i + len) % m_size;
 		remaining -= len;
 	} else {
 		*part1Begin = m_data.end();
 		*part1End = m_data.end();
 	}
 	if(remaining > 0) {
-		len = MIN(remaining, m_size - head);
-		*part2Begin = m_data.begin() + head;
-		*part2End = m_data.begin() + head + len;
+		len = MIN(remaining, m_size - i);
+		*part2Begin = m_data.begin() + i;
+		*part2End = m_data.begin() + i + len;
 	} else {
 		*part2Begin = m_data.end();
 		*part2End = m_data.end();
@@ -218,14 +225,15 @@ uint SampleSinkFifo::readBegin(uint count,
 
 uint SampleSinkFifo::readCommit(uint count)
 {
-	QMutexLocker mutexLocker(&m_mutex);
+	uint head = m_head.load();
+	uint fill = distance(head, m_tail.loadAcquire());
 
-	if(count > m_fill) {
+	if(count > fill) {
 		qCritical("SampleSinkFifo: cannot commit more than available samples");
-		count = m_fill;
+		count = fill;
 	}
-	m_head = (m_head + count) % m_size;
-	m_fill -= count;
+
+	m_head.storeRelease(advance(head, count));
 
 	return count;
 }
@@ -19,28 +19,28 @@
 #define INCLUDE_SAMPLEFIFO_H
 
 #include <QObject>
-#include <QMutex>
+#include <QAtomicInt>
 #include <QTime>
 #include "dsp/dsptypes.h"
 #include "util/export.h"
 
+/**
+ * Wait-free single producer single consumer FIFO of samples.
+ *
+ * write() must be called from one thread only (the device thread) and read(), readBegin()
+ * and readCommit() from one other thread only (the DSP engine or threaded sink thread).
+ * Head and tail are positions in [0, 2*size[ so that an empty and a full FIFO can be told
+ * apart without wasting a slot. Each one is only written by its owner and published with
+ * release semantics. They are kept on separate cache lines to avoid false sharing.
+ * setSize() must be called while neither side is running.
+ *
+ * Overflows are counted and logged by the producer at most every 2.5s with the number of
+ * messages suppressed in between. The device source engine resets the statistics when it
+ * starts and logs them when it goes back to idle.
+ */
 class SDRANGEL_API SampleSinkFifo : public QObject {
 	Q_OBJECT
 
-private:
-	QMutex m_mutex;
-	QTime m_msgRateTimer;
-	int m_suppressed;
-
-	SampleVector m_data;
-
-	uint m_size;
-	uint m_fill;
-	uint m_head;
-	uint m_tail;
-
-	void create(uint s);
-
 public:
 	SampleSinkFifo(QObject* parent = NULL);
 	SampleSinkFifo(int size, QObject* parent = NULL);
@@ -48,7 +48,7 @@ public:
 
 	bool setSize(int size);
 	inline uint size() const { return m_size; }
-	inline uint fill() { QMutexLocker mutexLocker(&m_mutex); uint fill = m_fill; return fill; }
+	inline uint fill() const { return distance(m_head.loadAcquire(), m_tail.loadAcquire()); }
 
 	uint write(const quint8* data, uint count);
 	uint write(SampleVector::const_iterator begin, SampleVector::const_iterator end);
@@ -60,8 +60,41 @@ public:
 		SampleVector::iterator* part2Begin, SampleVector::iterator* part2End);
 	uint readCommit(uint count);
 
+	// Statistics. Counters wrap around at 2^32 and can be read from any thread.
+	uint getNbOverflows() const { return (uint) m_nbOverflows.load(); }           //!< Number of writes that could not store all samples
+	uint getNbDroppedSamples() const { return (uint) m_nbDroppedSamples.load(); } //!< Number of samples dropped on overflows
+	uint getNbUnderflows() const { return (uint) m_nbUnderflows.load(); }         //!< Number of reads that asked for more than available
+	uint getMaxFill() const { return (uint) m_maxFill.load(); }                   //!< Highest fill seen by the producer after a write
+	void resetStats(); //!< must be called while the producer is not running
+
 signals:
 	void dataReady();
+
+private:
+	SampleVector m_data;
+	uint m_size;
+
+	char m_pad0[64];
+	QAtomicInt m_tail;             //!< producer position
+	QAtomicInt m_nbOverflows;
+	QAtomicInt m_nbDroppedSamples;
+	QAtomicInt m_maxFill;
+	QTime m_msgRateTimer;          //!< producer side overflow messages rate limit
+	int m_suppressed;
+	char m_pad1[64];
+	QAtomicInt m_head;             //!< consumer position
+	QAtomicInt m_nbUnderflows;
+	char m_pad2[64];
+
+	void create(uint s);
+	uint writeSamples(const Sample* begin, uint count);
+
+	/** Number of samples between head and tail positions */
+	inline uint distance(uint head, uint tail) const { return tail >= head ? tail - head : tail + 2*m_size - head; }
+	/** Position moved count samples ahead */
+	inline uint advance(uint position, uint count) const { position += count; return position >= 2*m_size ? position - 2*m_size : position; }
+	/** Index in the data vector of a position */
+	inline uint index(uint position) const { return position >= m_size ? position - m_size : position; }
 };
 
 #endif // INCLUDE_SAMPLEFIFO_H
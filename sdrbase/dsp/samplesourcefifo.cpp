@@ -15,6 +15,7 @@
 ///////////////////////////////////////////////////////////////////////////////////
 
 #include <assert.h>
+#include <algorithm>
 #include "samplesourcefifo.h"
 
 SampleSourceFifo::SampleSourceFifo(uint32_t size) :
@@ -89,3 +90,21 @@ void SampleSourceFifo::bumpIndex(SampleVector::iterator& writeAt)
 
     writeAt = m_data.begin() + m_iw;
 }
+
+void SampleSourceFifo::bumpIndex(SampleVector::iterator& writeAt, unsigned int nbSamples)
+{
+    assert(nbSamples <= m_size);
+
+    // the block was written from m_iw possibly past m_size into the second buffer
+    // so the part before m_size is copied forward and the part past m_size backward
+    unsigned int nbFirst = nbSamples < m_size - m_iw ? nbSamples : m_size - m_iw;
+    std::copy(m_data.begin() + m_iw, m_data.begin() + m_iw + nbFirst, m_data.begin() + m_iw + m_size);
+    std::copy(m_data.begin() + m_size, m_data.begin() + m_size + (nbSamples - nbFirst), m_data.begin());
+
+    {
+//        QMutexLocker mutexLocker(&m_mutex);
+        m_iw = (m_iw + nbSamples) % m_size;
+    }
+
+    writeAt = m_data.begin() + m_iw;
+}
@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QThread>
+#include <QDebug>
+
+#include "dsp/basebandsamplesource.h"
+#include "dsp/samplesourcemixer.h"
+
+#if defined(USE_SSE2)
+#include <emmintrin.h>
+#elif defined(USE_NEON)
+#include <arm_neon.h>
+#endif
+
+SampleSourceMixer::SampleSourceMixer() :
+    m_nbJobs(0),
+    m_nextJob(0),
+    m_refCount(0),
+    m_released(0),
+    m_nbSamples(0)
+{
+    // the calling thread takes its share of the work
+    int nbWorkers = QThread::idealThreadCount() - 1;
+    nbWorkers = nbWorkers < 1 ? 1 : nbWorkers;
+    m_threadPool.setMaxThreadCount(nbWorkers);
+    m_threadPool.setExpiryTimeout(-1); // keep threads around between blocks
+
+    for (int i = 0; i < nbWorkers; i++) {
+        m_workers.push_back(new Worker(this));
+    }
+
+    qDebug("SampleSourceMixer::SampleSourceMixer: %d worker threads", nbWorkers);
+}
+
+SampleSourceMixer::~SampleSourceMixer()
+{
+    m_threadPool.waitForDone();
+
+    for (std::vector<Worker*>::iterator it = m_workers.begin(); it != m_workers.end(); ++it) {
+        delete *it;
+    }
+}
+
+void SampleSourceMixer::clear()
+{
+    m_nbJobs = 0;
+}
+
+void SampleSourceMixer::addSource(BasebandSampleSource *source)
+{
+    if (m_nbJobs == m_jobs.size()) {
+        m_jobs.push_back(Job());
+    }
+
+    m_jobs[m_nbJobs].m_source = source;
+    m_nbJobs++;
+}
+
+void SampleSourceMixer::mix(SampleVector::iterator writeAt, unsigned int nbSamples, unsigned int divisionFactor)
+{
+    if (m_nbJobs == 0) {
+        return;
+    }
+
+    for (unsigned int i = 0; i < m_nbJobs; i++)
+    {
+        if (m_jobs[i].m_samples.size() < nbSamples) {
+            m_jobs[i].m_samples.resize(nbSamples);
+        }
+    }
+
+    // no need to wake up more workers than there are sources left for them
+    int nbWorkers = (int) m_nbJobs - 1 < (int) m_workers.size() ? m_nbJobs - 1 : m_workers.size();
+
+    m_nbSamples = nbSamples;
+    m_nextJob.store(0);
+    // workers hold a reference too so that none of them is still looking at the job list when we return
+    m_refCount.store(m_nbJobs + nbWorkers);
+
+    for (int i = 0; i < nbWorkers; i++) {
+        m_threadPool.start(m_workers[i]);
+    }
+
+    work();
+    m_released.acquire();
+
+    qint16 scale = getScale(divisionFactor);
+
+    for (unsigned int i = 0; i < m_nbJobs; i++) {
+        mixBlock(&(*writeAt), &m_jobs[i].m_samples[0], nbSamples, scale, i == 0);
+    }
+}
+
+void SampleSourceMixer::work()
+{
+    int nbJobs = m_nbJobs;
+    int i;
+
+    while ((i = m_nextJob.fetchAndAddOrdered(1)) < nbJobs)
+    {
+        m_jobs[i].m_source->pullBlock(m_jobs[i].m_samples.begin(), m_nbSamples);
+        release(); // this source is done
+    }
+}
+
+void SampleSourceMixer::release()
+{
+    if (m_refCount.fetchAndAddOrdered(-1) == 1) {
+        m_released.release();
+    }
+}
+
+void SampleSourceMixer::Worker::run()
+{
+    m_mixer->work();
+    m_mixer->release();
+}
+
+qint16 SampleSourceMixer::getScale(unsigned int divisionFactor)
+{
+    return (4096 + (divisionFactor >> 1)) / (divisionFactor == 0 ? 1 : divisionFactor);
+}
+
+void SampleSourceMixer::mixBlock(Sample *out, const Sample *in, unsigned int nbSamples, qint16 scale, bool first)
+{
+    const qint16 *x = (const qint16 *) in;
+    qint16 *y = (qint16 *) out;
+    unsigned int nbValues = 2*nbSamples;
+    unsigned int i = 0;
+
+#if defined(USE_SSE2)
+    // (x, x) pairs times (scale, 0) gives x * scale on 32 bits
+    __m128i vscale = _mm_set1_epi32((quint16) scale);
+    __m128i vround = _mm_set1_epi32(1<<11);
+
+    for (; i + 8 <= nbValues; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) &x[i]);
+        __m128i lo = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(v, v), vscale), vround), 12);
+        __m128i hi = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(v, v), vscale), vround), 12);
+        v = _mm_packs_epi32(lo, hi);
+
+        if (!first) {
+            v = _mm_adds_epi16(v, _mm_loadu_si128((const __m128i*) &y[i]));
+        }
+
+        _mm_storeu_si128((__m128i*) &y[i], v);
+    }
+#elif defined(USE_NEON)
+    for (; i + 8 <= nbValues; i += 8)
+    {
+        int16x8_t v = vld1q_s16(&x[i]);
+        int16x4_t lo = vqmovn_s32(vrshrq_n_s32(vmull_n_s16(vget_low_s16(v), scale), 12));
+        int16x4_t hi = vqmovn_s32(vrshrq_n_s32(vmull_n_s16(vget_high_s16(v), scale), 12));
+        v = vcombine_s16(lo, hi);
+
+        if (!first) {
+            v = vqaddq_s16(v, vld1q_s16(&y[i]));
+        }
+
+        vst1q_s16(&y[i], v);
+    }
+#endif
+
+    for (; i < nbValues; i++)
+    {
+        qint32 v = (x[i] * scale + (1<<11)) >> 12;
+        v = v < -32768 ? -32768 : v > 32767 ? 32767 : v;
+
+        if (!first)
+        {
+            v += y[i];
+            v = v < -32768 ? -32768 : v > 32767 ? 32767 : v;
+        }
+
+        y[i] = v;
+    }
+}
@@ -0,0 +1,86 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_SAMPLESOURCEMIXER_H_
+#define SDRBASE_DSP_SAMPLESOURCEMIXER_H_
+
+#include <vector>
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QSemaphore>
+#include <QThreadPool>
+
+#include "dsp/dsptypes.h"
+#include "util/export.h"
+
+class BasebandSampleSource;
+
+/**
+ * Mixes the output of several sample sources into one block.
+ *
+ * Each source is pulled into its own block. Sources are picked dynamically from a common job
+ * index by a fixed pool of worker threads and the calling thread so that all sources are pulled
+ * in parallel. A source is pulled from one thread only per block so it still produces samples
+ * in order. Once all blocks are ready they are divided by the division factor and summed
+ * with saturation into the destination.
+ */
+class SDRANGEL_API SampleSourceMixer
+{
+public:
+    SampleSourceMixer();
+    ~SampleSourceMixer();
+
+    void clear(); //!< start a new block
+    void addSource(BasebandSampleSource *source); //!< add a source to the mix
+    /** Pull nbSamples from all sources and write the mix at writeAt. Each source is divided by divisionFactor. */
+    void mix(SampleVector::iterator writeAt, unsigned int nbSamples, unsigned int divisionFactor);
+    int getNbThreads() const { return m_workers.size() + 1; }
+
+    /** Scale nbSamples of in by scale/4096 and add them with saturation to out or copy them if first */
+    static void mixBlock(Sample *out, const Sample *in, unsigned int nbSamples, qint16 scale, bool first);
+    static qint16 getScale(unsigned int divisionFactor); //!< fixed point scale used by mixBlock
+
+private:
+    struct Job
+    {
+        BasebandSampleSource *m_source;
+        SampleVector m_samples;
+    };
+
+    class Worker : public QRunnable
+    {
+    public:
+        Worker(SampleSourceMixer *mixer) : m_mixer(mixer) { setAutoDelete(false); }
+        virtual void run();
+    private:
+        SampleSourceMixer *m_mixer;
+    };
+
+    std::vector<Job> m_jobs; //!< kept between blocks so that sample buffers are not reallocated
+    unsigned int m_nbJobs;
+    std::vector<Worker*> m_workers;
+    QThreadPool m_threadPool;
+    QAtomicInt m_nextJob;  //!< index of the next source to be pulled
+    QAtomicInt m_refCount; //!< pending sources and running workers
+    QSemaphore m_released; //!< signaled when the reference count drops to zero
+    unsigned int m_nbSamples;
+
+    void work();
+    void release();
+};
+
+#endif /* SDRBASE_DSP_SAMPLESOURCEMIXER_H_ */
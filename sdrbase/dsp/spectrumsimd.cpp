@@ -0,0 +1,326 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsp/spectrumsimd.h"
+
+#if defined(USE_SSE2)
+#include <emmintrin.h>
+#elif defined(USE_NEON)
+#include <arm_neon.h>
+#endif
+
+const Real SpectrumSIMD::c0 =  1.442715774671615f;
+const Real SpectrumSIMD::c1 = -0.721122539246379f;
+const Real SpectrumSIMD::c2 =  0.4793243587459152f;
+const Real SpectrumSIMD::c3 = -0.3677039823361407f;
+const Real SpectrumSIMD::c4 =  0.3220854963408836f;
+const Real SpectrumSIMD::c5 = -0.20529829593065144f;
+
+// The polynomial itself is within 2.45e-6 of log2 that is 7.4e-6 dB. Over the whole range
+// of normal floats float rounding of results up to +/-380 dB brings the error to 4.4e-5 dB.
+const Real SpectrumSIMD::powerToDBMaxError = 1e-4f;
+
+static const Real dBPerLog2 = 3.0102999566f; // 10*log10(2)
+
+void SpectrumSIMD::samplesToComplex(const Sample *in, Complex *out, unsigned int nbSamples)
+{
+    unsigned int i = 0;
+    const qint16 *x = (const qint16 *) in;
+    float *y = (float *) out;
+
+#if defined(USE_SSE2)
+    __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*) &x[2*i]);
+        __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+        __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+        _mm_storeu_ps(&y[2*i], _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+        _mm_storeu_ps(&y[2*i + 4], _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+    }
+#elif defined(USE_NEON)
+    float32x4_t scale = vdupq_n_f32(1.0f / 32768.0f);
+
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        int16x8_t v = vld1q_s16(&x[2*i]);
+        vst1q_f32(&y[2*i], vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+        vst1q_f32(&y[2*i + 4], vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+#endif
+
+    for (; i < nbSamples; i++) {
+        out[i] = Complex(in[i].real() / 32768.0f, in[i].imag() / 32768.0f);
+    }
+}
+
+void SpectrumSIMD::applyWindow(const Complex *in, const Real *window, Complex *out, unsigned int nbSamples)
+{
+    unsigned int i = 0;
+    const float *x = (const float *) in;
+    float *y = (float *) out;
+
+#if defined(USE_SSE2)
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        __m128 w = _mm_loadu_ps(&window[i]);
+        _mm_storeu_ps(&y[2*i], _mm_mul_ps(_mm_loadu_ps(&x[2*i]), _mm_unpacklo_ps(w, w)));
+        _mm_storeu_ps(&y[2*i + 4], _mm_mul_ps(_mm_loadu_ps(&x[2*i + 4]), _mm_unpackhi_ps(w, w)));
+    }
+#elif defined(USE_NEON)
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        float32x4x2_t v = vld2q_f32(&x[2*i]); // de-interleaved real and imaginary parts
+        float32x4_t w = vld1q_f32(&window[i]);
+        v.val[0] = vmulq_f32(v.val[0], w);
+        v.val[1] = vmulq_f32(v.val[1], w);
+        vst2q_f32(&y[2*i], v);
+    }
+#endif
+
+    for (; i < nbSamples; i++) {
+        out[i] = in[i] * window[i];
+    }
+}
+
+void SpectrumSIMD::magSq(const Complex *in, Real *out, unsigned int nbSamples)
+{
+    unsigned int i = 0;
+    const float *x = (const float *) in;
+
+#if defined(USE_SSE2)
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(&x[2*i]);
+        __m128 b = _mm_loadu_ps(&x[2*i + 4]);
+        __m128 re = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+        __m128 im = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+        _mm_storeu_ps(&out[i], _mm_add_ps(_mm_mul_ps(re, re), _mm_mul_ps(im, im)));
+    }
+#elif defined(USE_NEON)
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        float32x4x2_t v = vld2q_f32(&x[2*i]);
+        vst1q_f32(&out[i], vaddq_f32(vmulq_f32(v.val[0], v.val[0]), vmulq_f32(v.val[1], v.val[1])));
+    }
+#endif
+
+    for (; i < nbSamples; i++) {
+        out[i] = in[i].real() * in[i].real() + in[i].imag() * in[i].imag();
+    }
+}
+
+void SpectrumSIMD::powerToDB(const Real *in, Real *out, unsigned int nbSamples, Real offset)
+{
+    unsigned int i = 0;
+
+#if defined(USE_SSE2)
+    const __m128i mantissaMask = _mm_set1_epi32(0x007fffff);
+    const __m128i one = _mm_set1_epi32(0x3f800000);
+    const __m128 sqrt2 = _mm_set1_ps(1.41421356f);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 onef = _mm_set1_ps(1.0f);
+    const __m128 scale = _mm_set1_ps(dBPerLog2);
+    const __m128 ofs = _mm_set1_ps(offset);
+
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        __m128i bits = _mm_castps_si128(_mm_loadu_ps(&in[i]));
+        __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff)), _mm_set1_epi32(127)));
+        __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, mantissaMask), one));
+        // m > sqrt(2): m = m/2 and e = e+1
+        __m128 above = _mm_cmpgt_ps(m, sqrt2);
+        m = _mm_or_ps(_mm_and_ps(above, _mm_mul_ps(m, half)), _mm_andnot_ps(above, m));
+        e = _mm_add_ps(e, _mm_and_ps(above, onef));
+        m = _mm_sub_ps(m, onef);
+        __m128 p = _mm_set1_ps(c5);
+        p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(c4));
+        p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(c3));
+        p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(c2));
+        p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(c1));
+        p = _mm_add_ps(_mm_mul_ps(p, m), _mm_set1_ps(c0));
+        p = _mm_add_ps(_mm_mul_ps(p, m), e);
+        _mm_storeu_ps(&out[i], _mm_add_ps(_mm_mul_ps(p, scale), ofs));
+    }
+#elif defined(USE_NEON)
+    const uint32x4_t mantissaMask = vdupq_n_u32(0x007fffff);
+    const uint32x4_t one = vdupq_n_u32(0x3f800000);
+    const float32x4_t sqrt2 = vdupq_n_f32(1.41421356f);
+    const float32x4_t onef = vdupq_n_f32(1.0f);
+
+    for (; i + 4 <= nbSamples; i += 4)
+    {
+        uint32x4_t bits = vreinterpretq_u32_f32(vld1q_f32(&in[i]));
+        float32x4_t e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(bits, 23), vdupq_n_u32(0xff))), vdupq_n_s32(127)));
+        float32x4_t m = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, mantissaMask), one));
+        uint32x4_t above = vcgtq_f32(m, sqrt2);
+        m = vbslq_f32(above, vmulq_n_f32(m, 0.5f), m);
+        e = vbslq_f32(above, vaddq_f32(e, onef), e);
+        m = vsubq_f32(m, onef);
+        float32x4_t p = vdupq_n_f32(c5);
+        p = vaddq_f32(vmulq_f32(p, m), vdupq_n_f32(c4));
+        p = vaddq_f32(vmulq_f32(p, m), vdupq_n_f32(c3));
+        p = vaddq_f32(vmulq_f32(p, m), vdupq_n_f32(c2));
+        p = vaddq_f32(vmulq_f32(p, m), vdupq_n_f32(c1));
+        p = vaddq_f32(vmulq_f32(p, m), vdupq_n_f32(c0));
+        p = vaddq_f32(vmulq_f32(p, m), e);
+        vst1q_f32(&out[i], vaddq_f32(vmulq_n_f32(p, dBPerLog2), vdupq_n_f32(offset)));
+    }
+#endif
+
+    for (; i < nbSamples; i++) {
+        out[i] = fastLog2(in[i]) * dBPerLog2 + offset;
+    }
+}
+
+static inline Real rangeMax(const Real *in, unsigned int n)
+{
+    unsigned int i = 0;
+    Real r = in[0];
+
+#if defined(USE_SSE2)
+    if (n >= 8)
+    {
+        __m128 acc = _mm_loadu_ps(in);
+
+        for (i = 4; i + 4 <= n; i += 4) {
+            acc = _mm_max_ps(acc, _mm_loadu_ps(&in[i]));
+        }
+
+        acc = _mm_max_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1,0,3,2)));
+        acc = _mm_max_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(2,3,0,1)));
+        r = _mm_cvtss_f32(acc);
+    }
+#elif defined(USE_NEON)
+    if (n >= 8)
+    {
+        float32x4_t acc = vld1q_f32(in);
+
+        for (i = 4; i + 4 <= n; i += 4) {
+            acc = vmaxq_f32(acc, vld1q_f32(&in[i]));
+        }
+
+        float32x2_t m = vpmax_f32(vget_low_f32(acc), vget_high_f32(acc));
+        r = vget_lane_f32(vpmax_f32(m, m), 0);
+    }
+#endif
+
+    for (; i < n; i++) {
+        r = in[i] > r ? in[i] : r;
+    }
+
+    return r;
+}
+
+static inline Real rangeMin(const Real *in, unsigned int n)
+{
+    unsigned int i = 0;
+    Real r = in[0];
+
+#if defined(USE_SSE2)
+    if (n >= 8)
+    {
+        __m128 acc = _mm_loadu_ps(in);
+
+        for (i = 4; i + 4 <= n; i += 4) {
+            acc = _mm_min_ps(acc, _mm_loadu_ps(&in[i]));
+        }
+
+        acc = _mm_min_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1,0,3,2)));
+        acc = _mm_min_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(2,3,0,1)));
+        r = _mm_cvtss_f32(acc);
+    }
+#elif defined(USE_NEON)
+    if (n >= 8)
+    {
+        float32x4_t acc = vld1q_f32(in);
+
+        for (i = 4; i + 4 <= n; i += 4) {
+            acc = vminq_f32(acc, vld1q_f32(&in[i]));
+        }
+
+        float32x2_t m = vpmin_f32(vget_low_f32(acc), vget_high_f32(acc));
+        r = vget_lane_f32(vpmin_f32(m, m), 0);
+    }
+#endif
+
+    for (; i < n; i++) {
+        r = in[i] < r ? in[i] : r;
+    }
+
+    return r;
+}
+
+static inline Real rangeMean(const Real *in, unsigned int n)
+{
+    unsigned int i = 0;
+    Real r = 0.0f;
+
+#if defined(USE_SSE2)
+    __m128 acc = _mm_setzero_ps();
+
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm_add_ps(acc, _mm_loadu_ps(&in[i]));
+    }
+
+    acc = _mm_add_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(1,0,3,2)));
+    acc = _mm_add_ps(acc, _mm_shuffle_ps(acc, acc, _MM_SHUFFLE(2,3,0,1)));
+    r = _mm_cvtss_f32(acc);
+#elif defined(USE_NEON)
+    float32x4_t acc = vdupq_n_f32(0.0f);
+
+    for (; i + 4 <= n; i += 4) {
+        acc = vaddq_f32(acc, vld1q_f32(&in[i]));
+    }
+
+    float32x2_t s = vpadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    r = vget_lane_f32(vpadd_f32(s, s), 0);
+#endif
+
+    for (; i < n; i++) {
+        r += in[i];
+    }
+
+    return r / n;
+}
+
+void SpectrumSIMD::reduce(const Real *in, unsigned int nbIn, Real *out, unsigned int nbOut, Reduction reduction)
+{
+    unsigned int start = 0;
+
+    for (unsigned int i = 0; i < nbOut; i++)
+    {
+        unsigned int end = ((quint64) (i + 1) * nbIn) / nbOut;
+
+        switch (reduction)
+        {
+        case ReductionMean:
+            out[i] = rangeMean(&in[start], end - start);
+            break;
+        case ReductionMin:
+            out[i] = rangeMin(&in[start], end - start);
+            break;
+        case ReductionMax:
+        default:
+            out[i] = rangeMax(&in[start], end - start);
+            break;
+        }
+
+        start = end;
+    }
+}
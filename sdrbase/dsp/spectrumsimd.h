@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_SPECTRUMSIMD_H_
+#define SDRBASE_DSP_SPECTRUMSIMD_H_
+
+#include <string.h>
+#include <QtGlobal>
+#include "dsp/dsptypes.h"
+#include "util/export.h"
+
+/**
+ * Vectorized kernels of the spectrum display path: SSE2 or NEON when the build defines
+ * USE_SSE2 or USE_NEON, scalar code otherwise and for the tail of blocks.
+ *
+ * Sample conversion, windowing, magnitude squared and the max or min reduction of bins to
+ * display columns give exactly the same results as the scalar code. The dB conversion uses
+ * a polynomial approximation of log2 with an absolute error below powerToDBMaxError for
+ * normal positive floats. Zero and denormal powers give about -382 dB (plus offset) instead
+ * of -inf.
+ */
+class SDRANGEL_API SpectrumSIMD
+{
+public:
+    /** How bins sharing the same display column are combined by reduce */
+    enum Reduction {
+        ReductionMax,
+        ReductionMean,
+        ReductionMin
+    };
+
+    static const Real powerToDBMaxError; //!< bound of the absolute error of powerToDB in dB
+
+    /** I/Q samples to complex normalized to full scale (divided by 32768) */
+    static void samplesToComplex(const Sample *in, Complex *out, unsigned int nbSamples);
+    /** Complex samples multiplied by a real window */
+    static void applyWindow(const Complex *in, const Real *window, Complex *out, unsigned int nbSamples);
+    /** Magnitude squared */
+    static void magSq(const Complex *in, Real *out, unsigned int nbSamples);
+    /** 10*log10(in) + offset */
+    static void powerToDB(const Real *in, Real *out, unsigned int nbSamples, Real offset);
+    /** Reduces nbIn values to nbOut <= nbIn values. Output i combines inputs i*nbIn/nbOut to (i+1)*nbIn/nbOut - 1 */
+    static void reduce(const Real *in, unsigned int nbIn, Real *out, unsigned int nbOut, Reduction reduction);
+
+    /** Approximation of log2(x) for normal x > 0 used by powerToDB */
+    static inline Real fastLog2(Real x)
+    {
+        quint32 bits;
+        memcpy(&bits, &x, sizeof(bits));
+        Real e = (Real) ((int) ((bits >> 23) & 0xff) - 127);
+        bits = (bits & 0x007fffff) | 0x3f800000; // mantissa in [1, 2)
+        Real m;
+        memcpy(&m, &bits, sizeof(m));
+
+        if (m > 1.41421356f) // center the range on 1 that is m in [sqrt(2)/2, sqrt(2))
+        {
+            m *= 0.5f;
+            e += 1.0f;
+        }
+
+        m -= 1.0f;
+        return e + m * (c0 + m * (c1 + m * (c2 + m * (c3 + m * (c4 + m * c5)))));
+    }
+
+private:
+    // least squares fit of log2(1+x)/x on [sqrt(2)/2-1, sqrt(2)-1]
+    static const Real c0, c1, c2, c3, c4, c5;
+};
+
+#endif /* SDRBASE_DSP_SPECTRUMSIMD_H_ */
@@ -1,4 +1,6 @@
+#include <QDebug>
 #include "dsp/spectrumvis.h"
+#include "dsp/spectrumsimd.h"
 #include "gui/glspectrum.h"
 #include "dsp/dspcommands.h"
 #include "util/messagequeue.h"
@@ -13,6 +15,7 @@ inline double log2f(double n)
 #endif
 
 MESSAGE_CLASS_DEFINITION(SpectrumVis::MsgConfigureSpectrumVis, Message)
+MESSAGE_CLASS_DEFINITION(SpectrumVis::MsgConfigureSpectrumVisAveraging, Message)
 
 SpectrumVis::SpectrumVis(GLSpectrum* glSpectrum) :
 	BasebandSampleSink(),
@@ -21,6 +24,13 @@ SpectrumVis::SpectrumVis(GLSpectrum* glSpectrum) :
 	m_logPowerSpectrum(MAX_FFT_SIZE),
 	m_fftBufferFill(0),
 	m_needMoreSamples(false),
+	m_avgMode(AvgModeNone),
+	m_avgNb(1),
+	m_avgCount(0),
+	m_avgIndex(0),
+	m_holdMode(HoldModeNone),
+	m_holdInit(false),
+	m_maxFrameRate(0),
 	m_glSpectrum(glSpectrum),
 	m_mutex(QMutex::Recursive)
 {
@@ -39,6 +49,12 @@ void SpectrumVis::configure(MessageQueue* msgQueue, int fftSize, int overlapPerc
 	msgQueue->push(cmd);
 }
 
+void SpectrumVis::configureAveraging(MessageQueue* msgQueue, AvgMode avgMode, int avgNb, HoldMode holdMode, int maxFrameRate)
+{
+	MsgConfigureSpectrumVisAveraging* cmd = new MsgConfigureSpectrumVisAveraging(avgMode, avgNb, holdMode, maxFrameRate);
+	msgQueue->push(cmd);
+}
+
 void SpectrumVis::feedTriggered(const SampleVector::const_iterator& triggerPoint, const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly)
 {
 	feed(triggerPoint, end, positiveOnly); // normal feed from trigger point
@@ -81,12 +97,8 @@ void SpectrumVis::feed(const SampleVector::const_iterator& cbegin, const SampleV
 			QMutexLocker mutexLocker(&m_mutex);
 
 			// fill up the buffer
-			std::vector<Complex>::iterator it = m_fftBuffer.begin() + m_fftBufferFill;
-
-			for (std::size_t i = 0; i < samplesNeeded; ++i, ++begin)
-			{
-				*it++ = Complex(begin->real() / 32768.0f, begin->imag() / 32768.0f);
-			}
+			SpectrumSIMD::samplesToComplex(&(*begin), &m_fftBuffer[m_fftBufferFill], samplesNeeded);
+			begin += samplesNeeded;
 
 			// apply fft window (and copy from m_fftBuffer to m_fftIn)
 			m_window.apply(&m_fftBuffer[0], m_fft->in());
@@ -95,8 +107,6 @@ void SpectrumVis::feed(const SampleVector::const_iterator& cbegin, const SampleV
 			m_fft->transform();
 
 			// extract power spectrum and reorder buckets
-			Real ofs = 20.0f * log10f(1.0f / m_fftSize);
-			Real mult = (10.0f / log2f(10.0f));
 			const Complex* fftOut = m_fft->out();
 			Complex c;
 			Real v;
@@ -108,29 +118,18 @@ void SpectrumVis::feed(const SampleVector::const_iterator& cbegin, const SampleV
 				{
 					c = fftOut[i];
 					v = c.real() * c.real() + c.imag() * c.imag();
-					v = mult * log2f(v) + ofs;
-					m_logPowerSpectrum[i * 2] = v;
-					m_logPowerSpectrum[i * 2 + 1] = v;
+					m_powerSpectrum[i * 2] = v;
+					m_powerSpectrum[i * 2 + 1] = v;
 				}
 			}
 			else
 			{
-				for (std::size_t i = 0; i < halfSize; i++)
-				{
-					c = fftOut[i + halfSize];
-					v = c.real() * c.real() + c.imag() * c.imag();
-					v = mult * log2f(v) + ofs;
-					m_logPowerSpectrum[i] = v;
-
-					c = fftOut[i];
-					v = c.real() * c.real() + c.imag() * c.imag();
-					v = mult * log2f(v) + ofs;
-					m_logPowerSpectrum[i + halfSize] = v;
-				}
+				SpectrumSIMD::magSq(&fftOut[halfSize], &m_powerSpectrum[0], halfSize);
+				SpectrumSIMD::magSq(&fftOut[0], &m_powerSpectrum[halfSize], halfSize);
 			}
 
-			// send new data to visualisation
-			m_glSpectrum->newSpectrum(m_logPowerSpectrum, m_fftSize);
+			// average, hold and send new data to visualisation
+			processPowerSpectrum();
 
 			// advance buffer respecting the fft overlap factor
 			std::copy(m_fftBuffer.begin() + m_refillSize, m_fftBuffer.end(), m_fftBuffer.begin());
@@ -142,10 +141,8 @@ void SpectrumVis::feed(const SampleVector::const_iterator& cbegin, const SampleV
 		else
 		{
 			// not enough samples for FFT - just fill in new data and return
-			for(std::vector<Complex>::iterator it = m_fftBuffer.begin() + m_fftBufferFill; begin < end; ++begin)
-			{
-				*it++ = Complex(begin->real() / 32768.0f, begin->imag() / 32768.0f);
-			}
+			SpectrumSIMD::samplesToComplex(&(*begin), &m_fftBuffer[m_fftBufferFill], todo);
+			begin = end;
 
 			m_fftBufferFill += todo;
 			m_needMoreSamples = true;
@@ -153,6 +150,104 @@ void SpectrumVis::feed(const SampleVector::const_iterator& cbegin, const SampleV
 	}
 }
 
+void SpectrumVis::processPowerSpectrum()
+{
+	const std::vector<Real> *spectrum = &m_powerSpectrum;
+
+	switch (m_avgMode)
+	{
+	case AvgModeMoving:
+	{
+		// replace the oldest spectrum of the history in the running sum
+		Real *oldest = &m_avgHistory[m_avgIndex * m_fftSize];
+		unsigned int count = m_avgCount < m_avgNb ? ++m_avgCount : m_avgNb;
+
+		for (std::size_t i = 0; i < m_fftSize; i++)
+		{
+			m_avgSum[i] += m_powerSpectrum[i] - oldest[i];
+			oldest[i] = m_powerSpectrum[i];
+			m_avgSpectrum[i] = m_avgSum[i] > 0.0 ? m_avgSum[i] / count : 0.0; // rounding of the running sum may go below zero
+		}
+
+		m_avgIndex = m_avgIndex < m_avgNb - 1 ? m_avgIndex + 1 : 0;
+		spectrum = &m_avgSpectrum;
+		break;
+	}
+	case AvgModeFixed:
+	{
+		if (m_avgCount == 0) {
+			std::copy(m_powerSpectrum.begin(), m_powerSpectrum.begin() + m_fftSize, m_avgSum.begin());
+		} else {
+			for (std::size_t i = 0; i < m_fftSize; i++) {
+				m_avgSum[i] += m_powerSpectrum[i];
+			}
+		}
+
+		if (++m_avgCount < m_avgNb) {
+			return; // not complete yet
+		}
+
+		for (std::size_t i = 0; i < m_fftSize; i++) {
+			m_avgSpectrum[i] = m_avgSum[i] / m_avgNb;
+		}
+
+		m_avgCount = 0;
+		spectrum = &m_avgSpectrum;
+		break;
+	}
+	case AvgModeExponential:
+	{
+		// weight is 1/n for the first spectra so that the average settles quickly
+		unsigned int count = m_avgCount < m_avgNb ? ++m_avgCount : m_avgNb;
+		Real alpha = 1.0f / count;
+
+		for (std::size_t i = 0; i < m_fftSize; i++) {
+			m_avgSpectrum[i] += alpha * (m_powerSpectrum[i] - m_avgSpectrum[i]);
+		}
+
+		spectrum = &m_avgSpectrum;
+		break;
+	}
+	default:
+		break;
+	}
+
+	if (m_holdMode != HoldModeNone)
+	{
+		if (!m_holdInit)
+		{
+			std::copy(spectrum->begin(), spectrum->begin() + m_fftSize, m_holdSpectrum.begin());
+			m_holdInit = true;
+		}
+		else if (m_holdMode == HoldModeMax)
+		{
+			for (std::size_t i = 0; i < m_fftSize; i++) {
+				m_holdSpectrum[i] = (*spectrum)[i] > m_holdSpectrum[i] ? (*spectrum)[i] : m_holdSpectrum[i];
+			}
+		}
+		else
+		{
+			for (std::size_t i = 0; i < m_fftSize; i++) {
+				m_holdSpectrum[i] = (*spectrum)[i] < m_holdSpectrum[i] ? (*spectrum)[i] : m_holdSpectrum[i];
+			}
+		}
+
+		spectrum = &m_holdSpectrum;
+	}
+
+	// the log conversion and the display are skipped for frames beyond the display rate
+	if ((m_maxFrameRate > 0) && m_frameTimer.isValid() && (m_frameTimer.elapsed() < 1000 / m_maxFrameRate)) {
+		return;
+	}
+
+	m_frameTimer.start();
+
+	Real ofs = 20.0f * log10f(1.0f / m_fftSize);
+	SpectrumSIMD::powerToDB(&(*spectrum)[0], &m_logPowerSpectrum[0], m_fftSize, ofs);
+
+	m_glSpectrum->newSpectrum(m_logPowerSpectrum, m_fftSize);
+}
+
 void SpectrumVis::start()
 {
 }
@@ -169,6 +264,12 @@ bool SpectrumVis::handleMessage(const Message& message)
 		handleConfigure(conf.getFFTSize(), conf.getOverlapPercent(), conf.getWindow());
 		return true;
 	}
+	else if (MsgConfigureSpectrumVisAveraging::match(message))
+	{
+		MsgConfigureSpectrumVisAveraging& conf = (MsgConfigureSpectrumVisAveraging&) message;
+		handleConfigureAveraging(conf.getAvgMode(), conf.getAvgNb(), conf.getHoldMode(), conf.getMaxFrameRate());
+		return true;
+	}
 	else
 	{
 		return false;
@@ -204,4 +305,37 @@ void SpectrumVis::handleConfigure(int fftSize, int overlapPercent, FFTWindow::Fu
 	m_overlapSize = (m_fftSize * m_overlapPercent) / 100;
 	m_refillSize = m_fftSize - m_overlapSize;
 	m_fftBufferFill = m_overlapSize;
+	resetAveraging();
+}
+
+void SpectrumVis::handleConfigureAveraging(AvgMode avgMode, int avgNb, HoldMode holdMode, int maxFrameRate)
+{
+	QMutexLocker mutexLocker(&m_mutex);
+
+	m_avgMode = avgMode;
+	m_avgNb = avgNb < 1 ? 1 : avgNb;
+	m_holdMode = holdMode;
+	m_maxFrameRate = maxFrameRate < 0 ? 0 : maxFrameRate;
+	resetAveraging();
+
+	qDebug("SpectrumVis::handleConfigureAveraging: avgMode: %d avgNb: %u holdMode: %d maxFrameRate: %d",
+			(int) m_avgMode, m_avgNb, (int) m_holdMode, m_maxFrameRate);
+}
+
+void SpectrumVis::resetAveraging()
+{
+	m_powerSpectrum.resize(m_fftSize);
+	m_avgSpectrum.assign(m_fftSize, 0.0f);
+	m_holdSpectrum.resize(m_fftSize);
+	m_avgSum.assign(m_fftSize, 0.0);
+
+	if (m_avgMode == AvgModeMoving) {
+		m_avgHistory.assign(m_fftSize * m_avgNb, 0.0f);
+	} else {
+		m_avgHistory.clear();
+	}
+
+	m_avgCount = 0;
+	m_avgIndex = 0;
+	m_holdInit = false;
 }
@@ -3,6 +3,7 @@
 
 #include <dsp/basebandsamplesink.h>
 #include <QMutex>
+#include <QElapsedTimer>
 #include "dsp/fftengine.h"
 #include "fftwindow.h"
 #include "util/export.h"
@@ -14,6 +15,21 @@ class MessageQueue;
 class SDRANGEL_API SpectrumVis : public BasebandSampleSink {
 
 public:
+	enum AvgMode
+	{
+		AvgModeNone,
+		AvgModeMoving,      //!< average of the last N spectra
+		AvgModeFixed,       //!< average of N spectra then start over. Only one spectrum out of N is displayed
+		AvgModeExponential  //!< exponential moving average with a 1/N weight for the new spectrum
+	};
+
+	enum HoldMode
+	{
+		HoldModeNone,
+		HoldModeMax, //!< maximum of averaged power since last configuration
+		HoldModeMin  //!< minimum of averaged power since last configuration
+	};
+
 	class SDRANGEL_API MsgConfigureSpectrumVis : public Message {
 		MESSAGE_CLASS_DECLARATION
 
@@ -35,10 +51,36 @@ public:
 		FFTWindow::Function m_window;
 	};
 
+	class SDRANGEL_API MsgConfigureSpectrumVisAveraging : public Message {
+		MESSAGE_CLASS_DECLARATION
+
+	public:
+		MsgConfigureSpectrumVisAveraging(AvgMode avgMode, int avgNb, HoldMode holdMode, int maxFrameRate) :
+			Message(),
+			m_avgMode(avgMode),
+			m_avgNb(avgNb),
+			m_holdMode(holdMode),
+			m_maxFrameRate(maxFrameRate)
+		{ }
+
+		AvgMode getAvgMode() const { return m_avgMode; }
+		int getAvgNb() const { return m_avgNb; }
+		HoldMode getHoldMode() const { return m_holdMode; }
+		int getMaxFrameRate() const { return m_maxFrameRate; }
+
+	private:
+		AvgMode m_avgMode;
+		int m_avgNb;
+		HoldMode m_holdMode;
+		int m_maxFrameRate;
+	};
+
 	SpectrumVis(GLSpectrum* glSpectrum = NULL);
 	virtual ~SpectrumVis();
 
 	void configure(MessageQueue* msgQueue, int fftSize, int overlapPercent, FFTWindow::Function window);
+	/** Averaging and hold of the power spectrum. Spectra are sent to display at most maxFrameRate times per second (0 for no limit). */
+	void configureAveraging(MessageQueue* msgQueue, AvgMode avgMode, int avgNb, HoldMode holdMode, int maxFrameRate);
 
 	virtual void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly);
 	void feedTriggered(const SampleVector::const_iterator& triggerPoint, const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly);
@@ -52,6 +94,11 @@ private:
 
 	std::vector<Complex> m_fftBuffer;
 	std::vector<Real> m_logPowerSpectrum;
+	std::vector<Real> m_powerSpectrum;     //!< linear power of the last FFT in display order
+	std::vector<Real> m_avgSpectrum;       //!< linear power after averaging
+	std::vector<Real> m_holdSpectrum;      //!< linear power after max or min hold
+	std::vector<double> m_avgSum;          //!< moving average running sum or fixed average accumulator
+	std::vector<Real> m_avgHistory;        //!< moving average: last m_avgNb spectra
 
 	std::size_t m_fftSize;
 	std::size_t m_overlapPercent;
@@ -60,11 +107,23 @@ private:
 	std::size_t m_fftBufferFill;
 	bool m_needMoreSamples;
 
+	AvgMode m_avgMode;
+	unsigned int m_avgNb;
+	unsigned int m_avgCount;  //!< number of spectra averaged so far
+	unsigned int m_avgIndex;  //!< moving average: position of the oldest spectrum in history
+	HoldMode m_holdMode;
+	bool m_holdInit;          //!< hold spectrum has been initialized
+	int m_maxFrameRate;
+	QElapsedTimer m_frameTimer;
+
 	GLSpectrum* m_glSpectrum;
 
 	QMutex m_mutex;
 
 	void handleConfigure(int fftSize, int overlapPercent, FFTWindow::Function window);
+	void handleConfigureAveraging(AvgMode avgMode, int avgNb, HoldMode holdMode, int maxFrameRate);
+	void resetAveraging();
+	void processPowerSpectrum(); //!< average, hold and send to display from m_powerSpectrum
 };
 
 #endif // INCLUDE_SPECTRUMVIS_H
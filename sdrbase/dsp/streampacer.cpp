@@ -0,0 +1,73 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include "dsp/streampacer.h"
+
+StreamPacer::StreamPacer() :
+    m_tickMs(50),
+    m_sampleRate(0),
+    m_outputCount(0)
+{
+    m_elapsedTimer.start();
+}
+
+void StreamPacer::start()
+{
+    m_elapsedTimer.start();
+    m_outputCount = 0;
+}
+
+int StreamPacer::getNbOutputSamples(int sampleRate)
+{
+    if (sampleRate != m_sampleRate)
+    {
+        if (m_sampleRate > 0) // carry on at the new rate
+        {
+            m_outputCount = (m_outputCount * sampleRate) / m_sampleRate;
+        }
+        else // start over
+        {
+            m_outputCount = 0;
+            m_elapsedTimer.start();
+        }
+
+        m_sampleRate = sampleRate;
+    }
+
+    qint64 nbDueSamples = (qint64) ((m_elapsedTimer.nsecsElapsed() * 1e-9) * sampleRate);
+    qint64 nbOutputSamples = nbDueSamples - m_outputCount;
+
+    if (nbOutputSamples > ((qint64) sampleRate * 5 * m_tickMs) / 1000) // ticks were missed: do not catch up
+    {
+        m_outputCount = 0;
+        m_elapsedTimer.start();
+        return (int) (((qint64) sampleRate * m_tickMs) / 1000);
+    }
+
+    m_outputCount = nbDueSamples;
+    return (int) nbOutputSamples;
+}
+
+const qint16 *StreamPacer::resample(const qint16 *in, int nbIn, int nbOut)
+{
+    if (m_resampled.size() < 2 * (unsigned int) nbOut) {
+        m_resampled.resize(2 * nbOut);
+    }
+
+    m_resampler.resample(in, nbIn, &m_resampled[0], nbOut);
+    return &m_resampled[0];
+}
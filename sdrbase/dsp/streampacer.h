@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_DSP_STREAMPACER_H_
+#define SDRBASE_DSP_STREAMPACER_H_
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+#include <vector>
+
+#include "dsp/driftresampler.h"
+#include "util/export.h"
+
+/**
+ * Paces the output of a sample stream received from a remote sender at its nominal sample rate
+ * in local time. It is meant to be called on a periodic timer. Each call gives the number of
+ * samples due since the previous one from a local elapsed time so that the timer jitter does not
+ * accumulate. When ticks were missed it outputs one tick worth of samples and restarts instead of
+ * catching up. A DriftResampler then takes as many input samples as the stream clock requires for
+ * these output samples.
+ *
+ * On each tick: getNbOutputSamples() then getNbInputSamples() to know how many samples to read
+ * from the buffer and resample() with the samples read.
+ */
+class SDRANGEL_API StreamPacer
+{
+public:
+    StreamPacer();
+
+    void start();                                       //!< restarts the local clock
+    void setTickMs(int tickMs) { m_tickMs = tickMs; }   //!< period of the calls
+    void setRatio(double ratio) { m_resampler.setRatio(ratio); } //!< input samples consumed per output sample
+
+    /** Number of I/Q samples due at sampleRate since the last call. A rate change carries on at the new rate */
+    int getNbOutputSamples(int sampleRate);
+    /** Number of I/Q samples to be given to resample() to produce nbOutputSamples */
+    int getNbInputSamples(int nbOutputSamples) const { return m_resampler.getNbInputSamples(nbOutputSamples); }
+    /** Resamples nbIn I/Q samples of in to nbOut I/Q samples. Returns the output valid until the next call */
+    const qint16 *resample(const qint16 *in, int nbIn, int nbOut);
+
+private:
+    QElapsedTimer m_elapsedTimer;     //!< local clock of the samples output
+    int m_tickMs;
+    int m_sampleRate;
+    qint64 m_outputCount;             //!< samples output since the start of m_elapsedTimer
+    DriftResampler m_resampler;
+    std::vector<qint16> m_resampled;
+};
+
+#endif /* SDRBASE_DSP_STREAMPACER_H_ */
@@ -9,6 +9,7 @@ ThreadedBasebandSampleSinkFifo::ThreadedBasebandSampleSinkFifo(BasebandSampleSin
 	m_sampleSink(sampleSink)
 {
 	connect(&m_sampleFifo, SIGNAL(dataReady()), this, SLOT(handleFifoData()));
+	connect(this, SIGNAL(blockRefQueued()), this, SLOT(handleBlockRefs()), Qt::QueuedConnection);
 	m_sampleFifo.setSize(size);
 }
 
@@ -22,11 +23,54 @@ void ThreadedBasebandSampleSinkFifo::writeToFifo(SampleVector::const_iterator& b
 	m_sampleFifo.write(begin, end);
 }
 
+void ThreadedBasebandSampleSinkFifo::queueBlockRef(const SampleSinkDispatcher::BlockRef& blockRef)
+{
+	m_blockRefsMutex.lock();
+	m_blockRefs.enqueue(blockRef);
+	m_blockRefsMutex.unlock();
+	emit blockRefQueued();
+}
+
+void ThreadedBasebandSampleSinkFifo::handleBlockRefs()
+{
+	// samples written to the FIFO before parallel dispatch was enabled come first
+	feedFifoData(false);
+
+	m_blockRefsMutex.lock();
+
+	while (!m_blockRefs.isEmpty())
+	{
+		SampleSinkDispatcher::BlockRef blockRef = m_blockRefs.dequeue();
+		m_blockRefsMutex.unlock();
+
+		if (m_sampleSink != NULL)
+		{
+			if (blockRef.m_part1Begin != blockRef.m_part1End) {
+				m_sampleSink->feed(blockRef.m_part1Begin, blockRef.m_part1End, blockRef.m_positiveOnly);
+			}
+
+			if (blockRef.m_part2Begin != blockRef.m_part2End) {
+				m_sampleSink->feed(blockRef.m_part2Begin, blockRef.m_part2End, blockRef.m_positiveOnly);
+			}
+		}
+
+		blockRef.release(); // the source engine may commit its FIFO once all sinks have released the block
+		m_blockRefsMutex.lock();
+	}
+
+	m_blockRefsMutex.unlock();
+}
+
 void ThreadedBasebandSampleSinkFifo::handleFifoData() // FIXME: Fixed? Move it to the new threadable sink class
+{
+	feedFifoData(true);
+}
+
+void ThreadedBasebandSampleSinkFifo::feedFifoData(bool yieldToMessages)
 {
 	bool positiveOnly = false;
 
-	while ((m_sampleFifo.fill() > 0) && (m_sampleSink->getInputMessageQueue()->size() == 0))
+	while ((m_sampleFifo.fill() > 0) && (!yieldToMessages || (m_sampleSink->getInputMessageQueue()->size() == 0)))
 	{
 		SampleVector::iterator part1begin;
 		SampleVector::iterator part1end;
@@ -111,6 +155,16 @@ void ThreadedBasebandSampleSink::feed(SampleVector::const_iterator begin, Sample
 	m_threadedBasebandSampleSinkFifo->writeToFifo(begin, end);
 }
 
+void ThreadedBasebandSampleSink::feed(const SampleSinkDispatcher::BlockRef& blockRef)
+{
+	m_threadedBasebandSampleSinkFifo->queueBlockRef(blockRef);
+}
+
+bool ThreadedBasebandSampleSink::isRunning() const
+{
+	return m_thread->isRunning();
+}
+
 bool ThreadedBasebandSampleSink::handleSinkMessage(const Message& cmd)
 {
 	return m_basebandSampleSink->handleMessage(cmd);
@@ -20,8 +20,10 @@
 
 #include <dsp/basebandsamplesink.h>
 #include <QMutex>
+#include <QQueue>
 
 #include "samplesinkfifo.h"
+#include "samplesinkdispatcher.h"
 #include "util/messagequeue.h"
 #include "util/export.h"
 
@@ -39,12 +41,21 @@ public:
 	ThreadedBasebandSampleSinkFifo(BasebandSampleSink* sampleSink, std::size_t size = 1<<18);
 	~ThreadedBasebandSampleSinkFifo();
 	void writeToFifo(SampleVector::const_iterator& begin, SampleVector::const_iterator& end);
+	void queueBlockRef(const SampleSinkDispatcher::BlockRef& blockRef); //!< the sink thread will feed the shared block and release it
 
 	BasebandSampleSink* m_sampleSink;
 	SampleSinkFifo m_sampleFifo;
+	QMutex m_blockRefsMutex;
+	QQueue<SampleSinkDispatcher::BlockRef> m_blockRefs; //!< shared blocks waiting for the sink thread
+
+	void feedFifoData(bool yieldToMessages);
+
+signals:
+	void blockRefQueued();
 
 public slots:
 	void handleFifoData();
+	void handleBlockRefs();
 };
 
 /**
@@ -66,6 +77,8 @@ public:
 
 	bool handleSinkMessage(const Message& cmd); //!< Send message to sink synchronously
 	void feed(SampleVector::const_iterator begin, SampleVector::const_iterator end, bool positiveOnly); //!< Feed sink with samples
+	void feed(const SampleSinkDispatcher::BlockRef& blockRef); //!< Feed sink with a block shared with other sinks from this thread without a copy
+	bool isRunning() const; //!< true when this thread can process the samples
 
 	QString getSampleSinkObjectName() const;
 
@@ -38,6 +38,7 @@ public:
 	~ThreadedBasebandSampleSource();
 
 	const BasebandSampleSource *getSource() const { return m_basebandSampleSource; }
+	BasebandSampleSource *getSource() { return m_basebandSampleSource; }
 	MessageQueue* getInputMessageQueue() { return m_basebandSampleSource->getInputMessageQueue(); }   //!< Return pointer to sample source's input message queue
 	MessageQueue* getOutputMessageQueue() { return m_basebandSampleSource->getOutputMessageQueue(); } //!< Return pointer to sample source's output message queue
 
@@ -46,6 +47,7 @@ public:
 
 	bool handleSourceMessage(const Message& cmd);  //!< Send message to source synchronously
 	void pull(Sample& sample);                     //!< Pull one sample from source
+	void pullBlock(SampleVector::iterator begin, unsigned int nbSamples) { m_basebandSampleSource->pullBlock(begin, nbSamples); } //!< Pull nbSamples samples from source
 	void pullAudio(int nbSamples) { if (m_basebandSampleSource) m_basebandSampleSource->pullAudio(nbSamples); }
 
     /** direct feeding of sample source FIFO */
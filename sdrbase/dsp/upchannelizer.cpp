@@ -102,6 +102,66 @@ void UpChannelizer::pull(Sample& sample)
     }
 }
 
+void UpChannelizer::pullBlock(SampleVector::iterator begin, unsigned int nbSamples)
+{
+    if (m_sampleSource == 0) {
+        return;
+    }
+
+    if (m_filterStages.size() == 0) // optimization when no downsampling is done anyway
+    {
+        m_sampleSource->pullBlock(begin, nbSamples);
+        return;
+    }
+
+    m_mutex.lock();
+
+    unsigned int nbStages = m_filterStages.size();
+
+    if (m_stageBuffers.size() != nbStages)
+    {
+        m_stageBuffers.resize(nbStages);
+        m_stageNbSamples.resize(nbStages + 1);
+    }
+
+    // from the outer stage size the work of each stage. Its input is the output of the next stage.
+    m_stageNbSamples[0] = nbSamples;
+
+    for (unsigned int i = 0; i < nbStages; i++)
+    {
+        m_stageNbSamples[i+1] = m_filterStages[i]->nbSamplesIn(m_stageNbSamples[i]);
+
+        if (m_stageBuffers[i].size() < m_stageNbSamples[i+1] + 1) {
+            m_stageBuffers[i].resize(m_stageNbSamples[i+1] + 1);
+        }
+    }
+
+    // then run the stages from the inner one. This is the same sequence of operations as in pull()
+    // where m_sampleIn and m_stageSamples hold the samples pending consumption by each stage
+    for (int i = nbStages - 1; i >= 0; i--)
+    {
+        SampleVector& samplesIn = m_stageBuffers[i];
+        unsigned int nbSamplesIn = m_stageNbSamples[i+1];
+        Sample& pending = (i == (int) nbStages - 1) ? m_sampleIn : m_stageSamples[i+1];
+
+        samplesIn[0] = pending;
+
+        if ((i == (int) nbStages - 1) && (nbSamplesIn > 0)) {
+            m_sampleSource->pullBlock(samplesIn.begin() + 1, nbSamplesIn); // get new input samples
+        }
+
+        Sample *samplesOut = (i == 0) ? &(*begin) : &m_stageBuffers[i-1][1];
+        m_filterStages[i]->workBlock(&samplesIn[0], samplesOut, m_stageNbSamples[i]);
+        pending = samplesIn[nbSamplesIn];
+    }
+
+    if (nbSamples > 0) {
+        m_stageSamples[0] = *(begin + nbSamples - 1);
+    }
+
+    m_mutex.unlock();
+}
+
 void UpChannelizer::start()
 {
     if (m_sampleSource != 0)
@@ -201,49 +261,38 @@ void UpChannelizer::applyConfiguration()
     }
 }
 
-#ifdef USE_SSE4_1
 UpChannelizer::FilterStage::FilterStage(Mode mode) :
-    m_filter(new IntHalfbandFilterEO1<UPCHANNELIZER_HB_FILTER_ORDER>),
-    m_workFunction(0)
+    m_ops(0),
+    m_filter(0),
+    m_workFunction(0),
+    m_blockWorkFunction(0)
 {
     switch(mode) {
         case ModeCenter:
-            m_workFunction = &IntHalfbandFilterEO1<UPCHANNELIZER_HB_FILTER_ORDER>::workInterpolateCenter;
+            m_ops = &HBFilterSelector::get(HBFilterSelector::UpChannelizerCenter);
+            m_workFunction = m_ops->m_interpolate[HBFilterOps::ModeCenter];
+            m_blockWorkFunction = m_ops->m_interpolateBlock[HBFilterOps::ModeCenter];
             break;
 
         case ModeLowerHalf:
-            m_workFunction = &IntHalfbandFilterEO1<UPCHANNELIZER_HB_FILTER_ORDER>::workInterpolateLowerHalf;
+            m_ops = &HBFilterSelector::get(HBFilterSelector::UpChannelizerLowerHalf);
+            m_workFunction = m_ops->m_interpolate[HBFilterOps::ModeLowerHalf];
+            m_blockWorkFunction = m_ops->m_interpolateBlock[HBFilterOps::ModeLowerHalf];
             break;
 
         case ModeUpperHalf:
-            m_workFunction = &IntHalfbandFilterEO1<UPCHANNELIZER_HB_FILTER_ORDER>::workInterpolateUpperHalf;
+            m_ops = &HBFilterSelector::get(HBFilterSelector::UpChannelizerUpperHalf);
+            m_workFunction = m_ops->m_interpolate[HBFilterOps::ModeUpperHalf];
+            m_blockWorkFunction = m_ops->m_interpolateBlock[HBFilterOps::ModeUpperHalf];
             break;
     }
-}
-#else
-UpChannelizer::FilterStage::FilterStage(Mode mode) :
-    m_filter(new IntHalfbandFilterDB<UPCHANNELIZER_HB_FILTER_ORDER>),
-    m_workFunction(0)
-{
-    switch(mode) {
-        case ModeCenter:
-            m_workFunction = &IntHalfbandFilterDB<UPCHANNELIZER_HB_FILTER_ORDER>::workInterpolateCenter;
-            break;
 
-        case ModeLowerHalf:
-            m_workFunction = &IntHalfbandFilterDB<UPCHANNELIZER_HB_FILTER_ORDER>::workInterpolateLowerHalf;
-            break;
-
-        case ModeUpperHalf:
-            m_workFunction = &IntHalfbandFilterDB<UPCHANNELIZER_HB_FILTER_ORDER>::workInterpolateUpperHalf;
-            break;
-    }
+    m_filter = (*m_ops->m_create)();
 }
-#endif
 
 UpChannelizer::FilterStage::~FilterStage()
 {
-    delete m_filter;
+    (*m_ops->m_destroy)(m_filter);
 }
 
 bool UpChannelizer::signalContainsChannel(Real sigStart, Real sigEnd, Real chanStart, Real chanEnd) const
@@ -323,6 +372,7 @@ void UpChannelizer::freeFilterChain()
         delete *it;
     m_filterStages.clear();
     m_stageSamples.clear();
+    m_stageBuffers.clear();
 }
 
 
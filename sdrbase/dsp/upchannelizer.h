@@ -23,11 +23,7 @@
 #include <QMutex>
 #include "util/export.h"
 #include "util/message.h"
-#ifdef USE_SSE4_1
-#include "dsp/inthalfbandfiltereo1.h"
-#else
-#include "dsp/inthalfbandfilterdb.h"
-#endif
+#include "dsp/hbfilterselector.h"
 
 #define UPCHANNELIZER_HB_FILTER_ORDER 96
 
@@ -63,6 +59,7 @@ public:
     virtual void start();
     virtual void stop();
     virtual void pull(Sample& sample);
+    virtual void pullBlock(SampleVector::iterator begin, unsigned int nbSamples);
     virtual void pullAudio(int nbSamples) { if (m_sampleSource) m_sampleSource->pullAudio(nbSamples); }
 
     virtual bool handleMessage(const Message& cmd);
@@ -75,26 +72,37 @@ protected:
             ModeUpperHalf
         };
 
-#ifdef USE_SSE4_1
-        typedef bool (IntHalfbandFilterEO1<UPCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(Sample* sIn, Sample *sOut);
-        IntHalfbandFilterEO1<UPCHANNELIZER_HB_FILTER_ORDER>* m_filter;
-#else
-        typedef bool (IntHalfbandFilterDB<UPCHANNELIZER_HB_FILTER_ORDER>::*WorkFunction)(Sample* sIn, Sample *sOut);
-        IntHalfbandFilterDB<UPCHANNELIZER_HB_FILTER_ORDER>* m_filter;
-#endif
-        WorkFunction m_workFunction;
+        const HBFilterOps* m_ops; //!< half band filter class selected for the mode
+        void* m_filter;
+        HBFilterOps::InterpolateFunction m_workFunction;
+        HBFilterOps::InterpolateBlockFunction m_blockWorkFunction; //!< mode specialized block interpolator bound at construction
 
         FilterStage(Mode mode);
         ~FilterStage();
 
         bool work(Sample* sampleIn, Sample *sampleOut)
         {
-            return (m_filter->*m_workFunction)(sampleIn, sampleOut);
+            return (*m_workFunction)(m_filter, sampleIn, sampleOut);
+        }
+
+        /** Number of input samples consumed to produce the next nbSamplesOut samples. Every other output consumes one input */
+        unsigned int nbSamplesIn(unsigned int nbSamplesOut) const
+        {
+            unsigned int state = (*m_ops->m_getState)(m_filter);
+            return (state + nbSamplesOut) / 2 - state / 2;
+        }
+
+        /** Produce nbSamplesOut samples consuming nbSamplesIn(nbSamplesOut) samples from samplesIn */
+        void workBlock(Sample* samplesIn, Sample* samplesOut, unsigned int nbSamplesOut)
+        {
+            (*m_blockWorkFunction)(m_filter, samplesIn, samplesOut, nbSamplesOut);
         }
     };
     typedef std::vector<FilterStage*> FilterStages;
     FilterStages m_filterStages;
     std::vector<Sample> m_stageSamples;
+    std::vector<SampleVector> m_stageBuffers;   //!< block mode: input samples of each stage. First one is the sample still pending from the previous call
+    std::vector<unsigned int> m_stageNbSamples; //!< block mode: number of output samples of each stage. The last one is the number of samples pulled from the modulator
     BasebandSampleSource* m_sampleSource; //!< Modulator
     int m_outputSampleRate;
     int m_requestedInputSampleRate;
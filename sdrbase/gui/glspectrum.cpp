@@ -38,6 +38,8 @@ GLSpectrum::GLSpectrum(QWidget* parent) :
 	m_decay(0),
 	m_sampleRate(500000),
 	m_fftSize(512),
+	m_displaySize(0),
+	m_binReduction(SpectrumSIMD::ReductionMax),
 	m_displayGrid(true),
 	m_displayGridIntensity(5),
 	m_displayTraceIntensity(50),
@@ -52,6 +54,8 @@ GLSpectrum::GLSpectrum(QWidget* parent) :
 	m_histogramBuffer(NULL),
 	m_histogram(NULL),
 	m_histogramHoldoff(NULL),
+	m_histogramLowest(NULL),
+	m_histogramHighest(NULL),
 	m_displayHistogram(true),
 	m_displayChanged(false),
 	m_colorLoc(0),
@@ -138,6 +142,14 @@ GLSpectrum::~GLSpectrum()
 		delete[] m_histogramHoldoff;
 		m_histogramHoldoff = NULL;
 	}
+	if(m_histogramLowest != NULL) {
+		delete[] m_histogramLowest;
+		m_histogramLowest = NULL;
+	}
+	if(m_histogramHighest != NULL) {
+		delete[] m_histogramHighest;
+		m_histogramHighest = NULL;
+	}
 }
 
 void GLSpectrum::setCenterFrequency(quint64 frequency)
@@ -269,6 +281,11 @@ void GLSpectrum::setDisplayTraceIntensity(int intensity)
 	update();
 }
 
+void GLSpectrum::setBinReduction(SpectrumSIMD::Reduction reduction)
+{
+	m_binReduction = reduction;
+}
+
 void GLSpectrum::addChannelMarker(ChannelMarker* channelMarker)
 {
 	QMutexLocker mutexLocker(&m_mutex);
@@ -314,8 +331,15 @@ void GLSpectrum::newSpectrum(const std::vector<Real>& spectrum, int fftSize)
 		return;
 	}
 
-	updateWaterfall(spectrum);
-	updateHistogram(spectrum);
+	if(m_displaySize < m_fftSize) {
+		// more bins than pixels: combine the bins of each pixel column before display
+		SpectrumSIMD::reduce(&spectrum[0], m_fftSize, &m_reducedSpectrum[0], m_displaySize, m_binReduction);
+		updateWaterfall(m_reducedSpectrum);
+		updateHistogram(m_reducedSpectrum);
+	} else {
+		updateWaterfall(spectrum);
+		updateHistogram(spectrum);
+	}
 }
 
 void GLSpectrum::updateWaterfall(const std::vector<Real>& spectrum)
@@ -323,7 +347,7 @@ void GLSpectrum::updateWaterfall(const std::vector<Real>& spectrum)
 	if(m_waterfallBufferPos < m_waterfallBuffer->height()) {
 		quint32* pix = (quint32*)m_waterfallBuffer->scanLine(m_waterfallBufferPos);
 
-		for(int i = 0; i < m_fftSize; i++) {
+		for(int i = 0; i < m_displaySize; i++) {
 			int v = (int)((spectrum[i] - m_referenceLevel) * 2.4 * 100.0 / m_powerRange + 240.0);
 			if(v > 239)
 				v = 239;
@@ -342,7 +366,6 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
 	quint8* b = m_histogram;
 	quint8* h = m_histogramHoldoff;
 	int sub = 1;
-	int fftMulSize = 100 * m_fftSize;
 
 	if(m_decay > 0)
 		sub += m_decay;
@@ -353,31 +376,54 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
 
 		if(m_histogramHoldoffCount <= 0)
 		{
-			for(int i = 0; i < fftMulSize; i++)
+			// decay only the range of non zero cells of each column as zero cells do not change
+			for(int x = 0; x < m_displaySize; x++)
 			{
-				if((*b>>4) > 0) // *b > 16
-				{
-					*b = *b - sub;
-				}
-				else if(*b > 0)
+				int lowest = m_histogramLowest[x];
+				int highest = m_histogramHighest[x];
+				quint8* column = m_histogram + x * 100;
+				b = column + lowest;
+				h = m_histogramHoldoff + x * 100 + lowest;
+
+				for(int y = lowest; y <= highest; y++)
 				{
-					if(*h >= sub)
-					{
-						*h = *h - sub;
-					}
-					else if(*h > 0)
+					if((*b>>4) > 0) // *b > 16
 					{
-						*h = *h - 1;
+						*b = *b - sub;
 					}
-					else
+					else if(*b > 0)
 					{
-						*b = *b - 1;
-						*h = m_histogramLateHoldoff;
+						if(*h >= sub)
+						{
+							*h = *h - sub;
+						}
+						else if(*h > 0)
+						{
+							*h = *h - 1;
+						}
+						else
+						{
+							*b = *b - 1;
+							*h = m_histogramLateHoldoff;
+						}
 					}
+
+					b++;
+					h++;
 				}
 
-				b++;
-				h++;
+				while((lowest <= highest) && (column[lowest] == 0))
+					lowest++;
+				while((highest >= lowest) && (column[highest] == 0))
+					highest--;
+
+				if(lowest > highest) { // empty
+					lowest = 100;
+					highest = 0;
+				}
+
+				m_histogramLowest[x] = lowest;
+				m_histogramHighest[x] = highest;
 			}
 
 			m_histogramHoldoffCount = m_histogramHoldoffBase;
@@ -392,7 +438,7 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
         const __m128 power = {m_powerRange, m_powerRange, m_powerRange, m_powerRange};
         const __m128 mul = {100.0f, 100.0f, 100.0f, 100.0f};
 
-        for(int i = 0; i < m_fftSize; i += 4) {
+        for(int i = 0; i < m_displaySize; i += 4) {
             __m128 abc = _mm_loadu_ps (&spectrum[i]);
             abc = _mm_sub_ps(abc, refl);
             abc = _mm_mul_ps(abc, mul);
@@ -400,7 +446,7 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
             abc =  _mm_add_ps(abc, mul);
             __m128i result = _mm_cvtps_epi32(abc);
 
-            for(int j = 0; j < 4; j++) {
+            for(int j = 0; (j < 4) && (i + j < m_displaySize); j++) {
                 int v = ((int*)&result)[j];
                 if((v >= 0) && (v <= 99)) {
                     b = m_histogram + (i + j) * 100 + v;
@@ -408,6 +454,7 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
                         *b += m_histogramStroke; // was 4
                     else if(*b < 239)
                         *b += 1;
+                    extendHistogramRange(i + j, v, v);
                 }
             }
         }
@@ -417,7 +464,7 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
         const __m128 power = {m_powerRange, m_powerRange, m_powerRange, m_powerRange};
         const __m128 mul = {100.0f, 100.0f, 100.0f, 100.0f};
 
-        for(int i = 0; i < m_fftSize; i += 4) {
+        for(int i = 0; i < m_displaySize; i += 4) {
             __m128 abc = _mm_loadu_ps (&spectrum[i]);
             abc = _mm_sub_ps(abc, refl);
             abc = _mm_mul_ps(abc, mul);
@@ -425,7 +472,7 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
             abc =  _mm_add_ps(abc, mul);
             __m128i result = _mm_cvtps_epi32(abc);
 
-            for(int j = 0; j < 4; j++) {
+            for(int j = 0; (j < 4) && (i + j < m_displaySize); j++) {
                 int v = ((int*)&result)[j];
                 if((v >= 1) && (v <= 98)) {
                     b = m_histogram + (i + j) * 100 + v;
@@ -441,18 +488,20 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
                         b[1] += add;
                     else if(b[1] < 239)
                         b[1] += 1;
+                    extendHistogramRange(i + j, v - 1, v + 1);
                 } else if((v >= 0) && (v <= 99)) {
                     b = m_histogram + (i + j) * 100 + v;
                     if(*b < 220)
                         *b += add;
                     else if(*b < 239)
                         *b += 1;
+                    extendHistogramRange(i + j, v, v);
                 }
             }
         }
     }
 #else
-    for(int i = 0; i < m_fftSize; i++) {
+    for(int i = 0; i < m_displaySize; i++) {
         int v = (int)((spectrum[i] - m_referenceLevel) * 100.0 / m_powerRange + 100.0);
 
         if ((v >= 0) && (v <= 99)) {
@@ -461,6 +510,7 @@ void GLSpectrum::updateHistogram(const std::vector<Real>& spectrum)
                 *b += m_histogramStroke; // was 4
             else if(*b < 239)
                 *b += 1;
+            extendHistogramRange(i, v, v);
         }
     }
 #endif
@@ -510,8 +560,10 @@ void GLSpectrum::clearSpectrumHistogram()
 	if(!m_mutex.tryLock(2))
 		return;
 
-	memset(m_histogram, 0x00, 100 * m_fftSize);
-	memset(m_histogramHoldoff, 0x07, 100 * m_fftSize);
+	memset(m_histogram, 0x00, 100 * m_displaySize);
+	memset(m_histogramHoldoff, 0x07, 100 * m_displaySize);
+	memset(m_histogramLowest, 100, m_displaySize);
+	memset(m_histogramHighest, 0, m_displaySize);
 
 	m_mutex.unlock();
 	update();
@@ -548,15 +600,15 @@ void GLSpectrum::paintGL()
 
 			if (m_waterfallTexturePos + m_waterfallBufferPos < m_waterfallTextureHeight)
 			{
-				m_glShaderWaterfall.subTexture(0, m_waterfallTexturePos, m_fftSize, m_waterfallBufferPos,  m_waterfallBuffer->scanLine(0));
+				m_glShaderWaterfall.subTexture(0, m_waterfallTexturePos, m_displaySize, m_waterfallBufferPos,  m_waterfallBuffer->scanLine(0));
 				m_waterfallTexturePos += m_waterfallBufferPos;
 			}
 			else
 			{
 				int breakLine = m_waterfallTextureHeight - m_waterfallTexturePos;
 				int linesLeft = m_waterfallTexturePos + m_waterfallBufferPos - m_waterfallTextureHeight;
-				m_glShaderWaterfall.subTexture(0, m_waterfallTexturePos, m_fftSize, breakLine,  m_waterfallBuffer->scanLine(0));
-				m_glShaderWaterfall.subTexture(0, 0, m_fftSize, linesLeft,  m_waterfallBuffer->scanLine(breakLine));
+				m_glShaderWaterfall.subTexture(0, m_waterfallTexturePos, m_displaySize, breakLine,  m_waterfallBuffer->scanLine(0));
+				m_glShaderWaterfall.subTexture(0, 0, m_displaySize, linesLeft,  m_waterfallBuffer->scanLine(breakLine));
 				m_waterfallTexturePos = linesLeft;
 			}
 
@@ -633,7 +685,7 @@ void GLSpectrum::paintGL()
 					quint8* b = bs;
 					pix = (quint32*)m_histogramBuffer->scanLine(99 - y);
 
-					for (int x = 0; x < m_fftSize; x++)
+					for (int x = 0; x < m_displaySize; x++)
 					{
 						*pix = m_histogramPalette[*b];
 						pix++;
@@ -656,7 +708,7 @@ void GLSpectrum::paintGL()
 			    		0, 1
 			    };
 
-				m_glShaderHistogram.subTexture(0, 0, m_fftSize, 100,  m_histogramBuffer->scanLine(0));
+				m_glShaderHistogram.subTexture(0, 0, m_displaySize, 100,  m_histogramBuffer->scanLine(0));
 				m_glShaderHistogram.drawSurface(m_glHistogramBoxMatrix, tex1, vtx1, 4);
 			}
 		}
@@ -789,37 +841,33 @@ void GLSpectrum::paintGL()
 	// paint max hold lines on top of histogram
 	if (m_displayMaxHold)
 	{
-		if (m_maxHold.size() < (uint)m_fftSize)
-			m_maxHold.resize(m_fftSize);
+		if (m_maxHold.size() < (uint)m_displaySize)
+			m_maxHold.resize(m_displaySize);
 
-		for(int i = 0; i < m_fftSize; i++)
+		for(int i = 0; i < m_displaySize; i++)
 		{
-			int j;
-			quint8* bs = m_histogram + i * 100;
-			for(j = 99; j > 1; j--) {
-				if(bs[j] > 0)
-					break;
-			}
-			// TODO: ((bs[j] * (float)j) + (bs[j + 1] * (float)(j + 1))) / (bs[j] +  bs[j + 1])
+			// highest non zero cell above 1 else 1
+			int j = m_histogramHighest[i] > 1 ? m_histogramHighest[i] : 1;
 			j = j - 99;
 			m_maxHold[i] = (j * m_powerRange) / 99.0 + m_referenceLevel;
 		}
 		{
-			GLfloat q3[2*m_fftSize];
+			GLfloat q3[2*m_displaySize];
 			Real bottom = -m_powerRange;
+			Real binsPerColumn = m_displaySize > 1 ? (m_fftSize - 1) / (Real) (m_displaySize - 1) : 1.0f;
 
-			for(int i = 0; i < m_fftSize; i++) {
+			for(int i = 0; i < m_displaySize; i++) {
 				Real v = m_maxHold[i] - m_referenceLevel;
 				if(v > 0)
 					v = 0;
 				else if(v < bottom)
 					v = bottom;
-				q3[2*i] = (Real) i;
+				q3[2*i] = (Real) i * binsPerColumn;
 				q3[2*i+1] = v;
 			}
 
 			QVector4D color(1.0f, 0.0f, 0.0f, (float) m_displayTraceIntensity / 100.0f);
-			m_glShaderSimple.drawPolyline(m_glHistogramSpectrumMatrix, color, q3, m_fftSize);
+			m_glShaderSimple.drawPolyline(m_glHistogramSpectrumMatrix, color, q3, m_displaySize);
 		}
 	}
 
@@ -828,20 +876,21 @@ void GLSpectrum::paintGL()
 	{
 		{
 			Real bottom = -m_powerRange;
-			GLfloat q3[2*m_fftSize];
+			GLfloat q3[2*m_displaySize];
+			Real binsPerColumn = m_displaySize > 1 ? (m_fftSize - 1) / (Real) (m_displaySize - 1) : 1.0f;
 
-			for(int i = 0; i < m_fftSize; i++) {
+			for(int i = 0; i < m_displaySize; i++) {
 				Real v = (*m_currentSpectrum)[i] - m_referenceLevel;
 				if(v > 0)
 					v = 0;
 				else if(v < bottom)
 					v = bottom;
-				q3[2*i] = (Real) i;
+				q3[2*i] = (Real) i * binsPerColumn;
 				q3[2*i+1] = v;
 			}
 
 			QVector4D color(1.0f, 1.0f, 0.25f, (float) m_displayTraceIntensity / 100.0f);
-			m_glShaderSimple.drawPolyline(m_glHistogramSpectrumMatrix, color, q3, m_fftSize);
+			m_glShaderSimple.drawPolyline(m_glHistogramSpectrumMatrix, color, q3, m_displaySize);
 		}
 	}
 
@@ -1479,21 +1528,28 @@ void GLSpectrum::applyChanges()
 		m_glShaderFrequencyScale.initTexture(m_frequencyPixmap.toImage());
 	}
 
-	bool fftSizeChanged = true;
+	// at most one column per pixel of the plot area. This keeps the textures within the maximum
+	// texture size of software renderers like llvmpipe for the largest FFT sizes.
+	int plotWidth = width() - leftMargin - rightMargin;
+	int displaySize = (plotWidth > 0) && (plotWidth < m_fftSize) ? plotWidth : m_fftSize;
+	bool displaySizeChanged = true;
 
 	if(m_waterfallBuffer != NULL) {
-		fftSizeChanged = m_waterfallBuffer->width() != m_fftSize;
+		displaySizeChanged = m_waterfallBuffer->width() != displaySize;
 	}
 
+	m_displaySize = displaySize;
+	m_reducedSpectrum.resize((m_displaySize + 3) & ~3); // whole SSE2 vectors in updateHistogram
+
 	bool windowSizeChanged = m_waterfallTextureHeight != waterfallHeight;
 
-	if (fftSizeChanged || windowSizeChanged)
+	if (displaySizeChanged || windowSizeChanged)
 	{
 		if(m_waterfallBuffer != 0) {
 			delete m_waterfallBuffer;
 		}
 
-		m_waterfallBuffer = new QImage(m_fftSize, waterfallHeight, QImage::Format_ARGB32);
+		m_waterfallBuffer = new QImage(m_displaySize, waterfallHeight, QImage::Format_ARGB32);
 
 		if(m_waterfallBuffer != 0)
 		{
@@ -1509,7 +1565,7 @@ void GLSpectrum::applyChanges()
 		}
 	}
 
-	if(fftSizeChanged)
+	if(displaySizeChanged)
 	{
 		if(m_histogramBuffer != NULL) {
 			delete m_histogramBuffer;
@@ -1523,8 +1579,16 @@ void GLSpectrum::applyChanges()
 			delete[] m_histogramHoldoff;
 			m_histogramHoldoff = NULL;
 		}
+		if(m_histogramLowest != NULL) {
+			delete[] m_histogramLowest;
+			m_histogramLowest = NULL;
+		}
+		if(m_histogramHighest != NULL) {
+			delete[] m_histogramHighest;
+			m_histogramHighest = NULL;
+		}
 
-		m_histogramBuffer = new QImage(m_fftSize, 100, QImage::Format_RGB32);
+		m_histogramBuffer = new QImage(m_displaySize, 100, QImage::Format_RGB32);
 
 		if(m_histogramBuffer != NULL)
 		{
@@ -1538,13 +1602,17 @@ void GLSpectrum::applyChanges()
 			return;
 		}
 
-		m_histogram = new quint8[100 * m_fftSize];
-		memset(m_histogram, 0x00, 100 * m_fftSize);
-		m_histogramHoldoff = new quint8[100 * m_fftSize];
-		memset(m_histogramHoldoff, 0x07, 100 * m_fftSize);
+		m_histogram = new quint8[100 * m_displaySize];
+		memset(m_histogram, 0x00, 100 * m_displaySize);
+		m_histogramHoldoff = new quint8[100 * m_displaySize];
+		memset(m_histogramHoldoff, 0x07, 100 * m_displaySize);
+		m_histogramLowest = new quint8[m_displaySize];
+		memset(m_histogramLowest, 100, m_displaySize);
+		m_histogramHighest = new quint8[m_displaySize];
+		memset(m_histogramHighest, 0, m_displaySize);
 	}
 
-	if(fftSizeChanged || windowSizeChanged)
+	if(displaySizeChanged || windowSizeChanged)
 	{
 		m_waterfallTextureHeight = waterfallHeight;
 		m_waterfallTexturePos = 0;
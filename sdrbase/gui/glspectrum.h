@@ -28,6 +28,7 @@
 #include <QMatrix4x4>
 #include <QGLWidget>
 #include "dsp/dsptypes.h"
+#include "dsp/spectrumsimd.h"
 #include "gui/scaleengine.h"
 #include "gui/glshadersimple.h"
 #include "gui/glshadertextured.h"
@@ -59,6 +60,7 @@ public:
 	void setDisplayGrid(bool display);
 	void setDisplayGridIntensity(int intensity);
 	void setDisplayTraceIntensity(int intensity);
+	void setBinReduction(SpectrumSIMD::Reduction reduction);
 
 	void addChannelMarker(ChannelMarker* channelMarker);
 	void removeChannelMarker(ChannelMarker* channelMarker);
@@ -110,6 +112,9 @@ private:
 	quint32 m_sampleRate;
 
 	int m_fftSize;
+	int m_displaySize; //!< number of columns of waterfall, histogram and traces: FFT size reduced to at most one bin per pixel
+	SpectrumSIMD::Reduction m_binReduction;
+	std::vector<Real> m_reducedSpectrum;
 
 	bool m_displayGrid;
 	int m_displayGridIntensity;
@@ -145,6 +150,8 @@ private:
 	QImage* m_histogramBuffer;
 	quint8* m_histogram;
 	quint8* m_histogramHoldoff;
+	quint8* m_histogramLowest;  //!< per column lowest non zero histogram cell (100 if none)
+	quint8* m_histogramHighest; //!< per column highest non zero histogram cell (0 if none)
 	int m_histogramHoldoffBase;
 	int m_histogramHoldoffCount;
 	int m_histogramLateHoldoff;
@@ -168,6 +175,14 @@ private:
 	void updateWaterfall(const std::vector<Real>& spectrum);
 	void updateHistogram(const std::vector<Real>& spectrum);
 
+	void extendHistogramRange(int column, int low, int high)
+	{
+		if(low < m_histogramLowest[column])
+			m_histogramLowest[column] = low;
+		if(high > m_histogramHighest[column])
+			m_histogramHighest[column] = high;
+	}
+
 	void initializeGL();
 	void resizeGL(int width, int height);
 	void paintGL();
@@ -5,6 +5,11 @@
 #include "util/simpleserializer.h"
 #include "ui_glspectrumgui.h"
 
+static const int averagingNbs[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
+static const int nbAveragingNbs = sizeof(averagingNbs) / sizeof(averagingNbs[0]);
+static const int maxFrameRates[] = {0, 50, 25, 10, 5, 1}; // 0 is no limit
+static const int nbMaxFrameRates = sizeof(maxFrameRates) / sizeof(maxFrameRates[0]);
+
 GLSpectrumGUI::GLSpectrumGUI(QWidget* parent) :
 	QWidget(parent),
 	ui(new Ui::GLSpectrumGUI),
@@ -27,13 +32,32 @@ GLSpectrumGUI::GLSpectrumGUI(QWidget* parent) :
 	m_displayCurrent(false),
 	m_displayHistogram(false),
 	m_displayGrid(false),
-	m_invert(true)
+	m_invert(true),
+	m_averagingMode(SpectrumVis::AvgModeNone),
+	m_averagingNb(1),
+	m_holdMode(SpectrumVis::HoldModeNone),
+	m_maxFrameRate(0),
+	m_binReduction(SpectrumSIMD::ReductionMax)
 {
 	ui->setupUi(this);
 	for(int ref = 0; ref >= -110; ref -= 5)
 		ui->refLevel->addItem(QString("%1").arg(ref));
 	for(int range = 100; range >= 5; range -= 5)
 		ui->levelRange->addItem(QString("%1").arg(range));
+	ui->averagingMode->addItem("No avg"); // in SpectrumVis::AvgMode order
+	ui->averagingMode->addItem("Moving");
+	ui->averagingMode->addItem("Fixed");
+	ui->averagingMode->addItem("Exp");
+	for(int i = 0; i < nbAveragingNbs; i++)
+		ui->averaging->addItem(QString("%1").arg(averagingNbs[i]));
+	ui->hold->addItem("No hold"); // in SpectrumVis::HoldMode order
+	ui->hold->addItem("Max");
+	ui->hold->addItem("Min");
+	for(int i = 0; i < nbMaxFrameRates; i++)
+		ui->displayRate->addItem(maxFrameRates[i] == 0 ? QString("Max") : QString("%1").arg(maxFrameRates[i]));
+	ui->binReduction->addItem("Bin max"); // in SpectrumSIMD::Reduction order
+	ui->binReduction->addItem("Bin mean");
+	ui->binReduction->addItem("Bin min");
 }
 
 GLSpectrumGUI::~GLSpectrumGUI()
@@ -66,6 +90,11 @@ void GLSpectrumGUI::resetToDefaults()
 	m_displayHistogram = false;
 	m_displayGrid = false;
 	m_invert = true;
+	m_averagingMode = SpectrumVis::AvgModeNone;
+	m_averagingNb = 1;
+	m_holdMode = SpectrumVis::HoldModeNone;
+	m_maxFrameRate = 0;
+	m_binReduction = SpectrumSIMD::ReductionMax;
 	applySettings();
 }
 
@@ -90,6 +119,11 @@ QByteArray GLSpectrumGUI::serialize() const
 	s.writeBool(16, m_displayCurrent);
 	s.writeS32(17, m_displayTraceIntensity);
 	s.writeReal(18, m_glSpectrum->getWaterfallShare());
+	s.writeS32(19, m_averagingMode);
+	s.writeS32(20, m_averagingNb);
+	s.writeS32(21, m_holdMode);
+	s.writeS32(22, m_maxFrameRate);
+	s.writeS32(23, m_binReduction);
 	return s.final();
 }
 
@@ -122,6 +156,11 @@ bool GLSpectrumGUI::deserialize(const QByteArray& data)
 		d.readS32(17, &m_displayTraceIntensity, 50);
 		Real waterfallShare;
 		d.readReal(18, &waterfallShare, 0.66);
+		d.readS32(19, &m_averagingMode, SpectrumVis::AvgModeNone);
+		d.readS32(20, &m_averagingNb, 1);
+		d.readS32(21, &m_holdMode, SpectrumVis::HoldModeNone);
+		d.readS32(22, &m_maxFrameRate, 0);
+		d.readS32(23, &m_binReduction, SpectrumSIMD::ReductionMax);
 		m_glSpectrum->setWaterfallShare(waterfallShare);
 		applySettings();
 		return true;
@@ -152,6 +191,21 @@ void GLSpectrumGUI::applySettings()
 	ui->invert->setChecked(m_invert);
 	ui->grid->setChecked(m_displayGrid);
 	ui->gridIntensity->setSliderPosition(m_displayGridIntensity);
+	ui->averagingMode->setCurrentIndex(m_averagingMode);
+	ui->hold->setCurrentIndex(m_holdMode);
+	ui->binReduction->setCurrentIndex(m_binReduction);
+	for(int i = 0; i < nbAveragingNbs; i++) {
+		if(m_averagingNb == averagingNbs[i]) {
+			ui->averaging->setCurrentIndex(i);
+			break;
+		}
+	}
+	for(int i = 0; i < nbMaxFrameRates; i++) {
+		if(m_maxFrameRate == maxFrameRates[i]) {
+			ui->displayRate->setCurrentIndex(i);
+			break;
+		}
+	}
 
 	ui->decay->setToolTip(QString("Decay: %1").arg(m_decay));
 	ui->holdoff->setToolTip(QString("Holdoff: %1").arg(m_histogramLateHoldoff));
@@ -170,8 +224,21 @@ void GLSpectrumGUI::applySettings()
 	m_glSpectrum->setInvertedWaterfall(m_invert);
 	m_glSpectrum->setDisplayGrid(m_displayGrid);
 	m_glSpectrum->setDisplayGridIntensity(m_displayGridIntensity);
+	m_glSpectrum->setBinReduction((SpectrumSIMD::Reduction) m_binReduction);
 
 	m_spectrumVis->configure(m_messageQueue, m_fftSize, m_fftOverlap, (FFTWindow::Function)m_fftWindow);
+	applyAveraging();
+}
+
+void GLSpectrumGUI::applyAveraging()
+{
+	if(m_spectrumVis == NULL)
+		return;
+	m_spectrumVis->configureAveraging(m_messageQueue,
+		(SpectrumVis::AvgMode) m_averagingMode,
+		m_averagingNb,
+		(SpectrumVis::HoldMode) m_holdMode,
+		m_maxFrameRate);
 }
 
 void GLSpectrumGUI::on_fftWindow_currentIndexChanged(int index)
@@ -293,8 +360,55 @@ void GLSpectrumGUI::on_traceIntensity_valueChanged(int index)
 		m_glSpectrum->setDisplayTraceIntensity(m_displayTraceIntensity);
 }
 
+void GLSpectrumGUI::on_averagingMode_currentIndexChanged(int index)
+{
+	if (index < 0) {
+		return;
+	}
+	m_averagingMode = index;
+	applyAveraging();
+}
+
+void GLSpectrumGUI::on_averaging_currentIndexChanged(int index)
+{
+	if ((index < 0) || (index >= nbAveragingNbs)) {
+		return;
+	}
+	m_averagingNb = averagingNbs[index];
+	applyAveraging();
+}
+
+void GLSpectrumGUI::on_hold_currentIndexChanged(int index)
+{
+	if (index < 0) {
+		return;
+	}
+	m_holdMode = index;
+	applyAveraging();
+}
+
+void GLSpectrumGUI::on_displayRate_currentIndexChanged(int index)
+{
+	if ((index < 0) || (index >= nbMaxFrameRates)) {
+		return;
+	}
+	m_maxFrameRate = maxFrameRates[index];
+	applyAveraging();
+}
+
+void GLSpectrumGUI::on_binReduction_currentIndexChanged(int index)
+{
+	if (index < 0) {
+		return;
+	}
+	m_binReduction = index;
+	if(m_glSpectrum != NULL)
+		m_glSpectrum->setBinReduction((SpectrumSIMD::Reduction) m_binReduction);
+}
+
 void GLSpectrumGUI::on_clearSpectrum_clicked(bool checked)
 {
 	if(m_glSpectrum != NULL)
 		m_glSpectrum->clearSpectrumHistogram();
+	applyAveraging(); // restarts averaging and hold
 }
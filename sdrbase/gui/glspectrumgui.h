@@ -50,8 +50,14 @@ private:
 	bool m_displayHistogram;
 	bool m_displayGrid;
 	bool m_invert;
+	int m_averagingMode;
+	int m_averagingNb;
+	int m_holdMode;
+	int m_maxFrameRate;
+	int m_binReduction;
 
 	void applySettings();
+	void applyAveraging();
 
 private slots:
 	void on_fftWindow_currentIndexChanged(int index);
@@ -63,6 +69,11 @@ private slots:
 	void on_stroke_valueChanged(int index);
 	void on_gridIntensity_valueChanged(int index);
 	void on_traceIntensity_valueChanged(int index);
+	void on_averagingMode_currentIndexChanged(int index);
+	void on_averaging_currentIndexChanged(int index);
+	void on_hold_currentIndexChanged(int index);
+	void on_displayRate_currentIndexChanged(int index);
+	void on_binReduction_currentIndexChanged(int index);
 
 	void on_waterfall_toggled(bool checked);
 	void on_histogram_toggled(bool checked);
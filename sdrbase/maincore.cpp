@@ -0,0 +1,247 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QCoreApplication>
+#include <QDebug>
+
+#include "maincore.h"
+#include "device/devicesourceapi.h"
+#include "plugin/pluginmanager.h"
+#include "plugin/pluginheadless.h"
+#include "dsp/dspengine.h"
+#include "dsp/dspdevicesourceengine.h"
+#include "dsp/dspcommands.h"
+#include "dsp/fftengine.h"
+#include "dsp/hbfilterselector.h"
+#include "util/messagequeue.h"
+
+volatile sig_atomic_t MainCore::m_quitRequested = 0;
+
+MainCore::Options::Options() :
+    m_deviceId("sdrangel.samplesource.rtlsdr"),
+    m_deviceSerial(),
+    m_deviceSequence(0),
+    m_presetGroup(),
+    m_presetDescription()
+{
+}
+
+MainCore::MainCore(const Options& options, QObject *parent) :
+    QObject(parent),
+    m_options(options),
+    m_settings(),
+    m_dspEngine(DSPEngine::instance()),
+    m_deviceSourceEngine(0),
+    m_deviceSourceAPI(0),
+    m_sampleSourceHeadless(0)
+{
+    qDebug() << "MainCore::MainCore: start";
+
+    FFTEngine::loadWisdom(); // before any filter gets its FFT
+    HBFilterSelector::calibrate(); // before any device or channel creates its half band filters
+
+    m_pluginManager = new PluginManager(0, this);
+    m_pluginManager->loadPlugins();
+
+    m_settings.load();
+    m_settings.sortPresets();
+
+    connect(&m_masterTimer, SIGNAL(timeout()), this, SLOT(tick()));
+    m_masterTimer.start(200);
+}
+
+MainCore::~MainCore()
+{
+    stop();
+
+    FFTEngine::stopPlanning();
+    FFTEngine::saveWisdom();
+
+    delete m_pluginManager;
+}
+
+bool MainCore::start()
+{
+    m_deviceSourceEngine = m_dspEngine->addDeviceSourceEngine();
+    m_deviceSourceEngine->start();
+
+    // no main window, spectrum display nor channel window
+    m_deviceSourceAPI = new DeviceSourceAPI(0, 0, m_deviceSourceEngine, 0, 0);
+    connect(m_deviceSourceAPI->getDeviceOutputMessageQueue(), SIGNAL(messageEnqueued()), this, SLOT(handleDSPMessages()), Qt::QueuedConnection);
+
+    m_sampleSourceHeadless = m_pluginManager->createSampleSourceHeadless(
+            m_options.m_deviceId,
+            m_options.m_deviceSerial,
+            m_options.m_deviceSequence,
+            m_deviceSourceAPI);
+
+    if (m_sampleSourceHeadless == 0)
+    {
+        qCritical("MainCore::start: cannot open device %s ser: %s seq: %d",
+                qPrintable(m_options.m_deviceId),
+                qPrintable(m_options.m_deviceSerial),
+                m_options.m_deviceSequence);
+        return false;
+    }
+
+    const Preset *preset = findPreset();
+
+    if (preset == 0)
+    {
+        qCritical("MainCore::start: preset [%s | %s] not found",
+                qPrintable(m_options.m_presetGroup),
+                qPrintable(m_options.m_presetDescription));
+        return false;
+    }
+
+    loadPresetSettings(preset);
+
+    if (!m_deviceSourceAPI->initAcquisition() || !m_deviceSourceAPI->startAcquisition())
+    {
+        qCritical("MainCore::start: cannot start acquisition: %s", qPrintable(m_deviceSourceAPI->errorMessage()));
+        return false;
+    }
+
+    qDebug("MainCore::start: running %s with %d channel(s)",
+            qPrintable(m_sampleSourceHeadless->getName()),
+            m_channelHeadlesses.size());
+
+    return true;
+}
+
+void MainCore::stop()
+{
+    if (m_deviceSourceEngine == 0) {
+        return;
+    }
+
+    m_deviceSourceEngine->stopAcquistion();
+
+    while (!m_channelHeadlesses.isEmpty()) {
+        m_channelHeadlesses.takeLast()->destroy();
+    }
+
+    if (m_sampleSourceHeadless)
+    {
+        m_deviceSourceEngine->setSource(0);
+        m_sampleSourceHeadless->destroy();
+        m_sampleSourceHeadless = 0;
+    }
+
+    delete m_deviceSourceAPI;
+    m_deviceSourceAPI = 0;
+
+    m_deviceSourceEngine->stop();
+    m_dspEngine->removeLastDeviceSourceEngine();
+    m_deviceSourceEngine = 0;
+}
+
+void MainCore::requestQuit()
+{
+    m_quitRequested = 1;
+}
+
+const Preset *MainCore::findPreset()
+{
+    if (m_options.m_presetGroup.isEmpty() && m_options.m_presetDescription.isEmpty()) {
+        return m_settings.getWorkingPreset();
+    }
+
+    for (int i = 0; i < m_settings.getPresetCount(); i++)
+    {
+        const Preset *preset = m_settings.getPreset(i);
+
+        if ((preset->getGroup() == m_options.m_presetGroup) && (preset->getDescription() == m_options.m_presetDescription)) {
+            return preset;
+        }
+    }
+
+    return 0;
+}
+
+void MainCore::loadPresetSettings(const Preset *preset)
+{
+    qDebug("MainCore::loadPresetSettings: preset [%s | %s]",
+        qPrintable(preset->getGroup()),
+        qPrintable(preset->getDescription()));
+
+    if (!preset->isSourcePreset())
+    {
+        qWarning("MainCore::loadPresetSettings: not a source preset");
+        return;
+    }
+
+    const QByteArray* sourceConfig = preset->findBestDeviceConfig(
+            m_deviceSourceAPI->getSampleSourceId(),
+            m_deviceSourceAPI->getSampleSourceSerial(),
+            m_deviceSourceAPI->getSampleSourceSequence());
+
+    if (sourceConfig != 0) {
+        m_sampleSourceHeadless->deserialize(*sourceConfig);
+    }
+
+    m_sampleSourceHeadless->setCenterFrequency(preset->getCenterFrequency());
+
+    for (int i = 0; i < preset->getChannelCount(); i++)
+    {
+        const Preset::ChannelConfig& channelConfig = preset->getChannelConfig(i);
+        PluginHeadless *channelHeadless = m_pluginManager->createRxChannelHeadless(channelConfig.m_channel, m_deviceSourceAPI);
+
+        if (channelHeadless == 0)
+        {
+            qWarning("MainCore::loadPresetSettings: channel [%s] cannot run headless: skipped", qPrintable(channelConfig.m_channel));
+            continue;
+        }
+
+        channelHeadless->setName(QString("%1:%2").arg(channelConfig.m_channel).arg(m_channelHeadlesses.size()));
+        channelHeadless->deserialize(channelConfig.m_config);
+        m_channelHeadlesses.append(channelHeadless);
+    }
+}
+
+void MainCore::handleDSPMessages()
+{
+    Message* message;
+
+    while ((message = m_deviceSourceAPI->getDeviceOutputMessageQueue()->pop()) != 0)
+    {
+        if (DSPSignalNotification::match(*message))
+        {
+            DSPSignalNotification* notif = (DSPSignalNotification*) message;
+            qDebug("MainCore::handleDSPMessages: SampleRate:%d, CenterFrequency:%llu", notif->getSampleRate(), notif->getCenterFrequency());
+        }
+
+        delete message;
+    }
+}
+
+void MainCore::tick()
+{
+    if (m_quitRequested)
+    {
+        qDebug("MainCore::tick: quit requested");
+        m_masterTimer.stop();
+        QCoreApplication::exit(0);
+    }
+    else if (m_deviceSourceAPI && (m_deviceSourceAPI->state() == DSPDeviceSourceEngine::StError))
+    {
+        // let the service manager restart the process
+        qCritical("MainCore::tick: device engine error: %s", qPrintable(m_deviceSourceAPI->errorMessage()));
+        m_masterTimer.stop();
+        QCoreApplication::exit(1);
+    }
+}
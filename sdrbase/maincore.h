@@ -0,0 +1,85 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBASE_MAINCORE_H_
+#define SDRBASE_MAINCORE_H_
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QList>
+#include <signal.h>
+
+#include "settings/mainsettings.h"
+#include "util/export.h"
+
+class DSPEngine;
+class DSPDeviceSourceEngine;
+class DeviceSourceAPI;
+class PluginManager;
+class PluginHeadless;
+
+/**
+ * Headless counterpart of MainWindow: loads the plugins, opens one source device,
+ * restores a preset from the settings file and runs the DSP threads without creating
+ * any GUI object. Meant to be run as one process per device under a service manager.
+ */
+class SDRANGEL_API MainCore : public QObject {
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString m_deviceId;          //!< sample source plugin ID e.g. sdrangel.samplesource.rtlsdr
+        QString m_deviceSerial;      //!< device serial, takes precedence over the sequence when not empty
+        int m_deviceSequence;        //!< device sequence number among devices of the same kind
+        QString m_presetGroup;       //!< preset group. Working preset if both group and description are empty
+        QString m_presetDescription; //!< preset description
+
+        Options();
+    };
+
+    explicit MainCore(const Options& options, QObject *parent = 0);
+    ~MainCore();
+
+    bool start(); //!< Open the device, restore the preset and start acquisition
+    void stop();  //!< Stop acquisition and release device and channels
+
+    static void requestQuit(); //!< Async signal safe stop request
+
+private slots:
+    void handleDSPMessages();
+    void tick();
+
+private:
+    const Preset *findPreset();
+    void loadPresetSettings(const Preset *preset);
+
+    Options m_options;
+    MainSettings m_settings;
+    DSPEngine *m_dspEngine;
+    PluginManager *m_pluginManager;
+    DSPDeviceSourceEngine *m_deviceSourceEngine;
+    DeviceSourceAPI *m_deviceSourceAPI;
+    PluginHeadless *m_sampleSourceHeadless;
+    QList<PluginHeadless*> m_channelHeadlesses;
+    QTimer m_masterTimer;
+
+    static volatile sig_atomic_t m_quitRequested;
+};
+
+#endif /* SDRBASE_MAINCORE_H_ */
@@ -43,6 +43,8 @@
 #include "dsp/dspengine.h"
 #include "dsp/spectrumvis.h"
 #include "dsp/dspcommands.h"
+#include "dsp/fftengine.h"
+#include "dsp/hbfilterselector.h"
 #include "plugin/plugingui.h"
 #include "plugin/pluginapi.h"
 #include "plugin/plugingui.h"
@@ -112,6 +114,9 @@ MainWindow::MainWindow(QWidget* parent) :
             "QTabWidget::pane { border: 1px solid #808080; } "
             "QTabBar::tab:selected { background: rgb(100,100,100); }");
 
+    FFTEngine::loadWisdom(); // before any spectrum or filter gets its FFT
+    HBFilterSelector::calibrate(); // before any device or channel creates its half band filters
+
     m_pluginManager = new PluginManager(this);
     m_pluginManager->loadPlugins();
 
@@ -130,6 +135,21 @@ MainWindow::MainWindow(QWidget* parent) :
 
 	loadSettings();
 
+	ui->action_FFT_Pre_Planning->setChecked(m_settings.getFFTPrePlanning());
+
+	if (m_settings.getFFTPrePlanning()) {
+	    startFFTPlanning();
+	}
+
+	ui->action_Record_Compression->setChecked(m_settings.getRecordCompression());
+	on_action_Record_Compression_triggered(m_settings.getRecordCompression());
+#ifndef USE_LZ4
+	ui->action_Record_Compression->setEnabled(false); // built without LZ4: chunks are only bit packed
+#endif
+
+	ui->action_Channelizer_Bank->setChecked(m_settings.getChannelizerBank());
+	on_action_Channelizer_Bank_triggered(m_settings.getChannelizerBank());
+
 	qDebug() << "MainWindow::MainWindow: select SampleSource from settings...";
 
 	int sampleSourceIndex = m_settings.getSourceIndex();
@@ -164,6 +184,9 @@ MainWindow::MainWindow(QWidget* parent) :
 
 MainWindow::~MainWindow()
 {
+    FFTEngine::stopPlanning();
+    FFTEngine::saveWisdom();
+
     delete m_pluginManager;
 	delete m_dateTimeWidget;
 	delete m_showSystemWidget;
@@ -190,6 +213,9 @@ void MainWindow::addSourceDevice()
     DeviceSourceAPI *deviceSourceAPI = new DeviceSourceAPI(this, deviceTabIndex, dspDeviceSourceEngine, m_deviceUIs.back()->m_spectrum, m_deviceUIs.back()->m_channelWindow);
 
     m_deviceUIs.back()->m_deviceSourceAPI = deviceSourceAPI;
+    deviceSourceAPI->configureChannelizerBank(ui->action_Channelizer_Bank->isChecked());
+    deviceSourceAPI->configureSinkDispatch(ui->action_Parallel_Sinks->isChecked());
+    deviceSourceAPI->setRecordCompression(ui->action_Record_Compression->isChecked());
     m_deviceUIs.back()->m_samplingDeviceControl->setDeviceAPI(deviceSourceAPI);
     m_deviceUIs.back()->m_samplingDeviceControl->setPluginManager(m_pluginManager);
     m_pluginManager->populateRxChannelComboBox(m_deviceUIs.back()->m_samplingDeviceControl->getChannelSelector());
@@ -750,6 +776,62 @@ void MainWindow::on_action_My_Position_triggered()
 	myPositionDialog.exec();
 }
 
+void MainWindow::on_action_Channelizer_Bank_triggered(bool checked)
+{
+    m_settings.setChannelizerBank(checked);
+
+    for (std::vector<DeviceUISet*>::iterator it = m_deviceUIs.begin(); it != m_deviceUIs.end(); ++it)
+    {
+        if ((*it)->m_deviceSourceAPI) {
+            (*it)->m_deviceSourceAPI->configureChannelizerBank(checked);
+        }
+    }
+}
+
+void MainWindow::on_action_Parallel_Sinks_triggered(bool checked)
+{
+    for (std::vector<DeviceUISet*>::iterator it = m_deviceUIs.begin(); it != m_deviceUIs.end(); ++it)
+    {
+        if ((*it)->m_deviceSourceAPI) {
+            (*it)->m_deviceSourceAPI->configureSinkDispatch(checked);
+        }
+    }
+}
+
+void MainWindow::on_action_FFT_Pre_Planning_triggered(bool checked)
+{
+    m_settings.setFFTPrePlanning(checked);
+
+    if (checked) {
+        startFFTPlanning();
+    } else {
+        FFTEngine::stopPlanning();
+    }
+}
+
+void MainWindow::on_action_Record_Compression_triggered(bool checked)
+{
+    m_settings.setRecordCompression(checked);
+
+    for (std::vector<DeviceUISet*>::iterator it = m_deviceUIs.begin(); it != m_deviceUIs.end(); ++it)
+    {
+        if ((*it)->m_deviceSourceAPI) {
+            (*it)->m_deviceSourceAPI->setRecordCompression(checked);
+        }
+    }
+}
+
+void MainWindow::startFFTPlanning()
+{
+    std::vector<int> sizes;
+
+    for (int i = 0; i < 6; i++) { // spectrum FFT sizes 128 to 4096
+        sizes.push_back(1 << (i + 7));
+    }
+
+    FFTEngine::startPlanning(sizes);
+}
+
 void MainWindow::on_action_DV_Serial_triggered(bool checked)
 {
     m_dspEngine->setDVSerialSupport(checked);
@@ -129,6 +129,7 @@ private:
 	void savePresetSettings(Preset* preset, int tabIndex);
 
 	void createStatusBar();
+	void startFFTPlanning();
 	void closeEvent(QCloseEvent*);
 	void updatePresetControls();
 	QTreeWidgetItem* addPresetToTree(const Preset* preset);
@@ -153,6 +154,10 @@ private slots:
 	void on_presetTree_itemActivated(QTreeWidgetItem *item, int column);
 	void on_action_Audio_triggered();
 	void on_action_DV_Serial_triggered(bool checked);
+	void on_action_Channelizer_Bank_triggered(bool checked);
+	void on_action_Parallel_Sinks_triggered(bool checked);
+	void on_action_FFT_Pre_Planning_triggered(bool checked);
+	void on_action_Record_Compression_triggered(bool checked);
 	void on_action_My_Position_triggered();
 	void on_sampleSource_confirmClicked(bool checked);
 	void on_sampleSink_confirmClicked(bool checked);
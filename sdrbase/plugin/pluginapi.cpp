@@ -5,7 +5,7 @@
 
 MessageQueue* PluginAPI::getMainWindowMessageQueue()
 {
-	return m_mainWindow->getInputMessageQueue();
+	return m_mainWindow ? m_mainWindow->getInputMessageQueue() : 0;
 }
 
 void PluginAPI::registerRxChannel(const QString& channelName, PluginInterface* plugin)
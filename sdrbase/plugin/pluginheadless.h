@@ -0,0 +1,32 @@
+#ifndef INCLUDE_PLUGINHEADLESS_H
+#define INCLUDE_PLUGINHEADLESS_H
+
+#include <QByteArray>
+#include <QString>
+#include "util/export.h"
+
+/**
+ * Device or channel plugin instance running without any GUI object. It owns the
+ * same DSP core objects the PluginGUI counterpart would and reads and writes the
+ * same serialized settings so that presets saved by the GUI can be restored.
+ */
+class SDRANGEL_API PluginHeadless {
+public:
+	PluginHeadless() { };
+	virtual ~PluginHeadless() { };
+
+	virtual void destroy() = 0;
+
+	virtual void setName(const QString& name) = 0;
+	virtual QString getName() const = 0;
+
+	virtual void resetToDefaults() = 0;
+
+	virtual qint64 getCenterFrequency() const = 0;
+	virtual void setCenterFrequency(qint64 centerFrequency) = 0;
+
+	virtual QByteArray serialize() const = 0;
+	virtual bool deserialize(const QByteArray& data) = 0;
+};
+
+#endif // INCLUDE_PLUGINHEADLESS_H
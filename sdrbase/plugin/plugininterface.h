@@ -18,6 +18,7 @@ class PluginAPI;
 class DeviceSourceAPI;
 class DeviceSinkAPI;
 class PluginGUI;
+class PluginHeadless;
 class QWidget;
 
 class PluginInterface {
@@ -51,6 +52,7 @@ public:
 
 	// channel Rx plugins
 	virtual PluginGUI* createRxChannel(const QString& channelName, DeviceSourceAPI *deviceAPI) { return 0; }
+	virtual PluginHeadless* createRxChannelHeadless(const QString& channelName, DeviceSourceAPI *deviceAPI) { return 0; }
 
 	// channel Tx plugins
 	virtual PluginGUI* createTxChannel(const QString& channelName, DeviceSinkAPI *deviceAPI) { return 0; }
@@ -58,6 +60,7 @@ public:
 	// device source plugins only
 	virtual SamplingDevices enumSampleSources() { return SamplingDevices(); }
 	virtual PluginGUI* createSampleSourcePluginGUI(const QString& sourceId, QWidget **widget, DeviceSourceAPI *deviceAPI) { return 0; }
+	virtual PluginHeadless* createSampleSourcePluginHeadless(const QString& sourceId, DeviceSourceAPI *deviceAPI) { return 0; }
 
 	// device sink plugins only
 	virtual SamplingDevices enumSampleSinks() { return SamplingDevices(); }
@@ -16,13 +16,14 @@
 
 #include "device/devicesourceapi.h"
 #include "device/devicesinkapi.h"
-#include <QApplication>
+#include <QCoreApplication>
 #include <QPluginLoader>
 #include <QComboBox>
 #include <cstdio>
 
 #include "plugin/pluginmanager.h"
 #include "plugin/plugingui.h"
+#include "plugin/pluginheadless.h"
 #include "settings/preset.h"
 #include "mainwindow.h"
 #include "gui/glspectrum.h"
@@ -54,7 +55,7 @@ PluginManager::~PluginManager()
 
 void PluginManager::loadPlugins()
 {
-	QString applicationDirPath = QApplication::instance()->applicationDirPath();
+	QString applicationDirPath = QCoreApplication::instance()->applicationDirPath();
 	QString applicationLibPath = applicationDirPath + "/../lib";
 	qDebug() << "PluginManager::loadPlugins: " << qPrintable(applicationDirPath) << ", " << qPrintable(applicationLibPath);
 
@@ -612,6 +613,69 @@ int PluginManager::selectSampleSourceBySerialOrSequence(const QString& sourceId,
 	return index;
 }
 
+PluginHeadless* PluginManager::createSampleSourceHeadless(const QString& sourceId, const QString& sourceSerial, int sourceSequence, DeviceSourceAPI *deviceAPI)
+{
+	qDebug("PluginManager::createSampleSourceHeadless: id: %s ser: %s seq: %d", qPrintable(sourceId), qPrintable(sourceSerial), sourceSequence);
+
+	int index = -1;
+
+	// unlike the GUI there is no fallback to another device: a headless process is bound to one device
+	for (int i = 0; i < m_sampleSourceDevices.count(); i++)
+	{
+		if (m_sampleSourceDevices[i].m_deviceId != sourceId) {
+			continue;
+		}
+
+		if (sourceSerial.isEmpty())
+		{
+			if (m_sampleSourceDevices[i].m_deviceSequence == sourceSequence)
+			{
+				index = i;
+				break;
+			}
+		}
+		else if (m_sampleSourceDevices[i].m_deviceSerial == sourceSerial)
+		{
+			index = i;
+			break;
+		}
+	}
+
+	if (index < 0)
+	{
+		qWarning("PluginManager::createSampleSourceHeadless: no such device");
+		return 0;
+	}
+
+	PluginHeadless *pluginHeadless = m_sampleSourceDevices[index].m_plugin->createSampleSourcePluginHeadless(m_sampleSourceDevices[index].m_deviceId, deviceAPI);
+
+	if (pluginHeadless == 0)
+	{
+		qWarning("PluginManager::createSampleSourceHeadless: %s cannot run headless", qPrintable(sourceId));
+		return 0;
+	}
+
+	deviceAPI->setSampleSourceSequence(m_sampleSourceDevices[index].m_deviceSequence);
+	deviceAPI->setHardwareId(m_sampleSourceDevices[index].m_hadrwareId);
+	deviceAPI->setSampleSourceId(m_sampleSourceDevices[index].m_deviceId);
+	deviceAPI->setSampleSourceSerial(m_sampleSourceDevices[index].m_deviceSerial);
+	pluginHeadless->setName(m_sampleSourceDevices[index].m_displayName);
+
+	return pluginHeadless;
+}
+
+PluginHeadless* PluginManager::createRxChannelHeadless(const QString& channelName, DeviceSourceAPI *deviceAPI)
+{
+	for (int i = 0; i < m_rxChannelRegistrations.count(); i++)
+	{
+		if (m_rxChannelRegistrations[i].m_channelName == channelName) {
+			return m_rxChannelRegistrations[i].m_plugin->createRxChannelHeadless(channelName, deviceAPI);
+		}
+	}
+
+	return 0;
+}
+
 int PluginManager::selectSampleSinkBySerialOrSequence(const QString& sinkId, const QString& sinkSerial, int sinkSequence, DeviceSinkAPI *deviceAPI)
 {
 	qDebug("PluginManager::selectSampleSinkBySerialOrSequence by sequence: id: %s ser: %s seq: %d", qPrintable(sinkId), qPrintable(sinkSerial), sinkSequence);
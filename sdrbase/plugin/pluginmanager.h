@@ -15,6 +15,7 @@ class Message;
 class MessageQueue;
 class DeviceSourceAPI;
 class DeviceSinkAPI;
+class PluginHeadless;
 
 class SDRANGEL_API PluginManager : public QObject {
 	Q_OBJECT
@@ -64,6 +65,7 @@ public:
 	int selectFirstSampleSource(const QString& sourceId, DeviceSourceAPI *deviceAPI);
 	int selectSampleSourceBySerialOrSequence(const QString& sourceId, const QString& sourceSerial, int sourceSequence, DeviceSourceAPI *deviceAPI);
 	void selectSampleSourceByDevice(void *devicePtr, DeviceSourceAPI *deviceAPI);
+	PluginHeadless* createSampleSourceHeadless(const QString& sourceId, const QString& sourceSerial, int sourceSequence, DeviceSourceAPI *deviceAPI);
 
 	int selectSampleSinkByIndex(int index, DeviceSinkAPI *deviceAPI);
 	int selectFirstSampleSink(const QString& sourceId, DeviceSinkAPI *deviceAPI);
@@ -72,6 +74,7 @@ public:
 
 	void populateRxChannelComboBox(QComboBox *channels);
 	void createRxChannelInstance(int channelPluginIndex, DeviceSourceAPI *deviceAPI);
+	PluginHeadless* createRxChannelHeadless(const QString& channelName, DeviceSourceAPI *deviceAPI);
 
 	void populateTxChannelComboBox(QComboBox *channels);
 	void createTxChannelInstance(int channelPluginIndex, DeviceSinkAPI *deviceAPI);
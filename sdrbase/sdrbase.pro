@@ -4,7 +4,7 @@
 #
 #--------------------------------------------------------
 
-QT += core gui multimedia opengl
+QT += core gui multimedia opengl network
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TEMPLATE = lib
@@ -20,6 +20,8 @@ DEFINES += USE_SSE2=1
 QMAKE_CXXFLAGS += -msse2
 DEFINES += USE_SSE4_1=1
 QMAKE_CXXFLAGS += -msse4.1
+DEFINES += USE_LZ4=1
+INCLUDEPATH += ../lz4
 
 CONFIG(Release):build_subdir = release
 CONFIG(Debug):build_subdir = debug
@@ -44,6 +46,7 @@ win32 {
 }
 
 SOURCES += mainwindow.cpp\
+        maincore.cpp\
         audio/audiodeviceinfo.cpp\
         audio/audiofifo.cpp\
         audio/audiooutput.cpp\
@@ -54,10 +57,14 @@ SOURCES += mainwindow.cpp\
         dsp/agc.cpp\
         dsp/downchannelizer.cpp\
         dsp/upchannelizer.cpp\
+        dsp/channelizerbank.cpp\
         dsp/channelmarker.cpp\
         dsp/ctcssdetector.cpp\
         dsp/cwkeyer.cpp\
+        dsp/decimatorssimd.cpp\
         dsp/dspcommands.cpp\
+        dsp/driftresampler.cpp\
+        dsp/streampacer.cpp\
         dsp/dspengine.cpp\
         dsp/dspdevicesourceengine.cpp\
         dsp/dspdevicesinkengine.cpp\
@@ -68,15 +75,23 @@ SOURCES += mainwindow.cpp\
         dsp/filterrc.cpp\
         dsp/filtermbe.cpp\
         dsp/filerecord.cpp\
+        dsp/filerecordreader.cpp\
         dsp/interpolator.cpp\
+        dsp/jitterbuffercontrol.cpp\
         dsp/hbfiltertraits.cpp\
+        dsp/hbfilterselector.cpp\
         dsp/lowpass.cpp\
         dsp/nco.cpp\
         dsp/ncof.cpp\
+        dsp/ncomixer.cpp\
         dsp/pidcontroller.cpp\
         dsp/phaselock.cpp\
+        dsp/polyphasefilterbank.cpp\
         dsp/recursivefilters.cpp\
         dsp/samplesinkfifo.cpp\
+        dsp/samplesinkdispatcher.cpp\
+        dsp/samplesourcemixer.cpp\
+        dsp/spectrumsimd.cpp\
         dsp/samplesourcefifo.cpp\
         dsp/samplesinkfifodoublebuffered.cpp\
         dsp/basebandsamplesink.cpp\
@@ -131,9 +146,11 @@ SOURCES += mainwindow.cpp\
         util/prettyprint.cpp\
         util/syncmessenger.cpp\
         util/samplesourceserializer.cpp\
-        util/simpleserializer.cpp
+        util/simpleserializer.cpp\
+        util/udpsender.cpp
 
 HEADERS  += mainwindow.h\
+        maincore.h\
         audio/audiodeviceinfo.h\
         audio/audiofifo.h\
         audio/audiooutput.h\
@@ -143,12 +160,16 @@ HEADERS  += mainwindow.h\
         dsp/afsquelch.h\
         dsp/downchannelizer.h\
         dsp/upchannelizer.h\
+        dsp/channelizerbank.h\
         dsp/channelmarker.h\
         dsp/cwkeyer.h\
         dsp/complex.h\
         dsp/decimators.h\
+        dsp/decimatorssimd.h\
         dsp/interpolators.h\
         dsp/dspcommands.h\
+        dsp/driftresampler.h\
+        dsp/streampacer.h\
         dsp/dspengine.h\
         dsp/dspdevicesourceengine.h\
         dsp/dspdevicesinkengine.h\
@@ -160,9 +181,12 @@ HEADERS  += mainwindow.h\
         dsp/filterrc.h\
         dsp/filtermbe.h\
         dsp/filerecord.h\
+        dsp/filerecordreader.h\
         dsp/gfft.h\
         dsp/hbfiltertraits.h\
+        dsp/hbfilterselector.h\
         dsp/interpolator.h\
+        dsp/jitterbuffercontrol.h\
         dsp/inthalfbandfilter.h\
         dsp/inthalfbandfilterdb.h\
         dsp/inthalfbandfiltereo1.h\
@@ -176,11 +200,16 @@ HEADERS  += mainwindow.h\
         dsp/movingaverage.h\
         dsp/nco.h\
         dsp/ncof.h\
+        dsp/ncomixer.h\
         dsp/phasediscri.h\
         dsp/phaselock.h\
+        dsp/polyphasefilterbank.h\
         dsp/pidcontroller.h\
         dsp/recursivefilters.h\
         dsp/samplesinkfifo.h\
+        dsp/samplesinkdispatcher.h\
+        dsp/samplesourcemixer.h\
+        dsp/spectrumsimd.h\
         dsp/samplesourcefifo.h\
         dsp/samplesinkfifodoublebuffered.h\
         dsp/samplesinkfifodecimator.h\
@@ -226,6 +255,7 @@ HEADERS  += mainwindow.h\
         dsp/devicesamplesink.h\
         plugin/pluginapi.h\
         plugin/plugingui.h\
+        plugin/pluginheadless.h\
         plugin/plugininterface.h\
         plugin/pluginmanager.h\
         settings/preferences.h\
@@ -239,7 +269,8 @@ HEADERS  += mainwindow.h\
         util/prettyprint.h\
         util/syncmessenger.h\
         util/samplesourceserializer.h\
-        util/simpleserializer.h
+        util/simpleserializer.h\
+        util/udpsender.h
 
 FORMS    += mainwindow.ui\
         gui/scopewindow.ui\
@@ -258,6 +289,7 @@ FORMS    += mainwindow.ui\
 
 RESOURCES = resources/res.qrc
 
+LIBS += -L../lz4/$${build_subdir} -llz4
 !macx:LIBS += -L../serialdv/$${build_subdir} -lserialdv
 
 CONFIG(ANDROID):CONFIG += mobility
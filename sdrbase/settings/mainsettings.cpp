@@ -3,7 +3,8 @@
 
 #include "settings/mainsettings.h"
 
-MainSettings::MainSettings()
+MainSettings::MainSettings() :
+	m_audioDeviceInfo(0)
 {
 	resetToDefaults();
 }
@@ -31,6 +31,15 @@ public:
 	float getLatitude() const { return m_preferences.getLatitude(); }
 	float getLongitude() const { return m_preferences.getLongitude(); }
 
+	void setFFTPrePlanning(bool fftPrePlanning) { m_preferences.setFFTPrePlanning(fftPrePlanning); }
+	bool getFFTPrePlanning() const { return m_preferences.getFFTPrePlanning(); }
+
+	void setRecordCompression(bool recordCompression) { m_preferences.setRecordCompression(recordCompression); }
+	bool getRecordCompression() const { return m_preferences.getRecordCompression(); }
+
+	void setChannelizerBank(bool channelizerBank) { m_preferences.setChannelizerBank(channelizerBank); }
+	bool getChannelizerBank() const { return m_preferences.getChannelizerBank(); }
+
 	const AudioDeviceInfo *getAudioDeviceInfo() const { return m_audioDeviceInfo; }
 	void setAudioDeviceInfo(AudioDeviceInfo *audioDeviceInfo) { m_audioDeviceInfo = audioDeviceInfo; }
 
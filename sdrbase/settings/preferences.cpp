@@ -15,6 +15,9 @@ void Preferences::resetToDefaults()
 	m_sourceIndex = 0;
 	m_latitude = 0.0;
 	m_longitude = 0.0;
+	m_fftPrePlanning = true;
+	m_recordCompression = true;
+	m_channelizerBank = false;
 }
 
 QByteArray Preferences::serialize() const
@@ -27,6 +30,9 @@ QByteArray Preferences::serialize() const
 	s.writeS32(5, m_sourceIndex);
 	s.writeFloat(6, m_latitude);
 	s.writeFloat(7, m_longitude);
+	s.writeBool(8, m_fftPrePlanning);
+	s.writeBool(9, m_recordCompression);
+	s.writeBool(10, m_channelizerBank);
 	return s.final();
 }
 
@@ -47,6 +53,9 @@ bool Preferences::deserialize(const QByteArray& data)
 		d.readS32(5, &m_sourceIndex, 0);
 		d.readFloat(6, &m_latitude, 0.0);
 		d.readFloat(7, &m_longitude, 0.0);
+		d.readBool(8, &m_fftPrePlanning, true);
+		d.readBool(9, &m_recordCompression, true);
+		d.readBool(10, &m_channelizerBank, false);
 		return true;
 	} else {
 		resetToDefaults();
@@ -28,6 +28,15 @@ public:
 	float getLatitude() const { return m_latitude; }
 	float getLongitude() const { return m_longitude; }
 
+	void setFFTPrePlanning(bool fftPrePlanning) { m_fftPrePlanning = fftPrePlanning; }
+	bool getFFTPrePlanning() const { return m_fftPrePlanning; }
+
+	void setRecordCompression(bool recordCompression) { m_recordCompression = recordCompression; }
+	bool getRecordCompression() const { return m_recordCompression; }
+
+	void setChannelizerBank(bool channelizerBank) { m_channelizerBank = channelizerBank; }
+	bool getChannelizerBank() const { return m_channelizerBank; }
+
 protected:
 	QString m_sourceType;
 	QString m_sourceDevice;
@@ -38,6 +47,10 @@ protected:
 
 	float m_latitude;
 	float m_longitude;
+
+	bool m_fftPrePlanning; //!< plan the FFT spectrum sizes in background at startup
+	bool m_recordCompression; //!< LZ4 compress the chunks of I/Q records
+	bool m_channelizerBank; //!< feed the channelizers from the shared polyphase channelizer bank
 };
 
 #endif // INCLUDE_PREFERENCES_H
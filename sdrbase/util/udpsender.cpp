@@ -0,0 +1,401 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <QDebug>
+#include <QUdpSocket>
+#include <QStringList>
+#include <QMutexLocker>
+
+#include <algorithm>
+#include <string.h>
+
+#if defined(__linux__)
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+#include "util/udpsender.h"
+
+UDPSender::UDPSender(unsigned int maxDatagramSize, unsigned int nbSlots) :
+    m_maxDatagramSize(maxDatagramSize),
+    m_nbSlots(nbSlots),
+    m_slots(maxDatagramSize * nbSlots),
+    m_slotSizes(nbSlots),
+    m_tail(0),
+    m_count(0),
+    m_running(false),
+    m_destinationsChanged(false),
+    m_sentCount(0),
+    m_droppedCount(0),
+    m_socket(-1),
+    m_gso(false),
+    m_udpSocket(0)
+{
+}
+
+UDPSender::~UDPSender()
+{
+    stopWork();
+}
+
+void UDPSender::startWork()
+{
+    if (isRunning()) {
+        return;
+    }
+
+    m_mutex.lock();
+    m_running = true;
+    m_mutex.unlock();
+    start();
+}
+
+void UDPSender::stopWork()
+{
+    m_mutex.lock();
+    m_running = false;
+    m_queueNotEmpty.wakeOne();
+    m_mutex.unlock();
+    wait();
+}
+
+int UDPSender::setDestinations(const QString& destinations, quint16 defaultPort)
+{
+    QList<Destination> destinationList;
+    QStringList items = destinations.split(',', QString::SkipEmptyParts);
+
+    for (int i = 0; i < items.size(); i++)
+    {
+        QString item = items[i].trimmed();
+        Destination destination;
+        destination.port = defaultPort;
+        int colonIndex = item.indexOf(':');
+
+        if (colonIndex >= 0)
+        {
+            bool ok;
+            int port = item.mid(colonIndex + 1).toInt(&ok);
+
+            if (!ok || (port < 1) || (port > 65535))
+            {
+                qWarning("UDPSender::setDestinations: invalid port in %s", qPrintable(item));
+                continue;
+            }
+
+            destination.port = port;
+            item = item.left(colonIndex);
+        }
+
+        if (!destination.address.setAddress(item) || (destination.address.protocol() != QAbstractSocket::IPv4Protocol))
+        {
+            qWarning("UDPSender::setDestinations: invalid IPv4 address %s", qPrintable(item));
+            continue;
+        }
+
+        destinationList.append(destination);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_destinations = destinationList;
+    m_destinationsChanged = true;
+
+    return destinationList.size();
+}
+
+bool UDPSender::queueDatagram(const char *data, unsigned int size)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if ((m_count == m_nbSlots) || (size > m_maxDatagramSize))
+    {
+        m_droppedCount.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    unsigned int slot = (m_tail + m_count) % m_nbSlots;
+    memcpy(&m_slots[slot * m_maxDatagramSize], data, size);
+    m_slotSizes[slot] = size;
+    m_count++;
+    m_queueNotEmpty.wakeOne();
+
+    return true;
+}
+
+void UDPSender::run()
+{
+#if defined(__linux__)
+    m_socket = socket(AF_INET, SOCK_DGRAM, 0);
+
+    if (m_socket < 0)
+    {
+        qCritical("UDPSender::run: cannot create socket: %s", strerror(errno));
+        return;
+    }
+
+    int sendBufferSize = 1<<20;
+    unsigned char multicastTTL = 1;
+    unsigned char multicastLoop = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_SNDBUF, &sendBufferSize, sizeof(sendBufferSize));
+    setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_TTL, &multicastTTL, sizeof(multicastTTL));
+    setsockopt(m_socket, IPPROTO_IP, IP_MULTICAST_LOOP, &multicastLoop, sizeof(multicastLoop));
+#ifdef UDP_SEGMENT
+    // kernels before 4.18 ignore the UDP_SEGMENT control message and would send one oversized datagram
+    int gsoSize = 0;
+    socklen_t gsoSizeLen = sizeof(gsoSize);
+    m_gso = getsockopt(m_socket, SOL_UDP, UDP_SEGMENT, &gsoSize, &gsoSizeLen) == 0;
+
+    if (!m_gso) {
+        qDebug("UDPSender::run: UDP GSO not available: %s", strerror(errno));
+    }
+#endif
+#else
+    m_udpSocket = new QUdpSocket();
+#endif
+
+    m_mutex.lock();
+
+    while (m_running)
+    {
+        if (m_count == 0)
+        {
+            m_queueNotEmpty.wait(&m_mutex);
+            continue;
+        }
+
+        bool destinationsChanged = m_destinationsChanged;
+
+        if (m_destinationsChanged)
+        {
+            m_sendDestinations = m_destinations;
+            m_destinationsChanged = false;
+        }
+
+        // take contiguous slots so that a batch is a plain range of the pool
+        unsigned int first = m_tail;
+        unsigned int count = m_count < maxBatch ? m_count : maxBatch;
+        count = std::min(count, m_nbSlots - m_tail);
+        m_mutex.unlock();
+
+        if (destinationsChanged)
+        {
+            m_gsoMaxSizes.resize(m_sendDestinations.size());
+
+            for (int d = 0; d < m_sendDestinations.size(); d++) {
+                m_gsoMaxSizes[d] = getGSOMaxSize(m_sendDestinations[d]);
+            }
+        }
+
+        unsigned int failed = sendBatch(first, count);
+
+        m_mutex.lock();
+        m_tail = (m_tail + count) % m_nbSlots;
+        m_count -= count;
+        m_droppedCount.fetchAndAddRelaxed(failed);
+        m_sentCount.fetchAndAddRelaxed(count * m_sendDestinations.size() - failed);
+    }
+
+    m_mutex.unlock();
+
+#if defined(__linux__)
+    close(m_socket);
+    m_socket = -1;
+#else
+    delete m_udpSocket;
+    m_udpSocket = 0;
+#endif
+}
+
+#if defined(__linux__)
+
+unsigned int UDPSender::sendBatch(unsigned int first, unsigned int count)
+{
+    struct iovec iovs[maxBatch];
+    struct mmsghdr msgs[maxBatch];
+    unsigned int segments[maxBatch];
+#ifdef UDP_SEGMENT
+    char controls[maxBatch][CMSG_SPACE(sizeof(quint16))];
+#endif
+    struct sockaddr_in address;
+    unsigned int nbMsgs = 0;
+    unsigned int failed = 0;
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        iovs[i].iov_base = &m_slots[(first + i) * m_maxDatagramSize];
+        iovs[i].iov_len = m_slotSizes[first + i];
+    }
+
+    for (int d = 0; d < m_sendDestinations.size(); d++)
+    {
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(m_sendDestinations[d].address.toIPv4Address());
+        address.sin_port = htons(m_sendDestinations[d].port);
+        nbMsgs = 0;
+
+        // one message per datagram or per run of datagrams of the same size sent with GSO
+        for (unsigned int i = 0; i < count; i += segments[nbMsgs++])
+        {
+            memset(&msgs[nbMsgs], 0, sizeof(struct mmsghdr));
+            msgs[nbMsgs].msg_hdr.msg_name = &address;
+            msgs[nbMsgs].msg_hdr.msg_namelen = sizeof(address);
+            msgs[nbMsgs].msg_hdr.msg_iov = &iovs[i];
+            segments[nbMsgs] = 1;
+#ifdef UDP_SEGMENT
+            unsigned int size = iovs[i].iov_len;
+
+            if ((size > 0) && (size <= m_gsoMaxSizes[d]))
+            {
+                unsigned int maxSegments = 65507 / size < maxGSOSegments ? 65507 / size : maxGSOSegments;
+
+                while ((i + segments[nbMsgs] < count)
+                    && (segments[nbMsgs] < maxSegments)
+                    && (iovs[i + segments[nbMsgs]].iov_len == size))
+                {
+                    segments[nbMsgs]++;
+                }
+
+                if (segments[nbMsgs] > 1)
+                {
+                    msgs[nbMsgs].msg_hdr.msg_control = controls[nbMsgs];
+                    msgs[nbMsgs].msg_hdr.msg_controllen = sizeof(controls[nbMsgs]);
+                    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[nbMsgs].msg_hdr);
+                    cmsg->cmsg_level = SOL_UDP;
+                    cmsg->cmsg_type = UDP_SEGMENT;
+                    cmsg->cmsg_len = CMSG_LEN(sizeof(quint16));
+                    quint16 segmentSize = size;
+                    memcpy(CMSG_DATA(cmsg), &segmentSize, sizeof(quint16));
+                }
+            }
+#endif
+            msgs[nbMsgs].msg_hdr.msg_iovlen = segments[nbMsgs];
+        }
+
+        unsigned int index = 0;
+
+        while (index < nbMsgs)
+        {
+            int ret = sendmmsg(m_socket, &msgs[index], nbMsgs - index, 0);
+
+            if (ret > 0)
+            {
+                index += ret;
+                continue;
+            }
+
+            if (errno == EINTR) {
+                continue;
+            }
+#ifdef UDP_SEGMENT
+            if ((segments[index] > 1) && ((errno == EIO) || (errno == EINVAL) || (errno == ENOPROTOOPT)))
+            {
+                // no GSO on the interface of this destination: send the run one by one and stop coalescing for it
+                if (m_gsoMaxSizes[d] != 0)
+                {
+                    qWarning("UDPSender::sendBatch: UDP GSO not available for %s: %s",
+                        qPrintable(m_sendDestinations[d].address.toString()), strerror(errno));
+                    m_gsoMaxSizes[d] = 0;
+                }
+
+                for (unsigned int k = 0; k < segments[index]; k++)
+                {
+                    struct iovec *iov = &msgs[index].msg_hdr.msg_iov[k];
+
+                    if (sendto(m_socket, iov->iov_base, iov->iov_len, 0, (struct sockaddr *) &address, sizeof(address)) < 0) {
+                        failed++;
+                    }
+                }
+
+                index++;
+                continue;
+            }
+#endif
+            // e.g. ECONNREFUSED reported from a previous send: skip the message
+            failed += segments[index];
+            index++;
+        }
+    }
+
+    return failed;
+}
+
+unsigned int UDPSender::getGSOMaxSize(const Destination& destination)
+{
+#if defined(UDP_SEGMENT) && defined(IP_MTU)
+    if (!m_gso) {
+        return 0;
+    }
+
+    // the MTU of the route is read on a socket connected to the destination
+    int probe = socket(AF_INET, SOCK_DGRAM, 0);
+    int mtu = 0;
+    socklen_t mtuLen = sizeof(mtu);
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(destination.address.toIPv4Address());
+    address.sin_port = htons(destination.port);
+
+    if ((probe < 0)
+        || (::connect(probe, (struct sockaddr *) &address, sizeof(address)) < 0)
+        || (getsockopt(probe, IPPROTO_IP, IP_MTU, &mtu, &mtuLen) < 0))
+    {
+        qDebug("UDPSender::getGSOMaxSize: no MTU for %s: %s", qPrintable(destination.address.toString()), strerror(errno));
+        mtu = 0;
+    }
+
+    if (probe >= 0) {
+        close(probe);
+    }
+
+    return mtu > 28 ? mtu - 28 : 0; // IPv4 and UDP headers
+#else
+    return 0;
+#endif
+}
+
+#else
+
+unsigned int UDPSender::sendBatch(unsigned int first, unsigned int count)
+{
+    unsigned int failed = 0;
+
+    for (int d = 0; d < m_sendDestinations.size(); d++)
+    {
+        for (unsigned int i = first; i < first + count; i++)
+        {
+            if (m_udpSocket->writeDatagram(&m_slots[i * m_maxDatagramSize], m_slotSizes[i],
+                    m_sendDestinations[d].address, m_sendDestinations[d].port) < 0)
+            {
+                failed++;
+            }
+        }
+    }
+
+    return failed;
+}
+
+unsigned int UDPSender::getGSOMaxSize(const Destination&)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDE_UTIL_UDPSENDER_H_
+#define INCLUDE_UTIL_UDPSENDER_H_
+
+#include <QThread>
+#include <QMutex>
+#include <QAtomicInt>
+#include <QWaitCondition>
+#include <QHostAddress>
+#include <QList>
+#include <QString>
+#include <vector>
+
+#include "util/export.h"
+
+class QUdpSocket;
+
+/**
+ * Sends UDP datagrams to one or more destinations from its own thread. The DSP thread only copies
+ * completed datagrams into a fixed pool of slots and never waits on the network: when all slots are
+ * taken the datagram is dropped and counted. The sender thread takes the queued datagrams in batches
+ * and sends a batch with one sendmmsg call per destination on Linux. Runs of datagrams of the same
+ * size are then coalesced in single UDP GSO (generic segmentation offload) sends when the kernel
+ * supports it and the datagrams fit in the MTU of the route to the destination. Kernel support is
+ * probed on the socket when the thread starts and the MTU when the destinations change. A
+ * destination whose GSO sends fail gets its datagrams one by one from then on. Other systems
+ * write the datagrams one by one with a QUdpSocket.
+ *
+ * Destinations are IPv4 unicast or multicast addresses. Multicast is sent with a TTL of 1 and is
+ * looped back to the local host.
+ */
+class SDRANGEL_API UDPSender : public QThread
+{
+public:
+    struct Destination
+    {
+        QHostAddress address;
+        quint16 port;
+    };
+
+    UDPSender(unsigned int maxDatagramSize, unsigned int nbSlots = 256);
+    ~UDPSender();
+
+    void startWork();
+    void stopWork();
+
+    /** Sets the destinations from a comma separated list of address[:port]. Returns the number of valid destinations */
+    int setDestinations(const QString& destinations, quint16 defaultPort);
+    /** Copies a datagram to the send queue. Returns false if it was dropped because the queue is full */
+    bool queueDatagram(const char *data, unsigned int size);
+
+    quint32 getSentCount() const { return (quint32) m_sentCount.load(); }       //!< datagrams sent summed over all destinations
+    quint32 getDroppedCount() const { return (quint32) m_droppedCount.load(); } //!< datagrams dropped on a full queue or a send error
+
+    static const unsigned int maxBatch = 64;     //!< datagrams taken from the queue for one send
+    static const unsigned int maxGSOSegments = 64;
+
+protected:
+    void run();
+
+private:
+    unsigned int m_maxDatagramSize;
+    unsigned int m_nbSlots;
+    std::vector<char> m_slots;
+    std::vector<unsigned int> m_slotSizes;
+    unsigned int m_tail;                 //!< oldest queued slot
+    unsigned int m_count;                //!< number of queued slots
+    QMutex m_mutex;
+    QWaitCondition m_queueNotEmpty;
+    bool m_running;
+    QList<Destination> m_destinations;
+    bool m_destinationsChanged;
+    QAtomicInt m_sentCount;
+    QAtomicInt m_droppedCount;
+
+    // owned by the sender thread
+    QList<Destination> m_sendDestinations;
+    int m_socket;                        //!< native socket used with sendmmsg
+    bool m_gso;                          //!< UDP GSO is supported by the kernel
+    std::vector<unsigned int> m_gsoMaxSizes; //!< largest datagram coalesced with GSO per send destination, 0 for none
+    QUdpSocket *m_udpSocket;             //!< used where sendmmsg is not available
+
+    unsigned int sendBatch(unsigned int first, unsigned int count); //!< returns the number of failed datagram sends
+    unsigned int getGSOMaxSize(const Destination& destination); //!< largest datagram that fits the route MTU, 0 for no GSO
+};
+
+#endif /* INCLUDE_UTIL_UDPSENDER_H_ */
@@ -18,46 +18,33 @@
 #ifndef INCLUDE_UTIL_UDPSINK_H_
 #define INCLUDE_UTIL_UDPSINK_H_
 
-#include <QObject>
-#include <QUdpSocket>
-#include <QHostAddress>
-
 #include <cassert>
 
+#include "util/udpsender.h"
+
+/**
+ * Packs samples in datagrams of udpSize samples and hands the completed datagrams to a UDPSender
+ * that may be shared with other sinks.
+ */
 template<typename T>
 class UDPSink
 {
 public:
-	UDPSink(QObject *parent, unsigned int udpSize, unsigned int port) :
+	UDPSink(UDPSender *sender, unsigned int udpSize) :
+		m_sender(sender),
 		m_udpSize(udpSize),
-		m_address(QHostAddress::LocalHost),
-		m_port(port),
-		m_sampleBufferIndex(0)
-	{
-		m_sampleBuffer = new T[m_udpSize];
-		m_socket = new QUdpSocket(parent);
-	}
-
-	UDPSink (QObject *parent, unsigned int udpSize, QHostAddress& address, unsigned int port) :
-		m_udpSize(udpSize),
-		m_address(address),
-		m_port(port),
 		m_sampleBufferIndex(0)
 	{
 		assert(m_udpSize > 2);
+		assert(m_udpSize * sizeof(T) <= 65507);
 		m_sampleBuffer = new T[m_udpSize];
-		m_socket = new QUdpSocket(parent);
 	}
 
 	~UDPSink()
 	{
 		delete[] m_sampleBuffer;
-		delete m_socket;
 	}
 
-	void setAddress(QString& address) { m_address.setAddress(address); }
-	void setPort(unsigned int port) { m_port = port; }
-
 	void write(T sample)
 	{
 		if (m_sampleBufferIndex < m_udpSize)
@@ -67,19 +54,17 @@ public:
 		}
 		else
 		{
-			m_socket->writeDatagram((const char*)&m_sampleBuffer[0], (qint64 ) (m_udpSize * sizeof(T)), m_address, m_port);
+			m_sender->queueDatagram((const char*)&m_sampleBuffer[0], m_udpSize * sizeof(T));
 			m_sampleBuffer[0] = sample;
 			m_sampleBufferIndex = 1;
 		}
 	}
 
 private:
+	UDPSender *m_sender;
 	unsigned int m_udpSize;
-	QHostAddress m_address;
-	unsigned int m_port;
-	QUdpSocket *m_socket;
-	T *m_sampleBuffer;;
-	int m_sampleBufferIndex;
+	T *m_sampleBuffer;
+	unsigned int m_sampleBufferIndex;
 };
 
 
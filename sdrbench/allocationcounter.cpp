@@ -0,0 +1,56 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <cstdlib>
+#include <new>
+#include <QAtomicInt>
+
+#include "allocationcounter.h"
+
+static QAtomicInt nbAllocations(0);
+
+qint64 AllocationCounter::get()
+{
+    return nbAllocations.load();
+}
+
+void* operator new(std::size_t size)
+{
+    nbAllocations.fetchAndAddRelaxed(1);
+    void *p = std::malloc(size == 0 ? 1 : size);
+
+    if (!p) {
+        throw std::bad_alloc();
+    }
+
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+    std::free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+    std::free(p);
+}
@@ -0,0 +1,33 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBENCH_ALLOCATIONCOUNTER_H_
+#define SDRBENCH_ALLOCATIONCOUNTER_H_
+
+#include <QtGlobal>
+
+/**
+ * Counts the calls to the global operator new of the benchmark executable. Allocations made
+ * with malloc by C libraries (FFTW) are not seen.
+ */
+class AllocationCounter
+{
+public:
+    static qint64 get(); //!< number of allocations since the start of the program
+};
+
+#endif /* SDRBENCH_ALLOCATIONCOUNTER_H_ */
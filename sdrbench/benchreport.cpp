@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include "benchreport.h"
+
+BenchReport::BenchReport()
+{
+}
+
+BenchReport::~BenchReport()
+{
+}
+
+void BenchReport::setParameter(const std::string& name, qint64 value)
+{
+    m_parameters.push_back(std::pair<std::string, qint64>(name, value));
+}
+
+void BenchReport::add(const std::string& suite, const std::string& name, qint64 nbSamples, double seconds, qint64 allocations)
+{
+    record(suite, name, nbSamples, seconds, allocations);
+
+    printf("%-14s %-36s %10.2f MS/s %10.2f ns/S %8lld allocs\n",
+            suite.c_str(),
+            name.c_str(),
+            msps(nbSamples, seconds),
+            nsPerSample(nbSamples, seconds),
+            allocations);
+}
+
+void BenchReport::record(const std::string& suite, const std::string& name, qint64 nbSamples, double seconds, qint64 allocations)
+{
+    Result result;
+    result.m_suite = suite;
+    result.m_name = name;
+    result.m_nbSamples = nbSamples;
+    result.m_seconds = seconds;
+    result.m_allocations = allocations;
+    m_results.push_back(result);
+}
+
+bool BenchReport::writeJSON(const char *fileName) const
+{
+    FILE *file = fopen(fileName, "w");
+
+    if (!file)
+    {
+        fprintf(stderr, "BenchReport::writeJSON: cannot open %s\n", fileName);
+        return false;
+    }
+
+    // names are plain identifiers built by the benchmarks so no escaping is needed
+    fprintf(file, "{\n  \"parameters\": {");
+
+    for (unsigned int i = 0; i < m_parameters.size(); i++) {
+        fprintf(file, "%s\n    \"%s\": %lld", i == 0 ? "" : ",", m_parameters[i].first.c_str(), m_parameters[i].second);
+    }
+
+    fprintf(file, "\n  },\n  \"results\": [");
+
+    for (unsigned int i = 0; i < m_results.size(); i++)
+    {
+        const Result& r = m_results[i];
+        fprintf(file, "%s\n    {\"suite\": \"%s\", \"name\": \"%s\", \"samples\": %lld, \"seconds\": %.9f, \"msps\": %.4f, \"ns_per_sample\": %.4f, \"allocations\": %lld}",
+                i == 0 ? "" : ",",
+                r.m_suite.c_str(),
+                r.m_name.c_str(),
+                r.m_nbSamples,
+                r.m_seconds,
+                msps(r.m_nbSamples, r.m_seconds),
+                nsPerSample(r.m_nbSamples, r.m_seconds),
+                r.m_allocations);
+    }
+
+    fprintf(file, "\n  ]\n}\n");
+    fclose(file);
+
+    return true;
+}
@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBENCH_BENCHREPORT_H_
+#define SDRBENCH_BENCHREPORT_H_
+
+#include <string>
+#include <vector>
+#include <QtGlobal>
+
+/**
+ * Collects the results of the benchmarks and writes them as JSON so that they can be
+ * compared from one build to the next
+ */
+class BenchReport
+{
+public:
+    struct Result
+    {
+        std::string m_suite;
+        std::string m_name;
+        qint64 m_nbSamples;    //!< number of input samples (or transforms) processed
+        double m_seconds;      //!< processing time
+        qint64 m_allocations;  //!< number of heap allocations during the run, -1 if not counted
+    };
+
+    BenchReport();
+    ~BenchReport();
+
+    void setParameter(const std::string& name, qint64 value);
+    /** Adds a result and prints it on the standard output */
+    void add(const std::string& suite, const std::string& name, qint64 nbSamples, double seconds, qint64 allocations = -1);
+    /** Adds a result without printing it for the suites that print their own comparison tables */
+    void record(const std::string& suite, const std::string& name, qint64 nbSamples, double seconds, qint64 allocations = -1);
+    bool writeJSON(const char *fileName) const;
+
+    static double msps(qint64 nbSamples, double seconds) { return seconds > 0.0 ? (nbSamples / seconds) / 1e6 : 0.0; }
+    static double nsPerSample(qint64 nbSamples, double seconds) { return nbSamples > 0 ? (seconds * 1e9) / nbSamples : 0.0; }
+
+private:
+    std::vector<std::pair<std::string, qint64> > m_parameters;
+    std::vector<Result> m_results;
+};
+
+#endif /* SDRBENCH_BENCHREPORT_H_ */
@@ -0,0 +1,149 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <cstdlib>
+#include <QElapsedTimer>
+
+#include "dsp/basebandsamplesink.h"
+#include "dsp/downchannelizer.h"
+#include "dsp/dspcommands.h"
+#include "allocationcounter.h"
+#include "benchreport.h"
+#include "channelizerbench.h"
+
+/** Sink that only accumulates a checksum of what it receives */
+class ChecksumSink : public BasebandSampleSink
+{
+public:
+    ChecksumSink() : m_checksum(0), m_nbSamples(0) {}
+    virtual ~ChecksumSink() {}
+
+    virtual void start() {}
+    virtual void stop() {}
+    virtual bool handleMessage(const Message& cmd __attribute__((unused))) { return true; }
+
+    virtual void feed(const SampleVector::const_iterator& begin, const SampleVector::const_iterator& end, bool positiveOnly __attribute__((unused)))
+    {
+        for (SampleVector::const_iterator it = begin; it != end; ++it)
+        {
+            m_checksum = m_checksum * 31 + (quint16) it->m_real;
+            m_checksum = m_checksum * 31 + (quint16) it->m_imag;
+        }
+
+        m_nbSamples += end - begin;
+    }
+
+    quint64 m_checksum;
+    int m_nbSamples;
+};
+
+ChannelizerBench::ChannelizerBench(int nbSamples, int blockSize, BenchReport *report) :
+    m_nbSamples(nbSamples),
+    m_blockSize(blockSize),
+    m_inputSampleRate(4800000),
+    m_report(report)
+{
+    generate();
+}
+
+ChannelizerBench::~ChannelizerBench()
+{
+}
+
+void ChannelizerBench::generate()
+{
+    m_samples.resize(m_nbSamples);
+    std::srand(0);
+
+    for (int i = 0; i < m_nbSamples; i++)
+    {
+        m_samples[i].setReal((FixReal) ((std::rand() % 32768) - 16384));
+        m_samples[i].setImag((FixReal) ((std::rand() % 32768) - 16384));
+    }
+}
+
+double ChannelizerBench::runPath(int log2Decim, int channelFrequency, bool blockProcessing, quint64& checksum, int& nbOutSamples, qint64& allocations)
+{
+    ChecksumSink sink;
+    DownChannelizer channelizer(&sink);
+    channelizer.setBlockProcessing(blockProcessing);
+
+    DSPSignalNotification notif(m_inputSampleRate, 0);
+    channelizer.handleMessage(notif);
+    DSPConfigureChannelizer config(m_inputSampleRate >> log2Decim, channelFrequency);
+    channelizer.handleMessage(config);
+
+    allocations = AllocationCounter::get();
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < m_nbSamples; i += m_blockSize)
+    {
+        int n = (m_nbSamples - i) < m_blockSize ? m_nbSamples - i : m_blockSize;
+        channelizer.feed(m_samples.begin() + i, m_samples.begin() + i + n, false);
+    }
+
+    qint64 nsecs = timer.nsecsElapsed();
+    allocations = AllocationCounter::get() - allocations;
+    checksum = sink.m_checksum;
+    nbOutSamples = sink.m_nbSamples;
+
+    return nsecs / 1e9;
+}
+
+void ChannelizerBench::run()
+{
+    static const char *positions[3] = {"lower", "center", "upper"};
+
+    printf("DownChannelizer: %d samples at %d S/s in blocks of %d\n", m_nbSamples, m_inputSampleRate, m_blockSize);
+    printf("%6s %7s %12s %12s %8s %s\n", "decim", "pos", "sample MS/s", "block MS/s", "speedup", "match");
+
+    for (int log2Decim = 1; log2Decim <= 6; log2Decim++)
+    {
+        int channelBandwidth = m_inputSampleRate >> log2Decim;
+        int frequencies[3] = {
+            -m_inputSampleRate/2 + channelBandwidth/2, // lower edge
+            0,                                         // center
+            m_inputSampleRate/2 - channelBandwidth/2   // upper edge
+        };
+
+        for (int pos = 0; pos < 3; pos++)
+        {
+            quint64 sampleChecksum, blockChecksum;
+            int sampleNbOut, blockNbOut;
+            qint64 sampleAllocations, blockAllocations;
+            double sampleTime = runPath(log2Decim, frequencies[pos], false, sampleChecksum, sampleNbOut, sampleAllocations);
+            double blockTime = runPath(log2Decim, frequencies[pos], true, blockChecksum, blockNbOut, blockAllocations);
+            bool match = (sampleChecksum == blockChecksum) && (sampleNbOut == blockNbOut);
+
+            printf("%6d %7s %12.2f %12.2f %8.2f %s\n",
+                    1<<log2Decim,
+                    positions[pos],
+                    sampleTime > 0.0 ? (m_nbSamples / sampleTime) / 1e6 : 0.0,
+                    blockTime > 0.0 ? (m_nbSamples / blockTime) / 1e6 : 0.0,
+                    blockTime > 0.0 ? sampleTime / blockTime : 0.0,
+                    match ? "yes" : "NO");
+
+            char name[64];
+            snprintf(name, sizeof(name), "decim%d_%s_sample", 1<<log2Decim, positions[pos]);
+            m_report->record("channelizer", name, m_nbSamples, sampleTime, sampleAllocations);
+            snprintf(name, sizeof(name), "decim%d_%s_block", 1<<log2Decim, positions[pos]);
+            m_report->record("channelizer", name, m_nbSamples, blockTime, blockAllocations);
+        }
+    }
+}
@@ -0,0 +1,48 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBENCH_CHANNELIZERBENCH_H_
+#define SDRBENCH_CHANNELIZERBENCH_H_
+
+#include "dsp/dsptypes.h"
+
+class BenchReport;
+
+/**
+ * Compares the block and the sample by sample paths of the DownChannelizer
+ * for decimations by 2^1 to 2^6 in lower, center and upper positions
+ */
+class ChannelizerBench
+{
+public:
+    ChannelizerBench(int nbSamples, int blockSize, BenchReport *report);
+    ~ChannelizerBench();
+
+    void run();
+
+private:
+    int m_nbSamples;
+    int m_blockSize;
+    int m_inputSampleRate;
+    BenchReport *m_report;
+    SampleVector m_samples;
+
+    void generate();
+    double runPath(int log2Decim, int channelFrequency, bool blockProcessing, quint64& checksum, int& nbOutSamples, qint64& allocations);
+};
+
+#endif /* SDRBENCH_CHANNELIZERBENCH_H_ */
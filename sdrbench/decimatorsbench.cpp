@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <cstdlib>
+#include <QElapsedTimer>
+
+#include "dsp/decimators.h"
+#include "dsp/decimatorssimd.h"
+#include "benchreport.h"
+#include "decimatorsbench.h"
+
+DecimatorsBench::DecimatorsBench(int nbSamples, int blockSize, BenchReport *report) :
+    m_nbSamples(nbSamples),
+    m_blockSize(blockSize),
+    m_report(report)
+{
+}
+
+DecimatorsBench::~DecimatorsBench()
+{
+}
+
+template<typename T, uint InputBits>
+double DecimatorsBench::runPath(const std::vector<T>& buf, int log2Decim, int pos, quint64& checksum)
+{
+    Decimators<T, SDR_SAMP_SZ, InputBits> decimators;
+    SampleVector convertBuffer(m_blockSize);
+    int len = 2*m_blockSize; // I/Q interleaved
+    checksum = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i + len <= (int) buf.size(); i += len)
+    {
+        SampleVector::iterator it = convertBuffer.begin();
+        const T *b = &buf[i];
+
+        switch (log2Decim)
+        {
+        case 0:
+            decimators.decimate1(&it, b, len);
+            break;
+        case 1:
+            pos == 0 ? decimators.decimate2_inf(&it, b, len) : pos == 1 ? decimators.decimate2_sup(&it, b, len) : decimators.decimate2_cen(&it, b, len);
+            break;
+        case 2:
+            pos == 0 ? decimators.decimate4_inf(&it, b, len) : pos == 1 ? decimators.decimate4_sup(&it, b, len) : decimators.decimate4_cen(&it, b, len);
+            break;
+        case 3:
+            pos == 0 ? decimators.decimate8_inf(&it, b, len) : pos == 1 ? decimators.decimate8_sup(&it, b, len) : decimators.decimate8_cen(&it, b, len);
+            break;
+        case 4:
+            pos == 0 ? decimators.decimate16_inf(&it, b, len) : pos == 1 ? decimators.decimate16_sup(&it, b, len) : decimators.decimate16_cen(&it, b, len);
+            break;
+        case 5:
+            pos == 0 ? decimators.decimate32_inf(&it, b, len) : pos == 1 ? decimators.decimate32_sup(&it, b, len) : decimators.decimate32_cen(&it, b, len);
+            break;
+        default:
+            pos == 0 ? decimators.decimate64_inf(&it, b, len) : pos == 1 ? decimators.decimate64_sup(&it, b, len) : decimators.decimate64_cen(&it, b, len);
+            break;
+        }
+
+        // checksum is part of the timed loop as a sink would read the samples anyway
+        for (SampleVector::const_iterator s = convertBuffer.begin(); s != it; ++s) {
+            checksum = checksum * 31 + (((quint32) (quint16) s->m_real) << 16 | (quint16) s->m_imag);
+        }
+    }
+
+    return timer.nsecsElapsed() / 1e9;
+}
+
+template<typename T, uint InputBits>
+void DecimatorsBench::runType(const char *typeName, int minValue, int maxValue)
+{
+    static const char *positions[3] = {"inf", "sup", "cen"};
+    std::vector<T> buf(2*(m_nbSamples - m_nbSamples % m_blockSize));
+    std::srand(0);
+
+    for (unsigned int i = 0; i < buf.size(); i++) {
+        buf[i] = (T) (minValue + std::rand() % (maxValue - minValue + 1));
+    }
+
+    int nbSamples = buf.size() / 2;
+    DecimatorsSIMD::Level detected = DecimatorsSIMD::getDetectedLevel();
+
+    printf("Decimators %s: %d samples in blocks of %d\n", typeName, nbSamples, m_blockSize);
+    printf("%6s %4s %12s %12s %8s %s\n", "decim", "pos", "scalar MS/s", "simd MS/s", "speedup", "match");
+
+    for (int log2Decim = 0; log2Decim <= 6; log2Decim++)
+    {
+        for (int pos = 0; pos < (log2Decim == 0 ? 1 : 3); pos++)
+        {
+            quint64 scalarChecksum, simdChecksum;
+            DecimatorsSIMD::setLevel(DecimatorsSIMD::LevelNone);
+            double scalarTime = runPath<T, InputBits>(buf, log2Decim, pos, scalarChecksum);
+            DecimatorsSIMD::setLevel(detected);
+            double simdTime = runPath<T, InputBits>(buf, log2Decim, pos, simdChecksum);
+
+            printf("%6d %4s %12.2f %12.2f %8.2f %s\n",
+                    1<<log2Decim,
+                    log2Decim == 0 ? "-" : positions[pos],
+                    scalarTime > 0.0 ? (nbSamples / scalarTime) / 1e6 : 0.0,
+                    simdTime > 0.0 ? (nbSamples / simdTime) / 1e6 : 0.0,
+                    simdTime > 0.0 ? scalarTime / simdTime : 0.0,
+                    scalarChecksum == simdChecksum ? "yes" : "NO");
+
+            char name[64];
+            snprintf(name, sizeof(name), "%s_decim%d_%s_scalar", typeName, 1<<log2Decim, log2Decim == 0 ? "none" : positions[pos]);
+            m_report->record("decimators", name, nbSamples, scalarTime);
+            snprintf(name, sizeof(name), "%s_decim%d_%s_simd", typeName, 1<<log2Decim, log2Decim == 0 ? "none" : positions[pos]);
+            m_report->record("decimators", name, nbSamples, simdTime);
+        }
+    }
+}
+
+void DecimatorsBench::run()
+{
+    printf("Decimators: SIMD level %s\n", DecimatorsSIMD::getLevelName(DecimatorsSIMD::getDetectedLevel()));
+    runType<quint8, 8>("u8", 0, 255);
+    runType<qint8, 8>("i8", -128, 127);
+    runType<qint16, 12>("i12", -2048, 2047);
+}
@@ -0,0 +1,47 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBENCH_DECIMATORSBENCH_H_
+#define SDRBENCH_DECIMATORSBENCH_H_
+
+#include <vector>
+#include "dsp/dsptypes.h"
+
+class BenchReport;
+
+/**
+ * Compares the scalar and the vectorized paths of the Decimators used by device threads
+ * for 8 bit unsigned (RTL-SDR), 8 bit signed (HackRF) and 12 bit (Airspy, LimeSDR, ...) inputs
+ */
+class DecimatorsBench
+{
+public:
+    DecimatorsBench(int nbSamples, int blockSize, BenchReport *report);
+    ~DecimatorsBench();
+
+    void run();
+
+private:
+    int m_nbSamples;
+    int m_blockSize;
+    BenchReport *m_report;
+
+    template<typename T, uint InputBits> void runType(const char *typeName, int minValue, int maxValue);
+    template<typename T, uint InputBits> double runPath(const std::vector<T>& buf, int log2Decim, int pos, quint64& checksum);
+};
+
+#endif /* SDRBENCH_DECIMATORSBENCH_H_ */
@@ -0,0 +1,492 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <cstdlib>
+#include <algorithm>
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <QElapsedTimer>
+
+#include "dsp/inthalfbandfilter.h"
+#include "dsp/inthalfbandfilterdb.h"
+#include "dsp/inthalfbandfiltereo1.h"
+#include "dsp/inthalfbandfilterst.h"
+#include "dsp/inthalfbandfiltereo1i.h"
+#include "dsp/inthalfbandfiltersti.h"
+#include "dsp/interpolator.h"
+#include "dsp/fftfilt.h"
+#include "dsp/fftengine.h"
+#include "dsp/nco.h"
+#include "dsp/ncof.h"
+#include "dsp/phasediscri.h"
+#include "dsp/ctcssdetector.h"
+#include "allocationcounter.h"
+#include "benchreport.h"
+#include "dspbench.h"
+
+DSPBench::DSPBench(int nbSamples, int blockSize, int sampleRate, BenchReport *report) :
+    m_nbSamples(nbSamples - nbSamples % blockSize),
+    m_blockSize(blockSize),
+    m_sampleRate(sampleRate),
+    m_report(report),
+    m_checksum(0)
+{
+    generate();
+}
+
+DSPBench::~DSPBench()
+{
+}
+
+void DSPBench::generate()
+{
+    m_samples.resize(m_nbSamples);
+    m_complex.resize(m_nbSamples);
+    double phase = 0.0;
+    double phaseIncrement = (2.0 * M_PI * 0.1234); // tone at 0.1234 of the sample rate
+    std::srand(0);
+
+    for (int i = 0; i < m_nbSamples; i++)
+    {
+        qint16 re = (qint16) (8192.0 * cos(phase) + (std::rand() % 2048) - 1024);
+        qint16 im = (qint16) (8192.0 * sin(phase) + (std::rand() % 2048) - 1024);
+        m_samples[i] = Sample(re, im);
+        m_complex[i] = Complex(re, im);
+        phase += phaseIncrement;
+
+        if (phase > 2.0 * M_PI) {
+            phase -= 2.0 * M_PI;
+        }
+    }
+}
+
+void DSPBench::run(const std::string& suite)
+{
+    printf("DSP: %d samples at %d S/s in blocks of %d\n", m_nbSamples, m_sampleRate, m_blockSize);
+
+    if (suite.empty() || (suite == "halfband")) {
+        runHalfbands();
+    }
+    if (suite.empty() || (suite == "interpolator")) {
+        runInterpolator();
+    }
+    if (suite.empty() || (suite == "fftfilt")) {
+        runFFTFilter();
+    }
+    if (suite.empty() || (suite == "nco")) {
+        runNCO();
+    }
+    if (suite.empty() || (suite == "phasediscri")) {
+        runPhaseDiscriminators();
+    }
+    if (suite.empty() || (suite == "ctcss")) {
+        runCTCSS();
+    }
+    if (suite.empty() || (suite == "fft")) {
+        runFFT();
+    }
+
+    printf("DSP: checksum %llx\n", m_checksum);
+}
+
+template<class HBFilter>
+void DSPBench::runHalfband(const char *filterName)
+{
+    static const char *positions[3] = {"center", "lower", "upper"};
+
+    for (int pos = 0; pos < 3; pos++)
+    {
+        HBFilter filter;
+        Sample s;
+        qint64 allocations = AllocationCounter::get();
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < m_nbSamples; i++)
+        {
+            s = m_samples[i];
+            bool out = pos == 0 ? filter.workDecimateCenter(&s) : pos == 1 ? filter.workDecimateLowerHalf(&s) : filter.workDecimateUpperHalf(&s);
+
+            if (out) {
+                m_checksum += s.m_real ^ s.m_imag;
+            }
+        }
+
+        double seconds = timer.nsecsElapsed() / 1e9;
+        m_report->add("halfband", std::string(filterName) + "_" + positions[pos], m_nbSamples, seconds, AllocationCounter::get() - allocations);
+    }
+}
+
+template<uint32_t HBFilterOrder>
+void DSPBench::runHalfbandKernelEO1(bool intrinsics)
+{
+    // same ring buffers and pointer walk as IntHalfbandFilterEO1. The filter itself only
+    // runs the intrinsics when built with SSE 4.1 so both kernels are compared here.
+    const int size = HBFIRFilterTraits<HBFilterOrder>::hbOrder / 2;
+    int32_t even[2][HBFilterOrder];
+    int32_t odd[2][HBFilterOrder];
+    std::fill(&even[0][0], &even[0][0] + 2*HBFilterOrder, 0);
+    std::fill(&odd[0][0], &odd[0][0] + 2*HBFilterOrder, 0);
+    quint64 checksum = 0;
+    qint64 allocations = AllocationCounter::get();
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < m_nbSamples; i++)
+    {
+        int ptr = i % (2*size);
+        int32_t (*buf)[HBFilterOrder] = (ptr % 2) == 0 ? even : odd;
+        buf[0][ptr/2] = buf[0][ptr/2 + size] = m_samples[i].m_real;
+        buf[1][ptr/2] = buf[1][ptr/2 + size] = m_samples[i].m_imag;
+        int32_t iAcc = 0;
+        int32_t qAcc = 0;
+
+        if (intrinsics)
+        {
+            IntHalfbandFilterEO1Intrisics<HBFilterOrder>::work(ptr, even, odd, iAcc, qAcc);
+        }
+        else
+        {
+            int a = ptr/2 + size; // tip pointer
+            int b = ptr/2 + 1; // tail pointer
+
+            for (int j = 0; j < HBFIRFilterTraits<HBFilterOrder>::hbOrder / 4; j++)
+            {
+                iAcc += (buf[0][a] + buf[0][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[j];
+                qAcc += (buf[1][a] + buf[1][b]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[j];
+                a -= 1;
+                b += 1;
+            }
+        }
+
+        checksum = checksum * 31 + (quint32) (iAcc ^ qAcc);
+    }
+
+    double seconds = timer.nsecsElapsed() / 1e9;
+    char name[64];
+    snprintf(name, sizeof(name), "%s_%d_kernel", intrinsics ? "eo1i" : "eo1", HBFilterOrder);
+    m_report->add("halfband", name, m_nbSamples, seconds, AllocationCounter::get() - allocations);
+    m_kernelChecksums.push_back(checksum);
+}
+
+template<uint32_t HBFilterOrder>
+void DSPBench::runHalfbandKernelST(bool intrinsics)
+{
+    // same double buffer and pointer walk as IntHalfbandFilterST
+    const int size = HBFIRFilterTraits<HBFilterOrder>::hbOrder;
+    int32_t samplesDB[2*HBFilterOrder][2];
+    std::fill(&samplesDB[0][0], &samplesDB[0][0] + 4*HBFilterOrder, 0);
+    quint64 checksum = 0;
+    qint64 allocations = AllocationCounter::get();
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < m_nbSamples; i++)
+    {
+        int ptr = i % size;
+        samplesDB[ptr][0] = samplesDB[ptr + size][0] = m_samples[i].m_real;
+        samplesDB[ptr][1] = samplesDB[ptr + size][1] = m_samples[i].m_imag;
+
+        if ((ptr % 2) == 0) { // even and odd outputs are computed on odd samples
+            continue;
+        }
+
+        int32_t iEvenAcc = 0, qEvenAcc = 0, iOddAcc = 0, qOddAcc = 0;
+
+        if (intrinsics)
+        {
+            IntHalfbandFilterSTIntrinsics<HBFilterOrder>::workNA(ptr + 1, samplesDB, iEvenAcc, qEvenAcc, iOddAcc, qOddAcc);
+        }
+        else
+        {
+            int a = ptr + size; // tip pointer - odd
+            int b = ptr + 1; // tail pointer - even
+
+            for (int j = 0; j < HBFIRFilterTraits<HBFilterOrder>::hbOrder / 4; j++)
+            {
+                iEvenAcc += (samplesDB[a-1][0] + samplesDB[b][0])   * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[j];
+                iOddAcc  += (samplesDB[a][0]   + samplesDB[b+1][0]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[j];
+                qEvenAcc += (samplesDB[a-1][1] + samplesDB[b][1])   * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[j];
+                qOddAcc  += (samplesDB[a][1]   + samplesDB[b+1][1]) * HBFIRFilterTraits<HBFilterOrder>::hbCoeffs[j];
+                a -= 2;
+                b += 2;
+            }
+        }
+
+        checksum = checksum * 31 + (quint32) (iEvenAcc ^ qEvenAcc);
+        checksum = checksum * 31 + (quint32) (iOddAcc ^ qOddAcc);
+    }
+
+    double seconds = timer.nsecsElapsed() / 1e9;
+    char name[64];
+    snprintf(name, sizeof(name), "%s%d_kernel", intrinsics ? "sti" : "st", HBFilterOrder);
+    m_report->add("halfband", name, m_nbSamples, seconds, AllocationCounter::get() - allocations);
+    m_kernelChecksums.push_back(checksum);
+}
+
+void DSPBench::runHalfbands()
+{
+    runHalfband<IntHalfbandFilter<48> >("plain48");
+    runHalfband<IntHalfbandFilterDB<48> >("db48");
+    runHalfband<IntHalfbandFilterEO1<48> >("eo1_48");
+    runHalfband<IntHalfbandFilterEO1<96> >("eo1_96");
+    runHalfband<IntHalfbandFilterST<48> >("st48");
+
+    m_kernelChecksums.clear();
+    runHalfbandKernelEO1<48>(false);
+    runHalfbandKernelEO1<96>(false);
+    runHalfbandKernelST<48>(false);
+#if defined(USE_SSE4_1)
+    runHalfbandKernelEO1<48>(true);
+    runHalfbandKernelEO1<96>(true);
+    runHalfbandKernelST<48>(true);
+    bool match = std::equal(m_kernelChecksums.begin(), m_kernelChecksums.begin() + 3, m_kernelChecksums.begin() + 3);
+    printf("DSP: EO1i and STi kernels match the scalar kernels: %s\n", match ? "yes" : "NO");
+#else
+    printf("DSP: EO1i and STi kernels not built (needs SSE 4.1)\n");
+#endif
+
+    for (int i = 0; i < (int) m_kernelChecksums.size(); i++) {
+        m_checksum ^= (qint64) m_kernelChecksums[i];
+    }
+}
+
+void DSPBench::runInterpolator()
+{
+    Real distance = (Real) m_sampleRate / 48000;
+    std::vector<Complex> out(m_blockSize);
+
+    for (int block = 0; block < 2; block++)
+    {
+        Interpolator interpolator;
+        interpolator.create(16, m_sampleRate, 48000 / 2.2);
+        Real distanceRemain = 0;
+        Complex ci;
+        qint64 allocations = AllocationCounter::get();
+        QElapsedTimer timer;
+        timer.start();
+
+        if (block)
+        {
+            for (int i = 0; i < m_nbSamples; i += m_blockSize)
+            {
+                int nbOut = interpolator.decimate(&distanceRemain, distance, &m_complex[i], m_blockSize, &out[0]);
+
+                if (nbOut > 0) {
+                    m_checksum += (qint64) out[nbOut - 1].real();
+                }
+            }
+        }
+        else
+        {
+            for (int i = 0; i < m_nbSamples; i++)
+            {
+                if (interpolator.decimate(&distanceRemain, m_complex[i], &ci))
+                {
+                    m_checksum += (qint64) ci.real();
+                    distanceRemain += distance;
+                }
+            }
+        }
+
+        double seconds = timer.nsecsElapsed() / 1e9;
+        char name[64];
+        snprintf(name, sizeof(name), "decimate_%d_%s_%d_taps", m_sampleRate / 48000, block ? "block" : "sample", interpolator.getNbTaps());
+        m_report->add("interpolator", name, m_nbSamples, seconds, AllocationCounter::get() - allocations);
+    }
+}
+
+void DSPBench::runFFTFilter()
+{
+    static const char *modes[2] = {"filt", "ssb"};
+    const int fftLen = 1024;
+    std::vector<fftfilt::cmplx> out(m_blockSize + fftLen);
+
+    for (int mode = 0; mode < 2; mode++)
+    {
+        for (int block = 0; block < 2; block++)
+        {
+            fftfilt filter(0.01f, 0.2f, fftLen);
+            fftfilt::cmplx *rf;
+            qint64 allocations = AllocationCounter::get();
+            QElapsedTimer timer;
+            timer.start();
+
+            if (block)
+            {
+                for (int i = 0; i < m_nbSamples; i += m_blockSize)
+                {
+                    int nbOut = mode == 0 ?
+                            filter.runFilt(&m_complex[i], m_blockSize, &out[0]) :
+                            filter.runSSB(&m_complex[i], m_blockSize, &out[0], true);
+
+                    if (nbOut > 0) {
+                        m_checksum += (qint64) out[nbOut - 1].real();
+                    }
+                }
+            }
+            else
+            {
+                for (int i = 0; i < m_nbSamples; i++)
+                {
+                    int nbOut = mode == 0 ?
+                            filter.runFilt(m_complex[i], &rf) :
+                            filter.runSSB(m_complex[i], &rf, true);
+
+                    if (nbOut > 0) {
+                        m_checksum += (qint64) rf[nbOut - 1].real();
+                    }
+                }
+            }
+
+            double seconds = timer.nsecsElapsed() / 1e9;
+            char name[64];
+            snprintf(name, sizeof(name), "%s_%d_%s", modes[mode], fftLen, block ? "block" : "sample");
+            m_report->add("fftfilt", name, m_nbSamples, seconds, AllocationCounter::get() - allocations);
+        }
+    }
+}
+
+void DSPBench::runNCO()
+{
+    std::vector<Complex> out(m_blockSize);
+
+    for (int type = 0; type < 2; type++)
+    {
+        for (int block = 0; block < 2; block++)
+        {
+            NCO nco;
+            NCOF ncof;
+            nco.setFreq(12345.0, m_sampleRate);
+            ncof.setFreq(12345.0, m_sampleRate);
+            qint64 allocations = AllocationCounter::get();
+            QElapsedTimer timer;
+            timer.start();
+
+            for (int i = 0; i < m_nbSamples; i += m_blockSize)
+            {
+                if (block && (type == 0))
+                {
+                    nco.mixIQ(&m_samples[i], &out[0], m_blockSize);
+                }
+                else if (block)
+                {
+                    ncof.mixIQ(&m_samples[i], &out[0], m_blockSize);
+                }
+                else
+                {
+                    for (int j = 0; j < m_blockSize; j++)
+                    {
+                        Complex c(m_samples[i+j].real(), m_samples[i+j].imag());
+                        out[j] = c * (type == 0 ? nco.nextIQ() : ncof.nextIQ());
+                    }
+                }
+
+                m_checksum += (qint64) out[m_blockSize - 1].real();
+            }
+
+            double seconds = timer.nsecsElapsed() / 1e9;
+            m_report->add("nco", std::string(type == 0 ? "nco" : "ncof") + (block ? "_mix_block" : "_nextiq_sample"), m_nbSamples, seconds, AllocationCounter::get() - allocations);
+        }
+    }
+}
+
+void DSPBench::runPhaseDiscriminators()
+{
+    for (int delta = 0; delta < 2; delta++)
+    {
+        PhaseDiscriminators phaseDiscri;
+        phaseDiscri.setFMScaling(m_sampleRate / 5000.0f);
+        double magsq;
+        Real fmDev;
+        Real sum = 0;
+        qint64 allocations = AllocationCounter::get();
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < m_nbSamples; i++) {
+            sum += delta ? phaseDiscri.phaseDiscriminatorDelta(m_complex[i], magsq, fmDev) : phaseDiscri.phaseDiscriminator(m_complex[i]);
+        }
+
+        double seconds = timer.nsecsElapsed() / 1e9;
+        m_checksum += (qint64) sum;
+        m_report->add("phasediscri", delta ? "phase_discriminator_delta" : "phase_discriminator", m_nbSamples, seconds, AllocationCounter::get() - allocations);
+    }
+}
+
+void DSPBench::runCTCSS()
+{
+    CTCSSDetector detector;
+    detector.setCoefficients(3000, 6000); // as in NFMDemod: 0.5s / 2 Hz resolution at 6 kS/s
+    int maxToneIndex;
+    qint64 allocations = AllocationCounter::get();
+    QElapsedTimer timer;
+    timer.start();
+
+    for (int i = 0; i < m_nbSamples; i++)
+    {
+        Real sample = m_complex[i].real() / 32768.0f;
+
+        if (detector.analyze(&sample) && detector.getDetectedTone(maxToneIndex)) {
+            m_checksum += maxToneIndex;
+        }
+    }
+
+    double seconds = timer.nsecsElapsed() / 1e9;
+    m_report->add("ctcss", "analyze_6000", m_nbSamples, seconds, AllocationCounter::get() - allocations);
+}
+
+void DSPBench::runFFT()
+{
+    for (int log2Size = 8; log2Size <= 14; log2Size += 2)
+    {
+        int fftSize = 1 << log2Size;
+
+        if (fftSize > m_nbSamples)
+        {
+            printf("DSP: FFT of size %d skipped as there are only %d samples\n", fftSize, m_nbSamples);
+            continue;
+        }
+
+        FFTEngine *fft = FFTEngine::create();
+
+        if (!fft) { // no engine built
+            return;
+        }
+
+        fft->configure(fftSize, false);
+        int nbTransforms = m_nbSamples / fftSize > 16 ? m_nbSamples / fftSize : 16;
+        qint64 allocations = AllocationCounter::get();
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int i = 0; i < nbTransforms; i++)
+        {
+            int offset = (int) (((qint64) i * fftSize) % (m_nbSamples - fftSize + 1));
+            std::copy(m_complex.begin() + offset, m_complex.begin() + offset + fftSize, fft->in());
+            fft->transform();
+            m_checksum += (qint64) fft->out()[1].real();
+        }
+
+        double seconds = timer.nsecsElapsed() / 1e9;
+        char name[64];
+        snprintf(name, sizeof(name), "forward_%d", fftSize);
+        m_report->add("fft", name, (qint64) nbTransforms * fftSize, seconds, AllocationCounter::get() - allocations);
+        delete fft;
+    }
+}
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBENCH_DSPBENCH_H_
+#define SDRBENCH_DSPBENCH_H_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "dsp/dsptypes.h"
+
+class BenchReport;
+
+/**
+ * Runs the DSP kernels of the channel plugins on synthetic I/Q at a given sample rate:
+ * half band filters and their SSE 4.1 kernels, Interpolator, fftfilt, NCO, phase discriminators, CTCSS detector
+ * and the FFT engine. Results go to the report with their allocation counts.
+ */
+class DSPBench
+{
+public:
+    DSPBench(int nbSamples, int blockSize, int sampleRate, BenchReport *report);
+    ~DSPBench();
+
+    void run(const std::string& suite = ""); //!< runs all suites or only the one given
+
+private:
+    int m_nbSamples;
+    int m_blockSize;
+    int m_sampleRate;
+    BenchReport *m_report;
+    SampleVector m_samples;        //!< tone plus noise
+    std::vector<Complex> m_complex; //!< same as complex float
+    qint64 m_checksum;              //!< folds outputs so that the work is not optimized away
+    std::vector<quint64> m_kernelChecksums; //!< scalar then intrinsics half band kernels outputs
+
+    void generate();
+    template<class HBFilter> void runHalfband(const char *filterName);
+    template<uint32_t HBFilterOrder> void runHalfbandKernelEO1(bool intrinsics);
+    template<uint32_t HBFilterOrder> void runHalfbandKernelST(bool intrinsics);
+    void runHalfbands();
+    void runInterpolator();
+    void runFFTFilter();
+    void runNCO();
+    void runPhaseDiscriminators();
+    void runCTCSS();
+    void runFFT();
+};
+
+#endif /* SDRBENCH_DSPBENCH_H_ */
@@ -0,0 +1,131 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <QCoreApplication>
+
+#include "channelizerbench.h"
+#include "decimatorsbench.h"
+#include "spectrumbench.h"
+#include "dspbench.h"
+#include "benchreport.h"
+
+static const char *suites[] = {
+    "channelizer", "decimators", "spectrum", "halfband", "interpolator", "fftfilt", "nco", "phasediscri", "ctcss", "fft", 0
+};
+
+static bool isSuite(const std::string& suite)
+{
+    for (int i = 0; suites[i]; i++)
+    {
+        if (suite == suites[i]) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr, "usage: %s [-s suite] [-r sampleRate] [-j report.json] [nbSamples [blockSize]]\n", program);
+    fprintf(stderr, "  suites:");
+
+    for (int i = 0; suites[i]; i++) {
+        fprintf(stderr, " %s", suites[i]);
+    }
+
+    fprintf(stderr, "\n");
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    int nbSamples = 1<<22;
+    int blockSize = 1<<14;
+    int sampleRate = 384000;
+    std::string suite;
+    const char *jsonFileName = 0;
+    int nbPositional = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-s") == 0) && (i + 1 < argc)) {
+            suite = argv[++i];
+        } else if ((strcmp(argv[i], "-r") == 0) && (i + 1 < argc)) {
+            sampleRate = std::atoi(argv[++i]);
+        } else if ((strcmp(argv[i], "-j") == 0) && (i + 1 < argc)) {
+            jsonFileName = argv[++i];
+        } else if ((argv[i][0] != '-') && (nbPositional == 0)) {
+            nbSamples = std::atoi(argv[i]);
+            nbPositional++;
+        } else if ((argv[i][0] != '-') && (nbPositional == 1)) {
+            blockSize = std::atoi(argv[i]);
+            nbPositional++;
+        }
+        else
+        {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if ((nbSamples <= 0) || (blockSize <= 0) || (blockSize > nbSamples) || (sampleRate < 48000) || (!suite.empty() && !isSuite(suite)))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    BenchReport report;
+    report.setParameter("nbSamples", nbSamples);
+    report.setParameter("blockSize", blockSize);
+    report.setParameter("sampleRate", sampleRate);
+
+    if (suite.empty() || (suite == "channelizer"))
+    {
+        ChannelizerBench channelizerBench(nbSamples, blockSize, &report);
+        channelizerBench.run();
+    }
+
+    if (suite.empty() || (suite == "decimators"))
+    {
+        DecimatorsBench decimatorsBench(nbSamples, blockSize, &report);
+        decimatorsBench.run();
+    }
+
+    if (suite.empty() || (suite == "spectrum"))
+    {
+        SpectrumBench spectrumBench(1024, &report);
+        spectrumBench.run();
+    }
+
+    if ((suite != "channelizer") && (suite != "decimators") && (suite != "spectrum"))
+    {
+        DSPBench dspBench(nbSamples, blockSize, sampleRate, &report);
+        dspBench.run(suite);
+    }
+
+    if (jsonFileName && !report.writeJSON(jsonFileName)) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <cstdlib>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <QElapsedTimer>
+
+#include "dsp/fftwindow.h"
+#include "dsp/spectrumsimd.h"
+#include "benchreport.h"
+#include "spectrumbench.h"
+
+SpectrumBench::SpectrumBench(int nbSpectrums, BenchReport *report) :
+    m_nbSpectrums(nbSpectrums),
+    m_report(report)
+{
+}
+
+SpectrumBench::~SpectrumBench()
+{
+}
+
+void SpectrumBench::run()
+{
+    printf("Spectrum: log power spectrum extraction without the FFT, %d spectrums per size\n", m_nbSpectrums);
+    printf("%6s %12s %12s %8s %12s\n", "size", "scalar us", "simd us", "speedup", "max dB err");
+
+    for (int fftSize = 64; fftSize <= 65536; fftSize *= 2)
+    {
+        SampleVector samples(fftSize);
+        std::vector<Real> window(fftSize);
+        std::vector<Complex> buffer(fftSize), windowed(fftSize);
+        std::vector<Real> power(fftSize), scalarDB(fftSize), simdDB(fftSize);
+        FFTWindow fftWindow;
+        std::srand(fftSize);
+
+        for (int i = 0; i < fftSize; i++)
+        {
+            samples[i].m_real = (FixReal) (std::rand() % 65536 - 32768);
+            samples[i].m_imag = (FixReal) (std::rand() % 65536 - 32768);
+        }
+
+        fftWindow.create(FFTWindow::BlackmanHarris, fftSize);
+        fftWindow.apply(std::vector<Real>(fftSize, 1.0f), &window);
+        Real ofs = 20.0f * log10f(1.0f / fftSize);
+        Real mult = 10.0f / log2f(10.0f);
+        int nbSpectrums = std::max(16, m_nbSpectrums / (fftSize / 64)); // keep roughly the same number of samples per size
+
+        // scalar reference as in SpectrumVis before vectorization. The FFT output is emulated
+        // by the windowed samples as the FFT itself is not part of the comparison.
+        QElapsedTimer timer;
+        timer.start();
+
+        for (int n = 0; n < nbSpectrums; n++)
+        {
+            for (int i = 0; i < fftSize; i++) {
+                buffer[i] = Complex(samples[i].real() / 32768.0f, samples[i].imag() / 32768.0f);
+            }
+
+            for (int i = 0; i < fftSize; i++) {
+                windowed[i] = buffer[i] * window[i];
+            }
+
+            for (int i = 0; i < fftSize; i++) {
+                power[i] = windowed[i].real() * windowed[i].real() + windowed[i].imag() * windowed[i].imag();
+            }
+
+            for (int i = 0; i < fftSize; i++) {
+                scalarDB[i] = mult * log2f(power[i]) + ofs;
+            }
+        }
+
+        double scalarTime = timer.nsecsElapsed() / 1e3;
+        timer.restart();
+
+        for (int n = 0; n < nbSpectrums; n++)
+        {
+            SpectrumSIMD::samplesToComplex(&samples[0], &buffer[0], fftSize);
+            SpectrumSIMD::applyWindow(&buffer[0], &window[0], &windowed[0], fftSize);
+            SpectrumSIMD::magSq(&windowed[0], &power[0], fftSize);
+            SpectrumSIMD::powerToDB(&power[0], &simdDB[0], fftSize, ofs);
+        }
+
+        double simdTime = timer.nsecsElapsed() / 1e3;
+        Real maxError = 0.0f;
+
+        for (int i = 0; i < fftSize; i++)
+        {
+            if (power[i] >= 1e-30f) { // stay away from denormals where the approximation is not bounded
+                maxError = std::max(maxError, std::fabs(simdDB[i] - scalarDB[i]));
+            }
+        }
+
+        printf("%6d %12.3f %12.3f %8.2f %12.2e%s\n",
+                fftSize,
+                scalarTime / nbSpectrums,
+                simdTime / nbSpectrums,
+                simdTime > 0.0 ? scalarTime / simdTime : 0.0,
+                maxError,
+                maxError > SpectrumSIMD::powerToDBMaxError ? " out of bound" : "");
+
+        // times are in microseconds here
+        char name[64];
+        snprintf(name, sizeof(name), "log_power_%d_scalar", fftSize);
+        m_report->record("spectrum", name, (qint64) nbSpectrums * fftSize, scalarTime / 1e6);
+        snprintf(name, sizeof(name), "log_power_%d_simd", fftSize);
+        m_report->record("spectrum", name, (qint64) nbSpectrums * fftSize, simdTime / 1e6);
+    }
+}
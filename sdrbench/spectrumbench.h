@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////////
+// Copyright (C) 2017 F4EXB                                                      //
+// written by Edouard Griffiths                                                  //
+//                                                                               //
+// This program is free software; you can redistribute it and/or modify          //
+// it under the terms of the GNU General Public License as published by          //
+// the Free Software Foundation as version 3 of the License, or                  //
+//                                                                               //
+// This program is distributed in the hope that it will be useful,               //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of                //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the                  //
+// GNU General Public License V3 for more details.                               //
+//                                                                               //
+// You should have received a copy of the GNU General Public License             //
+// along with this program. If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SDRBENCH_SPECTRUMBENCH_H_
+#define SDRBENCH_SPECTRUMBENCH_H_
+
+#include "dsp/dsptypes.h"
+
+class BenchReport;
+
+/**
+ * Compares the scalar and the vectorized extraction of the log power spectrum done by SpectrumVis
+ * around the FFT: sample conversion, windowing, magnitude squared and dB conversion
+ */
+class SpectrumBench
+{
+public:
+    SpectrumBench(int nbSpectrums, BenchReport *report);
+    ~SpectrumBench();
+
+    void run();
+
+private:
+    int m_nbSpectrums;
+    BenchReport *m_report;
+};
+
+#endif /* SDRBENCH_SPECTRUMBENCH_H_ */